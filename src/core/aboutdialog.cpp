@@ -28,11 +28,13 @@
  **********************************************************************/
 
 #include "aboutdialog.h"
+#include <algorithm>
 #include <QDomDocument>
 #include "util/sys/sysinfo.h"
 #include "interfaces/ihavediaginfo.h"
 #include "core.h"
 #include "coreproxy.h"
+#include "entitydispatchindex.h"
 
 namespace LeechCraft
 {
@@ -241,6 +243,29 @@ namespace LeechCraft
 		if (!unPathedModules.isEmpty ())
 			text += QString ("Adapted plugins:") + "\n" + unPathedModules.join ("\n") + "\n\n";
 
+		const auto& dispatchStats = EntityDispatchIndex::Instance ().GetStats ();
+		if (!dispatchStats.isEmpty ())
+		{
+			auto kinds = dispatchStats.keys ();
+			std::sort (kinds.begin (), kinds.end (),
+					[&dispatchStats] (const QString& left, const QString& right)
+						{ return dispatchStats [left].TotalUsecs_ > dispatchStats [right].TotalUsecs_; });
+
+			text += QString ("Entity dispatch statistics:") + "\n";
+			for (const auto& kind : kinds)
+			{
+				const auto& stats = dispatchStats [kind];
+				text += QString ("* %1: %2 entities, %3 ms total, %4 ms max, %5 handlers queried, %6 skipped\n")
+						.arg (kind)
+						.arg (stats.Count_)
+						.arg (stats.TotalUsecs_ / 1000.0, 0, 'f', 1)
+						.arg (stats.MaxUsecs_ / 1000.0, 0, 'f', 1)
+						.arg (stats.Queried_)
+						.arg (stats.Skipped_);
+			}
+			text += "\n";
+		}
+
 		Ui_.DiagInfo_->setPlainText (text);
 	}
 }
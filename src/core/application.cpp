@@ -268,6 +268,7 @@ namespace LeechCraft
 				("safe-mode", "disable all plugins so that you can manually enable them in Settings later")
 				("list-plugins", "list all non-adapted plugins that were found and exit (this one doesn't check if plugins are valid and loadable)")
 				("no-resource-caching", "disable caching of dynamic loadable resources (useful for stuff like Azoth themes development)")
+				("profile-plugins", bpo::value<std::string> (), "write plugins loading, initialization and release timings to the given file in Chrome trace format on exit")
 				("autorestart", "automatically restart LC if it's closed (not guaranteed to work everywhere, especially on Windows and Mac OS X)")
 				("minimized", "start LC minimized to tray")
 				("restart", "restart the LC");
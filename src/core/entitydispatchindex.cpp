@@ -0,0 +1,91 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#include "entitydispatchindex.h"
+#include <algorithm>
+#include <QUrl>
+#include <QtDebug>
+#include "interfaces/structures.h"
+#include "core.h"
+#include "pluginmanager.h"
+
+namespace LeechCraft
+{
+	EntityDispatchIndex& EntityDispatchIndex::Instance ()
+	{
+		static EntityDispatchIndex index;
+		return index;
+	}
+
+	QObjectList EntityDispatchIndex::FilterCandidates (const Entity& e, const QObjectList& plugins)
+	{
+		QMutexLocker locker { &Lock_ };
+		if (!IsValid_)
+		{
+			Index_.Rebuild (Core::Instance ().GetPluginManager ()->GetAllPlugins ());
+			IsValid_ = true;
+		}
+
+		return Index_.FilterCandidates (e, plugins);
+	}
+
+	void EntityDispatchIndex::Invalidate ()
+	{
+		QMutexLocker locker { &Lock_ };
+		IsValid_ = false;
+	}
+
+	void EntityDispatchIndex::AddDispatch (const QString& type, qint64 usecs, int queried, int skipped)
+	{
+		QMutexLocker locker { &Lock_ };
+		auto& stats = Stats_ [type];
+		++stats.Count_;
+		stats.TotalUsecs_ += usecs;
+		stats.MaxUsecs_ = std::max (stats.MaxUsecs_, usecs);
+		stats.Queried_ += queried;
+		stats.Skipped_ += skipped;
+	}
+
+	QHash<QString, EntityDispatchIndex::DispatchStats> EntityDispatchIndex::GetStats () const
+	{
+		QMutexLocker locker { &Lock_ };
+		return Stats_;
+	}
+
+	QString GetEntityKind (const Entity& e)
+	{
+		if (!e.Mime_.isEmpty ())
+			return e.Mime_;
+
+		if (e.Entity_.type () == QVariant::Url)
+			return "url:" + e.Entity_.toUrl ().scheme ();
+
+		return e.Entity_.typeName ();
+	}
+}
@@ -0,0 +1,88 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#pragma once
+
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include "entityfilterindex.h"
+
+namespace LeechCraft
+{
+	struct Entity;
+
+	/** Narrows down the set of plugins that should be asked whether they
+	 * could handle an entity according to the filters provided by the
+	 * plugins implementing IEntityFilter, and collects statistics on
+	 * entity dispatching.
+	 */
+	class EntityDispatchIndex
+	{
+	public:
+		struct DispatchStats
+		{
+			int Count_ = 0;
+			qint64 TotalUsecs_ = 0;
+			qint64 MaxUsecs_ = 0;
+			int Queried_ = 0;
+			int Skipped_ = 0;
+		};
+	private:
+		mutable QMutex Lock_;
+
+		bool IsValid_ = false;
+		EntityFilterIndex Index_;
+
+		QHash<QString, DispatchStats> Stats_;
+
+		EntityDispatchIndex () = default;
+	public:
+		static EntityDispatchIndex& Instance ();
+
+		/** Returns the plugins from the given list that should be asked
+		 * whether they could handle the given entity, preserving the
+		 * order of the list.
+		 */
+		QObjectList FilterCandidates (const Entity&, const QObjectList&);
+
+		/** Marks the index as outdated so that it is rebuilt from the
+		 * currently loaded plugins on the next dispatch.
+		 */
+		void Invalidate ();
+
+		void AddDispatch (const QString& type, qint64 usecs, int queried, int skipped);
+		QHash<QString, DispatchStats> GetStats () const;
+	};
+
+	/** Returns the string identifying the kind of the given entity in
+	 * the dispatch statistics.
+	 */
+	QString GetEntityKind (const Entity&);
+}
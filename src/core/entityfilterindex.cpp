@@ -0,0 +1,130 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#include "entityfilterindex.h"
+#include <QUrl>
+#include <QtDebug>
+#include "interfaces/structures.h"
+#include "interfaces/ientityfilter.h"
+
+namespace LeechCraft
+{
+	void EntityFilterIndex::Rebuild (const QObjectList& plugins)
+	{
+		Filtered_.clear ();
+		Mime2Plugins_.clear ();
+		MimeType2Plugins_.clear ();
+		Scheme2Plugins_.clear ();
+		Key2Plugins_.clear ();
+
+		for (const auto plugin : plugins)
+		{
+			const auto ief = qobject_cast<IEntityFilter*> (plugin);
+			if (!ief)
+				continue;
+
+			EntityFilter filter;
+			try
+			{
+				filter = ief->GetEntityFilter ();
+			}
+			catch (const std::exception& e)
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "could not get filter for"
+						<< plugin
+						<< e.what ();
+				continue;
+			}
+
+			Filtered_ << plugin;
+
+			for (const auto& mime : filter.Mimes_)
+				if (mime.endsWith ("/*"))
+					MimeType2Plugins_ [mime.section ('/', 0, 0)] << plugin;
+				else
+					Mime2Plugins_ [mime] << plugin;
+
+			for (const auto& scheme : filter.UrlSchemes_)
+				Scheme2Plugins_ [scheme] << plugin;
+			for (const auto& key : filter.AdditionalKeys_)
+				Key2Plugins_ [key] << plugin;
+		}
+
+		qDebug () << Q_FUNC_INFO
+				<< "indexed"
+				<< Filtered_.size ()
+				<< "filtered handlers out of"
+				<< plugins.size ()
+				<< "plugins";
+	}
+
+	QObjectList EntityFilterIndex::FilterCandidates (const Entity& e, const QObjectList& plugins) const
+	{
+		if (Filtered_.isEmpty ())
+			return plugins;
+
+		QSet<QObject*> matched;
+		if (!e.Mime_.isEmpty ())
+		{
+			matched += Mime2Plugins_.value (e.Mime_);
+			matched += MimeType2Plugins_.value (e.Mime_.section ('/', 0, 0));
+		}
+		if (e.Entity_.type () == QVariant::Url)
+			matched += Scheme2Plugins_.value (e.Entity_.toUrl ().scheme ());
+		for (auto i = e.Additional_.begin (), end = e.Additional_.end (); i != end; ++i)
+			matched += Key2Plugins_.value (i.key ());
+
+		QObjectList result;
+		for (const auto plugin : plugins)
+			if (!Filtered_.contains (plugin) || matched.contains (plugin))
+				result << plugin;
+		return result;
+	}
+
+	bool MatchesEntityFilter (const EntityFilter& filter, const Entity& e)
+	{
+		if (!e.Mime_.isEmpty ())
+		{
+			const auto& wildcard = e.Mime_.section ('/', 0, 0) + "/*";
+			if (filter.Mimes_.contains (e.Mime_) || filter.Mimes_.contains (wildcard))
+				return true;
+		}
+
+		if (e.Entity_.type () == QVariant::Url &&
+				filter.UrlSchemes_.contains (e.Entity_.toUrl ().scheme ()))
+			return true;
+
+		for (const auto& key : filter.AdditionalKeys_)
+			if (e.Additional_.contains (key))
+				return true;
+
+		return false;
+	}
+}
@@ -32,6 +32,7 @@
 #include <algorithm>
 #include <QDesktopServices>
 #include <QUrl>
+#include <QElapsedTimer>
 #include "util/util.h"
 #include "util/sll/prelude.h"
 #include "interfaces/structures.h"
@@ -42,6 +43,7 @@
 #include "pluginmanager.h"
 #include "xmlsettingsmanager.h"
 #include "handlerchoicedialog.h"
+#include "entitydispatchindex.h"
 
 namespace LeechCraft
 {
@@ -52,14 +54,26 @@ namespace LeechCraft
 
 	namespace
 	{
+		struct DispatchCounters
+		{
+			int Queried_ = 0;
+			int Skipped_ = 0;
+		};
+
 		template<typename T, typename F>
-		QObjectList GetSubtype (const Entity& e, bool fullScan, const F& queryFunc)
+		QObjectList GetSubtype (const Entity& e, bool fullScan, const F& queryFunc, DispatchCounters& counters)
 		{
 			auto pm = Core::Instance ().GetPluginManager ();
+			const auto& allPlugins = pm->GetAllCastableRoots<T> ();
+			const auto& candidates = EntityDispatchIndex::Instance ().FilterCandidates (e, allPlugins);
+			counters.Skipped_ += allPlugins.size () - candidates.size ();
+
 			QMap<int, QObjectList> result;
 			int cutoffPriority = 0;
-			for (const auto& plugin : pm->GetAllCastableRoots<T> ())
+			for (const auto& plugin : candidates)
 			{
+				++counters.Queried_;
+
 				EntityTestHandleResult r;
 				try
 				{
@@ -114,6 +128,12 @@ namespace LeechCraft
 			if (Core::Instance ().IsShuttingDown ())
 				return {};
 
+			Core::Instance ().GetPluginManager ()->ActivateLazyFor (e);
+
+			QElapsedTimer timer;
+			timer.start ();
+			DispatchCounters counters;
+
 			const auto& unwanted = e.Additional_ ["IgnorePlugins"].toStringList ();
 			auto removeUnwanted = [&unwanted] (QObjectList& handlers)
 			{
@@ -127,7 +147,8 @@ namespace LeechCraft
 			if (!(e.Parameters_ & TaskParameter::OnlyHandle))
 			{
 				auto sub = GetSubtype<IDownload*> (e, true,
-						[] (Entity e, IDownload *dl) { return dl->CouldDownload (e); });
+						[] (Entity e, IDownload *dl) { return dl->CouldDownload (e); },
+						counters);
 				removeUnwanted (sub);
 				if (downloaders)
 					*downloaders = sub.size ();
@@ -136,12 +157,17 @@ namespace LeechCraft
 			if (!(e.Parameters_ & TaskParameter::OnlyDownload))
 			{
 				auto sub = GetSubtype<IEntityHandler*> (e, true,
-						[] (Entity e, IEntityHandler *eh) { return eh->CouldHandle (e); });
+						[] (Entity e, IEntityHandler *eh) { return eh->CouldHandle (e); },
+						counters);
 				removeUnwanted (sub);
 				if (handlers)
 					*handlers = sub.size ();
 				result += sub;
 			}
+
+			EntityDispatchIndex::Instance ().AddDispatch (GetEntityKind (e),
+					timer.nsecsElapsed () / 1000, counters.Queried_, counters.Skipped_);
+
 			return result;
 		}
 
@@ -36,6 +36,7 @@
 #include <interfaces/iplugin2.h>
 #include "xmlsettingsmanager.h"
 #include "core.h"
+#include "pluginmanager.h"
 
 namespace LeechCraft
 {
@@ -288,6 +289,75 @@ namespace LeechCraft
 		rootMenu->insertAction (FindActionBefore (act->text (), rootMenu), act);
 	}
 
+	void NewTabMenuManager::AddLazyObject (const QString& path, const PluginManifest& manifest)
+	{
+		if (manifest.TabClasses_.isEmpty () || LazyActions_.contains (path))
+			return;
+
+		auto menu = NewTabMenu_;
+		if (manifest.TabClasses_.size () > 1)
+		{
+			menu = new QMenu (manifest.Name_, NewTabMenu_);
+			NewTabMenu_->insertMenu (FindActionBefore (manifest.Name_, NewTabMenu_), menu);
+			LazyMenus_ [path] = menu;
+		}
+
+		for (const auto& info : manifest.TabClasses_)
+		{
+			const auto act = new QAction (info.VisibleName_, this);
+			connect (act,
+					SIGNAL (triggered ()),
+					this,
+					SLOT (handleNewTabRequested ()));
+			act->setProperty ("LazyPath", path);
+			act->setProperty ("TabClass", info.TabClass_);
+			act->setStatusTip (info.Description_);
+			act->setToolTip (info.Description_);
+
+			menu->insertAction (FindActionBefore (act->text (), menu), act);
+			LazyActions_ [path] << act;
+		}
+	}
+
+	void NewTabMenuManager::RemoveLazyObject (const QString& path)
+	{
+		for (const auto act : LazyActions_.take (path))
+		{
+			act->setVisible (false);
+			act->deleteLater ();
+		}
+
+		if (const auto menu = LazyMenus_.take (path))
+		{
+			menu->menuAction ()->setVisible (false);
+			menu->deleteLater ();
+		}
+	}
+
+	void NewTabMenuManager::OpenLazyTab (const QString& path, const QByteArray& tabClass)
+	{
+		const auto obj = Core::Instance ().GetPluginManager ()->ActivateLazy (path);
+		const auto tabs = qobject_cast<IHaveTabs*> (obj);
+		if (!tabs)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to load"
+					<< path
+					<< obj;
+			return;
+		}
+
+		for (const auto act : findChildren<QAction*> ())
+			if (act->property ("PluginObj").value<QObject*> () == obj &&
+					act->property ("TabClass").toByteArray () == tabClass)
+			{
+				OpenTab (act);
+				return;
+			}
+
+		tabs->TabOpenRequested (tabClass);
+	}
+
 	void NewTabMenuManager::handleNewTabRequested ()
 	{
 		QAction *action = qobject_cast<QAction*> (sender ());
@@ -299,6 +369,13 @@ namespace LeechCraft
 			return;
 		}
 
+		const auto& lazyPath = action->property ("LazyPath").toString ();
+		if (!lazyPath.isEmpty ())
+		{
+			OpenLazyTab (lazyPath, action->property ("TabClass").toByteArray ());
+			return;
+		}
+
 		OpenTab (action);
 	}
 }
@@ -31,6 +31,7 @@
 #define NEWTABMENUMANAGER_H
 #include <QObject>
 #include <QMap>
+#include <QHash>
 #include <QString>
 #include <QSet>
 
@@ -41,6 +42,8 @@ class ITabWidget;
 
 namespace LeechCraft
 {
+	struct PluginManifest;
+
 	class NewTabMenuManager : public QObject
 	{
 		Q_OBJECT
@@ -50,10 +53,20 @@ namespace LeechCraft
 		QList<QObject*> RegisteredMultiTabs_;
 		QSet<QChar> UsedAccelerators_;
 		QMap<QObject*, QMap<QString, QAction*>> HiddenActions_;
+
+		QHash<QString, QList<QAction*>> LazyActions_;
+		QHash<QString, QMenu*> LazyMenus_;
 	public:
 		NewTabMenuManager (QObject* = 0);
 
 		void AddObject (QObject*);
+
+		/** Adds the actions for the tab classes of a not yet loaded
+		 * on-demand plugin from the given library according to its
+		 * manifest. Triggering any of them loads the plugin.
+		 */
+		void AddLazyObject (const QString& path, const PluginManifest&);
+		void RemoveLazyObject (const QString& path);
 		void SetToolbarActions (QList<QList<QAction*>>);
 		void SingleRemoved (ITabWidget*);
 
@@ -66,6 +79,7 @@ namespace LeechCraft
 		QString AccelerateName (QString);
 		void ToggleHide (QObject*, const QByteArray&, bool);
 		void OpenTab (QAction*);
+		void OpenLazyTab (const QString& path, const QByteArray& tabClass);
 		void InsertAction (QAction*);
 		void InsertActionWParent (QAction*, QObject*, bool sub);
 	private slots:
@@ -36,6 +36,8 @@
 #include <QStringList>
 #include <QtDebug>
 #include <QtConcurrentMap>
+#include <QtConcurrentRun>
+#include <QThread>
 #include <QMessageBox>
 #include <QMainWindow>
 #include <util/util.h>
@@ -46,12 +48,15 @@
 #include <interfaces/ipluginready.h>
 #include <interfaces/ipluginadaptor.h>
 #include <interfaces/ihaveshortcuts.h>
+#include <interfaces/ithreadsafeinit.h>
 #include "core.h"
 #include "pluginmanager.h"
 #include "mainwindow.h"
 #include "xmlsettingsmanager.h"
 #include "coreproxy.h"
 #include "plugintreebuilder.h"
+#include "newtabmenumanager.h"
+#include "entitydispatchindex.h"
 #include "config.h"
 #include "coreinstanceobject.h"
 #include "shortcutmanager.h"
@@ -120,9 +125,15 @@ namespace LeechCraft
 		else if (role == Roles::PluginID)
 		{
 			auto loader = AvailablePlugins_ [index.row ()];
-			if (!loader || !loader->IsLoaded ())
+			if (!loader)
 				return QVariant ();
 
+			if (!loader->IsLoaded ())
+			{
+				const auto& manifest = ManifestCache_.Get (loader->GetFileName ());
+				return manifest ? manifest->ID_ : QVariant ();
+			}
+
 			return qobject_cast<IInfo*> (loader->Instance ())->GetUniqueID ();
 		}
 		else if (role == Roles::PluginFilename)
@@ -158,6 +169,25 @@ namespace LeechCraft
 					const auto& res = qobject_cast<IInfo*> (loader->Instance ())->GetIcon ();
 					return res.isNull () ? DefaultPluginIcon_ : res;
 				}
+			case Qt::ToolTipRole:
+				{
+					const auto& records = Profiler_.GetRecords (AvailablePlugins_.at (index.row ())->GetFileName ());
+					if (records.isEmpty ())
+						return QVariant ();
+
+					QStringList lines;
+					qint64 total = 0;
+					for (const auto& record : records)
+					{
+						total += record.DurationUsecs_;
+						lines << tr ("%1: %2 ms, heap %3 KiB")
+								.arg (GetStageName (record.Stage_))
+								.arg (record.DurationUsecs_ / 1000.0, 0, 'f', 1)
+								.arg (record.HeapDelta_ / 1024);
+					}
+					lines.prepend (tr ("Total: %1 ms").arg (total / 1000.0, 0, 'f', 1));
+					return lines.join ("\n");
+				}
 			case Qt::CheckStateRole:
 				{
 					QSettings settings (QCoreApplication::organizationName (),
@@ -335,53 +365,6 @@ namespace LeechCraft
 		return AvailablePlugins_.size ();
 	}
 
-	QObject* PluginManager::TryFirstInit (QObjectList ordered)
-	{
-		QSettings settings (QCoreApplication::organizationName (),
-				QCoreApplication::applicationName () + "-pg");
-		settings.beginGroup ("Plugins");
-		std::shared_ptr<void> groupGuard (nullptr,
-				[&settings] (void*) { settings.endGroup (); });
-
-		for (const auto obj : ordered)
-		{
-			const auto ii = qobject_cast<IInfo*> (obj);
-			try
-			{
-				qDebug () << "Initializing" << ii->GetName ();
-				emit loadProgress (tr ("Initializing %1: stage one...").arg (ii->GetName ()));
-				ii->Init (std::make_shared<CoreProxy> ());
-
-				const auto& path = GetPluginLibraryPath (obj);
-				if (path.isEmpty ())
-					continue;
-
-				settings.beginGroup (path);
-				settings.setValue ("Info", ii->GetInfo ());
-				settings.endGroup ();
-			}
-			catch (const std::exception& e)
-			{
-				qWarning () << Q_FUNC_INFO
-						<< "while initializing"
-						<< obj
-						<< "got"
-						<< e.what ();
-				return obj;
-			}
-			catch (...)
-			{
-				qWarning () << Q_FUNC_INFO
-						<< "while initializing"
-						<< obj
-						<< "caught unknown exception";
-				return obj;
-			}
-		}
-
-		return 0;
-	}
-
 	void PluginManager::TryUnload (QObjectList plugins)
 	{
 		for (const auto object : plugins)
@@ -408,7 +391,10 @@ namespace LeechCraft
 		FillInstances ();
 
 		if (safeMode)
+		{
 			Plugins_.clear ();
+			LazyPlugins_.clear ();
+		}
 
 		Plugins_.prepend (Core::Instance ().GetCoreInstanceObject ());
 
@@ -452,6 +438,7 @@ namespace LeechCraft
 			try
 			{
 				emit loadProgress (tr ("Initializing %1: stage two...").arg (ii->GetName ()));
+				const auto guard = Profiler_.Measure (GetProfileKey (obj), PluginProfiler::Stage::SecondInit);
 				ii->SecondInit ();
 			}
 			catch (const std::exception& e)
@@ -468,6 +455,10 @@ namespace LeechCraft
 		for (const auto plugin : GetAllPlugins ())
 			Core::Instance ().PostSecondInit (plugin);
 
+		for (const auto& loader : LazyPlugins_)
+			if (const auto& manifest = ManifestCache_.Get (loader->GetFileName ()))
+				Core::Instance ().GetNewTabMenuManager ()->AddLazyObject (loader->GetFileName (), *manifest);
+
 		TryUnload (failed);
 	}
 
@@ -489,7 +480,10 @@ namespace LeechCraft
 					continue;
 				}
 				qDebug () << "Releasing" << ii->GetName ();
-				ii->Release ();
+				{
+					const auto guard = Profiler_.Measure (GetProfileKey (obj), PluginProfiler::Stage::Release);
+					ii->Release ();
+				}
 
 				const auto& loader = Obj2Loader_.value (obj);
 				if (!loader)
@@ -512,11 +506,22 @@ namespace LeechCraft
 			}
 		}
 
+		const auto& varMap = static_cast<Application*> (qApp)->GetVarMap ();
+		if (varMap.count ("profile-plugins"))
+		{
+			const auto& path = QString::fromStdString (varMap ["profile-plugins"].as<std::string> ());
+			if (Profiler_.ExportChromeTrace (path))
+				qDebug () << Q_FUNC_INFO
+						<< "wrote plugins profile to"
+						<< path;
+		}
+
 		qDebug () << Q_FUNC_INFO
 				<< "destroying loaders...";
 		PluginTreeBuilder_.reset ();
-		FeatureProviders_.clear ();
+		InvalidatePluginsCache ();
 		AvailablePlugins_.clear ();
+		LazyPlugins_.clear ();
 		Obj2Loader_.clear ();
 		Plugins_.clear ();
 		PluginContainers_.clear ();
@@ -570,7 +575,23 @@ namespace LeechCraft
 					break;
 				}
 
-		return PluginID2PluginCache_ [id];
+		if (const auto plugin = PluginID2PluginCache_.value (id))
+			return plugin;
+
+		for (const auto& loader : LazyPlugins_)
+		{
+			const auto& path = loader->GetFileName ();
+			const auto& manifest = ManifestCache_.Get (path);
+			if (!manifest || manifest->ID_ != id)
+				continue;
+
+			const auto plugin = const_cast<PluginManager*> (this)->ActivateLazy (path);
+			if (plugin)
+				PluginID2PluginCache_ [id] = plugin;
+			return plugin;
+		}
+
+		return nullptr;
 	}
 
 	QObjectList PluginManager::GetFirstLevels (const QByteArray& pclass) const
@@ -696,9 +717,19 @@ namespace LeechCraft
 
 	QObject* PluginManager::GetProvider (const QString& feature) const
 	{
-		if (!FeatureProviders_.contains (feature))
-			return 0;
-		return (*FeatureProviders_ [feature])->Instance ();
+		for (const auto plugin : GetAllPlugins ())
+			if (qobject_cast<IInfo*> (plugin)->Provides ().contains (feature))
+				return plugin;
+
+		for (const auto& loader : LazyPlugins_)
+		{
+			const auto& path = loader->GetFileName ();
+			const auto& manifest = ManifestCache_.Get (path);
+			if (manifest && manifest->Provides_.contains (feature))
+				return const_cast<PluginManager*> (this)->ActivateLazy (path);
+		}
+
+		return nullptr;
 	}
 
 	const QStringList& PluginManager::GetPluginLoadErrors () const
@@ -706,6 +737,21 @@ namespace LeechCraft
 		return PluginLoadErrors_;
 	}
 
+	const PluginProfiler& PluginManager::GetProfiler () const
+	{
+		return Profiler_;
+	}
+
+	QString PluginManager::GetProfileKey (QObject *obj) const
+	{
+		const auto& path = GetPluginLibraryPath (obj);
+		if (!path.isEmpty ())
+			return path;
+
+		const auto ii = qobject_cast<IInfo*> (obj);
+		return ii ? QString::fromUtf8 (ii->GetUniqueID ()) : QString ();
+	}
+
 	QStringList PluginManager::FindPluginsPaths () const
 	{
 		QStringList result;
@@ -873,18 +919,178 @@ namespace LeechCraft
 		}
 	}
 
+	void PluginManager::PruneUnfulfillable ()
+	{
+		QHash<QString, PluginManifest> manifests;
+		for (const auto& loader : PluginContainers_)
+		{
+			// Plugins with unknown manifests and adaptors may provide anything.
+			const auto& manifest = ManifestCache_.Get (loader->GetFileName ());
+			if (!manifest || manifest->Interfaces_.contains ("IPluginAdaptor"))
+				return;
+
+			manifests [loader->GetFileName ()] = *manifest;
+		}
+
+		const auto coreObj = Core::Instance ().GetCoreInstanceObject ();
+		const auto& coreProvides = QSet<QString>::fromList (coreObj->Provides ());
+		const auto& coreExpected = coreObj->GetExpectedPluginClasses ();
+
+		bool changed = true;
+		while (changed)
+		{
+			changed = false;
+
+			auto provides = coreProvides;
+			auto expected = coreExpected;
+			for (const auto& manifest : manifests)
+			{
+				provides += QSet<QString>::fromList (manifest.Provides_);
+				expected += manifest.ExpectedPluginClasses_;
+			}
+
+			for (auto i = manifests.begin (); i != manifests.end (); )
+			{
+				if (provides.contains (QSet<QString>::fromList (i->Needs_)) &&
+						expected.contains (i->PluginClasses_))
+				{
+					++i;
+					continue;
+				}
+
+				qDebug () << Q_FUNC_INFO
+						<< "dependencies of"
+						<< i->Name_
+						<< "can't be fulfilled, not loading"
+						<< i.key ();
+				i = manifests.erase (i);
+				changed = true;
+			}
+		}
+
+		PluginContainers_.erase (std::remove_if (PluginContainers_.begin (), PluginContainers_.end (),
+					[&manifests] (const Loaders::IPluginLoader_ptr& loader)
+						{ return !manifests.contains (loader->GetFileName ()); }),
+				PluginContainers_.end ());
+	}
+
+	void PluginManager::DeferLazyPlugins ()
+	{
+		if (DBusMode_ ||
+				!XmlSettingsManager::Instance ()->Property ("LoadPluginsOnDemand", true).toBool ())
+			return;
+
+		QHash<QString, PluginManifest> manifests;
+		for (const auto& loader : PluginContainers_)
+		{
+			// Plugins with unknown manifests may need anything.
+			const auto& manifest = ManifestCache_.Get (loader->GetFileName ());
+			if (!manifest)
+				return;
+
+			manifests [loader->GetFileName ()] = *manifest;
+		}
+
+		QSet<QString> lazy;
+		for (auto i = manifests.begin (); i != manifests.end (); ++i)
+			if (i->Lazy_ &&
+					i->PluginClasses_.isEmpty () &&
+					i->ExpectedPluginClasses_.isEmpty () &&
+					!i->Interfaces_.contains ("IPluginAdaptor"))
+				lazy << i.key ();
+
+		bool changed = true;
+		while (changed && !lazy.isEmpty ())
+		{
+			changed = false;
+
+			QSet<QString> needed;
+			for (auto i = manifests.begin (); i != manifests.end (); ++i)
+				if (!lazy.contains (i.key ()))
+					needed += QSet<QString>::fromList (i->Needs_);
+
+			for (auto i = lazy.begin (); i != lazy.end (); )
+			{
+				if (QSet<QString>::fromList (manifests [*i].Provides_).intersect (needed).isEmpty ())
+				{
+					++i;
+					continue;
+				}
+
+				i = lazy.erase (i);
+				changed = true;
+			}
+		}
+
+		for (int i = 0; i < PluginContainers_.size (); ++i)
+		{
+			const auto& loader = PluginContainers_.at (i);
+			if (!lazy.contains (loader->GetFileName ()))
+				continue;
+
+			qDebug () << Q_FUNC_INFO
+					<< "deferring loading of"
+					<< loader->GetFileName ();
+			LazyPlugins_ << loader;
+			PluginContainers_.removeAt (i--);
+		}
+	}
+
 	void PluginManager::CheckPlugins ()
 	{
-		QSettings settings (QCoreApplication::organizationName (),
-				QCoreApplication::applicationName () + "-pg");
-		settings.beginGroup ("Plugins");
+		PruneUnfulfillable ();
 
 		QHash<QByteArray, QString> id2source;
 
+		QHash<QString, PluginManifest> manifests;
+		for (const auto& loader : PluginContainers_)
+			if (const auto& manifest = ManifestCache_.Get (loader->GetFileName ()))
+				manifests [loader->GetFileName ()] = *manifest;
+
+		for (int i = 0; i < PluginContainers_.size (); ++i)
+		{
+			const auto& loader = PluginContainers_.at (i);
+			if (!manifests.contains (loader->GetFileName ()))
+				continue;
+
+			const auto& id = manifests [loader->GetFileName ()].ID_;
+			if (!id2source.contains (id))
+			{
+				id2source [id] = loader->GetFileName ();
+				continue;
+			}
+
+			PluginLoadErrors_ << tr ("Plugin with ID %1 is "
+					"already loaded from %2; aborting load "
+					"from %3.")
+				.arg (QString::fromUtf8 (id.constData ()))
+				.arg (id2source [id])
+				.arg (loader->GetFileName ());
+			PluginContainers_.removeAt (i--);
+		}
+		id2source.clear ();
+
+		/* Deferred plugins aren't checked below, so they must have passed
+		 * the above check of the cached IDs.
+		 */
+		DeferLazyPlugins ();
+
+		const auto apiLevelCheck = [manifests] (Loaders::IPluginLoader_ptr loader)
+		{
+			const auto pos = manifests.find (loader->GetFileName ());
+			if (pos == manifests.end () || pos->APILevel_ != CURRENT_API_LEVEL)
+				Checks::APILevel (loader);
+		};
+
 		QList<std::function<void (Loaders::IPluginLoader_ptr)>> checks;
 		checks << Checks::IsFile
-				<< Checks::TryLoad
-				<< Checks::APILevel;
+				<< [this] (Loaders::IPluginLoader_ptr loader)
+					{
+						const auto guard = Profiler_.Measure (loader->GetFileName (),
+								PluginProfiler::Stage::Load);
+						Checks::TryLoad (loader);
+					}
+				<< apiLevelCheck;
 
 		auto thrCheck = [checks] (Loaders::IPluginLoader_ptr loader) -> boost::optional<Checks::Fail>
 		{
@@ -919,7 +1125,12 @@ namespace LeechCraft
 			}
 
 		checks.clear ();
-		checks << Checks::TryInstance;
+		checks << [this] (Loaders::IPluginLoader_ptr loader)
+				{
+					const auto guard = Profiler_.Measure (loader->GetFileName (),
+							PluginProfiler::Stage::Instance);
+					Checks::TryInstance (loader);
+				};
 
 		for (int i = 0; i < PluginContainers_.size (); ++i)
 		{
@@ -981,16 +1192,8 @@ namespace LeechCraft
 				continue;
 			}
 
-			QString name = info->GetName ();
-			QString pinfo = info->GetInfo ();
-
-			settings.beginGroup (loader->GetFileName ());
-			settings.setValue ("Name", name);
-			settings.setValue ("Info", pinfo);
-			settings.endGroup ();
+			ManifestCache_.Store (loader->GetFileName (), loader->Instance (), CURRENT_API_LEVEL, false);
 		}
-
-		settings.endGroup ();
 	}
 
 	void PluginManager::FillInstances ()
@@ -1006,39 +1209,289 @@ namespace LeechCraft
 		}
 	}
 
+	namespace
+	{
+		bool InitPlugin (QObject *obj, const ICoreProxy_ptr& proxy)
+		{
+			try
+			{
+				qobject_cast<IInfo*> (obj)->Init (proxy);
+				return true;
+			}
+			catch (const std::exception& e)
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "while initializing"
+						<< obj
+						<< "got"
+						<< e.what ();
+			}
+			catch (...)
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "while initializing"
+						<< obj
+						<< "caught unknown exception";
+			}
+			return false;
+		}
+	}
+
+	bool PluginManager::IsConcurrentInit (QObject *obj) const
+	{
+		if (DBusMode_ || PluginTreeBuilder_->HasDependents (obj))
+			return false;
+
+		const auto itsi = qobject_cast<IThreadSafeInit*> (obj);
+		return itsi && itsi->IsInitThreadSafe ();
+	}
+
+	void PluginManager::InvalidatePluginsCache ()
+	{
+		CacheValid_ = false;
+		EntityDispatchIndex::Instance ().Invalidate ();
+	}
+
 	QObjectList PluginManager::FirstInitAll ()
 	{
-		QObjectList ordered = PluginTreeBuilder_->GetResult ();
-		QObjectList initialized;
+		auto pending = PluginTreeBuilder_->GetResult ();
 		QObjectList failedList;
 
-		QObject *failed = 0;
-		while ((failed = TryFirstInit (ordered)))
+		/* Decided before any Init() is started, so that nothing is asked
+		 * from the plugins being initialized in other threads. No plugin
+		 * depends on these ones, so their failures can't make other
+		 * plugins unfulfilled, and a failure of other plugins only drops
+		 * the ones that haven't been started yet.
+		 */
+		QSet<QObject*> concurrent;
+		for (const auto obj : pending)
+			if (IsConcurrentInit (obj))
+				concurrent << obj;
+
+		auto handleResult = [this, &pending, &failedList] (QObject *obj, bool ok)
 		{
-			CacheValid_ = false;
-
-			failedList << failed;
-			Q_FOREACH (QObject *obj, ordered)
+			if (ok)
 			{
-				if (failed == obj)
-					break;
-				initialized << obj;
+				const auto& path = GetPluginLibraryPath (obj);
+				if (!path.isEmpty ())
+					ManifestCache_.Store (path, obj, CURRENT_API_LEVEL, true);
+				return;
 			}
 
-			PluginTreeBuilder_->RemoveObject (failed);
+			InvalidatePluginsCache ();
+			failedList << obj;
 
-			qDebug () << failed
+			PluginTreeBuilder_->RemoveObject (obj);
+
+			qDebug () << obj
 					<< "failed to initialize, recalculating dep tree...";
 			PluginTreeBuilder_->Calculate ();
 
-			ordered = PluginTreeBuilder_->GetResult ();
-			Q_FOREACH (QObject *obj, initialized)
-				ordered.removeAll (obj);
+			const auto& result = PluginTreeBuilder_->GetResult ();
+			pending.erase (std::remove_if (pending.begin (), pending.end (),
+						[&result] (QObject *other) { return !result.contains (other); }),
+					pending.end ());
+		};
+
+		QList<QPair<QObject*, QFuture<bool>>> running;
+
+		while (!pending.isEmpty ())
+		{
+			const auto obj = pending.takeFirst ();
+
+			const auto ii = qobject_cast<IInfo*> (obj);
+			emit loadProgress (tr ("Initializing %1: stage one...").arg (ii->GetName ()));
+
+			if (concurrent.contains (obj))
+			{
+				qDebug () << "Initializing concurrently" << ii->GetName ();
+
+				const auto& key = GetProfileKey (obj);
+				const ICoreProxy_ptr proxy = std::make_shared<CoreProxy> ();
+				running.append ({ obj, QtConcurrent::run ([this, obj, key, proxy]
+						{
+							const auto guard = Profiler_.Measure (key, PluginProfiler::Stage::Init);
+							return InitPlugin (obj, proxy);
+						}) });
+				continue;
+			}
+
+			qDebug () << "Initializing" << ii->GetName ();
+
+			bool ok = false;
+			{
+				const auto guard = Profiler_.Measure (GetProfileKey (obj), PluginProfiler::Stage::Init);
+				ok = InitPlugin (obj, std::make_shared<CoreProxy> ());
+			}
+			handleResult (obj, ok);
+		}
+
+		for (auto& pair : running)
+		{
+			pair.second.waitForFinished ();
+			handleResult (pair.first, pair.second.result ());
 		}
 
 		return failedList;
 	}
 
+	QObject* PluginManager::ActivateLazy (const QString& path)
+	{
+		/* Blocking on the main thread here could deadlock if it waits
+		 * for the calling thread, so the plugin is loaded later.
+		 */
+		if (QThread::currentThread () != thread ())
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "called from a non-main thread, queueing activation of"
+					<< path;
+			QMetaObject::invokeMethod (this,
+					"ActivateLazy",
+					Qt::QueuedConnection,
+					Q_ARG (QString, path));
+			return nullptr;
+		}
+
+		const auto pos = std::find_if (LazyPlugins_.begin (), LazyPlugins_.end (),
+				[&path] (const Loaders::IPluginLoader_ptr& loader) { return loader->GetFileName () == path; });
+		if (pos == LazyPlugins_.end ())
+			return nullptr;
+
+		const auto loader = *pos;
+		LazyPlugins_.erase (pos);
+
+		qDebug () << Q_FUNC_INFO
+				<< "loading on demand"
+				<< path;
+
+		if (const auto& manifest = ManifestCache_.Get (path))
+			for (const auto& feature : manifest->Needs_)
+				GetProvider (feature);
+
+		try
+		{
+			Checks::IsFile (loader);
+			{
+				const auto guard = Profiler_.Measure (path, PluginProfiler::Stage::Load);
+				Checks::TryLoad (loader);
+			}
+			Checks::APILevel (loader);
+			{
+				const auto guard = Profiler_.Measure (path, PluginProfiler::Stage::Instance);
+				Checks::TryInstance (loader);
+			}
+		}
+		catch (const Checks::Fail& f)
+		{
+			PluginLoadErrors_ << f.Error_;
+			if (f.Unload_)
+				loader->Unload ();
+			return nullptr;
+		}
+
+		const auto inst = loader->Instance ();
+
+		const auto& id = qobject_cast<IInfo*> (inst)->GetUniqueID ();
+		const auto& allPlugins = GetAllPlugins ();
+		const auto dupPos = std::find_if (allPlugins.begin (), allPlugins.end (),
+				[&id] (QObject *other) { return qobject_cast<IInfo*> (other)->GetUniqueID () == id; });
+		if (dupPos != allPlugins.end ())
+		{
+			PluginLoadErrors_ << tr ("Plugin with ID %1 is "
+					"already loaded from %2; aborting load "
+					"from %3.")
+				.arg (QString::fromUtf8 (id.constData ()))
+				.arg (GetPluginLibraryPath (*dupPos))
+				.arg (path);
+			loader->Unload ();
+			return nullptr;
+		}
+
+		PluginContainers_ << loader;
+		Obj2Loader_ [inst] = loader;
+		Plugins_ << inst;
+
+		PluginTreeBuilder_->AddObjects ({ inst });
+		PluginTreeBuilder_->Calculate ();
+		InvalidatePluginsCache ();
+
+		bool initialized = false;
+		if (PluginTreeBuilder_->GetResult ().contains (inst))
+		{
+			const auto guard = Profiler_.Measure (path, PluginProfiler::Stage::Init);
+			initialized = InitPlugin (inst, std::make_shared<CoreProxy> ());
+		}
+
+		if (!initialized)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "failed to initialize"
+					<< path;
+			PluginTreeBuilder_->RemoveObject (inst);
+			PluginTreeBuilder_->Calculate ();
+			InvalidatePluginsCache ();
+			Plugins_.removeAll (inst);
+			TryUnload ({ inst });
+			return nullptr;
+		}
+
+		ManifestCache_.Store (path, inst, CURRENT_API_LEVEL, true);
+
+		Core::Instance ().GetNewTabMenuManager ()->RemoveLazyObject (path);
+		Core::Instance ().Setup (inst);
+		if (qobject_cast<IHaveShortcuts*> (inst))
+			Core::Instance ().GetCoreInstanceObject ()->GetShortcutManager ()->AddObject (inst);
+
+		try
+		{
+			const auto guard = Profiler_.Measure (path, PluginProfiler::Stage::SecondInit);
+			qobject_cast<IInfo*> (inst)->SecondInit ();
+		}
+		catch (const std::exception& e)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "while initializing"
+					<< inst
+					<< "got"
+					<< e.what ();
+		}
+
+		Core::Instance ().PostSecondInit (inst);
+
+		const auto row = AvailablePlugins_.indexOf (loader);
+		if (row >= 0)
+			emit dataChanged (index (row, 0), index (row, columnCount () - 1));
+
+		emit pluginInjected (inst);
+		return inst;
+	}
+
+	void PluginManager::ActivateLazyFor (const Entity& e)
+	{
+		if (QThread::currentThread () != thread ())
+		{
+			QMetaObject::invokeMethod (this,
+					"ActivateLazyFor",
+					Qt::QueuedConnection,
+					Q_ARG (LeechCraft::Entity, e));
+			return;
+		}
+
+		if (LazyPlugins_.isEmpty ())
+			return;
+
+		QStringList paths;
+		for (const auto& loader : LazyPlugins_)
+		{
+			const auto& manifest = ManifestCache_.Get (loader->GetFileName ());
+			if (manifest && MatchesEntityFilter (manifest->EntityFilter_, e))
+				paths << loader->GetFileName ();
+		}
+
+		for (const auto& path : paths)
+			ActivateLazy (path);
+	}
+
 	Loaders::IPluginLoader_ptr PluginManager::MakeLoader (const QString& filename)
 	{
 #ifndef WITH_DBUS_LOADERS
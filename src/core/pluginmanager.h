@@ -37,6 +37,8 @@
 #include <QDir>
 #include <QIcon>
 #include "loaders/ipluginloader.h"
+#include "pluginmanifestcache.h"
+#include "pluginprofiler.h"
 #include "interfaces/iinfo.h"
 #include "interfaces/core/ipluginsmanager.h"
 
@@ -44,6 +46,7 @@ namespace LeechCraft
 {
 	class MainWindow;
 	class PluginTreeBuilder;
+	struct Entity;
 
 	class PluginManager : public QAbstractItemModel
 						, public IPluginsManager
@@ -64,7 +67,9 @@ namespace LeechCraft
 
 		// All plugins ever seen
 		PluginsContainer_t AvailablePlugins_;
-		QMap<QString, PluginsContainer_t::const_iterator> FeatureProviders_;
+
+		// Plugins to be loaded on demand that aren't loaded yet
+		PluginsContainer_t LazyPlugins_;
 
 		QStringList Headers_;
 		QIcon DefaultPluginIcon_;
@@ -73,6 +78,9 @@ namespace LeechCraft
 
 		std::shared_ptr<PluginTreeBuilder> PluginTreeBuilder_;
 
+		PluginManifestCache ManifestCache_;
+		PluginProfiler Profiler_;
+
 		mutable bool CacheValid_;
 		mutable QObjectList SortedCache_;
 	public:
@@ -122,7 +130,35 @@ namespace LeechCraft
 		QObject* GetProvider (const QString&) const;
 
 		const QStringList& GetPluginLoadErrors () const;
+
+		const PluginProfiler& GetProfiler () const;
+
+		/** Loads and initializes the not yet loaded on-demand plugin
+		 * from the given library. Returns the plugin instance, or null
+		 * if there is no such plugin or it has failed to load.
+		 *
+		 * If called from a thread other than the main one, doesn't
+		 * block: the plugin is loaded later in the main thread, and
+		 * null is returned.
+		 */
+		Q_INVOKABLE QObject* ActivateLazy (const QString& path);
+
+		/** Loads and initializes the not yet loaded on-demand plugins
+		 * whose entity filters match the given entity.
+		 *
+		 * If called from a thread other than the main one, doesn't
+		 * block: the plugins are loaded later in the main thread, so
+		 * only the already loaded ones see the entity. The Entity
+		 * metatype used for queueing is registered by Application.
+		 */
+		Q_INVOKABLE void ActivateLazyFor (const LeechCraft::Entity&);
 	private:
+		/** Returns the key identifying the given plugin in the profiler
+		 * records: the library path for plugins loaded from libraries,
+		 * or the unique ID otherwise.
+		 */
+		QString GetProfileKey (QObject*) const;
+
 		QStringList FindPluginsPaths () const;
 		void FindPlugins ();
 		void ScanPlugins (const QStringList&);
@@ -132,22 +168,45 @@ namespace LeechCraft
 		 */
 		void CheckPlugins ();
 
+		/** Filters out the plugins whose dependencies surely can't be
+		 * fulfilled according to the cached manifests, so that their
+		 * libraries aren't even loaded.
+		 */
+		void PruneUnfulfillable ();
+
+		/** Moves the plugins that may be loaded on demand according to
+		 * the cached manifests from PluginContainers_ to LazyPlugins_,
+		 * unless features they provide are needed by other plugins.
+		 */
+		void DeferLazyPlugins ();
+
 		/** Fills the Plugins_ list with all instances, both from "real"
 		 * plugins and from adaptors.
 		 */
 		void FillInstances ();
 
-		/** Tries to perform IInfo::Init() on all plugins. Returns the
-		 * list of plugins that failed.
+		/** Tries to perform IInfo::Init() on all plugins in dependency
+		 * order. The plugins depending on the failed ones are skipped.
+		 *
+		 * The leaf plugins implementing IThreadSafeInit are initialized
+		 * in the thread pool, concurrently with the rest. They are all
+		 * waited for before this function returns.
+		 *
+		 * Returns the list of plugins that failed.
 		 */
 		QList<QObject*> FirstInitAll ();
 
-		/** Tries to perform IInfo::Init() on plugins and returns the
-		 * first plugin that has failed to initialize. This function
-		 * stops initializing plugins upon first failure. If all plugins
-		 * were initialized successfully, this function returns NULL.
+		/** Returns whether IInfo::Init() of the given plugin may be
+		 * called in the thread pool: the plugin implements
+		 * IThreadSafeInit and no other plugin depends on it.
+		 */
+		bool IsConcurrentInit (QObject*) const;
+
+		/** Drops the cached list of loaded plugins and the entity
+		 * dispatch index built from it. Should be called whenever the
+		 * set of loaded plugins changes.
 		 */
-		QObject* TryFirstInit (QObjectList);
+		void InvalidatePluginsCache ();
 
 		/** Plainly tries to find a corresponding QPluginLoader and
 		 * unload the corresponding library.
@@ -31,6 +31,8 @@
 #include <QStyledItemDelegate>
 #include <QPushButton>
 #include <QSortFilterProxyModel>
+#include <QFileDialog>
+#include <QMessageBox>
 #include "util/gui/clearlineeditaddon.h"
 #include "interfaces/ihavesettings.h"
 #include "interfaces/iinfo.h"
@@ -39,6 +41,7 @@
 #include "coreinstanceobject.h"
 #include "settingstab.h"
 #include "coreproxy.h"
+#include "pluginmanager.h"
 
 namespace LeechCraft
 {
@@ -185,4 +188,20 @@ namespace LeechCraft
 	void PluginManagerDialog::reject ()
 	{
 	}
+
+	void PluginManagerDialog::on_ExportProfile__released ()
+	{
+		const auto& path = QFileDialog::getSaveFileName (this,
+				tr ("Export startup profile"),
+				QDir::homePath () + "/leechcraft-startup.json",
+				tr ("Chrome trace files (*.json)"));
+		if (path.isEmpty ())
+			return;
+
+		if (!Core::Instance ().GetPluginManager ()->GetProfiler ().ExportChromeTrace (path))
+			QMessageBox::critical (this,
+					"LeechCraft",
+					tr ("Unable to write the startup profile to %1.")
+						.arg (path));
+	}
 }
@@ -49,6 +49,8 @@ namespace LeechCraft
 
 		void accept ();
 		void reject ();
+	private slots:
+		void on_ExportProfile__released ();
 	};
 }
 
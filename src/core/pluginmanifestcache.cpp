@@ -0,0 +1,265 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#include "pluginmanifestcache.h"
+#include <memory>
+#include <QCoreApplication>
+#include <QSettings>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QtDebug>
+#include <util/util.h>
+#include <util/sll/prelude.h>
+#include "interfaces/iinfo.h"
+#include "interfaces/iplugin2.h"
+#include "interfaces/ipluginready.h"
+#include "interfaces/ipluginadaptor.h"
+#include "interfaces/ihavetabs.h"
+#include "interfaces/ihavesettings.h"
+#include "interfaces/ihaveshortcuts.h"
+#include "interfaces/ientityhandler.h"
+#include "interfaces/idownload.h"
+#include "interfaces/ilazyplugin.h"
+
+namespace LeechCraft
+{
+	namespace
+	{
+		template<typename T>
+		void CheckIface (QObject *obj, const QString& name, QStringList& result)
+		{
+			if (qobject_cast<T> (obj))
+				result << name;
+		}
+
+		QStringList GetInterfaces (QObject *obj)
+		{
+			QStringList result;
+			CheckIface<IPlugin2*> (obj, "IPlugin2", result);
+			CheckIface<IPluginReady*> (obj, "IPluginReady", result);
+			CheckIface<IPluginAdaptor*> (obj, "IPluginAdaptor", result);
+			CheckIface<IHaveTabs*> (obj, "IHaveTabs", result);
+			CheckIface<IHaveSettings*> (obj, "IHaveSettings", result);
+			CheckIface<IHaveShortcuts*> (obj, "IHaveShortcuts", result);
+			CheckIface<IEntityHandler*> (obj, "IEntityHandler", result);
+			CheckIface<IDownload*> (obj, "IDownload", result);
+			CheckIface<IEntityFilter*> (obj, "IEntityFilter", result);
+			CheckIface<ILazyPlugin*> (obj, "ILazyPlugin", result);
+			return result;
+		}
+
+		QList<TabClassManifest> GetTabClasses (QObject *obj)
+		{
+			QList<TabClassManifest> result;
+
+			const auto iht = qobject_cast<IHaveTabs*> (obj);
+			if (!iht)
+				return result;
+
+			for (const auto& info : iht->GetTabClasses ())
+				if (info.Features_ & TFOpenableByRequest)
+					result.append ({
+							info.TabClass_,
+							info.VisibleName_,
+							info.Description_,
+							static_cast<bool> (info.Features_ & TFSingle)
+						});
+			return result;
+		}
+
+		QVariantList SerializeTabClasses (const QList<TabClassManifest>& classes)
+		{
+			QVariantList result;
+			for (const auto& tc : classes)
+			{
+				QVariantMap map;
+				map ["Class"] = tc.TabClass_;
+				map ["Name"] = tc.VisibleName_;
+				map ["Description"] = tc.Description_;
+				map ["Single"] = tc.Single_;
+				result << map;
+			}
+			return result;
+		}
+
+		QList<TabClassManifest> DeserializeTabClasses (const QVariantList& list)
+		{
+			QList<TabClassManifest> result;
+			for (const auto& var : list)
+			{
+				const auto& map = var.toMap ();
+				result.append ({
+						map ["Class"].toByteArray (),
+						map ["Name"].toString (),
+						map ["Description"].toString (),
+						map ["Single"].toBool ()
+					});
+			}
+			return result;
+		}
+
+		QStringList ToStringList (const QSet<QByteArray>& set)
+		{
+			return Util::Map (set.toList (),
+					[] (const QByteArray& ba) { return QString::fromUtf8 (ba); });
+		}
+
+		QSet<QByteArray> FromStringList (const QStringList& list)
+		{
+			return QSet<QByteArray>::fromList (Util::Map (list,
+					[] (const QString& str) { return str.toUtf8 (); }));
+		}
+	}
+
+	boost::optional<PluginManifest> PluginManifestCache::Get (const QString& path) const
+	{
+		const auto pos = Cache_.find (path);
+		if (pos != Cache_.end ())
+			return *pos;
+
+		QSettings settings (QCoreApplication::organizationName (),
+				QCoreApplication::applicationName () + "-pg");
+		settings.beginGroup ("Plugins");
+		settings.beginGroup (path);
+		std::shared_ptr<void> groupGuard (nullptr,
+				[&settings] (void*)
+				{
+					settings.endGroup ();
+					settings.endGroup ();
+				});
+
+		const QFileInfo fi { path };
+		if (!settings.contains ("ManifestID") ||
+				settings.value ("ManifestMTime").toDateTime () != fi.lastModified () ||
+				settings.value ("ManifestSize").toLongLong () != fi.size () ||
+				settings.value ("ManifestLocale").toString () != GetLocale ())
+		{
+			Cache_ [path] = boost::none;
+			return {};
+		}
+
+		const PluginManifest manifest
+		{
+			settings.value ("ManifestID").toByteArray (),
+			settings.value ("Name").toString (),
+			settings.value ("Info").toString (),
+			settings.value ("ManifestAPILevel").toULongLong (),
+			settings.value ("ManifestProvides").toStringList (),
+			settings.value ("ManifestNeeds").toStringList (),
+			FromStringList (settings.value ("ManifestPluginClasses").toStringList ()),
+			FromStringList (settings.value ("ManifestExpectedPluginClasses").toStringList ()),
+			settings.value ("ManifestInterfaces").toStringList (),
+			settings.value ("ManifestLazy").toBool (),
+			{
+				settings.value ("ManifestEntityMimes").toStringList (),
+				settings.value ("ManifestEntitySchemes").toStringList (),
+				settings.value ("ManifestEntityKeys").toStringList ()
+			},
+			DeserializeTabClasses (settings.value ("ManifestTabClasses").toList ()),
+			settings.value ("ManifestInitialized").toBool ()
+		};
+		Cache_ [path] = manifest;
+		return manifest;
+	}
+
+	void PluginManifestCache::Store (const QString& path, QObject *instance, quint64 apiLevel, bool initialized)
+	{
+		const auto ii = qobject_cast<IInfo*> (instance);
+		if (!ii)
+			return;
+
+		const auto& existing = Get (path);
+		if (existing &&
+				existing->APILevel_ == apiLevel &&
+				(existing->Initialized_ || !initialized))
+			return;
+
+		PluginManifest manifest
+		{
+			ii->GetUniqueID (),
+			ii->GetName (),
+			ii->GetInfo (),
+			apiLevel,
+			ii->Provides (),
+			ii->Needs (),
+			{},
+			{},
+			GetInterfaces (instance),
+			false,
+			{},
+			GetTabClasses (instance),
+			initialized
+		};
+		if (const auto ip2 = qobject_cast<IPlugin2*> (instance))
+			manifest.PluginClasses_ = ip2->GetPluginClasses ();
+		if (const auto ipr = qobject_cast<IPluginReady*> (instance))
+			manifest.ExpectedPluginClasses_ = ipr->GetExpectedPluginClasses ();
+		if (const auto ilp = qobject_cast<ILazyPlugin*> (instance))
+			manifest.Lazy_ = ilp->IsLazy ();
+		if (const auto ief = qobject_cast<IEntityFilter*> (instance))
+			manifest.EntityFilter_ = ief->GetEntityFilter ();
+
+		QSettings settings (QCoreApplication::organizationName (),
+				QCoreApplication::applicationName () + "-pg");
+		settings.beginGroup ("Plugins");
+		settings.beginGroup (path);
+
+		const QFileInfo fi { path };
+		settings.setValue ("Name", manifest.Name_);
+		settings.setValue ("Info", manifest.Info_);
+		settings.setValue ("ManifestID", manifest.ID_);
+		settings.setValue ("ManifestMTime", fi.lastModified ());
+		settings.setValue ("ManifestSize", fi.size ());
+		settings.setValue ("ManifestLocale", GetLocale ());
+		settings.setValue ("ManifestAPILevel", manifest.APILevel_);
+		settings.setValue ("ManifestProvides", manifest.Provides_);
+		settings.setValue ("ManifestNeeds", manifest.Needs_);
+		settings.setValue ("ManifestPluginClasses", ToStringList (manifest.PluginClasses_));
+		settings.setValue ("ManifestExpectedPluginClasses", ToStringList (manifest.ExpectedPluginClasses_));
+		settings.setValue ("ManifestInterfaces", manifest.Interfaces_);
+		settings.setValue ("ManifestLazy", manifest.Lazy_);
+		settings.setValue ("ManifestEntityMimes", manifest.EntityFilter_.Mimes_);
+		settings.setValue ("ManifestEntitySchemes", manifest.EntityFilter_.UrlSchemes_);
+		settings.setValue ("ManifestEntityKeys", manifest.EntityFilter_.AdditionalKeys_);
+		settings.setValue ("ManifestTabClasses", SerializeTabClasses (manifest.TabClasses_));
+		settings.setValue ("ManifestInitialized", manifest.Initialized_);
+
+		settings.endGroup ();
+		settings.endGroup ();
+
+		Cache_ [path] = manifest;
+	}
+
+	const QString& PluginManifestCache::GetLocale () const
+	{
+		if (Locale_.isEmpty ())
+			Locale_ = Util::GetLocaleName ();
+		return Locale_;
+	}
+}
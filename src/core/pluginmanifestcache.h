@@ -0,0 +1,99 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <QStringList>
+#include <QSet>
+#include <QHash>
+#include "interfaces/ientityfilter.h"
+
+class QObject;
+
+namespace LeechCraft
+{
+	struct TabClassManifest
+	{
+		QByteArray TabClass_;
+		QString VisibleName_;
+		QString Description_;
+		bool Single_;
+	};
+
+	struct PluginManifest
+	{
+		QByteArray ID_;
+		QString Name_;
+		QString Info_;
+		quint64 APILevel_;
+
+		QStringList Provides_;
+		QStringList Needs_;
+
+		QSet<QByteArray> PluginClasses_;
+		QSet<QByteArray> ExpectedPluginClasses_;
+
+		QStringList Interfaces_;
+
+		bool Lazy_;
+		EntityFilter EntityFilter_;
+		QList<TabClassManifest> TabClasses_;
+
+		/* Whether the manifest was taken after IInfo::Init(), that is,
+		 * with the plugin's translations installed.
+		 */
+		bool Initialized_;
+	};
+
+	/** Caches the metadata of the plugin libraries so that it's
+	 * available without loading and instantiating the plugins.
+	 *
+	 * The manifests are stored along with the other per-library data
+	 * and are valid as long as the modification time and the size of
+	 * the library and the application locale don't change, since the
+	 * names and descriptions are translated.
+	 */
+	class PluginManifestCache
+	{
+		mutable QHash<QString, boost::optional<PluginManifest>> Cache_;
+		mutable QString Locale_;
+	public:
+		boost::optional<PluginManifest> Get (const QString& path) const;
+
+		/** Stores the manifest of the given instance unless a valid one
+		 * with the same API level is already stored. A manifest taken
+		 * before IInfo::Init() is replaced by the first one taken after
+		 * it, which has the translated strings.
+		 */
+		void Store (const QString& path, QObject *instance, quint64 apiLevel, bool initialized);
+	private:
+		const QString& GetLocale () const;
+	};
+}
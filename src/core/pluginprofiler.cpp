@@ -0,0 +1,187 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#include "pluginprofiler.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QThread>
+#include <QtDebug>
+
+#ifdef Q_OS_LINUX
+#include <malloc.h>
+#endif
+
+namespace LeechCraft
+{
+	namespace
+	{
+		qint64 GetHeapSize ()
+		{
+#ifdef __GLIBC__
+#if __GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33)
+			const auto& info = mallinfo2 ();
+#else
+			const auto& info = mallinfo ();
+#endif
+			return static_cast<qint64> (info.uordblks) + static_cast<qint64> (info.hblkhd);
+#else
+			return 0;
+#endif
+		}
+
+		QByteArray EscapeJson (const QString& str)
+		{
+			QByteArray result;
+			for (const auto c : str.toUtf8 ())
+				switch (c)
+				{
+				case '"':
+					result += "\\\"";
+					break;
+				case '\\':
+					result += "\\\\";
+					break;
+				default:
+					if (static_cast<uchar> (c) < 0x20)
+						result += "\\u00" + QByteArray::number (static_cast<uchar> (c), 16).rightJustified (2, '0');
+					else
+						result += c;
+					break;
+				}
+			return result;
+		}
+	}
+
+	PluginProfiler::PluginProfiler ()
+	{
+		Timer_.start ();
+	}
+
+	Util::DefaultScopeGuard PluginProfiler::Measure (const QString& plugin, Stage stage)
+	{
+		const auto start = Timer_.nsecsElapsed () / 1000;
+		const auto heap = GetHeapSize ();
+		return Util::MakeScopeGuard ([this, plugin, stage, start, heap]
+				{
+					AddRecord ({
+							plugin,
+							stage,
+							start,
+							Timer_.nsecsElapsed () / 1000 - start,
+							GetHeapSize () - heap,
+							0
+						});
+				});
+	}
+
+	QList<PluginProfiler::Record> PluginProfiler::GetRecords () const
+	{
+		QMutexLocker locker { &Lock_ };
+		return Records_;
+	}
+
+	QList<PluginProfiler::Record> PluginProfiler::GetRecords (const QString& plugin) const
+	{
+		QList<Record> result;
+
+		QMutexLocker locker { &Lock_ };
+		for (const auto& record : Records_)
+			if (record.Plugin_ == plugin)
+				result << record;
+		return result;
+	}
+
+	bool PluginProfiler::ExportChromeTrace (const QString& filename) const
+	{
+		QFile file { filename };
+		if (!file.open (QIODevice::WriteOnly))
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to open"
+					<< filename
+					<< file.errorString ();
+			return false;
+		}
+
+		QByteArray events;
+		for (const auto& record : GetRecords ())
+		{
+			if (!events.isEmpty ())
+				events += ",\n";
+
+			const auto& name = QFileInfo { record.Plugin_ }.baseName ();
+			events += "{\"name\":\"" + EscapeJson (name) + "\","
+					"\"cat\":\"" + EscapeJson (GetStageName (record.Stage_)) + "\","
+					"\"ph\":\"X\","
+					"\"ts\":" + QByteArray::number (record.StartUsecs_) + ","
+					"\"dur\":" + QByteArray::number (record.DurationUsecs_) + ","
+					"\"pid\":1,"
+					"\"tid\":" + QByteArray::number (record.Thread_) + ","
+					"\"args\":{\"plugin\":\"" + EscapeJson (record.Plugin_) + "\","
+					"\"heapDelta\":" + QByteArray::number (record.HeapDelta_) + "}}";
+		}
+
+		file.write ("{\"traceEvents\":[\n" + events + "\n]}\n");
+		return true;
+	}
+
+	void PluginProfiler::AddRecord (Record record)
+	{
+		const auto thread = QThread::currentThreadId ();
+
+		QMutexLocker locker { &Lock_ };
+		if (!Threads_.contains (thread))
+		{
+			const auto idx = Threads_.size ();
+			Threads_ [thread] = idx;
+		}
+		record.Thread_ = Threads_ [thread];
+
+		Records_ << record;
+	}
+
+	QString GetStageName (PluginProfiler::Stage stage)
+	{
+		switch (stage)
+		{
+		case PluginProfiler::Stage::Load:
+			return "load";
+		case PluginProfiler::Stage::Instance:
+			return "instance";
+		case PluginProfiler::Stage::Init:
+			return "init";
+		case PluginProfiler::Stage::SecondInit:
+			return "secondInit";
+		case PluginProfiler::Stage::Release:
+			return "release";
+		}
+
+		return {};
+	}
+}
@@ -0,0 +1,96 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <util/sll/util.h>
+
+namespace LeechCraft
+{
+	/** Records how much time and memory each plugin takes during its
+	 * loading, initialization and release stages.
+	 *
+	 * The profiler is thread-safe, so stages that are run concurrently
+	 * may be measured as well. Heap growth is only available with glibc
+	 * and includes allocations made by other threads during the stage.
+	 */
+	class PluginProfiler
+	{
+	public:
+		enum class Stage
+		{
+			Load,
+			Instance,
+			Init,
+			SecondInit,
+			Release
+		};
+
+		struct Record
+		{
+			QString Plugin_;
+			Stage Stage_;
+
+			qint64 StartUsecs_;
+			qint64 DurationUsecs_;
+			qint64 HeapDelta_;
+
+			int Thread_;
+		};
+	private:
+		QElapsedTimer Timer_;
+
+		mutable QMutex Lock_;
+		QList<Record> Records_;
+		QHash<Qt::HANDLE, int> Threads_;
+	public:
+		PluginProfiler ();
+
+		/** Starts measuring the given stage of the given plugin. The
+		 * measurement is recorded when the returned guard is destroyed.
+		 */
+		Util::DefaultScopeGuard Measure (const QString& plugin, Stage stage);
+
+		QList<Record> GetRecords () const;
+		QList<Record> GetRecords (const QString& plugin) const;
+
+		/** Writes the records to the given file in the Chrome trace
+		 * event format, suitable for chrome://tracing.
+		 */
+		bool ExportChromeTrace (const QString& filename) const;
+	private:
+		void AddRecord (Record);
+	};
+
+	QString GetStageName (PluginProfiler::Stage);
+}
@@ -67,6 +67,8 @@ namespace LeechCraft
 			throw std::runtime_error ("VertexInfo creation failed.");
 		}
 
+		Name_ = info->GetName ();
+
 		AllFeatureDeps_ = QSet<QString>::fromList (info->Needs ());
 		UnfulfilledFeatureDeps_ = AllFeatureDeps_;
 		FeatureProvides_ = QSet<QString>::fromList (info->Provides ());
@@ -90,11 +92,26 @@ namespace LeechCraft
 	void PluginTreeBuilder::AddObjects (const QObjectList& objs)
 	{
 		Instances_ << objs;
+
+		for (const auto object : objs)
+			try
+			{
+				Infos_ [object] = VertexInfo (object);
+			}
+			catch (const std::exception& e)
+			{
+				qWarning () << Q_FUNC_INFO
+						<< e.what ()
+						<< "for"
+						<< object
+						<< "; skipping";
+			}
 	}
 
 	void PluginTreeBuilder::RemoveObject (QObject *obj)
 	{
 		Instances_.removeAll (obj);
+		Infos_.remove (obj);
 	}
 
 	template<typename Edge>
@@ -141,7 +158,7 @@ namespace LeechCraft
 			G_ [u].IsFulfilled_ = G_ [u].UnfulfilledFeatureDeps_.isEmpty () &&
 					G_ [u].UnfulfilledP2PDeps_.isEmpty ();
 			if (!G_ [u].IsFulfilled_)
-				qWarning () << qobject_cast<IInfo*> (G_ [u].Object_)->GetName ()
+				qWarning () << G_ [u].Name_
 						<< "failed to initialize because of:"
 						<< G_ [u].UnfulfilledFeatureDeps_
 						<< G_ [u].UnfulfilledP2PDeps_;
@@ -182,6 +199,7 @@ namespace LeechCraft
 		Graph_.clear ();
 		Object2Vertex_.clear ();
 		Result_.clear ();
+		Required_.clear ();
 
 		CreateGraph ();
 		const auto& edge2vert = MakeEdges ();
@@ -212,6 +230,12 @@ namespace LeechCraft
 		boost::topological_sort (fulfilledSubgraph, std::back_inserter (vertices));
 		for (const auto& vertex : vertices)
 			Result_ << fulfilledSubgraph [vertex].Object_;
+
+		for (const auto& pair : edge2vert)
+			if (pair.first != pair.second &&
+					Graph_ [pair.first].IsFulfilled_ &&
+					Graph_ [pair.second].IsFulfilled_)
+				Required_ << Graph_ [pair.second].Object_;
 	}
 
 	QObjectList PluginTreeBuilder::GetResult () const
@@ -219,26 +243,21 @@ namespace LeechCraft
 		return Result_;
 	}
 
+	bool PluginTreeBuilder::HasDependents (QObject *obj) const
+	{
+		return Required_.contains (obj);
+	}
+
 	void PluginTreeBuilder::CreateGraph ()
 	{
 		for (const auto object : Instances_)
 		{
-			try
-			{
-				VertexInfo vi (object);
-				Vertex_t objVertex = boost::add_vertex (Graph_);
-				Graph_ [objVertex] = vi;
-				Object2Vertex_ [object] = objVertex;
-			}
-			catch (const std::exception& e)
-			{
-				qWarning () << Q_FUNC_INFO
-						<< e.what ()
-						<< "for"
-						<< object
-						<< "; skipping";
+			if (!Infos_.contains (object))
 				continue;
-			}
+
+			Vertex_t objVertex = boost::add_vertex (Graph_);
+			Graph_ [objVertex] = Infos_ [object];
+			Object2Vertex_ [object] = objVertex;
 		}
 	}
 
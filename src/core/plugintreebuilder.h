@@ -62,6 +62,7 @@ namespace LeechCraft
 			QSet<QByteArray> P2PProvides_;
 
 			QObject *Object_;
+			QString Name_;
 
 			VertexInfo ();
 			VertexInfo (QObject*);
@@ -78,8 +79,15 @@ namespace LeechCraft
 
 		Graph_t Graph_;
 
+		/* The infos are queried from the objects once, when they are
+		 * added, so that Calculate() doesn't call into plugins which may
+		 * be initializing in other threads at the moment.
+		 */
+		QHash<QObject*, VertexInfo> Infos_;
+
 		QHash<QObject*, Vertex_t> Object2Vertex_;
 		QObjectList Result_;
+		QSet<QObject*> Required_;
 	public:
 		PluginTreeBuilder ();
 
@@ -87,6 +95,11 @@ namespace LeechCraft
 		void RemoveObject (QObject*);
 		void Calculate ();
 		QObjectList GetResult () const;
+
+		/** Returns whether any other object from the result depends on
+		 * the given one.
+		 */
+		bool HasDependents (QObject*) const;
 	private:
 		void CreateGraph ();
 		QMap<Edge_t, QPair<Vertex_t, Vertex_t>> MakeEdges ();
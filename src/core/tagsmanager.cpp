@@ -31,6 +31,7 @@
 #include <stdexcept>
 #include <algorithm>
 #include <QStringList>
+#include <QSet>
 #include <QSettings>
 #include <QCoreApplication>
 #include <QtDebug>
@@ -92,13 +93,33 @@ int TagsManager::rowCount (const QModelIndex& index) const
 
 ITagsManager::tag_id TagsManager::GetID (const QString& tag)
 {
-	const auto& keys = Tags_.keys (tag);
-	if (keys.isEmpty ())
-		return InsertTag (tag);
-	else if (keys.size () > 1)
+	const auto count = ReverseTags_.count (tag);
+	if (!count)
+		return InsertTags ({ tag }).value (0);
+	else if (count > 1)
 		throw std::runtime_error (qPrintable (QString ("More than one key for %1").arg (tag)));
 	else
-		return keys.at (0).toString ();
+		return ReverseTags_.value (tag).toString ();
+}
+
+QList<ITagsManager::tag_id> TagsManager::GetIDs (const QStringList& tags)
+{
+	QStringList newTags;
+	QSet<QString> newTagsSet;
+	for (const auto& tag : tags)
+		if (!ReverseTags_.contains (tag) && !newTagsSet.contains (tag))
+		{
+			newTags << tag;
+			newTagsSet << tag;
+		}
+
+	if (!newTags.isEmpty ())
+		InsertTags (newTags);
+
+	QList<tag_id> result;
+	for (const auto& tag : tags)
+		result << GetID (tag);
+	return result;
 }
 
 QString TagsManager::GetTag (ITagsManager::tag_id id) const
@@ -106,6 +127,14 @@ QString TagsManager::GetTag (ITagsManager::tag_id id) const
 	return Tags_ [id];
 }
 
+QStringList TagsManager::GetTags (const QList<ITagsManager::tag_id>& ids) const
+{
+	QStringList result;
+	for (const auto& id : ids)
+		result << GetTag (id);
+	return result;
+}
+
 QStringList TagsManager::GetAllTags () const
 {
 	return Tags_.values ();
@@ -122,11 +151,10 @@ QStringList TagsManager::Split (const QString& string) const
 
 QStringList TagsManager::SplitToIDs (const QString& string)
 {
-	const auto& tags = Split (string);
-	QStringList result;
-	std::transform (tags.begin (), tags.end (), std::back_inserter (result),
-			[this] (const QString& tag) { return GetID (tag.simplified ()); });
-	return result;
+	QStringList tags;
+	for (const auto& tag : Split (string))
+		tags << tag.simplified ();
+	return GetIDs (tags);
 }
 
 QString TagsManager::Join (const QStringList& tags) const
@@ -142,15 +170,38 @@ QString TagsManager::JoinIDs (const QStringList& tagIDs) const
 	return Join (hr);
 }
 
-ITagsManager::tag_id TagsManager::InsertTag (const QString& tag)
+QList<ITagsManager::tag_id> TagsManager::InsertTags (const QStringList& tags)
 {
-	beginInsertRows (QModelIndex (), Tags_.size (), Tags_.size ());
-	QUuid uuid = QUuid::createUuid ();
-	Tags_ [uuid] = tag;
-	endInsertRows ();
-	WriteSettings ();
+	QList<QUuid> uuids;
+	for (int i = 0; i < tags.size (); ++i)
+		uuids << QUuid::createUuid ();
+
+	if (uuids.size () == 1)
+	{
+		const auto row = std::distance (Tags_.begin (), Tags_.lowerBound (uuids.at (0)));
+		beginInsertRows (QModelIndex (), row, row);
+	}
+	else
+		beginResetModel ();
+
+	for (int i = 0; i < tags.size (); ++i)
+	{
+		Tags_ [uuids.at (i)] = tags.at (i);
+		ReverseTags_.insert (tags.at (i), uuids.at (i));
+	}
+
+	if (uuids.size () == 1)
+		endInsertRows ();
+	else
+		endResetModel ();
+
+	WriteTags (uuids);
 	emit tagsUpdated (GetAllTags ());
-	return uuid.toString ();
+
+	QList<tag_id> result;
+	for (const auto& uuid : uuids)
+		result << uuid.toString ();
+	return result;
 }
 
 void TagsManager::RemoveTag (const QModelIndex& index)
@@ -160,10 +211,12 @@ void TagsManager::RemoveTag (const QModelIndex& index)
 
 	TagsDictionary_t::iterator pos = Tags_.begin ();
 	std::advance (pos, index.row ());
+	const auto uuid = pos.key ();
 	beginRemoveRows (QModelIndex (), index.row (), index.row ());
+	ReverseTags_.remove (pos.value (), uuid);
 	Tags_.erase (pos);
 	endRemoveRows ();
-	WriteSettings ();
+	RemoveTagSetting (uuid);
 	emit tagsUpdated (GetAllTags ());
 }
 
@@ -174,11 +227,13 @@ void TagsManager::SetTag (const QModelIndex& index, const QString& newTag)
 
 	TagsDictionary_t::iterator pos = Tags_.begin ();
 	std::advance (pos, index.row ());
+	ReverseTags_.remove (*pos, pos.key ());
+	ReverseTags_.insert (newTag, pos.key ());
 	*pos = newTag;
 
 	emit dataChanged (index, index);
 
-	WriteSettings ();
+	WriteTags ({ pos.key () });
 
 	emit tagsUpdated (GetAllTags ());
 }
@@ -198,21 +253,57 @@ void TagsManager::ReadSettings ()
 	QSettings settings (QCoreApplication::organizationName (),
 			QCoreApplication::applicationName ());
 	settings.beginGroup ("Tags");
-	Tags_ = settings.value ("Dict").value<TagsDictionary_t> ();
+
+	// Migrate from the older format storing the whole dictionary as a single value.
+	const bool isOldFormat = settings.contains ("Dict");
+	if (isOldFormat)
+	{
+		Tags_ = settings.value ("Dict").value<TagsDictionary_t> ();
+		settings.remove ("Dict");
+	}
+	else
+	{
+		settings.beginGroup ("Entries");
+		for (const auto& key : settings.childKeys ())
+			Tags_ [QUuid (key)] = settings.value (key).toString ();
+		settings.endGroup ();
+	}
+
+	settings.endGroup ();
+
+	for (auto i = Tags_.begin (), end = Tags_.end (); i != end; ++i)
+		ReverseTags_.insert (i.value (), i.key ());
+
+	if (isOldFormat)
+		WriteTags (Tags_.keys ());
+
 	if (!Tags_.isEmpty ())
 	{
 		beginInsertRows (QModelIndex (), 0, Tags_.size () - 1);
 		endInsertRows ();
 	}
+}
+
+void TagsManager::WriteTags (const QList<QUuid>& uuids) const
+{
+	QSettings settings (QCoreApplication::organizationName (),
+			QCoreApplication::applicationName ());
+	settings.beginGroup ("Tags");
+	settings.beginGroup ("Entries");
+	for (const auto& uuid : uuids)
+		settings.setValue (uuid.toString (), Tags_ [uuid]);
+	settings.endGroup ();
 	settings.endGroup ();
 }
 
-void TagsManager::WriteSettings () const
+void TagsManager::RemoveTagSetting (const QUuid& uuid) const
 {
 	QSettings settings (QCoreApplication::organizationName (),
 			QCoreApplication::applicationName ());
 	settings.beginGroup ("Tags");
-	settings.setValue ("Dict", QVariant::fromValue<TagsDictionary_t> (Tags_));
+	settings.beginGroup ("Entries");
+	settings.remove (uuid.toString ());
+	settings.endGroup ();
 	settings.endGroup ();
 }
 
@@ -31,6 +31,7 @@
 #define TAGSMANAGER_H
 #include <QAbstractItemModel>
 #include <QMap>
+#include <QMultiHash>
 #include <QUuid>
 #include <QString>
 #include <QMetaType>
@@ -49,6 +50,7 @@ namespace LeechCraft
 		typedef QMap<QUuid, QString> TagsDictionary_t;
 	private:
 		TagsDictionary_t Tags_;
+		QMultiHash<QString, QUuid> ReverseTags_;
 	public:
 		static TagsManager& Instance ();
 		virtual ~TagsManager ();
@@ -60,7 +62,9 @@ namespace LeechCraft
 		int rowCount (const QModelIndex&) const;
 
 		tag_id GetID (const QString&);
+		QList<tag_id> GetIDs (const QStringList&);
 		QString GetTag (tag_id) const;
+		QStringList GetTags (const QList<tag_id>&) const;
 		QStringList GetAllTags () const;
 		QStringList Split (const QString&) const;
 		QStringList SplitToIDs (const QString&);
@@ -72,9 +76,10 @@ namespace LeechCraft
 		void RemoveTag (const QModelIndex&);
 		void SetTag (const QModelIndex&, const QString&);
 	private:
-		tag_id InsertTag (const QString&);
+		QList<tag_id> InsertTags (const QStringList&);
 		void ReadSettings ();
-		void WriteSettings () const;
+		void WriteTags (const QList<QUuid>&) const;
+		void RemoveTagSetting (const QUuid&) const;
 	signals:
 		void tagsUpdated (const QStringList&);
 	};
@@ -0,0 +1,185 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#include "entityfilterindextest.h"
+#include <QtTest>
+#include <QUrl>
+#include <interfaces/structures.h>
+#include "entityfilterindex.h"
+
+QTEST_MAIN (LeechCraft::EntityFilterIndexTest)
+
+namespace LeechCraft
+{
+	FilteredPlugin::FilteredPlugin (const EntityFilter& filter, QObject *parent)
+	: QObject { parent }
+	, Filter_ (filter)
+	{
+	}
+
+	EntityFilter FilteredPlugin::GetEntityFilter () const
+	{
+		return Filter_;
+	}
+
+	namespace
+	{
+		Entity MakeEntity (const QVariant& entity, const QString& mime,
+				const QVariantMap& additional = {})
+		{
+			Entity e;
+			e.Entity_ = entity;
+			e.Mime_ = mime;
+			e.Additional_ = additional;
+			return e;
+		}
+
+		EntityFilter MakeNotificationFilter ()
+		{
+			EntityFilter filter;
+			filter.Mimes_ << "x-leechcraft/notification"
+					<< "x-leechcraft/notification-rule-create";
+			return filter;
+		}
+	}
+
+	void EntityFilterIndexTest::testNoFilters ()
+	{
+		QObject first, second;
+		const QObjectList plugins { &first, &second };
+
+		EntityFilterIndex index;
+		index.Rebuild (plugins);
+
+		const auto& e = MakeEntity ("text", "x-leechcraft/notification");
+		QCOMPARE (index.FilterCandidates (e, plugins), plugins);
+	}
+
+	void EntityFilterIndexTest::testUnfilteredKept ()
+	{
+		QObject plain;
+		FilteredPlugin filtered { MakeNotificationFilter () };
+		const QObjectList plugins { &plain, &filtered };
+
+		EntityFilterIndex index;
+		index.Rebuild (plugins);
+
+		const auto& e = MakeEntity (QUrl { "http://example.com" }, {});
+		QCOMPARE (index.FilterCandidates (e, plugins), QObjectList { &plain });
+	}
+
+	void EntityFilterIndexTest::testMime ()
+	{
+		FilteredPlugin filtered { MakeNotificationFilter () };
+		const QObjectList plugins { &filtered };
+
+		EntityFilterIndex index;
+		index.Rebuild (plugins);
+
+		QCOMPARE (index.FilterCandidates (MakeEntity ({}, "x-leechcraft/notification"), plugins), plugins);
+		QCOMPARE (index.FilterCandidates (MakeEntity ({}, "x-leechcraft/notification-rule-create"), plugins), plugins);
+		QCOMPARE (index.FilterCandidates (MakeEntity ({}, "x-leechcraft/power-state-changed"), plugins), QObjectList {});
+	}
+
+	void EntityFilterIndexTest::testMimeWildcard ()
+	{
+		EntityFilter filter;
+		filter.Mimes_ << "image/*";
+		FilteredPlugin filtered { filter };
+		const QObjectList plugins { &filtered };
+
+		EntityFilterIndex index;
+		index.Rebuild (plugins);
+
+		QCOMPARE (index.FilterCandidates (MakeEntity ({}, "image/png"), plugins), plugins);
+		QCOMPARE (index.FilterCandidates (MakeEntity ({}, "text/plain"), plugins), QObjectList {});
+	}
+
+	void EntityFilterIndexTest::testUrlScheme ()
+	{
+		EntityFilter filter;
+		filter.UrlSchemes_ << "magnet";
+		FilteredPlugin filtered { filter };
+		const QObjectList plugins { &filtered };
+
+		EntityFilterIndex index;
+		index.Rebuild (plugins);
+
+		QCOMPARE (index.FilterCandidates (MakeEntity (QUrl { "magnet:?xt=urn:btih:abc" }, {}), plugins), plugins);
+		QCOMPARE (index.FilterCandidates (MakeEntity (QUrl { "http://example.com" }, {}), plugins), QObjectList {});
+		QCOMPARE (index.FilterCandidates (MakeEntity ("magnet:?xt=urn:btih:abc", {}), plugins), QObjectList {});
+	}
+
+	void EntityFilterIndexTest::testAdditionalKey ()
+	{
+		EntityFilter filter;
+		filter.AdditionalKeys_ << "org.LC.Plugins.Azoth.SourceID";
+		FilteredPlugin filtered { filter };
+		const QObjectList plugins { &filtered };
+
+		EntityFilterIndex index;
+		index.Rebuild (plugins);
+
+		const QVariantMap additional { { "org.LC.Plugins.Azoth.SourceID", "src" } };
+		QCOMPARE (index.FilterCandidates (MakeEntity ({}, "x-leechcraft/other", additional), plugins), plugins);
+		QCOMPARE (index.FilterCandidates (MakeEntity ({}, "x-leechcraft/other"), plugins), QObjectList {});
+	}
+
+	void EntityFilterIndexTest::testOrderPreserved ()
+	{
+		QObject plain;
+		FilteredPlugin first { MakeNotificationFilter () };
+		FilteredPlugin second { MakeNotificationFilter () };
+		const QObjectList plugins { &second, &plain, &first };
+
+		EntityFilterIndex index;
+		index.Rebuild (plugins);
+
+		const auto& e = MakeEntity ({}, "x-leechcraft/notification");
+		QCOMPARE (index.FilterCandidates (e, plugins), plugins);
+
+		const QObjectList reordered { &first, &second };
+		QCOMPARE (index.FilterCandidates (e, reordered), reordered);
+	}
+
+	void EntityFilterIndexTest::testMatchesEntityFilter ()
+	{
+		EntityFilter filter = MakeNotificationFilter ();
+		filter.Mimes_ << "image/*";
+		filter.UrlSchemes_ << "magnet";
+		filter.AdditionalKeys_ << "Key";
+
+		QVERIFY (MatchesEntityFilter (filter, MakeEntity ({}, "x-leechcraft/notification")));
+		QVERIFY (MatchesEntityFilter (filter, MakeEntity ({}, "image/jpeg")));
+		QVERIFY (MatchesEntityFilter (filter, MakeEntity (QUrl { "magnet:?xt=urn:btih:abc" }, {})));
+		const QVariantMap additional { { "Key", 1 } };
+		QVERIFY (MatchesEntityFilter (filter, MakeEntity ({}, {}, additional)));
+		QVERIFY (!MatchesEntityFilter (filter, MakeEntity (QUrl { "http://example.com" }, "text/html")));
+	}
+}
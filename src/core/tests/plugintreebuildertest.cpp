@@ -0,0 +1,162 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+
+#include "plugintreebuildertest.h"
+#include <QtTest>
+#include <QIcon>
+#include "plugintreebuilder.h"
+
+QTEST_MAIN (LeechCraft::PluginTreeBuilderTest)
+
+namespace LeechCraft
+{
+	TreePlugin::TreePlugin (const QByteArray& id,
+			const QStringList& needs, const QStringList& provides)
+	: ID_ (id)
+	, Needs_ (needs)
+	, Provides_ (provides)
+	{
+	}
+
+	void TreePlugin::Init (ICoreProxy_ptr)
+	{
+	}
+
+	void TreePlugin::SecondInit ()
+	{
+	}
+
+	QByteArray TreePlugin::GetUniqueID () const
+	{
+		return ID_;
+	}
+
+	QString TreePlugin::GetName () const
+	{
+		return QString::fromLatin1 (ID_);
+	}
+
+	QString TreePlugin::GetInfo () const
+	{
+		return {};
+	}
+
+	QIcon TreePlugin::GetIcon () const
+	{
+		return {};
+	}
+
+	void TreePlugin::Release ()
+	{
+	}
+
+	QStringList TreePlugin::Needs () const
+	{
+		++NeedsCalls_;
+		return Needs_;
+	}
+
+	QStringList TreePlugin::Provides () const
+	{
+		return Provides_;
+	}
+
+	void PluginTreeBuilderTest::testDependencyOrder ()
+	{
+		TreePlugin consumer { "consumer", { "feature" }, {} };
+		TreePlugin provider { "provider", {}, { "feature" } };
+
+		PluginTreeBuilder builder;
+		builder.AddObjects ({ &consumer, &provider });
+		builder.Calculate ();
+
+		const auto& result = builder.GetResult ();
+		QCOMPARE (result.size (), 2);
+		QVERIFY (result.indexOf (&provider) < result.indexOf (&consumer));
+	}
+
+	void PluginTreeBuilderTest::testHasDependents ()
+	{
+		TreePlugin consumer { "consumer", { "feature" }, {} };
+		TreePlugin provider { "provider", {}, { "feature" } };
+		TreePlugin standalone { "standalone", {}, { "other" } };
+
+		PluginTreeBuilder builder;
+		builder.AddObjects ({ &consumer, &provider, &standalone });
+		builder.Calculate ();
+
+		QVERIFY (builder.HasDependents (&provider));
+		QVERIFY (!builder.HasDependents (&consumer));
+		QVERIFY (!builder.HasDependents (&standalone));
+	}
+
+	void PluginTreeBuilderTest::testUnfulfilledSkipped ()
+	{
+		TreePlugin consumer { "consumer", { "missing" }, {} };
+		TreePlugin standalone { "standalone", {}, {} };
+
+		PluginTreeBuilder builder;
+		builder.AddObjects ({ &consumer, &standalone });
+		builder.Calculate ();
+
+		const QObjectList expected { &standalone };
+		QCOMPARE (builder.GetResult (), expected);
+	}
+
+	void PluginTreeBuilderTest::testRemoveObject ()
+	{
+		TreePlugin consumer { "consumer", { "feature" }, {} };
+		TreePlugin provider { "provider", {}, { "feature" } };
+
+		PluginTreeBuilder builder;
+		builder.AddObjects ({ &consumer, &provider });
+		builder.Calculate ();
+
+		builder.RemoveObject (&provider);
+		builder.Calculate ();
+
+		QVERIFY (builder.GetResult ().isEmpty ());
+		QVERIFY (!builder.HasDependents (&provider));
+	}
+
+	void PluginTreeBuilderTest::testInfosQueriedOnce ()
+	{
+		TreePlugin consumer { "consumer", { "feature" }, {} };
+		TreePlugin provider { "provider", {}, { "feature" } };
+
+		PluginTreeBuilder builder;
+		builder.AddObjects ({ &consumer, &provider });
+		builder.Calculate ();
+		builder.Calculate ();
+
+		QCOMPARE (consumer.NeedsCalls_, 1);
+		QCOMPARE (provider.NeedsCalls_, 1);
+	}
+}
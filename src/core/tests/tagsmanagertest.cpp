@@ -0,0 +1,146 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#include "tagsmanagertest.h"
+#include <QtTest>
+#include <QSettings>
+#include "tagsmanager.h"
+
+QTEST_MAIN (LeechCraft::TagsManagerTest)
+
+namespace LeechCraft
+{
+	namespace
+	{
+		const int TagsCount = 10000;
+		const int LookupsCount = 100000;
+
+		QStringList GetBenchTags ()
+		{
+			QStringList result;
+			for (int i = 0; i < TagsCount; ++i)
+				result << QString ("benchtag%1").arg (i);
+			return result;
+		}
+
+		QStringList GetLookups ()
+		{
+			const auto& tags = GetBenchTags ();
+
+			QStringList result;
+			for (int i = 0; i < LookupsCount; ++i)
+				result << tags.at ((i * 7919) % TagsCount);
+			return result;
+		}
+	}
+
+	void TagsManagerTest::initTestCase ()
+	{
+		QCoreApplication::setOrganizationName ("LeechCraftTests");
+		QCoreApplication::setApplicationName ("TagsManagerTest");
+
+		QSettings settings;
+		settings.clear ();
+
+		TagsManager::Instance ().GetIDs (GetBenchTags ());
+	}
+
+	void TagsManagerTest::cleanupTestCase ()
+	{
+		QSettings settings;
+		settings.clear ();
+	}
+
+	void TagsManagerTest::testGetIDStable ()
+	{
+		auto& tm = TagsManager::Instance ();
+		const auto& id = tm.GetID ("stable");
+		QCOMPARE (tm.GetID ("stable"), id);
+		QCOMPARE (tm.GetTag (id), QString ("stable"));
+	}
+
+	void TagsManagerTest::testGetIDsRoundTrip ()
+	{
+		auto& tm = TagsManager::Instance ();
+		const QStringList tags { "first", "second", "benchtag42", "third" };
+		const auto& ids = tm.GetIDs (tags);
+		QCOMPARE (ids.size (), tags.size ());
+		QCOMPARE (tm.GetTags (ids), tags);
+		QCOMPARE (ids.at (2), tm.GetID ("benchtag42"));
+	}
+
+	void TagsManagerTest::testGetIDsDuplicates ()
+	{
+		auto& tm = TagsManager::Instance ();
+		const auto& ids = tm.GetIDs ({ "dup", "other", "dup" });
+		QCOMPARE (ids.at (0), ids.at (2));
+		QVERIFY (ids.at (0) != ids.at (1));
+		QCOMPARE (tm.GetAllTags ().count ("dup"), 1);
+	}
+
+	void TagsManagerTest::testSplitToIDs ()
+	{
+		auto& tm = TagsManager::Instance ();
+		const auto& ids = tm.SplitToIDs (" foo ;bar;; foo  ");
+		QCOMPARE (ids.size (), 3);
+		QCOMPARE (ids.at (0), ids.at (2));
+		QCOMPARE (tm.JoinIDs (ids), QString ("foo; bar; foo"));
+	}
+
+	void TagsManagerTest::benchmarkGetID ()
+	{
+		auto& tm = TagsManager::Instance ();
+		const auto& lookups = GetLookups ();
+		QBENCHMARK
+		{
+			for (const auto& tag : lookups)
+				tm.GetID (tag);
+		}
+	}
+
+	void TagsManagerTest::benchmarkGetIDs ()
+	{
+		auto& tm = TagsManager::Instance ();
+		const auto& lookups = GetLookups ();
+		QBENCHMARK
+		{
+			tm.GetIDs (lookups);
+		}
+	}
+
+	void TagsManagerTest::benchmarkGetTags ()
+	{
+		auto& tm = TagsManager::Instance ();
+		const auto& ids = tm.GetIDs (GetLookups ());
+		QBENCHMARK
+		{
+			tm.GetTags (ids);
+		}
+	}
+}
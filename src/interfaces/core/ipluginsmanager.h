@@ -44,7 +44,8 @@
  *
  * This object also has the following signals:
  * - pluginInjected(QObject*), which is emitted after a successful
- *   plugin injection.
+ *   plugin injection or after a plugin loaded on demand has been
+ *   initialized.
  */
 class Q_DECL_EXPORT IPluginsManager
 {
@@ -114,7 +115,8 @@ public:
 	/** @brief Returns plugin identified by its id.
 	 *
 	 * If there is no such plugin with the given id, this function
-	 * returns a null pointer.
+	 * returns a null pointer. If the plugin is loaded on demand (see
+	 * ILazyPlugin) and isn't loaded yet, it is loaded and initialized.
 	 *
 	 * @param[in] id The ID of the plugin.
 	 * @return The plugin instance or null if no such plugin exists.
@@ -62,21 +62,16 @@ public:
 
 	/** @brief Returns the IDs of the given \em tags.
 	 *
-	 * This convenience function invokes GetID() for each tag in \em tags
-	 * and returns the list of the corresponding tag IDs.
+	 * This function is equivalent to invoking GetID() for each tag in
+	 * \em tags, but all the missing tags are added at once, so this
+	 * function should be preferred when identifying lots of tags.
 	 *
 	 * @param[in] tags The tags that should be identified.
 	 * @return The IDs of the tags.
 	 *
 	 * @sa GetID()
 	 */
-	QList<tag_id> GetIDs (const QStringList& tags)
-	{
-		QList<tag_id> result;
-		for (const auto& tag : tags)
-			result << GetID (tag);
-		return result;
-	}
+	virtual QList<tag_id> GetIDs (const QStringList& tags) = 0;
 
 	/** @brief Returns the tag with the given \em id.
 	 *
@@ -94,21 +89,15 @@ public:
 
 	/** @brief Returns the tags with the given \em ids.
 	 *
-	 * This convenience function invokes GetTag() for each tag ID in
-	 * \em ids and returns the list of the corresponding tags.
+	 * This function is equivalent to invoking GetTag() for each tag ID
+	 * in \em ids.
 	 *
 	 * @param[in] ids The ids of the tags.
 	 * @return The tags corresponding to the \em ids.
 	 *
 	 * @sa GetTag()
 	 */
-	QStringList GetTags (const QList<tag_id>& ids)
-	{
-		QStringList result;
-		for (const auto& id : ids)
-			result << GetTag (id);
-		return result;
-	}
+	virtual QStringList GetTags (const QList<tag_id>& ids) const = 0;
 
 	/** @brief Returns all tags existing in LeechCraft now.
 	 *
@@ -0,0 +1,90 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#pragma once
+
+#include <QStringList>
+#include <QtPlugin>
+
+/** @brief Describes the entities a handler or downloader could handle.
+ *
+ * An entity matches the filter if any of the following is true:
+ * - its Entity::Mime_ is in the Mimes_ list,
+ * - it is a QUrl whose scheme is in the UrlSchemes_ list,
+ * - its Entity::Additional_ map contains any of the AdditionalKeys_.
+ *
+ * @sa IEntityFilter
+ */
+struct EntityFilter
+{
+	/** @brief The MIME types of the matching entities.
+	 *
+	 * Wildcards of the form <code>type/&#42;</code> are supported.
+	 */
+	QStringList Mimes_;
+
+	/** @brief The URL schemes of the matching entities.
+	 */
+	QStringList UrlSchemes_;
+
+	/** @brief The keys of Entity::Additional_ of the matching entities.
+	 */
+	QStringList AdditionalKeys_;
+};
+
+/** @brief Interface for entity handlers with a declarative filter.
+ *
+ * IEntityHandler::CouldHandle() and IDownload::CouldDownload() are
+ * called for each entity for each plugin implementing those. Plugins
+ * that are only interested in a small set of entities may implement
+ * this interface to describe that set, and the plugin's CouldHandle()
+ * and CouldDownload() methods won't be called for the entities not
+ * matching the returned filter.
+ *
+ * The filter is queried only once after the plugin has been loaded, so
+ * it must not change during the plugin's lifetime.
+ *
+ * @sa EntityFilter
+ * @sa IEntityHandler
+ * @sa IDownload
+ */
+class Q_DECL_EXPORT IEntityFilter
+{
+public:
+	virtual ~IEntityFilter () {}
+
+	/** @brief Returns the filter of the entities this plugin handles.
+	 *
+	 * @return The filter of the entities that may be passed to
+	 * CouldHandle() and CouldDownload().
+	 */
+	virtual EntityFilter GetEntityFilter () const = 0;
+};
+
+Q_DECLARE_INTERFACE (IEntityFilter, "org.Deviant.LeechCraft.IEntityFilter/1.0");
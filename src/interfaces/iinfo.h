@@ -359,7 +359,7 @@ public:
 
 Q_DECLARE_INTERFACE (IInfo, "org.Deviant.LeechCraft.IInfo/1.0");
 
-#define CURRENT_API_LEVEL 20
+#define CURRENT_API_LEVEL 21
 
 #if QT_VERSION < 0x050000
 #define LC_EXPORT_PLUGIN(name,file) Q_EXPORT_PLUGIN2(name, file) \
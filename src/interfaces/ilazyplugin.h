@@ -0,0 +1,68 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#pragma once
+
+#include <QtPlugin>
+
+/** @brief Interface for plugins that may be loaded on demand.
+ *
+ * If the plugin returns true from IsLazy(), it is recorded in the
+ * plugin's cached manifest, and during the next startups the plugin
+ * won't be loaded and initialized until it is actually needed, that
+ * is, until one of the following happens:
+ * - an entity matching the plugin's filter (see IEntityFilter) is
+ *   about to be handled,
+ * - the user requests to open a tab of one of the plugin's tab classes
+ *   (see IHaveTabs),
+ * - another plugin requests it by its ID or a feature it provides.
+ *
+ * Plugins implementing IPlugin2 or IPluginReady are always loaded
+ * during startup, as well as the plugins whose features are needed by
+ * the plugins loaded during startup.
+ *
+ * The manifest is updated each time the plugin is loaded, so the
+ * changes of the value returned by IsLazy() take effect on the next
+ * startup after that.
+ *
+ * @sa IEntityFilter
+ */
+class Q_DECL_EXPORT ILazyPlugin
+{
+public:
+	virtual ~ILazyPlugin () {}
+
+	/** @brief Returns whether the plugin may be loaded on demand.
+	 *
+	 * @return Whether the plugin may be loaded only when needed.
+	 */
+	virtual bool IsLazy () const = 0;
+};
+
+Q_DECLARE_INTERFACE (ILazyPlugin, "org.Deviant.LeechCraft.ILazyPlugin/1.0");
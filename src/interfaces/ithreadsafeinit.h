@@ -0,0 +1,76 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+
+#pragma once
+
+#include <QtPlugin>
+
+/** @brief Interface for plugins whose IInfo::Init() is thread-safe.
+ *
+ * By default, IInfo::Init() of all plugins is called sequentially in
+ * the main thread. A plugin implementing this interface and returning
+ * true from IsInitThreadSafe() may instead be initialized in the
+ * thread pool, concurrently with the rest of the plugins, which speeds
+ * up startup if its Init() does lots of I/O.
+ *
+ * This is only done for leaf plugins, that is, plugins no other plugin
+ * depends on via IInfo::Needs() or IPlugin2, so nothing may observe a
+ * partially initialized plugin. The concurrent Init() is started after
+ * all the plugins this one depends on are initialized, and all the
+ * concurrent Init() calls are finished before any IInfo::SecondInit()
+ * is called.
+ *
+ * Such Init() implementations must not touch the GUI, install
+ * translators or otherwise modify the application-wide state, and
+ * must not block on the main thread (for example, via
+ * Qt::BlockingQueuedConnection), since the main thread waits for them
+ * to finish. The QObjects created during Init() belong to the
+ * initializing thread, so they should be moved to the main thread via
+ * QObject::moveToThread() if they are to live there, and they can't be
+ * children of objects that are already living in the main thread,
+ * including the plugin instance itself. Whatever can't be done in a
+ * separate thread should be done in IInfo::SecondInit().
+ *
+ * IInfo::SecondInit() and IInfo::Release() are still called in the
+ * main thread.
+ */
+class Q_DECL_EXPORT IThreadSafeInit
+{
+public:
+	virtual ~IThreadSafeInit () {}
+
+	/** @brief Returns whether IInfo::Init() may run in a separate thread.
+	 *
+	 * @return Whether the IInfo::Init() of this plugin is thread-safe.
+	 */
+	virtual bool IsInitThreadSafe () const = 0;
+};
+
+Q_DECLARE_INTERFACE (IThreadSafeInit, "org.Deviant.LeechCraft.IThreadSafeInit/1.0");
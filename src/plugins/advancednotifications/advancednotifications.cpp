@@ -135,6 +135,14 @@ namespace AdvancedNotifications
 		GeneralHandler_->Handle (e);
 	}
 
+	EntityFilter Plugin::GetEntityFilter () const
+	{
+		EntityFilter filter;
+		filter.Mimes_ << "x-leechcraft/notification"
+				<< "x-leechcraft/notification-rule-create";
+		return filter;
+	}
+
 	Util::XmlSettingsDialog_ptr Plugin::GetSettingsDialog () const
 	{
 		return SettingsDialog_;
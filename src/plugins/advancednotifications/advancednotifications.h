@@ -34,6 +34,7 @@
 #include <QAction>
 #include <interfaces/iinfo.h>
 #include <interfaces/ientityhandler.h>
+#include <interfaces/ientityfilter.h>
 #include <interfaces/ihavesettings.h>
 #include <interfaces/iactionsexporter.h>
 #include <interfaces/iquarkcomponentprovider.h>
@@ -49,6 +50,7 @@ namespace AdvancedNotifications
 	class Plugin : public QObject
 				 , public IInfo
 				 , public IEntityHandler
+				 , public IEntityFilter
 				 , public IHaveSettings
 				 , public IActionsExporter
 				 , public IQuarkComponentProvider
@@ -58,6 +60,7 @@ namespace AdvancedNotifications
 		Q_OBJECT
 		Q_INTERFACES (IInfo
 				IEntityHandler
+				IEntityFilter
 				IHaveSettings
 				IActionsExporter
 				IQuarkComponentProvider
@@ -83,6 +86,8 @@ namespace AdvancedNotifications
 		EntityTestHandleResult CouldHandle (const Entity&) const;
 		void Handle (Entity);
 
+		EntityFilter GetEntityFilter () const;
+
 		Util::XmlSettingsDialog_ptr GetSettingsDialog () const;
 
 		QList<QAction*> GetActions (ActionsEmbedPlace) const;
@@ -37,6 +37,8 @@
 #include <interfaces/core/icoreproxy.h>
 #include <interfaces/core/iiconthememanager.h>
 #include "interfaces/azoth/iaccount.h"
+#include "interfaces/azoth/iclentry.h"
+#include "interfaces/azoth/imessage.h"
 #include "interfaces/azoth/imucjoinwidget.h"
 #include "interfaces/azoth/iprotocol.h"
 #include "interfaces/azoth/isupportbookmarks.h"
@@ -237,6 +239,9 @@ namespace Azoth
 
 		actions << Util::CreateSeparator (menu);
 
+		actions << AddMemoryUsageAction (menu, account);
+		actions << Util::CreateSeparator (menu);
+
 		if (auto managed = qobject_cast<IRegManagedAccount*> (account->GetQObject ()))
 			if (managed->SupportsFeature (IRegManagedAccount::Feature::UpdatePass))
 				actions << AccountUpdatePassword_;
@@ -293,6 +298,42 @@ namespace Azoth
 		return { MenuChangeStatus_->menuAction (), Util::CreateSeparator (menu) };
 	}
 
+	namespace
+	{
+		qint64 EstimateMessageSize (IMessage *msg)
+		{
+			// The message object itself with its private data, timestamps,
+			// variants and so on, plus the body.
+			const qint64 overhead = 512;
+			return overhead + msg->GetBody ().size () * sizeof (QChar);
+		}
+	}
+
+	QAction* AccountActionsManager::AddMemoryUsageAction (QMenu *menu, IAccount *account)
+	{
+		int count = 0;
+		qint64 size = 0;
+		for (const auto entryObj : account->GetCLEntries ())
+		{
+			const auto entry = qobject_cast<ICLEntry*> (entryObj);
+			if (!entry)
+				continue;
+
+			for (const auto msg : entry->GetAllMessages ())
+			{
+				++count;
+				size += EstimateMessageSize (msg);
+			}
+		}
+
+		const auto action = new QAction (tr ("Messages in memory: %1 (about %2)")
+					.arg (count)
+					.arg (Util::MakePrettySize (size)),
+				menu);
+		action->setEnabled (false);
+		return action;
+	}
+
 	QList<QAction*> AccountActionsManager::AddBMActions (QMenu *menu, QObject *accObj)
 	{
 		if (!qobject_cast<ISupportBookmarks*> (accObj))
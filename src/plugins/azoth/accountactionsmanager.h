@@ -84,6 +84,7 @@ namespace Azoth
 	private:
 		QList<QAction*> AddMenuChangeStatus (QMenu*);
 		QList<QAction*> AddBMActions (QMenu*, QObject*);
+		QAction* AddMemoryUsageAction (QMenu*, IAccount*);
 	private slots:
 		void handleChangeStatusRequested ();
 		void joinAccountConference ();
@@ -45,6 +45,7 @@
 #include <QDesktopWidget>
 #include <QMimeData>
 #include <QToolBar>
+#include <QSet>
 
 #if QT_VERSION >= 0x050000
 #include <QUrlQuery>
@@ -183,6 +184,8 @@ namespace Azoth
 	, TypeTimer_ (new QTimer (this))
 	, PreviousState_ (CPSNone)
 	, IsCurrent_ (false)
+	, IsThemeLoaded_ (false)
+	, IsScrollbackPending_ (false)
 	{
 		Ui_.setupUi (this);
 		Ui_.View_->installEventFilter (new ZoomEventFilter (Ui_.View_));
@@ -231,6 +234,10 @@ namespace Azoth
 				SIGNAL (chatWindowSearchRequested (QString)),
 				this,
 				SLOT (handleChatWindowSearch (QString)));
+		connect (Ui_.View_,
+				SIGNAL (scrolledPastTop ()),
+				this,
+				SLOT (handleViewScrolledPastTop ()));
 
 		TypeTimer_->setInterval (2000);
 		connect (TypeTimer_,
@@ -289,6 +296,9 @@ namespace Azoth
 
 	void ChatTab::PrepareTheme ()
 	{
+		PendingBackfill_.clear ();
+		ThemeLoadTimer_.start ();
+
 		QString data = Core::Instance ().GetSelectedChatTemplate (GetEntry<QObject> (),
 				Ui_.View_->page ()->mainFrame ());
 		if (data.isEmpty ())
@@ -771,14 +781,12 @@ namespace Azoth
 
 	void ChatTab::on_View__loadFinished (bool)
 	{
-		Q_FOREACH (IMessage *msg, HistoryMessages_)
-			AppendMessage (msg);
-
 		ICLEntry *e = GetEntry<ICLEntry> ();
 		if (!e)
 		{
 			qWarning () << Q_FUNC_INFO
 					<< "null entry";
+			RenderMessages (HistoryMessages_);
 			return;
 		}
 
@@ -793,8 +801,7 @@ namespace Azoth
 						{ return left->GetDateTime () < right->GetDateTime (); });
 		}
 
-		for (const auto msg : messages)
-			AppendMessage (msg);
+		RenderMessages (HistoryMessages_ + messages);
 
 		QFile scrollerJS (":/plugins/azoth/resources/scripts/scrollers.js");
 		if (!scrollerJS.open (QIODevice::ReadOnly))
@@ -809,6 +816,17 @@ namespace Azoth
 
 		emit hookThemeReloaded (Util::DefaultHookProxy_ptr (new Util::DefaultHookProxy),
 				this, Ui_.View_, GetEntry<QObject> ());
+
+		qDebug () << Q_FUNC_INFO
+				<< (IsThemeLoaded_ ? "theme reload" : "tab open")
+				<< "for"
+				<< EntryID_
+				<< "took"
+				<< ThemeLoadTimer_.elapsed ()
+				<< "ms;"
+				<< PendingBackfill_.size ()
+				<< "messages left to backfill";
+		IsThemeLoaded_ = true;
 	}
 
 #ifdef ENABLE_MEDIACALLS
@@ -900,6 +918,31 @@ namespace Azoth
 		RequestLogs (ScrollbackPos_);
 	}
 
+	void ChatTab::handleViewScrolledPastTop ()
+	{
+		if (IsScrollbackPending_ || !PendingBackfill_.isEmpty ())
+			return;
+
+		const auto entry = GetEntry<ICLEntry> ();
+		if (!entry)
+			return;
+
+		const auto limit = Core::Instance ().GetMessagesRetentionLimit (entry->GetQObject ());
+		const auto retained = entry->GetAllMessages ().size ();
+		if (!limit || retained < limit)
+			return;
+
+		IsScrollbackPending_ = true;
+		ScrollbackPos_ += 50;
+		qDeleteAll (HistoryMessages_);
+		HistoryMessages_.clear ();
+		qDeleteAll (CoreMessages_);
+		CoreMessages_.clear ();
+		DummyMsgManager::Instance ().ClearMessages (GetCLEntry ());
+		LastDateTime_ = QDateTime ();
+		RequestLogs (retained + ScrollbackPos_);
+	}
+
 	void ChatTab::handleRichTextToggled ()
 	{
 		PrepareTheme ();
@@ -1386,27 +1429,48 @@ namespace Azoth
 		SetChatPartState (CPSPaused);
 	}
 
+	namespace
+	{
+		typedef QPair<uint, QString> DateBodyKey_t;
+
+		/* Messages from the history are considered to be the same as
+		 * the ones the entry already has if they have the same
+		 * direction and body and differ in time by less than this.
+		 */
+		const int DuplicateTimeDelta = 5;
+
+		bool IsKnownMessage (const QMap<IMessage::Direction, QSet<DateBodyKey_t>>& known, IMessage *msg)
+		{
+			const auto pos = known.find (msg->GetDirection ());
+			if (pos == known.end ())
+				return false;
+
+			const auto time = msg->GetDateTime ().toTime_t ();
+			const auto& body = msg->GetBody ();
+			for (int delta = -DuplicateTimeDelta + 1; delta < DuplicateTimeDelta; ++delta)
+				if (pos->contains ({ time + delta, body }))
+					return true;
+			return false;
+		}
+	}
+
 	void ChatTab::handleGotLastMessages (QObject *entryObj, const QList<QObject*>& messages)
 	{
 		if (entryObj != GetEntry<QObject> ())
 			return;
 
-		const auto entry = GetEntry<ICLEntry> ();
-		auto rMsgs = entry->GetAllMessages ();
-		std::reverse (rMsgs.begin (), rMsgs.end ());
+		IsScrollbackPending_ = false;
+
+		QMap<IMessage::Direction, QSet<DateBodyKey_t>> known;
+		for (const auto tMsg : GetEntry<ICLEntry> ()->GetAllMessages ())
+			known [tMsg->GetDirection ()] << DateBodyKey_t { tMsg->GetDateTime ().toTime_t (), tMsg->GetBody () };
 
 		for (const auto msgObj : messages)
 		{
 			const auto msg = qobject_cast<IMessage*> (msgObj);
 			const auto& dt = msg->GetDateTime ();
 
-			if (std::any_of (rMsgs.begin (), rMsgs.end (),
-					[msg] (IMessage *tMsg)
-					{
-						return tMsg->GetDirection () == msg->GetDirection () &&
-								tMsg->GetBody () == msg->GetBody () &&
-								std::abs (tMsg->GetDateTime ().secsTo (msg->GetDateTime ())) < 5;
-					}))
+			if (IsKnownMessage (known, msg))
 				continue;
 
 			if (HistoryMessages_.isEmpty () ||
@@ -1861,9 +1925,119 @@ namespace Azoth
 		{
 			return dt.date () == msg->GetDateTime ().date ();
 		}
+
+		const int FirstScreenMessagesCount = 100;
+		const int BackfillChunkSize = 500;
 	}
 
 	void ChatTab::AppendMessage (IMessage *msg)
+	{
+		const bool isActiveChat = Core::Instance ()
+				.GetChatTabsManager ()->IsActiveChat (GetEntry<ICLEntry> ());
+
+		QList<ChatMsgBatchItem> batch;
+		PrepareMessage (msg, GetMessageFilterSettings (), isActiveChat, batch);
+		if (batch.isEmpty ())
+			return;
+
+		if (!Core::Instance ().AppendMessagesByTemplate (Ui_.View_->page ()->mainFrame (),
+				GetEntry<QObject> (), batch))
+			qWarning () << Q_FUNC_INFO
+					<< "unhandled append message :(";
+	}
+
+	void ChatTab::RenderMessages (const QList<IMessage*>& messages)
+	{
+		const bool isActiveChat = Core::Instance ()
+				.GetChatTabsManager ()->IsActiveChat (GetEntry<ICLEntry> ());
+		const auto& settings = GetMessageFilterSettings ();
+
+		QList<ChatMsgBatchItem> batch;
+		for (const auto msg : messages)
+			PrepareMessage (msg, settings, isActiveChat, batch);
+
+		const auto entryObj = GetEntry<QObject> ();
+
+		int firstScreenSize = batch.size ();
+		if (Core::Instance ().CanPrependMessages (entryObj))
+			firstScreenSize = std::min (firstScreenSize, FirstScreenMessagesCount);
+		const auto backfillSize = batch.size () - firstScreenSize;
+
+		if (!Core::Instance ().AppendMessagesByTemplate (Ui_.View_->page ()->mainFrame (),
+				entryObj, batch.mid (backfillSize)))
+			qWarning () << Q_FUNC_INFO
+					<< "unhandled append messages :(";
+
+		PendingBackfill_.clear ();
+		for (const auto& item : batch.mid (0, backfillSize))
+			PendingBackfill_.append ({ item.Message_, item.Info_ });
+
+		if (!PendingBackfill_.isEmpty ())
+			QTimer::singleShot (0,
+					this,
+					SLOT (backfillMessages ()));
+	}
+
+	void ChatTab::backfillMessages ()
+	{
+		if (PendingBackfill_.isEmpty ())
+			return;
+
+		const auto chunkStart = std::max (0, PendingBackfill_.size () - BackfillChunkSize);
+
+		QList<ChatMsgBatchItem> chunk;
+		for (auto i = PendingBackfill_.begin () + chunkStart; i != PendingBackfill_.end (); ++i)
+			if (i->first)
+				chunk.append ({ i->first, i->second });
+		PendingBackfill_.erase (PendingBackfill_.begin () + chunkStart, PendingBackfill_.end ());
+
+		const auto frame = Ui_.View_->page ()->mainFrame ();
+		const auto prevMax = frame->scrollBarMaximum (Qt::Vertical);
+		const auto prevValue = frame->scrollBarValue (Qt::Vertical);
+
+		if (!Core::Instance ().PrependMessagesByTemplate (frame, GetEntry<QObject> (), chunk))
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to backfill messages, dropping"
+					<< PendingBackfill_.size ();
+			PendingBackfill_.clear ();
+			return;
+		}
+
+		frame->setScrollBarValue (Qt::Vertical,
+				prevValue + frame->scrollBarMaximum (Qt::Vertical) - prevMax);
+
+		if (!PendingBackfill_.isEmpty ())
+		{
+			QTimer::singleShot (0,
+					this,
+					SLOT (backfillMessages ()));
+			return;
+		}
+
+		qDebug () << Q_FUNC_INFO
+				<< "backfill for"
+				<< EntryID_
+				<< "finished in"
+				<< ThemeLoadTimer_.elapsed ()
+				<< "ms since theme load";
+	}
+
+	ChatTab::MessageFilterSettings ChatTab::GetMessageFilterSettings () const
+	{
+		const auto& xsm = XmlSettingsManager::Instance ();
+		return
+		{
+			xsm.property ("ShowStatusChangesEvents").toBool (),
+			xsm.property ("ShowStatusChangesEventsInPrivates").toBool (),
+			xsm.property ("ShowJoinsLeaves").toBool (),
+			xsm.property ("ShowEndConversations").toBool (),
+			xsm.property ("SeparateMUCEventLogWindow").toBool ()
+		};
+	}
+
+	void ChatTab::PrepareMessage (IMessage *msg, const MessageFilterSettings& settings,
+			bool isActiveChat, QList<ChatMsgBatchItem>& batch)
 	{
 		ICLEntry *other = qobject_cast<ICLEntry*> (msg->OtherPart ());
 		if (!other && msg->OtherPart ())
@@ -1886,22 +2060,22 @@ namespace Azoth
 
 		if (msg->GetMessageSubType () == IMessage::SubType::ParticipantStatusChange &&
 				(!parent || parent->GetEntryType () == ICLEntry::EntryType::MUC) &&
-				!XmlSettingsManager::Instance ().property ("ShowStatusChangesEvents").toBool ())
+				!settings.ShowStatusChanges_)
 			return;
 
 		if (msg->GetMessageSubType () == IMessage::SubType::ParticipantStatusChange &&
 				(!parent || parent->GetEntryType () != ICLEntry::EntryType::MUC) &&
-				!XmlSettingsManager::Instance ().property ("ShowStatusChangesEventsInPrivates").toBool ())
+				!settings.ShowStatusChangesInPrivates_)
 			return;
 
 		if ((msg->GetMessageSubType () == IMessage::SubType::ParticipantJoin ||
 					msg->GetMessageSubType () == IMessage::SubType::ParticipantLeave) &&
-				!XmlSettingsManager::Instance ().property ("ShowJoinsLeaves").toBool ())
+				!settings.ShowJoinsLeaves_)
 			return;
 
 		if (msg->GetMessageSubType () == IMessage::SubType::ParticipantEndedConversation)
 		{
-			if (!XmlSettingsManager::Instance ().property ("ShowEndConversations").toBool ())
+			if (!settings.ShowEndConversations_)
 				return;
 			else if (other)
 				msg->SetBody (tr ("%1 ended the conversation.")
@@ -1915,7 +2089,7 @@ namespace Azoth
 		if (proxy->IsCancelled ())
 			return;
 
-		if (XmlSettingsManager::Instance ().property ("SeparateMUCEventLogWindow").toBool () &&
+		if (settings.SeparateMUCEventLog_ &&
 				(!parent || parent->GetEntryType () == ICLEntry::EntryType::MUC) &&
 				(msg->GetMessageType () != IMessage::Type::MUCMessage &&
 					msg->GetMessageType () != IMessage::Type::ServiceMessage))
@@ -1928,11 +2102,6 @@ namespace Azoth
 				return;
 		}
 
-		QWebFrame *frame = Ui_.View_->page ()->mainFrame ();
-
-		const bool isActiveChat = Core::Instance ()
-				.GetChatTabsManager ()->IsActiveChat (GetEntry<ICLEntry> ());
-
 		if (!LastDateTime_.isNull () && !IsSameDay (LastDateTime_, msg) && parent)
 		{
 			auto datetime = msg->GetDateTime ();
@@ -1949,7 +2118,7 @@ namespace Azoth
 				isActiveChat,
 				ToggleRichText_->isChecked ()
 			};
-			Core::Instance ().AppendMessageByTemplate (frame, coreMessage, coreInfo);
+			batch.append ({ coreMessage, coreInfo });
 			CoreMessages_ << coreMessage;
 		}
 
@@ -1966,10 +2135,7 @@ namespace Azoth
 		if (!links.isEmpty ())
 			LastLink_ = links.last ();
 
-		if (!Core::Instance ().AppendMessageByTemplate (frame,
-				msg->GetQObject (), info))
-			qWarning () << Q_FUNC_INFO
-					<< "unhandled append message :(";
+		batch.append ({ msg->GetQObject (), info });
 	}
 
 	QString ChatTab::ReformatTitle ()
@@ -33,12 +33,14 @@
 #include <QPointer>
 #include <QPersistentModelIndex>
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <interfaces/core/ihookproxy.h>
 #include <interfaces/ihavetabs.h>
 #include <interfaces/idndtab.h>
 #include <interfaces/ihaverecoverabletabs.h>
 #include <interfaces/iwkfontssettable.h>
 #include "interfaces/azoth/azothcommon.h"
+#include "interfaces/azoth/ibatchchatstyleresourcesource.h"
 #include "ui_chattab.h"
 
 class QTextBrowser;
@@ -116,6 +118,20 @@ namespace Azoth
 		Util::FindNotificationWk *ChatFinder_;
 
 		bool IsCurrent_;
+
+		QList<QPair<QPointer<QObject>, ChatMsgAppendInfo>> PendingBackfill_;
+		QElapsedTimer ThemeLoadTimer_;
+		bool IsThemeLoaded_;
+		bool IsScrollbackPending_;
+
+		struct MessageFilterSettings
+		{
+			bool ShowStatusChanges_;
+			bool ShowStatusChangesInPrivates_;
+			bool ShowJoinsLeaves_;
+			bool ShowEndConversations_;
+			bool SeparateMUCEventLog_;
+		};
 	public:
 		static void SetParentMultiTabs (QObject*);
 		static void SetChatTabClassInfo (const TabClassInfo&);
@@ -188,6 +204,7 @@ namespace Azoth
 		void on_SubjChange__released ();
 		void on_View__loadFinished (bool);
 		void handleHistoryBack ();
+		void handleViewScrolledPastTop ();
 		void handleRichTextToggled ();
 		void handleQuoteSelection ();
 		void handleOpenLastLink ();
@@ -223,6 +240,8 @@ namespace Azoth
 		void handleAccountStyleChanged (IAccount*);
 
 		void performJS (const QString&);
+
+		void backfillMessages ();
 	private:
 		template<typename T>
 		T* GetEntry () const;
@@ -246,6 +265,20 @@ namespace Azoth
 		 */
 		void AppendMessage (IMessage*);
 
+		/** Renders the given messages into the freshly loaded view:
+		 * the most recent ones are appended at once, and the older
+		 * ones are backfilled later if the chat style supports it.
+		 */
+		void RenderMessages (const QList<IMessage*>&);
+
+		MessageFilterSettings GetMessageFilterSettings () const;
+
+		/** Filters the message and appends it (possibly preceded by a
+		 * date separator) to the given batch.
+		 */
+		void PrepareMessage (IMessage*, const MessageFilterSettings&,
+				bool isActiveChat, QList<ChatMsgBatchItem>&);
+
 		/** Updates the tab icon and other usages of state icon from the
 		 * TabIcon_.
 		 */
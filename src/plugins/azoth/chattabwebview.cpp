@@ -29,6 +29,7 @@
 
 #include "chattabwebview.h"
 #include <QContextMenuEvent>
+#include <QWheelEvent>
 #include <QWebHitTestResult>
 #include <QPointer>
 #include <QMenu>
@@ -58,6 +59,10 @@ namespace Azoth
 				SIGNAL (linkClicked (QUrl)),
 				this,
 				SLOT (handlePageLinkClicked (QUrl)));
+		connect (page (),
+				SIGNAL (scrollRequested (int, int, QRect)),
+				this,
+				SLOT (handlePageScrolled (int, int)));
 	}
 
 	void ChatTabWebView::SetQuoteAction (QAction *act)
@@ -77,6 +82,17 @@ namespace Azoth
 		emit linkClicked (r.linkUrl (), false);
 	}
 
+	void ChatTabWebView::wheelEvent (QWheelEvent *e)
+	{
+		/* The frame doesn't scroll if it's already at the top, so
+		 * handlePageScrolled() won't notice this one.
+		 */
+		if (e->delta () > 0 && IsAtTop ())
+			emit scrolledPastTop ();
+
+		QWebView::wheelEvent (e);
+	}
+
 	void ChatTabWebView::contextMenuEvent (QContextMenuEvent *e)
 	{
 		QPointer<QMenu> menu (new QMenu (this));
@@ -126,6 +142,12 @@ namespace Azoth
 		menu->exec (mapToGlobal (e->pos ()));
 	}
 
+	bool ChatTabWebView::IsAtTop () const
+	{
+		const auto frame = page ()->mainFrame ();
+		return frame->scrollBarValue (Qt::Vertical) == frame->scrollBarMinimum (Qt::Vertical);
+	}
+
 	void ChatTabWebView::HandleNick (QMenu *menu, const QUrl& nickUrl)
 	{
 #if QT_VERSION < 0x050000
@@ -231,5 +253,12 @@ namespace Azoth
 	{
 		emit linkClicked (url, true);
 	}
+
+	void ChatTabWebView::handlePageScrolled (int, int dy)
+	{
+		// Positive dy means the contents moved down, that is, the user scrolled up.
+		if (dy > 0 && IsAtTop ())
+			emit scrolledPastTop ();
+	}
 }
 }
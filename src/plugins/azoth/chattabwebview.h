@@ -47,7 +47,10 @@ namespace Azoth
 	protected:
 		void mouseReleaseEvent (QMouseEvent*);
 		void contextMenuEvent (QContextMenuEvent*);
+		void wheelEvent (QWheelEvent*);
 	private:
+		bool IsAtTop () const;
+
 		void HandleNick (QMenu*, const QUrl&);
 		void HandleURL (QMenu*, const QUrl&);
 		void HandleDataFilters (QMenu*, const QString&);
@@ -58,9 +61,11 @@ namespace Azoth
 		void handleHighlightOccurences ();
 		void handleSaveLink ();
 		void handlePageLinkClicked (const QUrl&);
+		void handlePageScrolled (int, int);
 	signals:
 		void linkClicked (const QUrl&, bool);
 		void chatWindowSearchRequested (const QString&);
+		void scrolledPastTop ();
 	};
 }
 }
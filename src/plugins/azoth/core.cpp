@@ -28,6 +28,7 @@
  **********************************************************************/
 
 #include "core.h"
+#include <algorithm>
 #include <QIcon>
 #include <QAction>
 #include <QStandardItemModel>
@@ -53,6 +54,7 @@
 #include <interfaces/iplugin2.h>
 #include <interfaces/an/constants.h>
 #include <interfaces/core/icoreproxy.h>
+#include <interfaces/core/ipluginsmanager.h>
 #include <interfaces/core/irootwindowsmanager.h>
 #include "interfaces/azoth/iprotocolplugin.h"
 #include "interfaces/azoth/iprotocol.h"
@@ -67,6 +69,7 @@
 #include "interfaces/azoth/irichtextmessage.h"
 #include "interfaces/azoth/ihaveservicediscovery.h"
 #include "interfaces/azoth/iextselfinfoaccount.h"
+#include "interfaces/azoth/ihistoryplugin.h"
 #ifdef ENABLE_CRYPT
 #include "cryptomanager.h"
 #endif
@@ -260,6 +263,9 @@ namespace Azoth
 				this, "updateStatusIconset");
 		XmlSettingsManager::Instance ().RegisterObject ("GroupContacts",
 				this, "handleGroupContactsChanged");
+		XmlSettingsManager::Instance ().RegisterObject ("MaxMessagesInMemory",
+				this, "handleMaxMessagesInMemoryChanged");
+		handleMaxMessagesInMemoryChanged ();
 	}
 
 	Core& Core::Instance ()
@@ -371,6 +377,9 @@ namespace Azoth
 
 		PluginManager_->AddPlugin (plugin);
 
+		if (const auto ihp = qobject_cast<IHistoryPlugin*> (plugin))
+			HistoryPlugins_ << ihp;
+
 		QSet<QByteArray> classes = plugin2->GetPluginClasses ();
 		if (classes.contains ("org.LeechCraft.Plugins.Azoth.Plugins.IProtocolPlugin"))
 			AddProtocolPlugin (plugin);
@@ -681,6 +690,16 @@ namespace Azoth
 		return msg->GetBody ().contains (mucEntry->GetNick (), Qt::CaseInsensitive);
 	}
 
+	int Core::GetMessagesRetentionLimit (QObject *entryObj) const
+	{
+		if (MaxMessagesInMemory_ <= 0)
+			return 0;
+
+		const bool isStored = std::any_of (HistoryPlugins_.begin (), HistoryPlugins_.end (),
+				[entryObj] (IHistoryPlugin *hist) { return hist->IsHistoryEnabledFor (entryObj); });
+		return isStored ? MaxMessagesInMemory_ : 0;
+	}
+
 	void Core::AddProtocolPlugin (QObject *plugin)
 	{
 		IProtocolPlugin *ipp =
@@ -787,6 +806,62 @@ namespace Azoth
 		return src->AppendMessage (frame, message, info);
 	}
 
+	bool Core::AppendMessagesByTemplate (QWebFrame *frame,
+			QObject *entry, const QList<ChatMsgBatchItem>& batch)
+	{
+		if (batch.isEmpty ())
+			return true;
+
+		IChatStyleResourceSource *src = GetCurrentChatStyle (entry);
+		if (!src)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "empty result for"
+					<< entry;
+			return false;
+		}
+
+		if (const auto batchSrc = dynamic_cast<IBatchChatStyleResourceSource*> (src))
+			return batchSrc->AppendMessages (frame, batch);
+
+		bool result = true;
+		for (const auto& item : batch)
+			result = src->AppendMessage (frame, item.Message_, item.Info_) && result;
+		return result;
+	}
+
+	bool Core::PrependMessagesByTemplate (QWebFrame *frame,
+			QObject *entry, const QList<ChatMsgBatchItem>& batch)
+	{
+		if (batch.isEmpty ())
+			return true;
+
+		IChatStyleResourceSource *src = GetCurrentChatStyle (entry);
+		if (!src)
+			return false;
+
+		const auto batchSrc = dynamic_cast<IBatchChatStyleResourceSource*> (src);
+		if (!batchSrc || !batchSrc->SupportsPrepend ())
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "style doesn't support prepending messages for"
+					<< entry;
+			return false;
+		}
+
+		return batchSrc->PrependMessages (frame, batch);
+	}
+
+	bool Core::CanPrependMessages (QObject *entry) const
+	{
+		IChatStyleResourceSource *src = GetCurrentChatStyle (entry);
+		if (!src)
+			return false;
+
+		const auto batchSrc = dynamic_cast<IBatchChatStyleResourceSource*> (src);
+		return batchSrc && batchSrc->SupportsPrepend ();
+	}
+
 	void Core::FrameFocused (QObject *entry, QWebFrame *frame)
 	{
 		IChatStyleResourceSource *src = GetCurrentChatStyle (entry);
@@ -1040,13 +1115,54 @@ namespace Azoth
 		}
 	}
 
-	void Core::AddCLEntry (ICLEntry *clEntry,
-			QStandardItem *accItem)
+	void Core::AddCLEntries (const QList<ICLEntry*>& entries, QStandardItem *accItem)
+	{
+		QList<ICLEntry*> added;
+		QHash<QStandardItem*, QList<QStandardItem*>> cat2items;
+		for (const auto clEntry : entries)
+		{
+			if (!RegisterCLEntry (clEntry))
+				continue;
+
+			for (const auto catItem : GetCategoriesItems (GetDisplayGroups (clEntry), accItem))
+			{
+				cat2items [catItem] << CreateEntryItem (clEntry, catItem);
+
+				bool isMucCat = catItem->data (CLRIsMUCCategory).toBool ();
+				if (!isMucCat)
+					isMucCat = clEntry->GetEntryType () == ICLEntry::EntryType::PrivateChat;
+				catItem->setData (isMucCat, CLRIsMUCCategory);
+			}
+
+			added << clEntry;
+		}
+
+		InsertEntryItems (cat2items);
+
+		for (const auto clEntry : added)
+		{
+			HandleStatusChanged (clEntry->GetStatus (), clEntry, QString ());
+
+			if (clEntry->GetEntryType () == ICLEntry::EntryType::PrivateChat)
+				handleEntryPermsChanged (clEntry);
+
+			TooltipManager_->AddEntry (clEntry);
+
+			const auto& id = clEntry->GetEntryID ();
+			ChatTabsManager_->UpdateEntryMapping (id, clEntry->GetQObject ());
+			ChatTabsManager_->SetChatEnabled (id, true);
+
+			Util::DefaultHookProxy_ptr proxy (new Util::DefaultHookProxy);
+			emit hookAddingCLEntryEnd (proxy, clEntry->GetQObject ());
+		}
+	}
+
+	bool Core::RegisterCLEntry (ICLEntry *clEntry)
 	{
 		Util::DefaultHookProxy_ptr proxy (new Util::DefaultHookProxy);
 		emit hookAddingCLEntryBegin (proxy, clEntry->GetQObject ());
 		if (proxy->IsCancelled ())
-			return;
+			return false;
 
 		ResourcesManager::Instance ().HandleEntry (clEntry);
 
@@ -1103,36 +1219,9 @@ namespace Azoth
 
 		EventsNotifier_->RegisterEntry (clEntry);
 
-		const QString& id = clEntry->GetEntryID ();
-		ID2Entry_ [id] = clEntry->GetQObject ();
+		ID2Entry_ [clEntry->GetEntryID ()] = clEntry->GetQObject ();
 
-		const QStringList& groups = GetDisplayGroups (clEntry);
-		{
-			ModelUpdateSafeguard outerGuard (CLModel_);
-			QList<QStandardItem*> catItems = GetCategoriesItems (groups, accItem);
-			Q_FOREACH (QStandardItem *catItem, catItems)
-			{
-				AddEntryTo (clEntry, catItem);
-
-				bool isMucCat = catItem->data (CLRIsMUCCategory).toBool ();
-				if (!isMucCat)
-					isMucCat = clEntry->GetEntryType () == ICLEntry::EntryType::PrivateChat;
-				catItem->setData (isMucCat, CLRIsMUCCategory);
-			}
-		}
-
-		HandleStatusChanged (clEntry->GetStatus (), clEntry, QString ());
-
-		if (clEntry->GetEntryType () == ICLEntry::EntryType::PrivateChat)
-			handleEntryPermsChanged (clEntry);
-
-		TooltipManager_->AddEntry (clEntry);
-
-		ChatTabsManager_->UpdateEntryMapping (id, clEntry->GetQObject ());
-		ChatTabsManager_->SetChatEnabled (id, true);
-
-		proxy.reset (new Util::DefaultHookProxy);
-		emit hookAddingCLEntryEnd (proxy, clEntry->GetQObject ());
+		return true;
 	}
 
 	QList<QStandardItem*> Core::GetCategoriesItems (QStringList cats, QStandardItem *account)
@@ -1144,7 +1233,7 @@ namespace Azoth
 		ModelUpdateSafeguard guard (CLModel_);
 		Q_FOREACH (const QString& cat, cats)
 		{
-			if (!Account2Category2Item_ [account].keys ().contains (cat))
+			if (!Account2Category2Item_ [account].contains (cat))
 			{
 				QStandardItem *catItem = new QStandardItem (cat);
 				catItem->setEditable (false);
@@ -1163,28 +1252,9 @@ namespace Azoth
 		return result;
 	}
 
-	QStandardItem* Core::GetAccountItem (const IAccount *account)
+	QStandardItem* Core::GetAccountItem (const IAccount *account) const
 	{
-		for (int i = 0, size = CLModel_->rowCount ();
-				i < size; ++i)
-		{
-			const auto& var = CLModel_->item (i)->data (CLRAccountObject);
-			if (var.value<IAccount*> () == account)
-				return CLModel_->item (i);
-		}
-		return 0;
-	}
-
-	QStandardItem* Core::GetAccountItem (const IAccount *account,
-			QMap<const IAccount*, QStandardItem*>& accountItemCache)
-	{
-		if (accountItemCache.contains (account))
-			return accountItemCache [account];
-
-		const auto accountItem = GetAccountItem (account);
-		if (accountItem)
-			accountItemCache [account] = accountItem;
-		return accountItem;
+		return Account2Item_.value (account);
 	}
 
 	void Core::HandleStatusChanged (const EntryStatus&, ICLEntry *entry, const QString& variant)
@@ -1196,10 +1266,9 @@ namespace Azoth
 		const auto& icon = ResourcesManager::Instance ().GetIconPathForState (state);
 
 		for (auto item : Entry2Items_.value (entry))
-		{
 			ItemIconManager_->SetIcon (item, icon.get ());
-			RecalculateOnlineForCat (item->parent ());
-		}
+
+		UpdateOnlineCount (entry, state != SOffline);
 
 		const QString& id = entry->GetEntryID ();
 		if (!XferJobManager_->GetPendingIncomingJobsFor (id).isEmpty ())
@@ -1236,11 +1305,7 @@ namespace Azoth
 	void Core::IncreaseUnreadCount (ICLEntry* entry, int amount)
 	{
 		for (auto item : Entry2Items_.value (entry))
-			{
-				int prevValue = item->data (CLRUnreadMsgCount).toInt ();
-				item->setData (std::max (0, prevValue + amount), CLRUnreadMsgCount);
-				RecalculateUnreadForParents (item);
-			}
+			SetUnreadCount (item, item->data (CLRUnreadMsgCount).toInt () + amount);
 	}
 
 	int Core::GetUnreadCount (ICLEntry *entry) const
@@ -1280,27 +1345,41 @@ namespace Azoth
 		return CoreCommandsManager_;
 	}
 
-	void Core::RecalculateUnreadForParents (QStandardItem *clItem)
+	namespace
 	{
-		QStandardItem *category = clItem->parent ();
-		int sum = 0;
-		for (int i = 0, rc = category->rowCount ();
-				i < rc; ++i)
-			sum += category->child (i)->data (CLRUnreadMsgCount).toInt ();
-		category->setData (sum, CLRUnreadMsgCount);
+		void AdjustCounter (QStandardItem *item, int role, int delta)
+		{
+			if (!item || !delta)
+				return;
+
+			item->setData (std::max (0, item->data (role).toInt () + delta), role);
+		}
 	}
 
-	void Core::RecalculateOnlineForCat (QStandardItem *catItem)
+	void Core::SetUnreadCount (QStandardItem *clItem, int count)
 	{
-		int result = 0;
-		for (int i = 0; i < catItem->rowCount (); ++i)
-		{
-			auto entryObj = catItem->child (i)->
-					data (CLREntryObject).value<QObject*> ();
-			result += qobject_cast<ICLEntry*> (entryObj)->GetStatus ().State_ != SOffline;
-		}
+		count = std::max (0, count);
+
+		const int prevValue = clItem->data (CLRUnreadMsgCount).toInt ();
+		if (prevValue == count)
+			return;
 
-		catItem->setData (result, CLRNumOnline);
+		clItem->setData (count, CLRUnreadMsgCount);
+		AdjustCounter (clItem->parent (), CLRUnreadMsgCount, count - prevValue);
+	}
+
+	void Core::UpdateOnlineCount (ICLEntry *entry, bool isOnline)
+	{
+		if (OnlineEntries_.contains (entry) == isOnline)
+			return;
+
+		if (isOnline)
+			OnlineEntries_ << entry;
+		else
+			OnlineEntries_.remove (entry);
+
+		for (auto item : Entry2Items_.value (entry))
+			AdjustCounter (item->parent (), CLRNumOnline, isOnline ? 1 : -1);
 	}
 
 	void Core::HandlePowerNotification (Entity e)
@@ -1327,37 +1406,57 @@ namespace Azoth
 		}
 	}
 
-	void Core::RemoveCLItem (QStandardItem *item)
+	void Core::RemoveCLItems (const QList<QStandardItem*>& items)
 	{
-		QObject *entryObj = item->data (CLREntryObject).value<QObject*> ();
-		Entry2Items_ [qobject_cast<ICLEntry*> (entryObj)].removeAll (item);
+		QHash<QStandardItem*, QList<int>> cat2rows;
+		for (const auto item : items)
+		{
+			const auto entryObj = item->data (CLREntryObject).value<QObject*> ();
+			const auto entry = qobject_cast<ICLEntry*> (entryObj);
+			Entry2Items_ [entry].removeAll (item);
 
-		QStandardItem *category = item->parent ();
-		const int unread = item->data (CLRUnreadMsgCount).toInt ();
+			QStandardItem *category = item->parent ();
+			AdjustCounter (category, CLRUnreadMsgCount, -item->data (CLRUnreadMsgCount).toInt ());
+			if (OnlineEntries_.contains (entry))
+				AdjustCounter (category, CLRNumOnline, -1);
 
-		ItemIconManager_->Cancel (item);
+			ItemIconManager_->Cancel (item);
 
-		ModelUpdateSafeguard guard (CLModel_);
-		category->removeRow (item->row ());
+			cat2rows [category] << item->row ();
+		}
 
-		if (!category->rowCount ())
+		ModelUpdateSafeguard guard (CLModel_);
+		for (auto i = cat2rows.begin (), end = cat2rows.end (); i != end; ++i)
 		{
-			QStandardItem *account = category->parent ();
-			ItemIconManager_->Cancel (category);
+			QStandardItem *category = i.key ();
 
-			const QString& text = category->text ();
+			auto& rows = i.value ();
+			std::sort (rows.begin (), rows.end (), std::greater<int> ());
+			for (int pos = 0; pos < rows.size (); )
+			{
+				int count = 1;
+				while (pos + count < rows.size () &&
+						rows.at (pos + count) == rows.at (pos) - count)
+					++count;
 
-			account->removeRow (category->row ());
-			Account2Category2Item_ [account].remove (text);
-		}
-		else if (unread)
-		{
-			const int sum = category->data (CLRUnreadMsgCount).toInt ();
-			category->setData (std::max (sum - unread, 0), CLRUnreadMsgCount);
+				category->removeRows (rows.at (pos + count - 1), count);
+				pos += count;
+			}
+
+			if (!category->rowCount ())
+			{
+				QStandardItem *account = category->parent ();
+				ItemIconManager_->Cancel (category);
+
+				const QString& text = category->text ();
+
+				account->removeRow (category->row ());
+				Account2Category2Item_ [account].remove (text);
+			}
 		}
 	}
 
-	void Core::AddEntryTo (ICLEntry *clEntry, QStandardItem *catItem)
+	QStandardItem* Core::CreateEntryItem (ICLEntry *clEntry, QStandardItem *catItem)
 	{
 		QStandardItem *clItem = new QStandardItem (clEntry->GetEntryName ());
 		clItem->setEditable (false);
@@ -1375,10 +1474,27 @@ namespace Azoth
 				Qt::ItemIsDragEnabled |
 				Qt::ItemIsDropEnabled);
 
+		Entry2Items_ [clEntry] << clItem;
+
+		return clItem;
+	}
+
+	void Core::InsertEntryItems (const QHash<QStandardItem*, QList<QStandardItem*>>& cat2items)
+	{
 		ModelUpdateSafeguard guard (CLModel_);
-		catItem->appendRow (clItem);
+		for (auto i = cat2items.begin (), end = cat2items.end (); i != end; ++i)
+		{
+			QStandardItem *category = i.key ();
+			category->appendRows (i.value ());
 
-		Entry2Items_ [clEntry] << clItem;
+			int online = 0;
+			for (const auto item : i.value ())
+			{
+				const auto entryObj = item->data (CLREntryObject).value<QObject*> ();
+				online += OnlineEntries_.contains (qobject_cast<ICLEntry*> (entryObj));
+			}
+			AdjustCounter (category, CLRNumOnline, online);
+		}
 	}
 
 	IChatStyleResourceSource* Core::GetCurrentChatStyle (QObject *entry) const
@@ -1567,10 +1683,11 @@ namespace Azoth
 			ModelUpdateSafeguard guard (CLModel_);
 			CLModel_->appendRow (accItem);
 		}
+		Account2Item_ [account] = accItem;
 
 		accItem->setEditable (false);
 
-		QList<QStandardItem*> clItems;
+		QList<ICLEntry*> clEntries;
 		Q_FOREACH (QObject *clObj, account->GetCLEntries ())
 		{
 			ICLEntry *clEntry = qobject_cast<ICLEntry*> (clObj);
@@ -1583,8 +1700,9 @@ namespace Azoth
 				continue;
 			}
 
-			AddCLEntry (clEntry, accItem);
+			clEntries << clEntry;
 		}
+		AddCLEntries (clEntries, accItem);
 
 		NotificationsManager_->AddAccount (accObject);
 
@@ -1667,24 +1785,20 @@ namespace Azoth
 
 		emit accountRemoved (accFace);
 
-		for (int i = 0; i < CLModel_->rowCount (); ++i)
+		if (const auto item = Account2Item_.take (accFace))
 		{
-			QStandardItem *item = CLModel_->item (i);
-			const auto obj = item->data (CLRAccountObject).value<IAccount*> ();
-			if (obj == accFace)
-			{
-				ItemIconManager_->Cancel (item);
-				{
-					ModelUpdateSafeguard guard (CLModel_);
-					CLModel_->removeRow (i);
-				}
-				break;
-			}
+			ItemIconManager_->Cancel (item);
+
+			ModelUpdateSafeguard guard (CLModel_);
+			CLModel_->removeRow (item->row ());
 		}
 
 		for (auto entry : Entry2Items_.keys ())
 			if (entry->GetParentAccount () == accFace)
+			{
 				Entry2Items_.remove (entry);
+				OnlineEntries_.remove (entry);
+			}
 
 		NotificationsManager_->RemoveAccount (account);
 
@@ -1696,9 +1810,9 @@ namespace Azoth
 
 	void Core::handleGotCLItems (const QList<QObject*>& items)
 	{
-		ModelUpdateSafeguard outerGuard (CLModel_);
-
-		QMap<const IAccount*, QStandardItem*> accountItemCache;
+		QList<QStandardItem*> accountItems;
+		QHash<QStandardItem*, QList<ICLEntry*>> accItem2entries;
+		QList<ICLEntry*> entries;
 		for (const auto item : items)
 		{
 			const auto entry = qobject_cast<ICLEntry*> (item);
@@ -1716,7 +1830,7 @@ namespace Azoth
 				continue;
 
 			const auto account = entry->GetParentAccount ();
-			const auto accountItem = GetAccountItem (account, accountItemCache);
+			const auto accountItem = GetAccountItem (account);
 			if (!accountItem)
 			{
 				qWarning () << Q_FUNC_INFO
@@ -1726,11 +1840,23 @@ namespace Azoth
 				continue;
 			}
 
-			AddCLEntry (entry, accountItem);
+			if (!accItem2entries.contains (accountItem))
+				accountItems << accountItem;
+			accItem2entries [accountItem] << entry;
+			entries << entry;
+		}
+
+		for (const auto accountItem : accountItems)
+			AddCLEntries (accItem2entries [accountItem], accountItem);
+
+		for (const auto entry : entries)
+		{
+			if (!Entry2Items_.contains (entry))
+				continue;
 
 			if (entry->GetEntryType () == ICLEntry::EntryType::MUC)
 			{
-				auto mucEntry = qobject_cast<IMUCEntry*> (item);
+				auto mucEntry = qobject_cast<IMUCEntry*> (entry->GetQObject ());
 
 				const bool open = XmlSettingsManager::Instance ()
 						.property ("OpenTabsForAutojoin").toBool ();
@@ -1747,6 +1873,8 @@ namespace Azoth
 
 	void Core::handleRemovedCLItems (const QList<QObject*>& items)
 	{
+		QList<ICLEntry*> entries;
+		QList<QStandardItem*> clItems;
 		for (const auto clitem : items)
 		{
 			const auto entry = qobject_cast<ICLEntry*> (clitem);
@@ -1758,6 +1886,16 @@ namespace Azoth
 				continue;
 			}
 
+			entries << entry;
+			clItems += Entry2Items_.value (entry);
+		}
+
+		RemoveCLItems (clItems);
+
+		for (const auto entry : entries)
+		{
+			const auto clitem = entry->GetQObject ();
+
 			if (entry->GetEntryType () == ICLEntry::EntryType::MUC &&
 					XmlSettingsManager::Instance ().property ("CloseConfOnLeave").toBool ())
 				GetChatTabsManager ()->CloseChat (entry, false);
@@ -1771,10 +1909,8 @@ namespace Azoth
 
 			ChatTabsManager_->HandleEntryRemoved (entry);
 
-			for (auto item : Entry2Items_.value (entry))
-				RemoveCLItem (item);
-
 			Entry2Items_.remove (entry);
+			OnlineEntries_.remove (entry);
 
 			ActionsManager_->HandleEntryRemoved (entry);
 
@@ -1819,21 +1955,18 @@ namespace Azoth
 		XmlSettingsManager::Instance ().setProperty (id,
 				serializedStatus);
 
-		for (int i = 0, size = CLModel_->rowCount (); i < size; ++i)
+		const auto item = GetAccountItem (acc);
+		if (!item)
 		{
-			QStandardItem *item = CLModel_->item (i);
-			if (item->data (CLRAccountObject).value<IAccount*> () != acc)
-				continue;
-
-			ItemIconManager_->SetIcon (item,
-					ResourcesManager::Instance ().GetIconPathForState (status.State_).get ());
+			qWarning () << Q_FUNC_INFO
+					<< "item for account"
+					<< sender ()
+					<< "not found";
 			return;
 		}
 
-		qWarning () << Q_FUNC_INFO
-				<< "item for account"
-				<< sender ()
-				<< "not found";
+		ItemIconManager_->SetIcon (item,
+				ResourcesManager::Instance ().GetIconPathForState (status.State_).get ());
 	}
 
 	void Core::handleAccountRenamed (const QString& name)
@@ -1847,15 +1980,8 @@ namespace Azoth
 			return;
 		}
 
-		for (int i = 0, size = CLModel_->rowCount (); i < size; ++i)
-		{
-			QStandardItem *item = CLModel_->item (i);
-			if (item->data (CLRAccountObject).value<IAccount*> () != acc)
-				continue;
-
+		if (const auto item = GetAccountItem (acc))
 			item->setText (name);
-			return;
-		}
 	}
 
 	void Core::handleStatusChanged (const EntryStatus& status, const QString& variant)
@@ -1921,22 +2047,24 @@ namespace Azoth
 		if (!Entry2Items_.contains (entry))
 			return;
 
+		QList<QStandardItem*> obsolete;
 		for (auto item : Entry2Items_.value (entry))
 		{
 			const QString& oldCat = item->data (CLREntryCategory).toString ();
-			if (newGroups.removeAll (oldCat))
-				continue;
-
-			RemoveCLItem (item);
+			if (!newGroups.removeAll (oldCat))
+				obsolete << item;
 		}
+		RemoveCLItems (obsolete);
 
 		if (newGroups.isEmpty () && !Entry2Items_.value (entry).isEmpty ())
 			return;
 
 		auto accItem = GetAccountItem (entry->GetParentAccount ());
 
+		QHash<QStandardItem*, QList<QStandardItem*>> cat2items;
 		for (auto catItem : GetCategoriesItems (newGroups, accItem))
-			AddEntryTo (entry, catItem);
+			cat2items [catItem] << CreateEntryItem (entry, catItem);
+		InsertEntryItems (cat2items);
 
 		HandleStatusChanged (entry->GetStatus (), entry, QString ());
 	}
@@ -2131,6 +2259,12 @@ namespace Azoth
 				handleEntryGroupsChanged (GetDisplayGroups (entry), entry->GetQObject ());
 	}
 
+	void Core::handleMaxMessagesInMemoryChanged ()
+	{
+		MaxMessagesInMemory_ = XmlSettingsManager::Instance ()
+				.property ("MaxMessagesInMemory").toInt ();
+	}
+
 	void Core::updateItem ()
 	{
 		ICLEntry *entry = qobject_cast<ICLEntry*> (sender ());
@@ -2150,10 +2284,7 @@ namespace Azoth
 	{
 		const auto entry = qobject_cast<ICLEntry*> (entryObj);
 		for (auto item : Entry2Items_.value (entry))
-		{
-			item->setData (0, CLRUnreadMsgCount);
-			RecalculateUnreadForParents (item);
-		}
+			SetUnreadCount (item, 0);
 	}
 
 	void Core::handleGotSDSession (QObject *sdObj)
@@ -44,6 +44,7 @@
 #include "interfaces/azoth/iprotocol.h"
 #include "interfaces/azoth/iauthable.h"
 #include "interfaces/azoth/ichatstyleresourcesource.h"
+#include "interfaces/azoth/ibatchchatstyleresourcesource.h"
 #include "interfaces/azoth/isupportriex.h"
 #include "sourcetrackingmodel.h"
 #include "animatediconmanager.h"
@@ -63,6 +64,7 @@ namespace Azoth
 	class ICLEntry;
 	class IAccount;
 	class IMessage;
+	class IHistoryPlugin;
 	class IEmoticonResourceSource;
 	class IChatStyleResourceSource;
 
@@ -95,6 +97,9 @@ namespace Azoth
 		QObjectList ProtocolPlugins_;
 		QList<QAction*> AccountCreatorActions_;
 
+		QList<IHistoryPlugin*> HistoryPlugins_;
+		int MaxMessagesInMemory_ = 0;
+
 		CLTooltipManager * const TooltipManager_;
 		CLModel *CLModel_;
 		ChatTabsManager *ChatTabsManager_;
@@ -109,6 +114,9 @@ namespace Azoth
 		typedef QHash<ICLEntry*, QList<QStandardItem*>> Entry2Items_t;
 		Entry2Items_t Entry2Items_;
 
+		QHash<const IAccount*, QStandardItem*> Account2Item_;
+		QSet<ICLEntry*> OnlineEntries_;
+
 		ActionsManager *ActionsManager_;
 
 		typedef QHash<QString, QObject*> ID2Entry_t;
@@ -238,6 +246,11 @@ namespace Azoth
 		 */
 		bool IsHighlightMessage (IMessage*);
 
+		/** Returns the maximum number of messages the given entry is
+		 * allowed to keep in memory, or 0 if there is no limit.
+		 */
+		int GetMessagesRetentionLimit (QObject *entryObj) const;
+
 		/** @brief Returns the avatar for the given CL entry scaled to
 		 * the given size.
 		 *
@@ -257,6 +270,9 @@ namespace Azoth
 		QUrl GetSelectedChatTemplateURL (QObject*) const;
 
 		bool AppendMessageByTemplate (QWebFrame*, QObject*, const ChatMsgAppendInfo&);
+		bool AppendMessagesByTemplate (QWebFrame*, QObject*, const QList<ChatMsgBatchItem>&);
+		bool PrependMessagesByTemplate (QWebFrame*, QObject*, const QList<ChatMsgBatchItem>&);
+		bool CanPrependMessages (QObject*) const;
 
 		void FrameFocused (QObject*, QWebFrame*);
 
@@ -288,10 +304,17 @@ namespace Azoth
 		void AddSmileResourceSource (IEmoticonResourceSource*);
 		void AddChatStyleResourceSource (IChatStyleResourceSource*);
 
-		/** Adds the given contact list entry to the given account and
-		 * performs common initialization tasks.
+		/** Adds the given contact list entries to the given account and
+		 * performs common initialization tasks. The model is updated
+		 * once per category instead of once per entry.
+		 */
+		void AddCLEntries (const QList<ICLEntry*>& entries, QStandardItem *accItem);
+
+		/** Connects to the entry signals and registers it in the
+		 * internal structures. Returns false if a hook cancelled
+		 * adding the entry.
 		 */
-		void AddCLEntry (ICLEntry *entry, QStandardItem *accItem);
+		bool RegisterCLEntry (ICLEntry *entry);
 
 		/** Returns the list of category items for the given account and
 		 * categories list. Creates the items if needed. The returned
@@ -304,13 +327,7 @@ namespace Azoth
 
 		/** Returns the QStandardItem for the given account.
 		 */
-		QStandardItem* GetAccountItem (const IAccount *accountObj);
-
-		/** Returns the QStandardItem for the given account and adds it
-		 * into accountItemCache.
-		 */
-		QStandardItem* GetAccountItem (const IAccount *account,
-				QMap<const IAccount*, QStandardItem*>& accountItemCache);
+		QStandardItem* GetAccountItem (const IAccount *accountObj) const;
 
 		/** Handles the event of status changes in a contact list entry.
 		 */
@@ -322,22 +339,32 @@ namespace Azoth
 		 */
 		void CheckFileIcon (const QString& id);
 
-		/** This functions calculates new value of number of unread
-		 * items for the chain of parents of the given item.
+		/** Sets the number of unread messages for the given item and
+		 * adjusts the counter of its parent by the difference.
 		 */
-		void RecalculateUnreadForParents (QStandardItem*);
+		void SetUnreadCount (QStandardItem*, int);
 
-		void RecalculateOnlineForCat (QStandardItem*);
+		/** Updates the online counters of the categories containing
+		 * the given entry, if its online state has changed.
+		 */
+		void UpdateOnlineCount (ICLEntry*, bool isOnline);
 
 		void HandlePowerNotification (Entity);
 
-		/** Removes one item representing the given CL entry.
+		/** Removes the given items representing CL entries, removing
+		 * contiguous rows of each category at once.
+		 */
+		void RemoveCLItems (const QList<QStandardItem*>&);
+
+		/** Creates an item for the given entry in the given category
+		 * without inserting it into the model.
 		 */
-		void RemoveCLItem (QStandardItem*);
+		QStandardItem* CreateEntryItem (ICLEntry*, QStandardItem*);
 
-		/** Adds the given entry to the given category item.
+		/** Appends the items created by CreateEntryItem() to their
+		 * categories and updates the categories' counters.
 		 */
-		void AddEntryTo (ICLEntry*, QStandardItem*);
+		void InsertEntryItems (const QHash<QStandardItem*, QList<QStandardItem*>>&);
 
 		IChatStyleResourceSource* GetCurrentChatStyle (QObject*) const;
 
@@ -444,6 +471,7 @@ namespace Azoth
 		 * changes of the "GroupContacts" property.
 		 */
 		void handleGroupContactsChanged ();
+		void handleMaxMessagesInMemoryChanged ();
 
 		/** This slot is used to update the model item which is
 		 * corresponding to the sender() which is expected to be a
@@ -102,6 +102,49 @@ namespace AzothUtil
 				break;
 		}
 	}
+
+	/** @brief Standard function to keep at most \em limit \em messages
+	 * in memory.
+	 *
+	 * This function is a standard implementation of the per-entry
+	 * message retention policy. It deletes the oldest messages in the
+	 * \em messages list so that at most \em limit messages are left.
+	 * The limit is typically obtained via
+	 * IProxyObject::GetMessagesRetentionLimit().
+	 *
+	 * To avoid trimming the list on each new message, nothing is done
+	 * until the list grows an eighth over the \em limit.
+	 *
+	 * Messages contained in \em keep (like unread messages that are
+	 * still referenced elsewhere) are never deleted, and the messages
+	 * after the first such message are kept as well, so that the
+	 * messages left in memory always form a contiguous range.
+	 *
+	 * The list of \em messages is assumed to be sorted according to the
+	 * message timestamp in ascending order.
+	 *
+	 * @param[inout] messages The list of messages to trim.
+	 * @param[in] limit The maximum number of messages to keep, or 0
+	 * for no limit.
+	 * @param[in] keep The messages that should not be deleted.
+	 * @return The number of deleted messages.
+	 *
+	 * @sa StandardPurgeMessages()
+	 */
+	template<typename T>
+	int StandardTrimMessages (QList<T*>& messages, int limit, const QList<T*>& keep = {})
+	{
+		if (limit <= 0 || messages.size () <= limit + limit / 8)
+			return 0;
+
+		const int toEvict = messages.size () - limit;
+		int evicted = 0;
+		while (evicted < toEvict && !keep.contains (messages.at (evicted)))
+			delete messages.at (evicted++);
+
+		messages.erase (messages.begin (), messages.begin () + evicted);
+		return evicted;
+	}
 }
 }
 }
@@ -0,0 +1,122 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#ifndef PLUGINS_AZOTH_INTERFACES_IBATCHCHATSTYLERESOURCESOURCE_H
+#define PLUGINS_AZOTH_INTERFACES_IBATCHCHATSTYLERESOURCESOURCE_H
+#include <QList>
+#include <QtPlugin>
+#include "ichatstyleresourcesource.h"
+
+class QWebFrame;
+
+namespace LeechCraft
+{
+namespace Azoth
+{
+	/** @brief Describes a single message in a batch of messages.
+	 *
+	 * @sa IBatchChatStyleResourceSource
+	 */
+	struct ChatMsgBatchItem
+	{
+		/** @brief The message object implementing IMessage.
+		 */
+		QObject *Message_;
+
+		/** @brief Additional parameters of the message.
+		 */
+		ChatMsgAppendInfo Info_;
+	};
+
+	/** @brief Interface for chat styles supporting batch message
+	 * rendering.
+	 *
+	 * Chat style resource sources implementing IChatStyleResourceSource
+	 * may also implement this interface to allow Azoth to render lots
+	 * of messages at once (for example, when a chat tab is opened or a
+	 * theme is reloaded) with a single modification of the chat view
+	 * document instead of one modification per message.
+	 *
+	 * The result of appending a batch should be the same as appending
+	 * each message of the batch in order via
+	 * IChatStyleResourceSource::AppendMessage().
+	 *
+	 * @sa IChatStyleResourceSource
+	 */
+	class IBatchChatStyleResourceSource
+	{
+	public:
+		virtual ~IBatchChatStyleResourceSource () {}
+
+		/** @brief Appends the given messages to the chat view.
+		 *
+		 * The messages in the \em batch are sorted chronologically.
+		 *
+		 * @param[in] frame The frame with the chat view.
+		 * @param[in] batch The list of messages to append.
+		 * @return Whether the messages have been appended successfully.
+		 *
+		 * @sa IChatStyleResourceSource::AppendMessage()
+		 */
+		virtual bool AppendMessages (QWebFrame *frame,
+				const QList<ChatMsgBatchItem>& batch) = 0;
+
+		/** @brief Returns whether this style supports prepending
+		 * messages.
+		 *
+		 * If this function returns false, PrependMessages() will never
+		 * be called, and Azoth will render the messages in the
+		 * chronological order instead.
+		 *
+		 * @return Whether PrependMessages() is supported.
+		 */
+		virtual bool SupportsPrepend () const = 0;
+
+		/** @brief Inserts the given messages before all the messages
+		 * in the chat view.
+		 *
+		 * This function is used to backfill the older messages after
+		 * the most recent ones have already been rendered. The
+		 * messages in the \em batch are sorted chronologically and are
+		 * all older than the messages already present in the view.
+		 *
+		 * @param[in] frame The frame with the chat view.
+		 * @param[in] batch The list of messages to prepend.
+		 * @return Whether the messages have been prepended successfully.
+		 */
+		virtual bool PrependMessages (QWebFrame *frame,
+				const QList<ChatMsgBatchItem>& batch) = 0;
+	};
+}
+}
+
+Q_DECLARE_INTERFACE (LeechCraft::Azoth::IBatchChatStyleResourceSource,
+		"org.Deviant.LeechCraft.Azoth.IBatchChatStyleResourceSource/1.0");
+
+#endif
@@ -344,6 +344,23 @@ namespace Azoth
 
 		virtual QObject* GetFirstUnreadMessage (QObject *entryObj) const = 0;
 
+		/** @brief Returns how many messages an entry may keep in memory.
+		 *
+		 * Entries are expected to delete their oldest messages once
+		 * they have more than the returned number of messages, for
+		 * example, via AzothUtil::StandardTrimMessages(). Deleted
+		 * messages are then loaded back from the history plugins when
+		 * needed.
+		 *
+		 * The returned limit is non-zero only if the user has
+		 * configured it and the history of the \em entryObj is
+		 * actually stored by some history plugin.
+		 *
+		 * @param[in] entryObj The entry object implementing ICLEntry.
+		 * @return The maximum number of messages, or 0 if unlimited.
+		 */
+		virtual int GetMessagesRetentionLimit (QObject *entryObj) const = 0;
+
 		virtual IFormatterProxyObject& GetFormatterProxy () = 0;
 	};
 }
@@ -323,6 +323,8 @@ namespace Acetamide
 	void ChannelCLEntry::HandleMessage (ChannelPublicMessage *msg)
 	{
 		AllMessages_ << msg;
+		AzothUtil::StandardTrimMessages (AllMessages_,
+				Core::Instance ().GetPluginProxy ()->GetMessagesRetentionLimit (this));
 		emit gotMessage (msg);
 	}
 
@@ -83,18 +83,24 @@ namespace Acetamide
 	QList<QObject*> ChannelHandler::GetParticipants () const
 	{
 		QList<QObject*> result;
-		Q_FOREACH (ChannelParticipantEntry_ptr cpe, Nick2Entry_.values ())
+		result.reserve (Nick2Entry_.size ());
+		for (const auto& cpe : Nick2Entry_)
 			result << cpe.get ();
 		return result;
 	}
 
+	int ChannelHandler::GetParticipantsCount () const
+	{
+		return Nick2Entry_.size ();
+	}
+
 	ChannelParticipantEntry_ptr ChannelHandler::GetSelf ()
 	{
-		Q_FOREACH (ChannelParticipantEntry_ptr cpe, Nick2Entry_.values ())
-			if (cpe->GetEntryName () == CM_->GetOurNick ())
-				return cpe;
+		const auto& ourNick = CM_->GetOurNick ();
+		if (!Self_ || Self_->GetEntryName () != ourNick)
+			Self_ = GetParticipantEntry (ourNick);
 
-		return GetParticipantEntry (CM_->GetOurNick ());
+		return Self_;
 	}
 
 	ChannelParticipantEntry_ptr ChannelHandler::GetParticipantEntry (const QString& nick, bool announce)
@@ -135,12 +141,15 @@ namespace Acetamide
 				IMessage::SubType::ParticipantNickChange,
 				Nick2Entry_ [oldNick]);
 
-		CM_->GetAccount ()->handleEntryRemoved (Nick2Entry_ [oldNick].get ());
+		const bool isAnnounced = !Unannounced_.contains (Nick2Entry_ [oldNick].get ());
+		if (isAnnounced)
+			CM_->GetAccount ()->handleEntryRemoved (Nick2Entry_ [oldNick].get ());
 		QList<ChannelRole> roles = Nick2Entry_ [oldNick]->Roles ();
 		ChannelParticipantEntry_ptr entry = Nick2Entry_.take (oldNick);
 		entry->SetEntryName (newNick);
 		entry->SetRoles (roles);
-		CM_->GetAccount ()->handleGotRosterItems (QObjectList () << entry.get ());
+		if (isAnnounced)
+			CM_->GetAccount ()->handleGotRosterItems (QObjectList () << entry.get ());
 
 		Nick2Entry_ [newNick] = entry;
 	}
@@ -155,6 +164,16 @@ namespace Acetamide
 		IsRosterReceived_ = status;
 	}
 
+	QList<QObject*> ChannelHandler::TakeUnannouncedParticipants ()
+	{
+		QList<QObject*> result;
+		result.reserve (Unannounced_.size ());
+		for (const auto entry : Unannounced_)
+			result << entry;
+		Unannounced_.clear ();
+		return result;
+	}
+
 	void ChannelHandler::HandleServiceMessage (const QString& msg,
 			IMessage::Type mt, IMessage::SubType mst,
 			ChannelParticipantEntry_ptr entry)
@@ -193,14 +212,27 @@ namespace Acetamide
 
 	void ChannelHandler::SetChannelUser (const QString& nick,
 			const QString& user, const QString& host)
+	{
+		AddChannelUser (nick, user, host, GetRolePrefixes ());
+	}
+
+	void ChannelHandler::SetChannelUsers (const QStringList& nicks)
+	{
+		const auto& prefixList = GetRolePrefixes ();
+		for (const auto& nick : nicks)
+			if (!nick.isEmpty ())
+				AddChannelUser (nick, QString (), QString (), prefixList);
+	}
+
+	void ChannelHandler::AddChannelUser (const QString& nick,
+			const QString& user, const QString& host, const QStringList& prefixList)
 	{
 		QString nickName = nick;
 		bool hasRole = false;
 		QChar roleSign;
 
-		if (CM_->GetISupport ().contains ("PREFIX"))
+		if (!prefixList.isEmpty ())
 		{
-			const QStringList& prefixList = CM_->GetISupport () ["PREFIX"].split (')');
 			int id = prefixList.value (1).indexOf (nick [0]);
 			if (id != -1)
 			{
@@ -247,7 +279,12 @@ namespace Acetamide
 		entry->SetStatus (EntryStatus (SOnline, QString ()));
 
 		if (!existed)
-			CM_->GetAccount ()->handleGotRosterItems ({ entry.get () });
+		{
+			if (IsRosterReceived_)
+				CM_->GetAccount ()->handleGotRosterItems ({ entry.get () });
+			else
+				Unannounced_ << entry.get ();
+		}
 
 		MakeJoinMessage (nickName);
 	}
@@ -472,7 +509,8 @@ namespace Acetamide
 //
 // 			if (participants.count () == 1)
 // 			{
-			CM_->GetAccount ()->handleEntryRemoved (entry.get ());
+			if (!Unannounced_.contains (entry.get ()))
+				CM_->GetAccount ()->handleEntryRemoved (entry.get ());
 			if (isPrivate)
 				CM_->CreateServerParticipantEntry (nick);
 // 			}
@@ -492,6 +530,8 @@ namespace Acetamide
 // 			}
 		}
 		Nick2Entry_.clear ();
+		Unannounced_.clear ();
+		Self_.reset ();
 
 		CM_->GetAccount ()->handleEntryRemoved (ChannelCLEntry_.get ());
 
@@ -738,13 +778,25 @@ namespace Acetamide
 		if (!Nick2Entry_.contains (nick))
 			return false;
 
-		ChannelParticipantEntry_ptr entry = Nick2Entry_ [nick];
-		Nick2Entry_.remove (nick);
-		CM_->GetAccount ()->handleEntryRemoved (entry.get ());
+		ChannelParticipantEntry_ptr entry = Nick2Entry_.take (nick);
+		if (entry == Self_)
+			Self_.reset ();
+
+		if (!Unannounced_.remove (entry.get ()))
+			CM_->GetAccount ()->handleEntryRemoved (entry.get ());
 
 		return true;
 	}
 
+	QStringList ChannelHandler::GetRolePrefixes () const
+	{
+		const auto& isupport = CM_->GetISupport ();
+		const auto pos = isupport.constFind ("PREFIX");
+		return pos == isupport.constEnd () ?
+				QStringList () :
+				pos->split (')');
+	}
+
 	ChannelParticipantEntry_ptr ChannelHandler::CreateParticipantEntry (const QString& nick, bool announce)
 	{
 		ChannelParticipantEntry_ptr entry (new ChannelParticipantEntry (nick,
@@ -32,6 +32,7 @@
 
 #include <QObject>
 #include <QHash>
+#include <QSet>
 #include <interfaces/azoth/imessage.h>
 #include "localtypes.h"
 #include "channelparticipantentry.h"
@@ -62,6 +63,8 @@ namespace Acetamide
 		bool IsRosterReceived_;
 
 		QHash<QString, ChannelParticipantEntry_ptr> Nick2Entry_;
+		ChannelParticipantEntry_ptr Self_;
+		QSet<ChannelParticipantEntry*> Unannounced_;
 
 		ChannelModes ChannelMode_;
 		QString Url_;
@@ -76,6 +79,7 @@ namespace Acetamide
 
 		ChannelOptions GetChannelOptions () const;
 		QList<QObject*> GetParticipants () const;
+		int GetParticipantsCount () const;
 
 		ChannelParticipantEntry_ptr GetSelf ();
 		ChannelParticipantEntry_ptr GetParticipantEntry (const QString&, bool announce = true);
@@ -90,6 +94,12 @@ namespace Acetamide
 		bool IsRosterReceived () const;
 		void SetRosterReceived (bool);
 
+		/** Returns the participants that were added while the roster
+		 * wasn't received yet and haven't been announced to the
+		 * account, and marks them as announced.
+		 */
+		QList<QObject*> TakeUnannouncedParticipants ();
+
 		void HandleServiceMessage (const QString&, IMessage::Type,
 				IMessage::SubType,
 				ChannelParticipantEntry_ptr entry = ChannelParticipantEntry_ptr ());
@@ -98,6 +108,7 @@ namespace Acetamide
 		void HandleIncomingMessage (const QString& nick, const QString& msg);
 		void SetChannelUser (const QString& nick,
 				const QString& user = QString (), const QString& host = QString ());
+		void SetChannelUsers (const QStringList& nicks);
 
 		void MakeJoinMessage (const QString&);
 		void MakeLeaveMessage (const QString&, const QString&);
@@ -153,6 +164,9 @@ namespace Acetamide
 		void SetUrl (const QString& url);
 	private:
 		bool RemoveUserFromChannel (const QString&);
+		QStringList GetRolePrefixes () const;
+		void AddChannelUser (const QString& nick, const QString& user,
+				const QString& host, const QStringList& prefixList);
 		ChannelParticipantEntry_ptr CreateParticipantEntry (const QString&, bool announce = true);
 		void RemoveThis ();
 	public slots:
@@ -209,26 +209,23 @@ namespace Acetamide
 
 	void ChannelsManager::GotNames (const QString& channel, const QStringList& participants)
 	{
-		if (IsChannelExists (channel) &&
-				!ChannelHandlers_ [channel]->IsRosterReceived ())
-		{
-			Q_FOREACH (const QString& nick, participants)
-			{
-				if (!nick.isEmpty ())
-					ChannelHandlers_ [channel]->SetChannelUser (nick);
-			}
-		}
+		const auto& ich = ChannelHandlers_.value (channel);
+		if (ich && !ich->IsRosterReceived ())
+			ich->SetChannelUsers (participants);
 		else
 			ReceiveCmdAnswerMessage ("names", participants.join (" "), false);
 	}
 
 	void ChannelsManager::GotEndOfNamesCmd (const QString& channel)
 	{
-		if (ChannelHandlers_.contains (channel) &&
-				!ChannelHandlers_ [channel]->IsRosterReceived ())
+		const auto& ich = ChannelHandlers_.value (channel);
+		if (ich && !ich->IsRosterReceived ())
 		{
-			ChannelHandlers_ [channel]->SetRosterReceived (true);
-			ISH_->GetAccount ()->handleGotRosterItems (QObjectList () << ChannelHandlers_ [channel]->GetCLEntry ());
+			ich->SetRosterReceived (true);
+
+			auto items = ich->TakeUnannouncedParticipants ();
+			items << ich->GetCLEntry ();
+			ISH_->GetAccount ()->handleGotRosterItems (items);
 		}
 		else
 			ReceiveCmdAnswerMessage ("names", "End of /NAMES", true);
@@ -558,7 +555,7 @@ namespace Acetamide
 		if (!ChannelHandlers_.contains (channel.toLower ()))
 			return 0;
 
-		return ChannelHandlers_ [channel.toLower ()]->GetParticipants ().count ();
+		return ChannelHandlers_ [channel.toLower ()]->GetParticipantsCount ();
 	}
 
 	void ChannelsManager::ClosePrivateChat (const QString& nick)
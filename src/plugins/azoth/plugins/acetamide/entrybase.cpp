@@ -134,9 +134,17 @@ namespace Acetamide
 		proxy->GetFormatterProxy ().PreprocessMessage (msg);
 
 		AllMessages_ << msg;
+		TrimMessages ();
 		emit gotMessage (msg);
 	}
 
+	void EntryBase::TrimMessages ()
+	{
+		const auto proto = qobject_cast<IrcProtocol*> (Account_->GetParentProtocol ());
+		const auto proxy = qobject_cast<IProxyObject*> (proto->GetProxyObject ());
+		AzothUtil::StandardTrimMessages (AllMessages_, proxy->GetMessagesRetentionLimit (this));
+	}
+
 	void EntryBase::SetStatus (const EntryStatus& status)
 	{
 		CurrentStatus_ = status;
@@ -84,6 +84,10 @@ namespace Acetamide
 		void SetAvatar (const QImage&);
 		void SetRawInfo (const QString&);
 		void SetInfo (const WhoIsMessage& msg);
+	protected:
+		/** Drops the oldest messages over the retention limit.
+		 */
+		void TrimMessages ();
 
 	signals:
 		void gotMessage (QObject*);
@@ -0,0 +1,158 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#include "irclinetokenizer.h"
+
+namespace LeechCraft
+{
+namespace Azoth
+{
+namespace Acetamide
+{
+	namespace
+	{
+		bool IsAlpha (char c)
+		{
+			return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+		}
+
+		bool IsDigit (char c)
+		{
+			return c >= '0' && c <= '9';
+		}
+
+		int IndexOf (const char *data, int from, int to, char c)
+		{
+			const auto pos = static_cast<const char*> (std::memchr (data + from, c, to - from));
+			return pos ? pos - data : -1;
+		}
+
+		void ParsePrefix (const char *data, int from, int to, IrcLine& line)
+		{
+			const int at = IndexOf (data, from, to, '@');
+			const int bang = IndexOf (data, from, at >= 0 ? at : to, '!');
+
+			if (at < 0 && bang < 0)
+			{
+				// Either a server name or a bare nickname.
+				const int dot = IndexOf (data, from, to, '.');
+				line.Nick_ = { from, (dot >= 0 ? dot : to) - from };
+				line.Host_ = { from, to - from };
+				return;
+			}
+
+			const int nickEnd = bang >= 0 ? bang : at;
+			line.Nick_ = { from, nickEnd - from };
+			if (bang >= 0)
+			{
+				const int userEnd = at >= 0 ? at : to;
+				line.User_ = { bang + 1, userEnd - bang - 1 };
+			}
+			if (at >= 0)
+				line.Host_ = { at + 1, to - at - 1 };
+		}
+
+		bool ParseCommand (const char *data, int from, int to, IrcLine& line)
+		{
+			const int len = to - from;
+			if (!len)
+				return false;
+
+			line.Command_ = { from, len };
+
+			if (len == 3 && IsDigit (data [from]) && IsDigit (data [from + 1]) && IsDigit (data [from + 2]))
+			{
+				line.NumericCode_ = (data [from] - '0') * 100 +
+						(data [from + 1] - '0') * 10 +
+						(data [from + 2] - '0');
+				return true;
+			}
+
+			for (int i = from; i < to; ++i)
+				if (!IsAlpha (data [i]))
+					return false;
+
+			line.NumericCode_ = -1;
+			return true;
+		}
+	}
+
+	bool TokenizeIrcLine (const char *data, int size, IrcLine& line)
+	{
+		line = IrcLine {};
+
+		int end = size;
+		while (end > 0 && (data [end - 1] == '\n' || data [end - 1] == '\r'))
+			--end;
+
+		int pos = 0;
+		if (pos < end && data [pos] == ':')
+		{
+			const int prefixStart = ++pos;
+			const int space = IndexOf (data, pos, end, ' ');
+			if (space < 0)
+				return false;
+
+			ParsePrefix (data, prefixStart, space, line);
+			pos = space + 1;
+			while (pos < end && data [pos] == ' ')
+				++pos;
+		}
+
+		const int commandSpace = IndexOf (data, pos, end, ' ');
+		const int commandEnd = commandSpace >= 0 ? commandSpace : end;
+		if (!ParseCommand (data, pos, commandEnd, line))
+			return false;
+		pos = commandEnd;
+
+		while (pos < end)
+		{
+			// data [pos] is a space here, and there may be several of them.
+			while (pos < end && data [pos] == ' ')
+				++pos;
+			if (pos >= end)
+				break;
+
+			if (data [pos] == ':')
+			{
+				line.Trailing_ = { pos + 1, end - pos - 1 };
+				break;
+			}
+
+			const int space = IndexOf (data, pos, end, ' ');
+			const int paramEnd = space >= 0 ? space : end;
+			line.Params_.append ({ pos, paramEnd - pos });
+			pos = paramEnd;
+		}
+
+		return true;
+	}
+}
+}
+}
@@ -0,0 +1,109 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#ifndef PLUGINS_AZOTH_PLUGINS_ACETAMIDE_IRCLINETOKENIZER_H
+#define PLUGINS_AZOTH_PLUGINS_ACETAMIDE_IRCLINETOKENIZER_H
+
+#include <cstring>
+#include <QByteArray>
+#include <QVarLengthArray>
+
+namespace LeechCraft
+{
+namespace Azoth
+{
+namespace Acetamide
+{
+	/** A part of the tokenized line, referring to the original line
+	 * buffer without copying it.
+	 */
+	struct IrcLineRange
+	{
+		int Pos_;
+		int Len_;
+
+		bool IsEmpty () const
+		{
+			return !Len_;
+		}
+	};
+
+	struct IrcLine
+	{
+		IrcLineRange Nick_;
+		IrcLineRange User_;
+		IrcLineRange Host_;
+		IrcLineRange Command_;
+		IrcLineRange Trailing_;
+		QVarLengthArray<IrcLineRange, 16> Params_;
+
+		/** The numeric code of the reply, or -1 for textual commands.
+		 */
+		int NumericCode_ = -1;
+	};
+
+	/** Splits the IRC line of the given \em size pointed to by
+	 * \em data into the prefix parts, the command and the parameters
+	 * in a single pass, without allocating memory for typical lines.
+	 *
+	 * The trailing CR/LF characters are ignored.
+	 *
+	 * Returns false if the line isn't a valid IRC message.
+	 */
+	bool TokenizeIrcLine (const char *data, int size, IrcLine& line);
+
+	/** Invokes \em handler for each complete (LF-terminated) line in
+	 * the \em buffer starting at the \em from position. The lines are
+	 * passed as raw data views over the buffer, so the handler should
+	 * copy them if it needs to keep them.
+	 *
+	 * Returns the position right after the last complete line.
+	 */
+	template<typename F>
+	int ForEachIrcLine (const QByteArray& buffer, F handler, int from = 0)
+	{
+		const auto data = buffer.constData ();
+		const auto size = buffer.size ();
+		while (from < size)
+		{
+			const auto nl = static_cast<const char*> (std::memchr (data + from, '\n', size - from));
+			if (!nl)
+				break;
+
+			const int next = nl - data + 1;
+			handler (QByteArray::fromRawData (data + from, next - from));
+			from = next;
+		}
+		return from;
+	}
+}
+}
+}
+
+#endif // PLUGINS_AZOTH_PLUGINS_ACETAMIDE_IRCLINETOKENIZER_H
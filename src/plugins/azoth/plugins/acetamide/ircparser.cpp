@@ -28,12 +28,9 @@
  **********************************************************************/
 
 #include "ircparser.h"
-#include <boost/bind.hpp>
-#include <boost/spirit/include/classic_core.hpp>
-#include <boost/spirit/include/classic_loops.hpp>
-#include <boost/spirit/include/classic_push_back_actor.hpp>
 #include <QTextCodec>
 #include "ircaccount.h"
+#include "irclinetokenizer.h"
 #include "ircserverhandler.h"
 
 namespace LeechCraft
@@ -42,8 +39,6 @@ namespace Azoth
 {
 namespace Acetamide
 {
-	using namespace boost::spirit::classic;
-
 	IrcParser::IrcParser (IrcServerHandler *sh)
 	: ISH_ (sh)
 	, ServerOptions_ (sh->GetServerOptions ())
@@ -414,81 +409,46 @@ namespace Acetamide
 
 	bool IrcParser::ParseMessage (const QByteArray& message)
 	{
-		QTextCodec *codec = QTextCodec::codecForName (ISH_->
-				GetServerOptions ().ServerEncoding_.toUtf8 ());
-		const auto& msg = codec->toUnicode (message);
-
-		IrcMessageOptions_.Command_.clear ();
-		IrcMessageOptions_.Nick_.clear ();
-		IrcMessageOptions_.Message_.clear ();
-		IrcMessageOptions_.Parameters_.clear ();
-		IrcMessageOptions_.UserName_.clear ();
-		IrcMessageOptions_.Host_.clear ();
-
-		std::string nickStr;
-		std::string userStr;
-		std::string hostStr;
-		std::string commandStr;
-		std::string msgStr;
-		QList<std::string> opts;
-
-		range<> ascii (char (0x01), char (0x7F));
-		rule<> special = lexeme_d [ch_p ('[') | ']' | '\\' | '`' |
-				'_' | '^' | '{' | '|' | '}'];
-		rule<> shortname = *(alnum_p
-				>> *(alnum_p || ch_p ('-'))
-				>> *alnum_p);
-		rule<> hostname = (shortname
-				>> *(ch_p ('.')
-				>> shortname)) [assign_a (hostStr)];
-		rule<> nickname = (alpha_p | special)
-				>> *(alnum_p | special | ch_p ('-'));
-		rule<> user =  +(ascii - '\r' - '\n' - ' ' - '@' - '\0');
-		rule<> host = lexeme_d [+(anychar_p - ' ')] ;
-		rule<> nick = lexeme_d [nickname [assign_a (nickStr)]
-				>> !(!(ch_p ('!')
-				>> user [assign_a (userStr)])
-				>> ch_p ('@')
-				>> host [assign_a (hostStr)])];
-		rule<> nospcrlfcl = (anychar_p - '\0' - '\r' - '\n' -
-				' ' - ':');
-		rule<> lastParam = lexeme_d [ch_p (' ')
-				>> !ch_p (':')
-				>> (*(ch_p (':') | ch_p (' ') | nospcrlfcl))
-					[assign_a (msgStr)]];
-		rule<> firsParam = lexeme_d [ch_p (' ')
-				>> (nospcrlfcl
-				>> *(ch_p (':') | nospcrlfcl))
-					[push_back_a (opts)]];
-		rule<> params =  *firsParam
-				>> !lastParam;
-		rule<> command = longest_d [(+alpha_p) |
-				(repeat_p (3) [digit_p])] [assign_a (commandStr)];
-		rule<> prefix = longest_d [hostname | nick];
-		rule<> reply = (lexeme_d [!(ch_p (':')
-				>> prefix >> ch_p (' '))]
-				>> command
-				>> !params
-				>> eol_p);
-
-		bool res = parse (msg.toUtf8 ().constData (), reply).full;
-
-		if (!res)
+		IrcLine line;
+		if (!TokenizeIrcLine (message.constData (), message.size (), line))
 		{
 			qWarning () << "input string is not a valide IRC command"
-					<< msg;
+					<< message;
 			return false;
 		}
-		else
+
+		const auto& encoding = ISH_->GetServerOptions ().ServerEncoding_;
+		if (!LastCodec_ || LastEncoding_ != encoding)
 		{
-			IrcMessageOptions_.Nick_ = QString::fromUtf8 (nickStr.c_str ());
-			IrcMessageOptions_.Command_ = QString::fromUtf8 (commandStr.c_str ()).toLower ();
-			IrcMessageOptions_.Message_ = QString::fromUtf8 (msgStr.c_str ());
-			IrcMessageOptions_.UserName_ = QString::fromUtf8 (userStr.c_str ());
-			IrcMessageOptions_.Host_ = QString::fromUtf8 (hostStr.c_str ());
-			IrcMessageOptions_.Parameters_ = opts;
+			LastEncoding_ = encoding;
+			LastCodec_ = QTextCodec::codecForName (encoding.toUtf8 ());
+			if (!LastCodec_)
+				LastCodec_ = QTextCodec::codecForName ("UTF-8");
+			IsUtf8Codec_ = LastCodec_->mibEnum () == 106;
 		}
 
+		const auto data = message.constData ();
+		auto decode = [this, data] (const IrcLineRange& range)
+		{
+			return range.IsEmpty () ?
+					QString () :
+					LastCodec_->toUnicode (data + range.Pos_, range.Len_);
+		};
+
+		IrcMessageOptions_.Nick_ = decode (line.Nick_);
+		IrcMessageOptions_.UserName_ = decode (line.User_);
+		IrcMessageOptions_.Host_ = decode (line.Host_);
+		IrcMessageOptions_.Command_ = QString::fromLatin1 (data + line.Command_.Pos_,
+				line.Command_.Len_).toLower ();
+		IrcMessageOptions_.NumericCode_ = line.NumericCode_;
+		IrcMessageOptions_.Message_ = decode (line.Trailing_);
+
+		IrcMessageOptions_.Parameters_.clear ();
+		for (const auto& param : line.Params_)
+			IrcMessageOptions_.Parameters_ << (IsUtf8Codec_ ?
+						std::string (data + param.Pos_, param.Len_) :
+						std::string (decode (param).toUtf8 ().constData ()));
+
 		return true;
 	}
 
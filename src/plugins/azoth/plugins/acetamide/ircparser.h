@@ -34,6 +34,8 @@
 #include "core.h"
 #include "localtypes.h"
 
+class QTextCodec;
+
 namespace LeechCraft
 {
 namespace Azoth
@@ -52,6 +54,10 @@ namespace Acetamide
 		IrcMessageOptions IrcMessageOptions_;
 
 		QStringList LongAnswerCommands_;
+
+		QString LastEncoding_;
+		QTextCodec *LastCodec_ = nullptr;
+		bool IsUtf8Codec_ = false;
 	public:
 		IrcParser (IrcServerHandler*);
 
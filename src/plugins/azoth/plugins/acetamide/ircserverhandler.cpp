@@ -1032,7 +1032,7 @@ namespace Acetamide
 			return;
 
 		const auto& opts = IrcParser_->GetIrcMessageOptions ();
-		if (ErrorHandler_->IsError (opts.Command_.toInt ()))
+		if (ErrorHandler_->IsError (opts.NumericCode_))
 		{
 			ErrorHandler_->HandleError (opts);
 			if (opts.Command_ == "433")
@@ -33,6 +33,7 @@
 #include <QTextCodec>
 #include <QSettings>
 #include "ircserverhandler.h"
+#include "irclinetokenizer.h"
 #include "clientconnection.h"
 #include "sslerrorsdialog.h"
 
@@ -125,8 +126,22 @@ namespace Acetamide
 
 	void IrcServerSocket::readReply ()
 	{
-		while (Socket_ptr->canReadLine ())
-			ISH_->ReadReply (Socket_ptr->readLine ());
+		if (IsReading_)
+			return;
+
+		IsReading_ = true;
+		while (Socket_ptr->bytesAvailable () > 0)
+		{
+			ReadBuffer_ += Socket_ptr->readAll ();
+
+			const auto consumed = ForEachIrcLine (ReadBuffer_,
+					[this] (const QByteArray& line) { ISH_->ReadReply (line); });
+			if (consumed == ReadBuffer_.size ())
+				ReadBuffer_.clear ();
+			else if (consumed)
+				ReadBuffer_.remove (0, consumed);
+		}
+		IsReading_ = false;
 	}
 
 	void IrcServerSocket::handleSslErrors (const QList<QSslError>& errors)
@@ -55,6 +55,9 @@ namespace Acetamide
 		std::shared_ptr<QTcpSocket> Socket_ptr;
 
 		QTextCodec *LastCodec_ = nullptr;
+
+		QByteArray ReadBuffer_;
+		bool IsReading_ = false;
 	public:
 		IrcServerSocket (IrcServerHandler*);
 		void ConnectToHost (const QString&, int);
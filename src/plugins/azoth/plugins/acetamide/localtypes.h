@@ -108,6 +108,8 @@ namespace Acetamide
 		QString Command_;
 		QString Message_;
 		QList<std::string> Parameters_;
+
+		int NumericCode_ = -1;
 	};
 
 	struct IrcBookmark
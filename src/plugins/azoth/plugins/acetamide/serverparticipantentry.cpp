@@ -94,6 +94,7 @@ namespace Acetamide
 	{
 		for (const auto message : messages)
 			AllMessages_ << qobject_cast<IMessage*> (message);
+		TrimMessages ();
 	}
 
 };
@@ -52,7 +52,14 @@ namespace Acetamide
 
 	void ServerResponseManager::DoAction (const IrcMessageOptions& opts)
 	{
-		if (opts.Command_ == "privmsg" && IsCTCPMessage (opts.Message_))
+		if (opts.NumericCode_ >= 0 && opts.NumericCode_ < Numeric2Action_.size ())
+		{
+			if (const auto& action = Numeric2Action_.at (opts.NumericCode_))
+				action (opts);
+			else
+				ISH_->ShowAnswer ("UNKNOWN CMD " + opts.Command_, opts.Message_);
+		}
+		else if (opts.Command_ == "privmsg" && IsCTCPMessage (opts.Message_))
 			Command2Action_ ["ctcp_rpl"] (opts);
 		else if (opts.Command_ == "notice" && IsCTCPMessage (opts.Message_))
 			Command2Action_ ["ctcp_rqst"] (opts);
@@ -261,6 +268,21 @@ namespace Acetamide
 		Command2Action_ ["378"] = [this] (const IrcMessageOptions& opts)
 			{ ISH_->ShowAnswer ("278", opts.Message_); };
 
+		// Numeric replies are the bulk of the traffic, so they are
+		// dispatched by their code directly instead of by string.
+		Numeric2Action_.resize (1000);
+		for (auto i = Command2Action_.begin (); i != Command2Action_.end (); )
+		{
+			bool ok = false;
+			const int code = i.key ().toInt (&ok);
+			if (ok && i.key ().size () == 3)
+			{
+				Numeric2Action_ [code] = i.value ();
+				i = Command2Action_.erase (i);
+			}
+			else
+				++i;
+		}
 
 		MatchString2Server_ ["unreal"] = IrcServer::UnrealIRCD;
 	}
@@ -475,7 +497,7 @@ namespace Acetamide
 			return;
 
 		const QString channel = QString::fromUtf8 (opts.Parameters_.last ().c_str ());
-		const QStringList& participants = opts.Message_.split (' ');
+		const QStringList& participants = opts.Message_.split (' ', QString::SkipEmptyParts);
 		ISH_->GotNames (channel, participants);
 	}
 
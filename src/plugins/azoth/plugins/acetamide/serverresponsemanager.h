@@ -35,6 +35,7 @@
 #include <QObject>
 #include <QHash>
 #include <QMap>
+#include <QVector>
 #include "localtypes.h"
 
 namespace LeechCraft
@@ -51,7 +52,9 @@ namespace Acetamide
 		Q_OBJECT
 
 		IrcServerHandler *ISH_;
-		QHash<QString, boost::function<void (const IrcMessageOptions&)>> Command2Action_;
+		typedef boost::function<void (const IrcMessageOptions&)> Action_f;
+		QHash<QString, Action_f> Command2Action_;
+		QVector<Action_f> Numeric2Action_;
 		QMap<QString, IrcServer> MatchString2Server_;
 	public:
 		ServerResponseManager (IrcServerHandler*);
@@ -0,0 +1,222 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#include "irclinetokenizertest.h"
+#include <algorithm>
+#include <QtTest>
+#include <QFile>
+#include <QElapsedTimer>
+#include <QtDebug>
+#include "irclinetokenizer.cpp"
+
+QTEST_APPLESS_MAIN (LeechCraft::Azoth::Acetamide::IrcLineTokenizerTest)
+
+namespace LeechCraft
+{
+namespace Azoth
+{
+namespace Acetamide
+{
+	namespace
+	{
+		QByteArray Get (const QByteArray& line, const IrcLineRange& range)
+		{
+			return line.mid (range.Pos_, range.Len_);
+		}
+
+		QByteArray GetReplayLog ()
+		{
+			const auto& path = qgetenv ("ACETAMIDE_REPLAY_LOG");
+			if (!path.isEmpty ())
+			{
+				QFile file { QString::fromLocal8Bit (path) };
+				if (file.open (QIODevice::ReadOnly))
+					return file.readAll ();
+
+				qWarning () << Q_FUNC_INFO
+						<< "unable to open"
+						<< path
+						<< "falling back to the generated log";
+			}
+
+			QByteArray names;
+			for (int i = 0; i < 60; ++i)
+				names += (i % 10 ? "" : "@") + QByteArray ("somenick") + QByteArray::number (i) + ' ';
+
+			QByteArray result;
+			for (int i = 0; i < 20000; ++i)
+			{
+				const auto& num = QByteArray::number (i);
+				switch (i % 5)
+				{
+				case 0:
+					result += ":nick" + num + "!~user@host-" + num + ".example.com PRIVMSG #channel :Hello there, how is it going?\r\n";
+					break;
+				case 1:
+					result += ":nick" + num + "!~user@host-" + num + ".example.com JOIN #channel\r\n";
+					break;
+				case 2:
+					result += ":nick" + num + "!~user@host-" + num + ".example.com QUIT :*.net *.split\r\n";
+					break;
+				case 3:
+					result += ":irc.example.com 353 mynick = #channel :" + names + "\r\n";
+					break;
+				case 4:
+					result += "PING :irc.example.com\r\n";
+					break;
+				}
+			}
+			return result;
+		}
+	}
+
+	void IrcLineTokenizerTest::userPrefix ()
+	{
+		const QByteArray str { ":nick!~user@host.example.com PRIVMSG #chan :hello world\r\n" };
+		IrcLine line;
+		QVERIFY (TokenizeIrcLine (str.constData (), str.size (), line));
+		QCOMPARE (Get (str, line.Nick_), QByteArray { "nick" });
+		QCOMPARE (Get (str, line.User_), QByteArray { "~user" });
+		QCOMPARE (Get (str, line.Host_), QByteArray { "host.example.com" });
+		QCOMPARE (Get (str, line.Command_), QByteArray { "PRIVMSG" });
+		QCOMPARE (line.NumericCode_, -1);
+		QCOMPARE (line.Params_.size (), 1);
+		QCOMPARE (Get (str, line.Params_ [0]), QByteArray { "#chan" });
+		QCOMPARE (Get (str, line.Trailing_), QByteArray { "hello world" });
+	}
+
+	void IrcLineTokenizerTest::serverPrefix ()
+	{
+		const QByteArray str { ":irc.example.com NOTICE * :*** Looking up your hostname\r\n" };
+		IrcLine line;
+		QVERIFY (TokenizeIrcLine (str.constData (), str.size (), line));
+		QCOMPARE (Get (str, line.Nick_), QByteArray { "irc" });
+		QCOMPARE (Get (str, line.Host_), QByteArray { "irc.example.com" });
+		QVERIFY (line.User_.IsEmpty ());
+		QCOMPARE (Get (str, line.Trailing_), QByteArray { "*** Looking up your hostname" });
+	}
+
+	void IrcLineTokenizerTest::noPrefix ()
+	{
+		const QByteArray str { "PING :irc.example.com\r\n" };
+		IrcLine line;
+		QVERIFY (TokenizeIrcLine (str.constData (), str.size (), line));
+		QVERIFY (line.Nick_.IsEmpty ());
+		QCOMPARE (Get (str, line.Command_), QByteArray { "PING" });
+		QVERIFY (line.Params_.isEmpty ());
+		QCOMPARE (Get (str, line.Trailing_), QByteArray { "irc.example.com" });
+	}
+
+	void IrcLineTokenizerTest::numericReply ()
+	{
+		const QByteArray str { ":irc.example.com 353 mynick = #chan :@op +voice user\r\n" };
+		IrcLine line;
+		QVERIFY (TokenizeIrcLine (str.constData (), str.size (), line));
+		QCOMPARE (line.NumericCode_, 353);
+		QCOMPARE (line.Params_.size (), 3);
+		QCOMPARE (Get (str, line.Params_ [2]), QByteArray { "#chan" });
+		QCOMPARE (Get (str, line.Trailing_), QByteArray { "@op +voice user" });
+	}
+
+	void IrcLineTokenizerTest::middleParamsOnly ()
+	{
+		const QByteArray str { ":nick!user@host MODE #chan +o other\n" };
+		IrcLine line;
+		QVERIFY (TokenizeIrcLine (str.constData (), str.size (), line));
+		QCOMPARE (line.Params_.size (), 3);
+		QCOMPARE (Get (str, line.Params_ [2]), QByteArray { "other" });
+		QVERIFY (line.Trailing_.IsEmpty ());
+	}
+
+	void IrcLineTokenizerTest::repeatedSpaces ()
+	{
+		const QByteArray str { ":nick!user@host  MODE  #chan   +o other  :some  text \r\n" };
+		IrcLine line;
+		QVERIFY (TokenizeIrcLine (str.constData (), str.size (), line));
+		QCOMPARE (Get (str, line.Command_), QByteArray { "MODE" });
+		QCOMPARE (line.Params_.size (), 3);
+		QCOMPARE (Get (str, line.Params_ [0]), QByteArray { "#chan" });
+		QCOMPARE (Get (str, line.Params_ [1]), QByteArray { "+o" });
+		QCOMPARE (Get (str, line.Params_ [2]), QByteArray { "other" });
+		QCOMPARE (Get (str, line.Trailing_), QByteArray { "some  text " });
+
+		const QByteArray noTrailing { "JOIN #chan  \r\n" };
+		QVERIFY (TokenizeIrcLine (noTrailing.constData (), noTrailing.size (), line));
+		QCOMPARE (line.Params_.size (), 1);
+		QVERIFY (line.Trailing_.IsEmpty ());
+	}
+
+	void IrcLineTokenizerTest::invalidCommand ()
+	{
+		IrcLine line;
+		for (const QByteArray& str : { QByteArray { ":prefix.only\r\n" },
+				QByteArray { "\r\n" },
+				QByteArray { "12 :two digits\r\n" },
+				QByteArray { "PRIV-MSG #chan :text\r\n" } })
+			QVERIFY (!TokenizeIrcLine (str.constData (), str.size (), line));
+	}
+
+	void IrcLineTokenizerTest::lineSplitting ()
+	{
+		const QByteArray buffer { "PING :a\r\nPING :b\r\nPING :c" };
+		QList<QByteArray> lines;
+		const auto consumed = ForEachIrcLine (buffer,
+				[&lines] (const QByteArray& line) { lines << QByteArray { line.constData (), line.size () }; });
+		QCOMPARE (lines, (QList<QByteArray> { "PING :a\r\n", "PING :b\r\n" }));
+		QCOMPARE (consumed, buffer.size () - 7);
+	}
+
+	void IrcLineTokenizerTest::replayBenchmark ()
+	{
+		const auto& log = GetReplayLog ();
+
+		qint64 lines = 0;
+		qint64 bytes = 0;
+		QElapsedTimer timer;
+		timer.start ();
+		QBENCHMARK
+		{
+			IrcLine line;
+			ForEachIrcLine (log,
+					[&] (const QByteArray& str)
+					{
+						if (TokenizeIrcLine (str.constData (), str.size (), line))
+							++lines;
+						bytes += str.size ();
+					});
+		}
+		const auto elapsed = std::max<qint64> (timer.elapsed (), 1);
+
+		qDebug () << "replayed" << lines << "lines," << bytes << "bytes:"
+				<< lines * 1000 / elapsed << "lines/sec";
+		QVERIFY (lines);
+	}
+}
+}
+}
@@ -224,6 +224,53 @@ namespace AdiumStyles
 
 	bool AdiumStyleSource::AppendMessage (QWebFrame *frame,
 			QObject *msgObj, const ChatMsgAppendInfo& info)
+	{
+		return AppendMessages (frame, { { msgObj, info } });
+	}
+
+	bool AdiumStyleSource::AppendMessages (QWebFrame *frame, const QList<ChatMsgBatchItem>& batch)
+	{
+		QString script;
+		QList<QPair<QObject*, QString>> stateful;
+		bool result = true;
+		for (const auto& item : batch)
+		{
+			QString statePrefix;
+			const auto& command = MakeAppendCommand (frame, item.Message_, item.Info_, statePrefix);
+			if (command.isEmpty ())
+			{
+				result = false;
+				continue;
+			}
+
+			script += command;
+			if (!statePrefix.isEmpty ())
+				stateful.append ({ item.Message_, statePrefix });
+		}
+
+		if (script.isEmpty ())
+			return result;
+
+		frame->evaluateJavaScript (script);
+
+		for (const auto& pair : stateful)
+			UpdateDeliveryState (frame, pair.first, pair.second);
+
+		return result;
+	}
+
+	bool AdiumStyleSource::SupportsPrepend () const
+	{
+		return false;
+	}
+
+	bool AdiumStyleSource::PrependMessages (QWebFrame*, const QList<ChatMsgBatchItem>&)
+	{
+		return false;
+	}
+
+	QString AdiumStyleSource::MakeAppendCommand (QWebFrame *frame,
+			QObject *msgObj, const ChatMsgAppendInfo& info, QString& statePrefix)
 	{
 		IMessage *msg = qobject_cast<IMessage*> (msgObj);
 		if (!msg)
@@ -231,7 +278,7 @@ namespace AdiumStyles
 			qWarning () << Q_FUNC_INFO
 					<< msgObj
 					<< "doesn't implement IMessage";
-			return false;
+			return {};
 		}
 
 		const QString& pack = Frame2Pack_ [frame];
@@ -241,7 +288,7 @@ namespace AdiumStyles
 					<< "empty pack for"
 					<< msgObj
 					<< msg->OtherPart ();
-			return false;
+			return {};
 		}
 
 		connect (msgObj,
@@ -303,7 +350,7 @@ namespace AdiumStyles
 					<< "unable to load content template for"
 					<< pack
 					<< prefix;
-			return false;
+			return {};
 		}
 
 		if (!content->open (QIODevice::ReadOnly))
@@ -313,7 +360,7 @@ namespace AdiumStyles
 					<< pack
 					<< prefix
 					<< content->errorString ();
-			return false;
+			return {};
 		}
 
 		QString templ = QString::fromUtf8 (content->readAll ());
@@ -346,39 +393,44 @@ namespace AdiumStyles
 			}
 		}
 
-		const QString& command = isNextMsg ? "appendNextMessage(\"%1\");" : "appendMessage(\"%1\");";
-		frame->evaluateJavaScript (command.arg (body));
-
 		if (templ.contains ("%stateElementId%"))
-		{
-			IAdvancedMessage *advMsg = qobject_cast<IAdvancedMessage*> (msgObj);
-			QString fname;
-			if (!advMsg || advMsg->IsDelivered () || in)
-				fname = "StateSent.html";
-			else
-			{
-				fname = "StateSending.html";
-				connect (msgObj,
-						SIGNAL (messageDelivered ()),
-						this,
-						SLOT (handleMessageDelivered ()),
-						Qt::UniqueConnection);
-				Msg2Frame_ [msgObj] = frame;
-			}
+			statePrefix = prefix;
 
-			Util::QIODevice_ptr content =
-					StylesLoader_->Load (QStringList (prefix + fname));
-			QString replacement;
-			if (content && content->open (QIODevice::ReadOnly))
-				replacement = QString::fromUtf8 (content->readAll ());
+		const QString& command = isNextMsg ? "appendNextMessage(\"%1\");" : "appendMessage(\"%1\");";
+		return command.arg (body);
+	}
+
+	void AdiumStyleSource::UpdateDeliveryState (QWebFrame *frame,
+			QObject *msgObj, const QString& prefix)
+	{
+		IMessage *msg = qobject_cast<IMessage*> (msgObj);
+		const bool in = GetMsgDirection (msg) == IMessage::Direction::In;
 
-			const QString& selector = QString ("*[id=\"delivery_state_%1\"]")
-					.arg (GetMessageID (msgObj));
-			QWebElement elem = frame->findFirstElement (selector);
-			elem.setInnerXml (replacement);
+		IAdvancedMessage *advMsg = qobject_cast<IAdvancedMessage*> (msgObj);
+		QString fname;
+		if (!advMsg || advMsg->IsDelivered () || in)
+			fname = "StateSent.html";
+		else
+		{
+			fname = "StateSending.html";
+			connect (msgObj,
+					SIGNAL (messageDelivered ()),
+					this,
+					SLOT (handleMessageDelivered ()),
+					Qt::UniqueConnection);
+			Msg2Frame_ [msgObj] = frame;
 		}
 
-		return true;
+		Util::QIODevice_ptr content =
+				StylesLoader_->Load (QStringList (prefix + fname));
+		QString replacement;
+		if (content && content->open (QIODevice::ReadOnly))
+			replacement = QString::fromUtf8 (content->readAll ());
+
+		const QString& selector = QString ("*[id=\"delivery_state_%1\"]")
+				.arg (GetMessageID (msgObj));
+		QWebElement elem = frame->findFirstElement (selector);
+		elem.setInnerXml (replacement);
 	}
 
 	void AdiumStyleSource::FrameFocused (QWebFrame*)
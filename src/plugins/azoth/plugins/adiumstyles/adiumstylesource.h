@@ -36,6 +36,7 @@
 #include <QColor>
 #include <QCache>
 #include <interfaces/azoth/ichatstyleresourcesource.h>
+#include <interfaces/azoth/ibatchchatstyleresourcesource.h>
 #include "plistparser.h"
 
 namespace LeechCraft
@@ -58,9 +59,11 @@ namespace AdiumStyles
 
 	class AdiumStyleSource : public QObject
 						   , public IChatStyleResourceSource
+						   , public IBatchChatStyleResourceSource
 	{
 		Q_OBJECT
-		Q_INTERFACES (LeechCraft::Azoth::IChatStyleResourceSource)
+		Q_INTERFACES (LeechCraft::Azoth::IChatStyleResourceSource
+				LeechCraft::Azoth::IBatchChatStyleResourceSource)
 
 		std::shared_ptr<Util::ResourceLoader> StylesLoader_;
 		IProxyObject *Proxy_;
@@ -88,7 +91,13 @@ namespace AdiumStyles
 		bool AppendMessage (QWebFrame*, QObject*, const ChatMsgAppendInfo&);
 		void FrameFocused (QWebFrame*);
 		QStringList GetVariantsForPack (const QString&);
+
+		bool AppendMessages (QWebFrame*, const QList<ChatMsgBatchItem>&);
+		bool SupportsPrepend () const;
+		bool PrependMessages (QWebFrame*, const QList<ChatMsgBatchItem>&);
 	private:
+		QString MakeAppendCommand (QWebFrame*, QObject*, const ChatMsgAppendInfo&, QString&);
+		void UpdateDeliveryState (QWebFrame*, QObject*, const QString&);
 		void PercentTemplate (QString&, const QMap<QString, QString>&) const;
 		void ParseGlobalTemplate (QString& templ, ICLEntry*) const;
 		QString ParseMsgTemplate (QString templ, const QString& path,
@@ -83,6 +83,7 @@ namespace StandardStyles
 			const QString&, QObject *entryObj, QWebFrame*) const
 	{
 		Coloring2Colors_.clear ();
+		StatusImages_.clear ();
 		if (pack != LastPack_)
 		{
 			LastPack_ = pack;
@@ -148,12 +149,108 @@ namespace StandardStyles
 	bool StandardStyleSource::AppendMessage (QWebFrame *frame,
 			QObject *msgObj, const ChatMsgAppendInfo& info)
 	{
-		QObject *azothSettings = Proxy_->GetSettingsManager ();
+		return AppendMessages (frame, { { msgObj, info } });
+	}
+
+	bool StandardStyleSource::AppendMessages (QWebFrame *frame, const QList<ChatMsgBatchItem>& batch)
+	{
 		const auto& colors = CreateColors (frame->metaData ().value ("coloring"), frame);
+
+		QString html;
+		int separatorPos = -1;
+		for (const auto& item : batch)
+		{
+			if (!qobject_cast<IMessage*> (item.Message_))
+			{
+				qWarning () << Q_FUNC_INFO
+						<< item.Message_
+						<< "doesn't implement IMessage";
+				continue;
+			}
+
+			if (IsMsgReadTracked (item.Message_))
+			{
+				const auto isRead = Proxy_->IsMessageRead (item.Message_);
+				if (!item.Info_.IsActiveChat_ &&
+						!isRead && IsLastMsgRead_.value (frame, false))
+					separatorPos = html.size ();
+				IsLastMsgRead_ [frame] = isRead;
+			}
+
+			html += FormatMessage (frame, item.Message_, item.Info_, colors);
+		}
+
+		QWebElement elem = frame->findFirstElement ("body");
+		if (separatorPos >= 0)
+		{
+			auto hr = elem.findFirst ("hr[class=\"lastSeparator\"]");
+			if (!hr.isNull ())
+				hr.removeFromDocument ();
+			html.insert (separatorPos, "<hr class=\"lastSeparator\" />");
+		}
+
+		elem.appendInside (html);
+		return true;
+	}
+
+	bool StandardStyleSource::SupportsPrepend () const
+	{
+		return true;
+	}
+
+	bool StandardStyleSource::PrependMessages (QWebFrame *frame, const QList<ChatMsgBatchItem>& batch)
+	{
+		const auto& colors = CreateColors (frame->metaData ().value ("coloring"), frame);
+
+		QWebElement elem = frame->findFirstElement ("body");
+		const bool hasSeparator = !elem.findFirst ("hr[class=\"lastSeparator\"]").isNull ();
+
+		QString html;
+		int separatorPos = -1;
+		bool prevRead = false;
+		for (const auto& item : batch)
+		{
+			if (!qobject_cast<IMessage*> (item.Message_))
+			{
+				qWarning () << Q_FUNC_INFO
+						<< item.Message_
+						<< "doesn't implement IMessage";
+				continue;
+			}
+
+			if (!hasSeparator && IsMsgReadTracked (item.Message_))
+			{
+				const auto isRead = Proxy_->IsMessageRead (item.Message_);
+				if (!item.Info_.IsActiveChat_ && !isRead && prevRead)
+					separatorPos = html.size ();
+				prevRead = isRead;
+			}
+
+			html += FormatMessage (frame, item.Message_, item.Info_, colors);
+		}
+
+		if (separatorPos >= 0)
+			html.insert (separatorPos, "<hr class=\"lastSeparator\" />");
+
+		elem.prependInside (html);
+		return true;
+	}
+
+	bool StandardStyleSource::IsMsgReadTracked (QObject *msgObj) const
+	{
+		const auto msg = qobject_cast<IMessage*> (msgObj);
+		return msg &&
+				(msg->GetMessageType () == IMessage::Type::ChatMessage ||
+					msg->GetMessageType () == IMessage::Type::MUCMessage);
+	}
+
+	QString StandardStyleSource::FormatMessage (QWebFrame *frame, QObject *msgObj,
+			const ChatMsgAppendInfo& info, const QList<QColor>& colors)
+	{
+		QObject *azothSettings = Proxy_->GetSettingsManager ();
 		auto& formatter = Proxy_->GetFormatterProxy ();
 
 		const bool isHighlightMsg = info.IsHighlightMsg_;
-		const bool isActiveChat = info.IsActiveChat_;
 
 		const QString& msgId = GetMessageID (msgObj);
 
@@ -324,27 +421,9 @@ namespace StandardStyles
 					.arg (msgId));
 		string.append (body);
 
-		QWebElement elem = frame->findFirstElement ("body");
-
-		if (msg->GetMessageType () == IMessage::Type::ChatMessage ||
-			msg->GetMessageType () == IMessage::Type::MUCMessage)
-		{
-			const auto isRead = Proxy_->IsMessageRead (msgObj);
-			if (!isActiveChat &&
-					!isRead && IsLastMsgRead_.value (frame, false))
-			{
-				auto hr = elem.findFirst ("hr[class=\"lastSeparator\"]");
-				if (!hr.isNull ())
-					hr.removeFromDocument ();
-				elem.appendInside ("<hr class=\"lastSeparator\" />");
-			}
-			IsLastMsgRead_ [frame] = isRead;
-		}
-
-		elem.appendInside (QString ("<div class='%1' style='word-wrap: break-word;'>%2</div>")
-					.arg (divClass)
-					.arg (string));
-		return true;
+		return QString ("<div class='%1' style='word-wrap: break-word;'>%2</div>")
+				.arg (divClass)
+				.arg (string);
 	}
 
 	void StandardStyleSource::FrameFocused (QWebFrame *frame)
@@ -390,10 +469,13 @@ namespace StandardStyles
 	{
 		const QString& fullName = Proxy_->GetSettingsManager ()->
 				property ("SystemIcons").toString () + '/' + statusIconName;
+		if (StatusImages_.contains (fullName))
+			return StatusImages_ [fullName];
+
 		const QString& statusIconPath = Proxy_->
 				GetResourceLoader (IProxyObject::PRLSystemIcons)->GetIconPath (fullName);
 		const QImage& img = QImage (statusIconPath);
-		return Util::GetAsBase64Src (img);
+		return StatusImages_ [fullName] = Util::GetAsBase64Src (img);
 	}
 
 	void StandardStyleSource::handleMessageDelivered ()
@@ -35,6 +35,7 @@
 #include <QHash>
 #include <QColor>
 #include <interfaces/azoth/ichatstyleresourcesource.h>
+#include <interfaces/azoth/ibatchchatstyleresourcesource.h>
 
 namespace LeechCraft
 {
@@ -52,9 +53,11 @@ namespace StandardStyles
 {
 	class StandardStyleSource : public QObject
 							  , public IChatStyleResourceSource
+							  , public IBatchChatStyleResourceSource
 	{
 		Q_OBJECT
-		Q_INTERFACES (LeechCraft::Azoth::IChatStyleResourceSource)
+		Q_INTERFACES (LeechCraft::Azoth::IChatStyleResourceSource
+				LeechCraft::Azoth::IBatchChatStyleResourceSource)
 
 		std::shared_ptr<Util::ResourceLoader> StylesLoader_;
 
@@ -63,6 +66,7 @@ namespace StandardStyles
 
 		mutable QHash<QString, QList<QColor>> Coloring2Colors_;
 		mutable QString LastPack_;
+		mutable QHash<QString, QString> StatusImages_;
 
 		QHash<QObject*, QWebFrame*> Msg2Frame_;
 	public:
@@ -75,7 +79,14 @@ namespace StandardStyles
 		bool AppendMessage (QWebFrame*, QObject*, const ChatMsgAppendInfo&);
 		void FrameFocused (QWebFrame*);
 		QStringList GetVariantsForPack (const QString&);
+
+		bool AppendMessages (QWebFrame*, const QList<ChatMsgBatchItem>&);
+		bool SupportsPrepend () const;
+		bool PrependMessages (QWebFrame*, const QList<ChatMsgBatchItem>&);
 	private:
+		bool IsMsgReadTracked (QObject*) const;
+		QString FormatMessage (QWebFrame*, QObject*,
+				const ChatMsgAppendInfo&, const QList<QColor>&);
 		QList<QColor> CreateColors (const QString&, QWebFrame*);
 		QString GetMessageID (QObject*);
 		QString GetStatusImage (const QString&);
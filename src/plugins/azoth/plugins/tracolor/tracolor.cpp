@@ -134,6 +134,14 @@ namespace Tracolor
 		}
 	}
 
+	EntityFilter Plugin::GetEntityFilter () const
+	{
+		EntityFilter filter;
+		filter.Mimes_ << "x-leechcraft/notification"
+				<< "x-leechcraft/notification-rule-create";
+		return filter;
+	}
+
 	void Plugin::initPlugin (QObject *proxyObj)
 	{
 		AzothProxy_ = qobject_cast<IProxyObject*> (proxyObj);
@@ -34,6 +34,7 @@
 #include <interfaces/iplugin2.h>
 #include <interfaces/ihavesettings.h>
 #include <interfaces/ientityhandler.h>
+#include <interfaces/ientityfilter.h>
 #include <interfaces/core/ihookproxy.h>
 
 namespace LeechCraft
@@ -52,12 +53,14 @@ namespace Tracolor
 				 , public IPlugin2
 				 , public IHaveSettings
 				 , public IEntityHandler
+				 , public IEntityFilter
 	{
 		Q_OBJECT
 		Q_INTERFACES (IInfo
 				IPlugin2
 				IHaveSettings
-				IEntityHandler)
+				IEntityHandler
+				IEntityFilter)
 
 		LC_PLUGIN_METADATA ("org.LeechCraft.Azoth.Tracolor")
 
@@ -82,6 +85,8 @@ namespace Tracolor
 
 		EntityTestHandleResult CouldHandle (const Entity&) const;
 		void Handle (Entity);
+
+		EntityFilter GetEntityFilter () const;
 	public slots:
 		void initPlugin (QObject*);
 		void hookCollectContactIcons (LeechCraft::IHookProxy_ptr, QObject*, QList<QIcon>&) const;
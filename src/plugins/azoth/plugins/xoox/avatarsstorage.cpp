@@ -29,11 +29,16 @@
 
 #include "avatarsstorage.h"
 #include <memory>
+#include <algorithm>
 #include <QTimer>
 #include <QImage>
+#include <QDateTime>
+#include <QDataStream>
+#include <QPointer>
 #include <QtConcurrentRun>
 #include <QtDebug>
 #include <util/sys/paths.h>
+#include <util/sll/futures.h>
 
 namespace LeechCraft
 {
@@ -41,14 +46,50 @@ namespace Azoth
 {
 namespace Xoox
 {
-	AvatarsStorage::AvatarsStorage (QObject *parent)
+	namespace
+	{
+		const QString IndexFilename = "index";
+		const quint8 IndexVersion = 1;
+		const int MaxStoredAvatars = 4000;
+
+		QByteArray MakeKey (const QByteArray& hash, const QSize& size)
+		{
+			if (!size.isValid ())
+				return hash;
+
+			return hash + '@' + QByteArray::number (size.width ()) +
+					'x' + QByteArray::number (size.height ());
+		}
+
+		int GetCost (const QImage& image)
+		{
+			return image.byteCount () / 1024 + 1;
+		}
+
+		qint64 GetNow ()
+		{
+			return QDateTime::currentMSecsSinceEpoch () / 1000;
+		}
+	}
+
+	AvatarsStorage::AvatarsStorage (QObject *parent, int cacheSizeKb)
 	: QObject { parent }
 	, AvatarsDir_ { Util::GetUserDir (Util::UserDir::Cache, "azoth/xoox/hashed_avatars") }
+	, Cache_ { cacheSizeKb }
 	{
+		LoadIndex ();
+
 		QTimer::singleShot (30000,
 				this,
 				SLOT (collectOldAvatars ()));
 
+		const auto saveTimer = new QTimer { this };
+		connect (saveTimer,
+				SIGNAL (timeout ()),
+				this,
+				SLOT (saveIndex ()));
+		saveTimer->start (5 * 60 * 1000);
+
 		// Remove later
 		QtConcurrent::run ([] () -> void
 				{
@@ -61,6 +102,11 @@ namespace Xoox
 				});
 	}
 
+	AvatarsStorage::~AvatarsStorage ()
+	{
+		saveIndex ();
+	}
+
 	/** The clients are free to not call this function if they know the avatar is
 	 * already stored. That means that we should be beware of this when implementing
 	 * caching, if we'd ever do.
@@ -82,19 +128,180 @@ namespace Xoox
 			return;
 		}
 
+		{
+			QMutexLocker locker { &CacheLock_ };
+			for (const auto& key : Cache_.keys ())
+				if (key.startsWith (hash + '@'))
+					Cache_.remove (key);
+			Cache_.insert (hash, new QImage (image), GetCost (image));
+
+			Index_ [hash] = GetNow ();
+			IndexDirty_ = true;
+		}
+
 		QtConcurrent::run ([file, image] { image.save (file.get (), "PNG", 0); });
 	}
 
-	QImage AvatarsStorage::GetAvatar (const QByteArray& hash) const
+	QImage AvatarsStorage::GetAvatar (const QByteArray& hash, const QSize& size) const
+	{
+		const auto& cached = GetCached (hash, size);
+		if (!cached.isNull ())
+			return cached;
+
+		auto image = GetCached (hash, QSize ());
+		if (image.isNull ())
+			image = QImage (AvatarsDir_.absoluteFilePath (hash));
+
+		QMutexLocker locker { &CacheLock_ };
+		if (image.isNull ())
+		{
+			if (Index_.remove (hash))
+				IndexDirty_ = true;
+			return image;
+		}
+
+		if (!Cache_.contains (hash))
+			Cache_.insert (hash, new QImage (image), GetCost (image));
+
+		if (size.isValid ())
+		{
+			image = image.scaled (size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+			Cache_.insert (MakeKey (hash, size), new QImage (image), GetCost (image));
+		}
+
+		Index_ [hash] = GetNow ();
+		IndexDirty_ = true;
+
+		return image;
+	}
+
+	QImage AvatarsStorage::GetAvatar (const QByteArray& hash, const QSize& size,
+			QObject *context, const AvatarHandler_f& handler, const QImage& placeholder)
+	{
+		const auto& cached = GetCached (hash, size);
+		if (!cached.isNull ())
+			return cached;
+
+		const QPointer<QObject> guard { context };
+		const auto& key = MakeKey (hash, size);
+		auto& handlers = PendingLoads_ [key];
+		handlers << [guard, handler] (const QImage& image)
+				{
+					if (guard)
+						handler (image);
+				};
+		if (handlers.size () > 1)
+			return placeholder;
+
+		Util::ExecuteFuture ([this, hash, size]
+				{
+					return QtConcurrent::run ([this, hash, size] { return GetAvatar (hash, size); });
+				},
+				[this, key] (const QImage& image)
+				{
+					for (const auto& handler : PendingLoads_.take (key))
+						handler (image);
+				},
+				this);
+
+		return placeholder;
+	}
+
+	QImage AvatarsStorage::GetCached (const QByteArray& hash, const QSize& size) const
+	{
+		QMutexLocker locker { &CacheLock_ };
+		const auto image = Cache_.object (MakeKey (hash, size));
+		if (!image)
+			return {};
+
+		Index_ [hash] = GetNow ();
+		IndexDirty_ = true;
+		return *image;
+	}
+
+	void AvatarsStorage::LoadIndex ()
+	{
+		QFile file { AvatarsDir_.absoluteFilePath (IndexFilename) };
+		if (file.open (QIODevice::ReadOnly))
+		{
+			QDataStream stream { &file };
+			quint8 version = 0;
+			stream >> version;
+			if (version == IndexVersion)
+			{
+				stream >> Index_;
+				return;
+			}
+
+			qWarning () << Q_FUNC_INFO
+					<< "unknown index version"
+					<< version
+					<< ", rebuilding";
+		}
+
+		for (const auto& info : AvatarsDir_.entryInfoList (QDir::Files))
+			if (info.fileName () != IndexFilename)
+				Index_ [info.fileName ().toLatin1 ()] = info.lastModified ().toMSecsSinceEpoch () / 1000;
+		IndexDirty_ = true;
+	}
+
+	void AvatarsStorage::saveIndex ()
 	{
-		return QImage (AvatarsDir_.absoluteFilePath (hash));
+		QHash<QByteArray, qint64> index;
+		{
+			QMutexLocker locker { &CacheLock_ };
+			if (!IndexDirty_)
+				return;
+
+			index = Index_;
+			IndexDirty_ = false;
+		}
+
+		QFile file { AvatarsDir_.absoluteFilePath (IndexFilename) };
+		if (!file.open (QIODevice::WriteOnly | QIODevice::Truncate))
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to open file"
+					<< file.fileName ()
+					<< "for writing:"
+					<< file.errorString ();
+			return;
+		}
+
+		QDataStream stream { &file };
+		stream << IndexVersion << index;
 	}
 
 	void AvatarsStorage::collectOldAvatars ()
 	{
-		auto list = AvatarsDir_.entryList (QDir::Files, QDir::Time | QDir::Reversed);
-		while (list.size () > 4000)
-			AvatarsDir_.remove (list.takeLast ());
+		QList<QPair<qint64, QByteArray>> entries;
+		{
+			QMutexLocker locker { &CacheLock_ };
+			if (Index_.size () <= MaxStoredAvatars)
+				return;
+
+			for (auto i = Index_.begin (), end = Index_.end (); i != end; ++i)
+				entries.append (qMakePair (i.value (), i.key ()));
+		}
+
+		const auto toRemove = entries.size () - MaxStoredAvatars;
+		std::nth_element (entries.begin (), entries.begin () + toRemove, entries.end ());
+		entries.erase (entries.begin () + toRemove, entries.end ());
+
+		for (const auto& entry : entries)
+			AvatarsDir_.remove (QString::fromLatin1 (entry.second));
+
+		{
+			QMutexLocker locker { &CacheLock_ };
+			for (const auto& entry : entries)
+			{
+				Index_.remove (entry.second);
+				Cache_.remove (entry.second);
+			}
+			IndexDirty_ = true;
+		}
+
+		saveIndex ();
 	}
 }
 }
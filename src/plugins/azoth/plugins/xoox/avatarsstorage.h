@@ -29,10 +29,14 @@
 
 #pragma once
 
+#include <functional>
 #include <QObject>
 #include <QDir>
-
-class QImage;
+#include <QCache>
+#include <QHash>
+#include <QMutex>
+#include <QImage>
+#include <QSize>
 
 namespace LeechCraft
 {
@@ -45,12 +49,42 @@ namespace Xoox
 		Q_OBJECT
 
 		QDir AvatarsDir_;
+
+		mutable QMutex CacheLock_;
+		mutable QCache<QByteArray, QImage> Cache_;
+		mutable QHash<QByteArray, qint64> Index_;
+		mutable bool IndexDirty_ = false;
+
+		QHash<QByteArray, QList<std::function<void (QImage)>>> PendingLoads_;
 	public:
-		AvatarsStorage (QObject* = 0);
+		typedef std::function<void (QImage)> AvatarHandler_f;
+
+		AvatarsStorage (QObject* = 0, int cacheSizeKb = 8192);
+		~AvatarsStorage ();
 
 		void StoreAvatar (const QImage&, const QByteArray&);
-		QImage GetAvatar (const QByteArray&) const;
+
+		/** Returns the avatar for the given hash scaled to fit into the
+		 * given size, or the original one if the size is invalid.
+		 *
+		 * This function is thread-safe and decodes the image only if
+		 * it isn't in the cache already.
+		 */
+		QImage GetAvatar (const QByteArray&, const QSize& = QSize ()) const;
+
+		/** Returns the avatar right away if it is already decoded,
+		 * otherwise returns the placeholder and loads the avatar in a
+		 * separate thread, invoking the handler in the main thread
+		 * unless the context object is destroyed by then.
+		 */
+		QImage GetAvatar (const QByteArray&, const QSize&,
+				QObject *context, const AvatarHandler_f& handler,
+				const QImage& placeholder = QImage ());
+	private:
+		QImage GetCached (const QByteArray&, const QSize&) const;
+		void LoadIndex ();
 	private slots:
+		void saveIndex ();
 		void collectOldAvatars ();
 	};
 }
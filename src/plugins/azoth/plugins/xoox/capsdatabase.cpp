@@ -28,11 +28,17 @@
  **********************************************************************/
 
 #include "capsdatabase.h"
+#include <stdexcept>
 #include <QDataStream>
+#include <QDateTime>
+#include <QDir>
 #include <QFile>
 #include <QTimer>
+#include <QSqlDatabase>
+#include <QSqlError>
 #include <util/util.h>
 #include <util/sys/paths.h>
+#include <util/db/dblock.h>
 
 Q_DECLARE_METATYPE (QXmppDiscoveryIq::Identity);
 
@@ -77,67 +83,258 @@ namespace Azoth
 {
 namespace Xoox
 {
+	namespace
+	{
+		/** The version of the database schema, stored in SQLite's
+		 * user_version pragma. Bump it and add an upgrade step to
+		 * InitializeTables() when changing the schema.
+		 */
+		const int SchemaVersion = 1;
+
+		/** Caps hashes not seen for this many days are removed.
+		 */
+		const int ExpiryDays = 180;
+
+		const int ExpiryCheckInterval = 6 * 3600 * 1000;
+
+		const QString ConnectionName = "org.LeechCraft.Azoth.Xoox.Caps";
+
+		template<typename T>
+		QByteArray Serialize (const T& t)
+		{
+			QByteArray result;
+			{
+				QDataStream stream (&result, QIODevice::WriteOnly);
+				stream << t;
+			}
+			return result;
+		}
+
+		template<typename T>
+		T Deserialize (const QByteArray& data)
+		{
+			T result;
+			QDataStream stream (data);
+			stream >> result;
+			return result;
+		}
+
+		qint64 GetNow ()
+		{
+			return QDateTime::currentMSecsSinceEpoch () / 1000;
+		}
+	}
+
 	CapsDatabase::CapsDatabase (QObject *parent)
 	: QObject (parent)
+	, DB_ (new QSqlDatabase (QSqlDatabase::addDatabase ("QSQLITE", ConnectionName)))
+	, Cache_ (512)
 	, SaveScheduled_ (false)
 	{
 		qRegisterMetaType<QXmppDiscoveryIq::Identity> ("QXmppDiscoveryIq::Identity");
 		qRegisterMetaTypeStreamOperators<QXmppDiscoveryIq::Identity> ("QXmppDiscoveryIq::Identity");
-		Load ();
+
+		DB_->setDatabaseName (Util::CreateIfNotExists ("azoth/xoox").filePath ("caps.db"));
+		if (!DB_->open ())
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to open the database";
+			Util::DBLock::DumpError (DB_->lastError ());
+			return;
+		}
+
+		QSqlQuery pragma (*DB_);
+		pragma.exec ("PRAGMA synchronous = OFF;");
+
+		try
+		{
+			InitializeTables ();
+		}
+		catch (const std::exception& e)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to initialize the database:"
+					<< e.what ();
+			return;
+		}
+
+		PrepareQueries ();
+		MigrateLegacy ();
+
+		QTimer::singleShot (60000,
+				this,
+				SLOT (expire ()));
+
+		const auto expireTimer = new QTimer (this);
+		connect (expireTimer,
+				SIGNAL (timeout ()),
+				this,
+				SLOT (expire ()));
+		expireTimer->start (ExpiryCheckInterval);
+	}
+
+	CapsDatabase::~CapsDatabase ()
+	{
+		if (SaveScheduled_)
+			save ();
+
+		Selector_ = QSqlQuery ();
+		Inserter_ = QSqlQuery ();
+		FeaturesUpdater_ = QSqlQuery ();
+		IdentitiesUpdater_ = QSqlQuery ();
+		Toucher_ = QSqlQuery ();
+
+		DB_->close ();
+		DB_.reset ();
+		QSqlDatabase::removeDatabase (ConnectionName);
 	}
 
 	bool CapsDatabase::Contains (const QByteArray& hash) const
 	{
-		return Ver2Features_.contains (hash) &&
-				Ver2Identities_.contains (hash);
+		const auto rec = GetRecord (hash);
+		return rec && rec->HasFeatures_ && rec->HasIdentities_;
 	}
 
 	QStringList CapsDatabase::Get (const QByteArray& hash) const
 	{
-		return Ver2Features_ [hash];
+		const auto rec = GetRecord (hash);
+		return rec ? rec->Features_ : QStringList ();
 	}
 
 	void CapsDatabase::Set (const QByteArray& hash, const QStringList& features)
 	{
-		Ver2Features_ [hash] = features;
-		ScheduleSave ();
+		Store (hash, FeaturesUpdater_, Serialize (features));
+
+		if (const auto rec = Cache_.object (hash))
+		{
+			rec->HasFeatures_ = true;
+			rec->Features_ = features;
+		}
 	}
 
 	QList<QXmppDiscoveryIq::Identity> CapsDatabase::GetIdentities (const QByteArray& hash) const
 	{
-		return Ver2Identities_ [hash];
+		const auto rec = GetRecord (hash);
+		return rec ? rec->Identities_ : QList<QXmppDiscoveryIq::Identity> ();
 	}
 
 	void CapsDatabase::SetIdentities (const QByteArray& hash,
 			const QList<QXmppDiscoveryIq::Identity>& ids)
 	{
-		Ver2Identities_ [hash] = ids;
-		ScheduleSave ();
+		Store (hash, IdentitiesUpdater_, Serialize (ids));
+
+		if (const auto rec = Cache_.object (hash))
+		{
+			rec->HasIdentities_ = true;
+			rec->Identities_ = ids;
+		}
 	}
 
 	void CapsDatabase::save () const
 	{
-		QDir dir = Util::CreateIfNotExists ("azoth/xoox");
-		QFile file (dir.filePath ("caps_s.db"));
-		if (!file.open (QIODevice::WriteOnly | QIODevice::Truncate))
+		SaveScheduled_ = false;
+		if (Touched_.isEmpty () || !DB_->isOpen ())
+			return;
+
+		Util::DBLock lock (*DB_);
+		try
+		{
+			lock.Init ();
+		}
+		catch (const std::exception& e)
 		{
 			qWarning () << Q_FUNC_INFO
-					<< "unable to open file"
-					<< file.fileName ()
-					<< "for writing:"
-					<< file.errorString ();
+					<< "error locking database for transaction:"
+					<< e.what ();
 			return;
 		}
 
-		QDataStream stream (&file);
-		stream << static_cast<quint8> (2)
-				<< Ver2Features_
-				<< Ver2Identities_;
+		Toucher_.bindValue (":last_seen", GetNow ());
+		for (const auto& hash : Touched_)
+		{
+			Toucher_.bindValue (":ver", hash);
+			if (!Toucher_.exec ())
+			{
+				Util::DBLock::DumpError (Toucher_);
+				return;
+			}
+		}
 
-		SaveScheduled_ = false;
+		lock.Good ();
+		Touched_.clear ();
 	}
 
-	void CapsDatabase::ScheduleSave ()
+	void CapsDatabase::expire ()
+	{
+		if (!DB_->isOpen ())
+			return;
+
+		QSqlQuery query (*DB_);
+		query.prepare ("DELETE FROM caps WHERE LastSeen < :threshold;");
+		query.bindValue (":threshold", GetNow () - ExpiryDays * 24 * 3600);
+		if (!query.exec ())
+			Util::DBLock::DumpError (query);
+	}
+
+	const CapsDatabase::Record* CapsDatabase::GetRecord (const QByteArray& hash) const
+	{
+		if (hash.isEmpty ())
+			return nullptr;
+
+		if (!Touched_.contains (hash))
+		{
+			Touched_ << hash;
+			ScheduleSave ();
+		}
+
+		if (const auto rec = Cache_.object (hash))
+			return rec;
+
+		auto rec = new Record;
+		if (DB_->isOpen ())
+		{
+			Selector_.bindValue (":ver", hash);
+			if (!Selector_.exec ())
+				Util::DBLock::DumpError (Selector_);
+			else if (Selector_.next ())
+			{
+				const auto& features = Selector_.value (0);
+				rec->HasFeatures_ = !features.isNull ();
+				rec->Features_ = Deserialize<QStringList> (features.toByteArray ());
+
+				const auto& ids = Selector_.value (1);
+				rec->HasIdentities_ = !ids.isNull ();
+				rec->Identities_ = Deserialize<QList<QXmppDiscoveryIq::Identity>> (ids.toByteArray ());
+			}
+			Selector_.finish ();
+		}
+
+		// Unknown hashes are cached as well, so that repeated
+		// presences from the same client don't hit the database.
+		Cache_.insert (hash, rec);
+		return rec;
+	}
+
+	void CapsDatabase::Store (const QByteArray& hash, QSqlQuery& updater, const QByteArray& data)
+	{
+		if (!DB_->isOpen ())
+			return;
+
+		Inserter_.bindValue (":ver", hash);
+		Inserter_.bindValue (":last_seen", GetNow ());
+		if (!Inserter_.exec ())
+		{
+			Util::DBLock::DumpError (Inserter_);
+			return;
+		}
+
+		updater.bindValue (":ver", hash);
+		updater.bindValue (":data", data);
+		if (!updater.exec ())
+			Util::DBLock::DumpError (updater);
+	}
+
+	void CapsDatabase::ScheduleSave () const
 	{
 		if (SaveScheduled_)
 			return;
@@ -148,10 +345,73 @@ namespace Xoox
 				SLOT (save ()));
 	}
 
-	void CapsDatabase::Load ()
+	void CapsDatabase::InitializeTables ()
+	{
+		QSqlQuery query (*DB_);
+		if (!query.exec ("PRAGMA user_version;") || !query.next ())
+		{
+			Util::DBLock::DumpError (query);
+			throw std::runtime_error ("unable to get schema version");
+		}
+
+		const int version = query.value (0).toInt ();
+		query.finish ();
+		if (version == SchemaVersion)
+			return;
+
+		Util::DBLock lock (*DB_);
+		lock.Init ();
+
+		if (version > SchemaVersion)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "database schema version"
+					<< version
+					<< "is newer than the supported one, recreating";
+			query.prepare ("DROP TABLE IF EXISTS caps;");
+			Util::DBLock::Execute (query);
+		}
+
+		query.prepare ("CREATE TABLE IF NOT EXISTS caps ("
+				"Ver BLOB PRIMARY KEY, "
+				"Features BLOB, "
+				"Identities BLOB, "
+				"LastSeen INTEGER NOT NULL"
+				");");
+		Util::DBLock::Execute (query);
+		query.prepare ("CREATE INDEX IF NOT EXISTS caps_last_seen ON caps (LastSeen);");
+		Util::DBLock::Execute (query);
+		query.prepare (QString ("PRAGMA user_version = %1;").arg (SchemaVersion));
+		Util::DBLock::Execute (query);
+
+		lock.Good ();
+	}
+
+	void CapsDatabase::PrepareQueries ()
+	{
+		Selector_ = QSqlQuery (*DB_);
+		Selector_.prepare ("SELECT Features, Identities FROM caps WHERE Ver = :ver;");
+
+		Inserter_ = QSqlQuery (*DB_);
+		Inserter_.prepare ("INSERT OR IGNORE INTO caps (Ver, LastSeen) VALUES (:ver, :last_seen);");
+
+		FeaturesUpdater_ = QSqlQuery (*DB_);
+		FeaturesUpdater_.prepare ("UPDATE caps SET Features = :data WHERE Ver = :ver;");
+
+		IdentitiesUpdater_ = QSqlQuery (*DB_);
+		IdentitiesUpdater_.prepare ("UPDATE caps SET Identities = :data WHERE Ver = :ver;");
+
+		Toucher_ = QSqlQuery (*DB_);
+		Toucher_.prepare ("UPDATE caps SET LastSeen = :last_seen WHERE Ver = :ver;");
+	}
+
+	void CapsDatabase::MigrateLegacy ()
 	{
 		QDir dir = Util::CreateIfNotExists ("azoth/xoox");
 		QFile file (dir.filePath ("caps_s.db"));
+		if (!file.exists ())
+			return;
+
 		if (!file.open (QIODevice::ReadOnly))
 		{
 			qWarning () << Q_FUNC_INFO
@@ -162,6 +422,9 @@ namespace Xoox
 			return;
 		}
 
+		QHash<QByteArray, QStringList> ver2features;
+		QHash<QByteArray, QList<QXmppDiscoveryIq::Identity>> ver2identities;
+
 		QDataStream stream (&file);
 		quint8 ver = 0;
 		stream >> ver;
@@ -170,9 +433,32 @@ namespace Xoox
 					<< "unknown storage version"
 					<< ver;
 		if (ver >= 1)
-			stream >> Ver2Features_;
+			stream >> ver2features;
 		if (ver >= 2)
-			stream >> Ver2Identities_;
+			stream >> ver2identities;
+
+		Util::DBLock lock (*DB_);
+		try
+		{
+			lock.Init ();
+		}
+		catch (const std::exception& e)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "error locking database for transaction:"
+					<< e.what ();
+			return;
+		}
+
+		for (auto i = ver2features.begin (), end = ver2features.end (); i != end; ++i)
+			Store (i.key (), FeaturesUpdater_, Serialize (i.value ()));
+		for (auto i = ver2identities.begin (), end = ver2identities.end (); i != end; ++i)
+			Store (i.key (), IdentitiesUpdater_, Serialize (i.value ()));
+
+		lock.Good ();
+
+		file.close ();
+		file.remove ();
 	}
 }
 }
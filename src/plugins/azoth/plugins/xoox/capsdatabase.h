@@ -29,11 +29,17 @@
 
 #pragma once
 
+#include <memory>
 #include <QObject>
 #include <QHash>
+#include <QSet>
+#include <QCache>
 #include <QStringList>
+#include <QSqlQuery>
 #include <QXmppDiscoveryIq.h>
 
+class QSqlDatabase;
+
 namespace LeechCraft
 {
 namespace Azoth
@@ -44,11 +50,29 @@ namespace Xoox
 	{
 		Q_OBJECT
 
-		QHash<QByteArray, QStringList> Ver2Features_;
-		QHash<QByteArray, QList<QXmppDiscoveryIq::Identity>> Ver2Identities_;
+		struct Record
+		{
+			bool HasFeatures_ = false;
+			QStringList Features_;
+
+			bool HasIdentities_ = false;
+			QList<QXmppDiscoveryIq::Identity> Identities_;
+		};
+
+		std::shared_ptr<QSqlDatabase> DB_;
+
+		mutable QSqlQuery Selector_;
+		QSqlQuery Inserter_;
+		QSqlQuery FeaturesUpdater_;
+		QSqlQuery IdentitiesUpdater_;
+		mutable QSqlQuery Toucher_;
+
+		mutable QCache<QByteArray, Record> Cache_;
+		mutable QSet<QByteArray> Touched_;
 		mutable bool SaveScheduled_;
 	public:
 		CapsDatabase (QObject* = 0);
+		~CapsDatabase ();
 
 		bool Contains (const QByteArray&) const;
 		QStringList Get (const QByteArray&) const;
@@ -57,9 +81,15 @@ namespace Xoox
 		void SetIdentities (const QByteArray&, const QList<QXmppDiscoveryIq::Identity>&);
 	private slots:
 		void save () const;
+		void expire ();
 	private:
-		void ScheduleSave ();
-		void Load ();
+		const Record* GetRecord (const QByteArray&) const;
+		void Store (const QByteArray&, QSqlQuery&, const QByteArray&);
+
+		void ScheduleSave () const;
+		void InitializeTables ();
+		void PrepareQueries ();
+		void MigrateLegacy ();
 	};
 }
 }
@@ -146,8 +146,7 @@ namespace Xoox
 	, FirstTimeConnect_ (true)
 	, VCardQueue_ (new FetchQueue ([this] (QString str, bool report)
 				{
-					const auto& id = Client_->vCardManager ().requestVCard (str);
-					ErrorMgr_->Whitelist (id, report);
+					IssueVCardRequest (str, report);
 				},
 				OurJID_.contains ("gmail.com") ? 3000 : 1500, 1, this))
 	, CapsQueue_ (new FetchQueue ([this] (QString str, bool report)
@@ -406,6 +405,16 @@ namespace Xoox
 			CapsQueue_->Clear ();
 			VersionQueue_->Clear ();
 
+			PendingVCards_.clear ();
+			qDebug () << Q_FUNC_INFO
+					<< OurJID_
+					<< "vCards issued:"
+					<< VCardStats_.Issued_
+					<< "; deduplicated:"
+					<< VCardStats_.Deduplicated_
+					<< "; served from cache:"
+					<< VCardStats_.FromCache_;
+
 			IsConnected_ = false;
 			Q_FOREACH (const QString& jid, JID2CLEntry_.keys ())
 			{
@@ -831,13 +840,29 @@ namespace Xoox
 
 	void ClientConnection::FetchVCard (const QString& jid, bool reportErrors)
 	{
-		ScheduleFetchVCard (jid, reportErrors);
+		const auto& key = GetVCardKey (jid);
+		if (!reportErrors && IsVCardFresh (key))
+		{
+			++VCardStats_.FromCache_;
+			return;
+		}
+
+		ScheduleFetchVCard (key, reportErrors, true);
 	}
 
 	void ClientConnection::FetchVCard (const QString& jid, VCardCallback_t callback, bool reportErrors)
 	{
-		VCardFetchCallbacks_ [jid] << callback;
-		ScheduleFetchVCard (jid, reportErrors);
+		const auto& key = GetVCardKey (jid);
+		if (!reportErrors && ServeCachedVCard (key, callback))
+			return;
+
+		VCardFetchCallbacks_ [key] << callback;
+		ScheduleFetchVCard (key, reportErrors, reportErrors);
+	}
+
+	ClientConnection::VCardFetchStats ClientConnection::GetVCardFetchStats () const
+	{
+		return VCardStats_;
 	}
 
 	void ClientConnection::FetchVersion (const QString& jid, bool reportErrors)
@@ -1071,7 +1096,12 @@ namespace Xoox
 		if (jid.isEmpty ())
 			jid = OurBareJID_;
 
-		for (const auto& f : VCardFetchCallbacks_.take (jid))
+		const auto& key = RoomHandlers_.contains (jid) ? vcard.from () : jid;
+		PendingVCards_.remove (key);
+		PruneVCardFetchTimes ();
+		VCardFetchTimes_ [key] = QDateTime::currentDateTime ();
+
+		for (const auto& f : VCardFetchCallbacks_.take (key))
 			f (vcard);
 
 		if (JID2CLEntry_.contains (jid))
@@ -1576,13 +1606,100 @@ namespace Xoox
 		DiscoveryManager_->setClientInfoForm (XEP0232Handler::ToDataForm (si));
 	}
 
-	void ClientConnection::ScheduleFetchVCard (const QString& jid, bool report)
+	namespace
 	{
+		const int VCardReplyTimeout = 60;
+		const int VCardCacheTimeout = 600;
+	}
+
+	QString ClientConnection::GetVCardKey (const QString& jid) const
+	{
+		QString bare;
+		QString resource;
+		Split (jid, &bare, &resource);
+		return !resource.isEmpty () && !RoomHandlers_.contains (bare) ?
+				bare :
+				jid;
+	}
+
+	bool ClientConnection::IsVCardPending (const QString& key) const
+	{
+		const auto& issued = PendingVCards_.value (key);
+		return issued.isValid () &&
+				issued.secsTo (QDateTime::currentDateTime ()) < VCardReplyTimeout;
+	}
+
+	bool ClientConnection::IsVCardFresh (const QString& key) const
+	{
+		const auto& fetched = VCardFetchTimes_.value (key);
+		return fetched.isValid () &&
+				fetched.secsTo (QDateTime::currentDateTime ()) < VCardCacheTimeout;
+	}
+
+	bool ClientConnection::ServeCachedVCard (const QString& key, const VCardCallback_t& callback)
+	{
+		if (!IsVCardFresh (key))
+			return false;
+
+		QXmppVCardIq vcard;
+		if (JID2CLEntry_.contains (key))
+			vcard = JID2CLEntry_ [key]->GetVCard ();
+		else if (key == OurBareJID_)
+			vcard = SelfContact_->GetVCard ();
+		else
+			return false;
+
+		++VCardStats_.FromCache_;
+		callback (vcard);
+		return true;
+	}
+
+	void ClientConnection::PruneVCardFetchTimes ()
+	{
+		const auto& now = QDateTime::currentDateTime ();
+		if (LastVCardPrune_.isValid () &&
+				LastVCardPrune_.secsTo (now) < VCardCacheTimeout)
+			return;
+
+		LastVCardPrune_ = now;
+
+		for (auto i = VCardFetchTimes_.begin (); i != VCardFetchTimes_.end (); )
+			if (i->secsTo (now) >= VCardCacheTimeout)
+				i = VCardFetchTimes_.erase (i);
+			else
+				++i;
+	}
+
+	void ClientConnection::ScheduleFetchVCard (const QString& jid, bool report, bool urgent)
+	{
+		if (IsVCardPending (jid))
+		{
+			++VCardStats_.Deduplicated_;
+			return;
+		}
+
+		if (urgent)
+		{
+			VCardQueue_->Remove (jid);
+			IssueVCardRequest (jid, report);
+			return;
+		}
+
 		FetchQueue::Priority prio = !JID2CLEntry_.contains (jid) ||
 					JID2CLEntry_ [jid]->GetStatus (QString ()).State_ == SOffline ?
 				FetchQueue::PLow :
 				FetchQueue::PHigh;
-		VCardQueue_->Schedule (jid, prio, report);
+		if (!VCardQueue_->Schedule (jid, prio, report))
+			++VCardStats_.Deduplicated_;
+	}
+
+	void ClientConnection::IssueVCardRequest (const QString& jid, bool report)
+	{
+		PendingVCards_ [jid] = QDateTime::currentDateTime ();
+		++VCardStats_.Issued_;
+
+		const auto& id = Client_->vCardManager ().requestVCard (jid);
+		ErrorMgr_->Whitelist (id, report);
 	}
 
 	GlooxCLEntry* ClientConnection::CreateCLEntry (const QString& jid)
@@ -35,6 +35,7 @@
 #include <QMap>
 #include <QHash>
 #include <QSet>
+#include <QDateTime>
 #include <QXmppClient.h>
 #include <QXmppMucIq.h>
 #include <interfaces/azoth/imessage.h>
@@ -190,6 +191,18 @@ namespace Xoox
 		QHash<QString, PacketCallback_t> AwaitingPacketCallbacks_;
 
 		QHash<QString, QList<VCardCallback_t>> VCardFetchCallbacks_;
+		QHash<QString, QDateTime> PendingVCards_;
+		QHash<QString, QDateTime> VCardFetchTimes_;
+		QDateTime LastVCardPrune_;
+	public:
+		struct VCardFetchStats
+		{
+			quint64 Issued_ = 0;
+			quint64 Deduplicated_ = 0;
+			quint64 FromCache_ = 0;
+		};
+	private:
+		VCardFetchStats VCardStats_;
 	public:
 		ClientConnection (GlooxAccount*);
 		virtual ~ClientConnection ();
@@ -267,8 +280,16 @@ namespace Xoox
 		QObject* GetCLEntry (const QString& bareJid, const QString& variant) const;
 		GlooxCLEntry* AddODSCLEntry (OfflineDataSource_ptr);
 		QList<QObject*> GetCLEntries () const;
+		/** Fetches the vCard for the user-visible request (like a
+		 * tooltip), ahead of the queued background requests.
+		 */
 		void FetchVCard (const QString&, bool reportErrors = false);
+
+		/** Fetches the vCard in the background, or ahead of the queued
+		 * background requests if reportErrors is true.
+		 */
 		void FetchVCard (const QString&, VCardCallback_t, bool reportErrors = false);
+		VCardFetchStats GetVCardFetchStats () const;
 		void FetchVersion (const QString&, bool reportErrors = false);
 
 		QXmppBookmarkSet GetBookmarks () const;
@@ -325,7 +346,13 @@ namespace Xoox
 
 		void handleVersionSettingsChanged ();
 	private:
-		void ScheduleFetchVCard (const QString&, bool);
+		QString GetVCardKey (const QString&) const;
+		bool IsVCardPending (const QString&) const;
+		bool IsVCardFresh (const QString&) const;
+		bool ServeCachedVCard (const QString&, const VCardCallback_t&);
+		void PruneVCardFetchTimes ();
+		void ScheduleFetchVCard (const QString&, bool report, bool urgent = false);
+		void IssueVCardRequest (const QString&, bool);
 		GlooxCLEntry* CreateCLEntry (const QString&);
 		GlooxCLEntry* CreateCLEntry (const QXmppRosterIq::Item&);
 		GlooxCLEntry* ConvertFromODS (const QString&, const QXmppRosterIq::Item&);
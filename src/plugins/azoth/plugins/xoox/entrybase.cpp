@@ -47,7 +47,6 @@
 #include <util/xpc/util.h>
 #include <util/sll/qtutil.h>
 #include <util/sll/delayedexecutor.h>
-#include <util/sll/futures.h>
 #include <interfaces/azoth/iproxyobject.h>
 #include <interfaces/azoth/azothutil.h>
 #include "glooxmessage.h"
@@ -116,25 +115,15 @@ namespace Xoox
 					return;
 
 				const auto id = GetEntryID ().toUtf8 ().toHex ();
-				Util::ExecuteFuture ([id]
-						{
-							return QtConcurrent::run ([id]
-									{
-										return Core::Instance ().GetAvatarsStorage ()->GetAvatar (id);
-									});
-						},
-						[this, guard] (const QImage& newAvatar)
-						{
-							if (!guard)
-								return;
-
-							if (newAvatar.isNull ())
-								return;
-
-							Avatar_ = std::move (newAvatar);
-							emit avatarChanged (Avatar_);
-						},
-						this);
+				const auto& handler = [this] (const QImage& newAvatar)
+				{
+					if (newAvatar.isNull () || !Avatar_.isNull ())
+						return;
+
+					Avatar_ = newAvatar;
+					emit avatarChanged (Avatar_);
+				};
+				handler (Core::Instance ().GetAvatarsStorage ()->GetAvatar (id, {}, this, handler));
 			}
 		};
 	}
@@ -541,6 +530,7 @@ namespace Xoox
 		proxy->GetFormatterProxy ().PreprocessMessage (msg);
 
 		AllMessages_ << msg;
+		TrimMessages ();
 		emit gotMessage (msg);
 	}
 
@@ -876,6 +866,14 @@ namespace Xoox
 		return Variant2Version_ [var];
 	}
 
+	void EntryBase::TrimMessages ()
+	{
+		const auto proto = qobject_cast<GlooxProtocol*> (Account_->GetParentProtocol ());
+		const auto proxy = qobject_cast<IProxyObject*> (proto->GetProxyObject ());
+		AzothUtil::StandardTrimMessages (AllMessages_,
+				proxy->GetMessagesRetentionLimit (this), UnreadMessages_);
+	}
+
 	void EntryBase::HandleUserActivity (const UserActivity *activity, const QString& variant)
 	{
 		if (activity->GetGeneral () == UserActivity::GeneralEmpty)
@@ -215,6 +215,11 @@ namespace Xoox
 
 		QByteArray GetVariantVerString (const QString&) const;
 		QXmppVersionIq GetClientVersion (const QString&) const;
+	protected:
+		/** Drops the oldest messages over the retention limit, keeping
+		 * the unread ones.
+		 */
+		void TrimMessages ();
 	private:
 		void HandleUserActivity (const UserActivity*, const QString&);
 		void HandleUserMood (const UserMood*, const QString&);
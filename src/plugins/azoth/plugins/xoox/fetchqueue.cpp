@@ -51,13 +51,22 @@ namespace Xoox
 				SLOT (handleFetch ()));
 	}
 
-	void FetchQueue::Schedule (const QString& string, FetchQueue::Priority prio, bool report)
+	bool FetchQueue::Schedule (const QString& string, FetchQueue::Priority prio, bool report)
 	{
 		if (report)
 			Reports_ << string;
 
-		if (Queue_.contains (string))
-			return;
+		if (Scheduled_.contains (string))
+		{
+			if (prio == PHigh && Queue_.first () != string)
+			{
+				Queue_.removeOne (string);
+				Queue_.prepend (string);
+			}
+			return false;
+		}
+
+		Scheduled_ << string;
 
 		switch (prio)
 		{
@@ -76,11 +85,24 @@ namespace Xoox
 					SLOT (handleFetch ()));
 			FetchTimer_->start ();
 		}
+
+		return true;
+	}
+
+	bool FetchQueue::Remove (const QString& string)
+	{
+		if (!Scheduled_.remove (string))
+			return false;
+
+		Queue_.removeOne (string);
+		Reports_.remove (string);
+		return true;
 	}
 
 	void FetchQueue::Clear ()
 	{
 		Queue_.clear ();
+		Scheduled_.clear ();
 		Reports_.clear ();
 
 		if (FetchTimer_->isActive ())
@@ -93,6 +115,7 @@ namespace Xoox
 		while (num--)
 		{
 			const auto& str = Queue_.takeFirst ();
+			Scheduled_.remove (str);
 			FetchFunction_ (str, Reports_.remove (str));
 		}
 
@@ -48,6 +48,7 @@ namespace Xoox
 
 		QTimer *FetchTimer_;
 		QStringList Queue_;
+		QSet<QString> Scheduled_;
 		std::function<void (const QString&, bool)> FetchFunction_;
 		int PerShot_;
 		QSet<QString> Reports_;
@@ -60,7 +61,12 @@ namespace Xoox
 		FetchQueue (std::function<void (const QString&, bool)> func,
 				int timeout, int perShot, QObject* = 0);
 
-		void Schedule (const QString&, Priority = PLow, bool report = false);
+		/** Returns false if the string is already scheduled. A pending
+		 * low-priority string is moved to the front if it is scheduled
+		 * again with high priority.
+		 */
+		bool Schedule (const QString&, Priority = PLow, bool report = false);
+		bool Remove (const QString&);
 		void Clear ();
 	private slots:
 		void handleFetch ();
@@ -354,6 +354,7 @@ namespace Xoox
 
 		const auto msg = Account_->CreateMessage (type, variant, text, GetJID ());
 		AllMessages_ << msg;
+		TrimMessages ();
 		return msg;
 	}
 
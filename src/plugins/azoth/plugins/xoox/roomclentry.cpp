@@ -588,6 +588,7 @@ namespace Xoox
 		proxy->GetFormatterProxy ().PreprocessMessage (msg);
 
 		AllMessages_ << msg;
+		AzothUtil::StandardTrimMessages (AllMessages_, proxy->GetMessagesRetentionLimit (this));
 		emit gotMessage (msg);
 	}
 
@@ -116,6 +116,7 @@ namespace Xoox
 	{
 		const auto msg = RoomHandler_->CreateMessage (type, Nick_, body);
 		AllMessages_ << msg;
+		TrimMessages ();
 		return msg;
 	}
 
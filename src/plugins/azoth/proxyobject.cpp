@@ -419,6 +419,11 @@ namespace Azoth
 		return Core::Instance ().GetUnreadQueueManager ()->GetFirstUnreadMessage (entryObj);
 	}
 
+	int ProxyObject::GetMessagesRetentionLimit (QObject *entryObj) const
+	{
+		return Core::Instance ().GetMessagesRetentionLimit (entryObj);
+	}
+
 	IFormatterProxyObject& ProxyObject::GetFormatterProxy ()
 	{
 		return Formatter_;
@@ -100,6 +100,8 @@ namespace Azoth
 
 		QObject* GetFirstUnreadMessage (QObject *entryObj) const override;
 
+		int GetMessagesRetentionLimit (QObject *entryObj) const override;
+
 		IFormatterProxyObject& GetFormatterProxy () override;
 	};
 }
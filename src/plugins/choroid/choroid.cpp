@@ -102,6 +102,11 @@ namespace Choroid
 					<< "unknown tab class"
 					<< tabClass;
 	}
+
+	bool Plugin::IsLazy () const
+	{
+		return true;
+	}
 }
 }
 
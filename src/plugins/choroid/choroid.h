@@ -33,6 +33,7 @@
 #include <QObject>
 #include <interfaces/iinfo.h>
 #include <interfaces/ihavetabs.h>
+#include <interfaces/ilazyplugin.h>
 
 namespace LeechCraft
 {
@@ -41,9 +42,10 @@ namespace Choroid
 	class Plugin : public QObject
 				 , public IInfo
 				 , public IHaveTabs
+				 , public ILazyPlugin
 	{
 		Q_OBJECT
-		Q_INTERFACES (IInfo IHaveTabs)
+		Q_INTERFACES (IInfo IHaveTabs ILazyPlugin)
 
 		ICoreProxy_ptr Proxy_;
 		TabClassInfo TabInfo_;
@@ -58,6 +60,8 @@ namespace Choroid
 
 		TabClasses_t GetTabClasses () const;
 		void TabOpenRequested (const QByteArray&);
+
+		bool IsLazy () const;
 	signals:
 		void addNewTab (const QString&, QWidget*);
 		void removeTab (QWidget*);
@@ -0,0 +1,85 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#include "compression.h"
+#include <zlib.h>
+#include <QList>
+
+namespace LeechCraft
+{
+namespace HttHare
+{
+	bool IsCompressibleMime (const QByteArray& mime)
+	{
+		if (mime.startsWith ("text/") ||
+				mime.endsWith ("+xml") ||
+				mime.endsWith ("+json"))
+			return true;
+
+		static const QList<QByteArray> compressible
+		{
+			"application/javascript",
+			"application/json",
+			"application/xml",
+			"application/x-subrip",
+			"application/x-mpegurl",
+			"application/vnd.apple.mpegurl",
+			"audio/x-mpegurl",
+			"audio/mpegurl",
+			"audio/x-scpls"
+		};
+		return compressible.contains (mime);
+	}
+
+	QByteArray Gzip (const QByteArray& data, int level)
+	{
+		z_stream stream {};
+		if (deflateInit2 (&stream, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+			return {};
+
+		QByteArray result;
+		// deflateBound() of older zlib versions doesn't account for the gzip wrapper.
+		result.resize (deflateBound (&stream, data.size ()) + 32);
+
+		stream.next_in = reinterpret_cast<Bytef*> (const_cast<char*> (data.constData ()));
+		stream.avail_in = data.size ();
+		stream.next_out = reinterpret_cast<Bytef*> (result.data ());
+		stream.avail_out = result.size ();
+
+		const auto rc = deflate (&stream, Z_FINISH);
+		deflateEnd (&stream);
+
+		if (rc != Z_STREAM_END)
+			return {};
+
+		result.resize (stream.total_out);
+		return result;
+	}
+}
+}
@@ -30,20 +30,41 @@
 #include "connection.h"
 #include <QtDebug>
 #include "requesthandler.h"
+#include "serverstats.h"
 
 namespace LeechCraft
 {
 namespace HttHare
 {
+	void LiveConnectionSettings::Set (const ConnectionSettings& settings)
+	{
+		KeepAliveTimeout_ = settings.KeepAliveTimeout_;
+		MaxRequests_ = settings.MaxRequests_;
+	}
+
 	Connection::Connection (boost::asio::io_service& service,
-			const StorageManager& stMgr, IconResolver *resolver, TrManager *trMgr)
+			const StorageManager& stMgr, IconResolver *resolver, TrManager *trMgr,
+			MimeCache& mimeCache, DirListingCache& listingCache, CompressedCache& compressedCache,
+			const LiveConnectionSettings& settings, ServerStats& stats)
 	: Strand_ { service }
 	, Socket_ { service }
+	, IdleTimer_ { service }
 	, StorageMgr_ (stMgr)
 	, IconResolver_ { resolver }
 	, TrManager_ { trMgr }
-	, Buf_ { 2 * 1024 }
+	, MimeCache_ (mimeCache)
+	, ListingCache_ (listingCache)
+	, CompressedCache_ (compressedCache)
+	, Settings_ (settings)
+	, Stats_ (stats)
+	, Buf_ { 8 * 1024 }
+	{
+	}
+
+	Connection::~Connection ()
 	{
+		if (Started_)
+			--Stats_.ActiveConnections_;
 	}
 
 	boost::asio::ip::tcp::socket& Connection::GetSocket ()
@@ -66,13 +87,52 @@ namespace HttHare
 		return TrManager_;
 	}
 
+	MimeCache& Connection::GetMimeCache () const
+	{
+		return MimeCache_;
+	}
+
+	DirListingCache& Connection::GetListingCache () const
+	{
+		return ListingCache_;
+	}
+
+	CompressedCache& Connection::GetCompressedCache () const
+	{
+		return CompressedCache_;
+	}
+
 	const StorageManager& Connection::GetStorageManager () const
 	{
 		return StorageMgr_;
 	}
 
+	const LiveConnectionSettings& Connection::GetSettings () const
+	{
+		return Settings_;
+	}
+
+	ServerStats& Connection::GetStats () const
+	{
+		return Stats_;
+	}
+
+	bool Connection::CanKeepAlive () const
+	{
+		return ServedRequests_ < Settings_.MaxRequests_.load ();
+	}
+
 	void Connection::Start ()
 	{
+		if (!Started_)
+		{
+			Started_ = true;
+			++Stats_.ActiveConnections_;
+		}
+
+		WaitingForRequest_ = true;
+		ArmIdleTimer ();
+
 		auto conn = shared_from_this ();
 		boost::asio::async_read_until (Socket_,
 				Buf_,
@@ -81,15 +141,68 @@ namespace HttHare
 					{ conn->HandleHeader (ec, transferred); }));
 	}
 
-	void Connection::HandleHeader (const boost::system::error_code&, unsigned long transferred)
+	void Connection::FinishRequest (bool keepAlive)
 	{
+		auto conn = shared_from_this ();
+		Strand_.dispatch ([conn, keepAlive]
+				{
+					if (keepAlive)
+						conn->Start ();
+					else
+						conn->Close ();
+				});
+	}
+
+	void Connection::HandleHeader (const boost::system::error_code& ec, unsigned long transferred)
+	{
+		WaitingForRequest_ = false;
+
+		boost::system::error_code iec;
+		IdleTimer_.cancel (iec);
+
+		if (ec)
+		{
+			if (ec != boost::asio::error::eof &&
+					ec != boost::asio::error::operation_aborted)
+				qWarning () << Q_FUNC_INFO
+						<< "error reading request:"
+						<< ec.message ().c_str ();
+			Close ();
+			return;
+		}
+
 		QByteArray data;
 		data.resize (transferred);
 
 		std::istream istr (&Buf_);
 		istr.read (data.data (), transferred);
 
+		++ServedRequests_;
+
 		RequestHandler { shared_from_this () } (data);
 	}
+
+	void Connection::ArmIdleTimer ()
+	{
+		IdleTimer_.expires_from_now (boost::posix_time::seconds { Settings_.KeepAliveTimeout_.load () });
+
+		auto conn = shared_from_this ();
+		IdleTimer_.async_wait (Strand_.wrap ([conn] (const boost::system::error_code& ec)
+				{
+					if (ec == boost::asio::error::operation_aborted ||
+							!conn->WaitingForRequest_ ||
+							conn->IdleTimer_.expires_at () > boost::asio::deadline_timer::traits_type::now ())
+						return;
+
+					conn->Close ();
+				}));
+	}
+
+	void Connection::Close ()
+	{
+		boost::system::error_code ec;
+		Socket_.shutdown (boost::asio::socket_base::shutdown_both, ec);
+		Socket_.close (ec);
+	}
 }
 }
@@ -30,6 +30,7 @@
 #pragma once
 
 #include <memory>
+#include <atomic>
 #include <boost/asio.hpp>
 
 namespace LeechCraft
@@ -39,19 +40,63 @@ namespace HttHare
 	class StorageManager;
 	class IconResolver;
 	class TrManager;
+	struct ServerStats;
+	class MimeCache;
+	class DirListingCache;
+	class CompressedCache;
 
+	struct ConnectionSettings
+	{
+		int KeepAliveTimeout_;
+		int MaxRequests_;
+	};
+
+	/* Shared by all the connections of a server and read on each use, so
+	 * the settings may be changed while the server is running.
+	 */
+	struct LiveConnectionSettings
+	{
+		std::atomic<int> KeepAliveTimeout_ { 0 };
+		std::atomic<int> MaxRequests_ { 0 };
+
+		void Set (const ConnectionSettings&);
+	};
+
+	/* Requests are read one by one: the next header is read only after
+	 * the response to the previous one is written completely, so
+	 * pipelined requests are served in order on the Strand_, and the
+	 * already received data of the following requests stays in the Buf_.
+	 */
 	class Connection : public std::enable_shared_from_this<Connection>
 	{
 		boost::asio::io_service::strand Strand_;
 		boost::asio::ip::tcp::socket Socket_;
+		boost::asio::deadline_timer IdleTimer_;
 
 		const StorageManager& StorageMgr_;
 		IconResolver * const IconResolver_;
 		TrManager * const TrManager_;
+		MimeCache& MimeCache_;
+		DirListingCache& ListingCache_;
+		CompressedCache& CompressedCache_;
+
+		const LiveConnectionSettings& Settings_;
+		ServerStats& Stats_;
 
 		boost::asio::streambuf Buf_;
+
+		int ServedRequests_ = 0;
+		bool WaitingForRequest_ = false;
+
+		/* Connections are created before they are accepted, so only the
+		 * started ones are counted as active.
+		 */
+		bool Started_ = false;
 	public:
-		Connection (boost::asio::io_service&, const StorageManager&, IconResolver*, TrManager*);
+		Connection (boost::asio::io_service&, const StorageManager&,
+				IconResolver*, TrManager*, MimeCache&, DirListingCache&,
+				CompressedCache&, const LiveConnectionSettings&, ServerStats&);
+		~Connection ();
 
 		Connection (const Connection&) = delete;
 		Connection& operator= (const Connection&) = delete;
@@ -60,12 +105,22 @@ namespace HttHare
 		boost::asio::io_service::strand& GetStrand ();
 		IconResolver* GetIconResolver () const;
 		TrManager* GetTrManager () const;
+		MimeCache& GetMimeCache () const;
+		DirListingCache& GetListingCache () const;
+		CompressedCache& GetCompressedCache () const;
 
 		const StorageManager& GetStorageManager () const;
+		const LiveConnectionSettings& GetSettings () const;
+		ServerStats& GetStats () const;
+
+		bool CanKeepAlive () const;
 
 		void Start ();
+		void FinishRequest (bool);
 	private:
 		void HandleHeader (const boost::system::error_code&, unsigned long);
+		void ArmIdleTimer ();
+		void Close ();
 	};
 
 	typedef std::shared_ptr<Connection> Connection_ptr;
@@ -29,13 +29,12 @@
 
 #include "htthare.h"
 #include <QIcon>
-#include <QEventLoop>
-#include <QTimer>
 #include <xmlsettingsdialog/xmlsettingsdialog.h>
 #include <util/util.h>
 #include <util/xsd/addressesmodelmanager.h>
 #include "server.h"
 #include "xmlsettingsmanager.h"
+#include "statswidget.h"
 
 namespace LeechCraft
 {
@@ -51,16 +50,29 @@ namespace HttHare
 		connect (AddrMgr_,
 				SIGNAL (addressesChanged ()),
 				this,
-				SLOT (reapplyAddresses ()));
+				SLOT (reapplySettings ()));
 
 		XSD_.reset (new Util::XmlSettingsDialog);
 		XSD_->RegisterObject (&XmlSettingsManager::Instance (), "httharesettings.xml");
 
 		XSD_->SetDataSource ("AddressesDataView", AddrMgr_->GetModel ());
+		XSD_->SetCustomWidget ("StatsWidget",
+				new StatsWidget { [this] { return S_ ? &S_->GetStats () : nullptr; } });
 
 		XmlSettingsManager::Instance ().RegisterObject ("EnableServer",
 				this, "handleEnableServerChanged");
 		handleEnableServerChanged ();
+
+		XmlSettingsManager::Instance ().RegisterObject ({
+					"KeepAliveTimeout",
+					"MaxKeepAliveRequests"
+				},
+				this, "handleConnectionSettingsChanged");
+		XmlSettingsManager::Instance ().RegisterObject ({
+					"IOThreadsCount",
+					"PerThreadIOServices"
+				},
+				this, "reapplySettings");
 	}
 
 	void Plugin::SecondInit ()
@@ -97,6 +109,29 @@ namespace HttHare
 		return XSD_;
 	}
 
+	namespace
+	{
+		ConnectionSettings GetConnectionSettings ()
+		{
+			const auto& xsm = XmlSettingsManager::Instance ();
+			return
+			{
+				xsm.property ("KeepAliveTimeout").toInt (),
+				xsm.property ("MaxKeepAliveRequests").toInt ()
+			};
+		}
+
+		ThreadingSettings GetThreadingSettings ()
+		{
+			const auto& xsm = XmlSettingsManager::Instance ();
+			return
+			{
+				xsm.property ("IOThreadsCount").toInt (),
+				xsm.property ("PerThreadIOServices").toBool ()
+			};
+		}
+	}
+
 	void Plugin::handleEnableServerChanged ()
 	{
 		const bool enable = XmlSettingsManager::Instance ().property ("EnableServer").toBool ();
@@ -108,24 +143,28 @@ namespace HttHare
 			S_.reset ();
 		else
 		{
-			S_.reset (new Server { AddrMgr_->GetAddresses () });
+			S_.reset (new Server { AddrMgr_->GetAddresses (), GetConnectionSettings (), GetThreadingSettings () });
 			S_->Start ();
 		}
 	}
 
-	void Plugin::reapplyAddresses ()
+	void Plugin::handleConnectionSettingsChanged ()
+	{
+		if (S_)
+			S_->SetConnectionSettings (GetConnectionSettings ());
+	}
+
+	void Plugin::reapplySettings ()
 	{
 		if (!S_)
 			return;
 
-		S_->Stop ();
+		/* The acceptors are closed by the time the old server is
+		 * destroyed, and they are bound with SO_REUSEADDR, so the
+		 * addresses can be bound again right away.
+		 */
 		S_.reset ();
-
-		QEventLoop loop;
-		QTimer::singleShot (100, &loop, SLOT (quit ()));
-		loop.exec ();
-
-		S_.reset (new Server { AddrMgr_->GetAddresses () });
+		S_.reset (new Server { AddrMgr_->GetAddresses (), GetConnectionSettings (), GetThreadingSettings () });
 		S_->Start ();
 	}
 }
@@ -70,7 +70,8 @@ namespace HttHare
 		Util::XmlSettingsDialog_ptr GetSettingsDialog () const;
 	private slots:
 		void handleEnableServerChanged ();
-		void reapplyAddresses ();
+		void handleConnectionSettingsChanged ();
+		void reapplySettings ();
 	};
 }
 }
@@ -37,25 +37,76 @@ namespace LeechCraft
 {
 namespace HttHare
 {
+	QByteArray Mime2CSSClass (QByteArray mime)
+	{
+		return mime.replace ('/', '_')
+				.replace ('-', '_')
+				.replace ('.', '_')
+				.replace ('+', '_');
+	}
+
+	namespace
+	{
+		const auto IconSize = 16;
+	}
+
 	IconResolver::IconResolver (QObject *parent)
 	: QObject (parent)
 	{
 	}
 
-	void IconResolver::resolveMime (QString mimetype, QByteArray& image, int dim)
+	QByteArray IconResolver::GetStyle (const QList<QByteArray>& mimes)
 	{
-		mimetype.replace ('/', '-');
-		auto icon = QIcon::fromTheme (mimetype);
+		QByteArray result;
+
+		QMutexLocker locker { &Lock_ };
+		for (const auto& mime : mimes)
+		{
+			const auto pos = Rules_.find (mime);
+			if (pos != Rules_.end ())
+			{
+				result += *pos;
+				continue;
+			}
+
+			if (Pending_.contains (mime))
+				continue;
+
+			Pending_ << mime;
+			QMetaObject::invokeMethod (this,
+					"resolveMime",
+					Qt::QueuedConnection,
+					Q_ARG (QByteArray, mime));
+		}
+
+		return result;
+	}
+
+	void IconResolver::resolveMime (const QByteArray& mime)
+	{
+		auto iconName = QString::fromLatin1 (mime);
+		iconName.replace ('/', '-');
+		auto icon = QIcon::fromTheme (iconName);
 		if (icon.isNull ())
 		{
-			mimetype.replace ("x-", "");
-			icon = QIcon::fromTheme (mimetype);
+			iconName.replace ("x-", "");
+			icon = QIcon::fromTheme (iconName);
 		}
 
 		if (icon.isNull ())
 			icon = QIcon::fromTheme ("application-octet-stream");
 
-		image = Util::GetAsBase64Src (icon.pixmap (dim, dim).toImage ()).toLatin1 ();
+		const auto& image = Util::GetAsBase64Src (icon.pixmap (IconSize, IconSize).toImage ()).toLatin1 ();
+
+		const auto& rule = "." + Mime2CSSClass (mime) + " {" +
+				"background-image: url('" + image + "');" +
+				"background-repeat: no-repeat;" +
+				"padding-left: " + QByteArray::number (IconSize + 4) + "px;" +
+				"}";
+
+		QMutexLocker locker { &Lock_ };
+		Pending_.remove (mime);
+		Rules_ [mime] = rule;
 	}
 }
 }
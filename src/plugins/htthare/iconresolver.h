@@ -30,20 +30,34 @@
 #pragma once
 
 #include <QObject>
-
-class QImage;
+#include <QHash>
+#include <QSet>
+#include <QMutex>
 
 namespace LeechCraft
 {
 namespace HttHare
 {
+	QByteArray Mime2CSSClass (QByteArray);
+
 	class IconResolver : public QObject
 	{
 		Q_OBJECT
+
+		QMutex Lock_;
+		QHash<QByteArray, QByteArray> Rules_;
+		QSet<QByteArray> Pending_;
 	public:
 		IconResolver (QObject* = 0);
-	public slots:
-		void resolveMime (QString, QByteArray&, int);
+
+		/* Returns the pre-rendered CSS rules for the mimes that are
+		 * already resolved, scheduling resolving of the others on the
+		 * GUI thread. Never blocks on the GUI thread, thus may be
+		 * called from the I/O threads.
+		 */
+		QByteArray GetStyle (const QList<QByteArray>&);
+	private slots:
+		void resolveMime (const QByteArray&);
 	};
 }
 }
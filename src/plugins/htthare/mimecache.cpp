@@ -0,0 +1,130 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#include "mimecache.h"
+
+#ifdef Q_OS_UNIX
+#include <sys/types.h>
+#include <sys/stat.h>
+#endif
+
+#include <QFileInfo>
+#include <QFile>
+#include <QDateTime>
+
+namespace LeechCraft
+{
+namespace HttHare
+{
+	bool operator== (const MimeCacheKey& left, const MimeCacheKey& right)
+	{
+		return left.Dev_ == right.Dev_ &&
+				left.Inode_ == right.Inode_ &&
+				left.MTime_ == right.MTime_;
+	}
+
+	uint qHash (const MimeCacheKey& key)
+	{
+		return ::qHash (key.Inode_) ^ ::qHash (key.Dev_) ^ ::qHash (key.MTime_);
+	}
+
+	MimeCache::MimeCache (int maxEntries)
+	: Cache_ { maxEntries }
+	{
+	}
+
+	namespace
+	{
+		MimeCacheKey MakeKey (const QFileInfo& fi)
+		{
+#ifdef Q_OS_UNIX
+			struct stat st;
+			if (!stat (QFile::encodeName (fi.filePath ()).constData (), &st))
+				return
+				{
+					static_cast<quint64> (st.st_dev),
+					static_cast<quint64> (st.st_ino),
+					static_cast<qint64> (st.st_mtime)
+				};
+#endif
+			// No inodes here, so approximate them with the path and size.
+			return
+			{
+				static_cast<quint64> (fi.size ()),
+				::qHash (fi.absoluteFilePath ()),
+				fi.lastModified ().toMSecsSinceEpoch ()
+			};
+		}
+	}
+
+	QByteArray MimeCache::operator() (const QFileInfo& fi)
+	{
+		const auto& key = MakeKey (fi);
+
+		{
+			QMutexLocker locker { &Lock_ };
+			if (const auto mime = Cache_.object (key))
+				return *mime;
+		}
+
+		const auto& mime = Detect (fi.filePath ());
+
+		QMutexLocker locker { &Lock_ };
+		Cache_.insert (key, new QByteArray (mime));
+		return mime;
+	}
+
+	Util::MimeDetector MimeCache::TakeDetector ()
+	{
+		{
+			QMutexLocker locker { &Lock_ };
+			if (!Detectors_.empty ())
+			{
+				const auto detector = Detectors_.back ();
+				Detectors_.pop_back ();
+				return detector;
+			}
+		}
+
+		return {};
+	}
+
+	QByteArray MimeCache::Detect (const QString& path)
+	{
+		// Loading the magic database is expensive, so the detectors are
+		// reused instead of being created for each file.
+		auto detector = TakeDetector ();
+		const auto& mime = detector (path);
+
+		QMutexLocker locker { &Lock_ };
+		Detectors_.push_back (detector);
+		return mime;
+	}
+}
+}
@@ -42,18 +42,24 @@
 #endif
 
 #include <errno.h>
+#include <algorithm>
 #include <QList>
+#include <QSet>
 #include <QString>
 #include <QtDebug>
 #include <QFileInfo>
 #include <QDir>
 #include <QDateTime>
+#include <QLocale>
 #include <util/util.h>
-#include <util/sys/mimedetector.h>
 #include "connection.h"
 #include "storagemanager.h"
 #include "iconresolver.h"
 #include "trmanager.h"
+#include "serverstats.h"
+#include "mimecache.h"
+#include "compression.h"
+#include "compressedcache.h"
 
 namespace LeechCraft
 {
@@ -92,6 +98,9 @@ namespace HttHare
 			Headers_ [line.left (colonPos)] = line.mid (colonPos + 1).trimmed ();
 		}
 
+		IsHttp11_ = req.value (2).toUpper () == "HTTP/1.1";
+		KeepAlive_ = ShouldKeepAlive (req.value (2)) && !HasBody ();
+
 #ifdef QT_DEBUG
 		qDebug () << Q_FUNC_INFO << "got request";
 		qDebug () << req << Url_;
@@ -108,6 +117,34 @@ namespace HttHare
 					"Method " + verb + " not supported by this server.");
 	}
 
+	bool RequestHandler::ShouldKeepAlive (const QByteArray& version) const
+	{
+		if (!Conn_->CanKeepAlive ())
+			return false;
+
+		const auto& connHeader = Headers_.value ("Connection").toLower ();
+		if (connHeader.contains ("close"))
+			return false;
+
+		if (version.toUpper () == "HTTP/1.0")
+			return connHeader.contains ("keep-alive");
+
+		return true;
+	}
+
+	bool RequestHandler::HasBody () const
+	{
+		for (auto i = Headers_.begin (); i != Headers_.end (); ++i)
+		{
+			const auto& name = i.key ().toLower ();
+			if (name == "transfer-encoding")
+				return true;
+			if (name == "content-length" && i.value ().trimmed () != "0")
+				return true;
+		}
+		return false;
+	}
+
 	QString RequestHandler::Tr (const char *msg)
 	{
 		auto locales = Headers_ ["Accept-Language"].split (',');
@@ -129,6 +166,9 @@ namespace HttHare
 	void RequestHandler::ErrorResponse (int code,
 			const QByteArray& reason, const QByteArray& full)
 	{
+		/* The rest of a bad request can't be told apart from the next one. */
+		KeepAlive_ = false;
+
 		ResponseLine_ = "HTTP/1.1 " + QByteArray::number (code) + " " + reason + "\r\n";
 
 		ResponseBody_ = QString (R"delim(<html>
@@ -148,81 +188,189 @@ namespace HttHare
 
 	namespace
 	{
-		QString NormalizeClass (QString mime)
+		const auto StreamingThreshold = 2000;
+		const auto StreamingBatch = 500;
+
+		QFileInfoList ListDir (const QString& path)
 		{
-			return mime.replace ('/', '_')
-					.replace ('-', '_')
-					.replace ('.', '_')
-					.replace ('+', '_');
+			return QDir { path }.entryInfoList (QDir::AllEntries | QDir::NoDot,
+					QDir::Name | QDir::DirsFirst);
 		}
 
-		const auto IconSize = 16;
-	}
+		QByteArray RenderRow (const QFileInfo& item, const QByteArray& mime)
+		{
+			const auto& name = item.fileName ().toUtf8 ();
+
+			QByteArray result;
+			result += "<tr><td class=" + Mime2CSSClass (mime) + "><a href='";
+			result += QUrl::toPercentEncoding (item.fileName (), {}, "'");
+			result += "'>" + name + "</a></td>";
+			result += "<td>" + Util::MakePrettySize (item.size ()).toUtf8 () + "</td>";
+			result += "<td>" + item.created ().toString (Qt::SystemLocaleShortDate).toUtf8 () + "</td></tr>";
+			return result;
+		}
 
-	QByteArray RequestHandler::MakeDirResponse (const QFileInfo& fi, const QString& path, const QUrl& url)
-	{
-		const auto& entries = QDir { path }
-				.entryInfoList (QDir::AllEntries | QDir::NoDot,
-						QDir::Name | QDir::DirsFirst);
+		QByteArray MakeDirTail (const QByteArray& style)
+		{
+			QByteArray result { "</table>" };
+			if (!style.isEmpty ())
+				result += "<style>" + style + "</style>";
+			result += "</body></html>";
+			return result;
+		}
 
-		struct MimeInfo
+		QByteArray MakeChunk (const QByteArray& data)
 		{
-			QString MimeType_;
-		};
-		QHash<QString, QByteArray> mimeCache;
-		QList<MimeInfo> mimes;
-		Util::MimeDetector detector;
-		for (const auto& entry : entries)
+			return QByteArray::number (data.size (), 16) + "\r\n" + data + "\r\n";
+		}
+
+		boost::asio::const_buffer BA2Buffer (const QByteArray& ba)
 		{
-			const auto& type = detector (entry.filePath ());
+			return { ba.constData (), static_cast<size_t> (ba.size ()) };
+		}
 
-			if (!mimeCache.contains (type))
+		class DirStreamer : public std::enable_shared_from_this<DirStreamer>
+		{
+			const Connection_ptr Conn_;
+			const QString Path_;
+			const QFileInfoList Entries_;
+			const bool KeepAlive_;
+
+			DirListing Listing_;
+			QSet<QByteArray> Mimes_;
+			int Pos_ = 0;
+
+			QByteArray Chunk_;
+		public:
+			DirStreamer (const Connection_ptr& conn, const QString& path,
+					const QDateTime& mtime, const QFileInfoList& entries, bool keepAlive)
+			: Conn_ { conn }
+			, Path_ { path }
+			, Entries_ { entries }
+			, KeepAlive_ { keepAlive }
+			, Listing_ { mtime, {}, {} }
 			{
-				QByteArray image;
-				QMetaObject::invokeMethod (Conn_->GetIconResolver (),
-						"resolveMime",
-						Qt::BlockingQueuedConnection,
-						Q_ARG (QString, type),
-						Q_ARG (QByteArray&, image),
-						Q_ARG (int, IconSize));
-				mimeCache [type] = image;
 			}
 
-			mimes.append ({ type });
-		}
+			void WriteNext ()
+			{
+				if (Pos_ < Entries_.size ())
+				{
+					auto& mimeCache = Conn_->GetMimeCache ();
 
-		QString result;
-		result += "<html><head><title>" + fi.fileName () + "</title><style>";
-		for (auto pos = mimeCache.begin (); pos != mimeCache.end (); ++pos)
-		{
-			result += "." + NormalizeClass (pos.key ()) + " {";
-			result += "background-image: url('" + pos.value () + "');";
-			result += "background-repeat: no-repeat;";
-			result += "padding-left: " + QString::number (IconSize + 4) + ";";
-			result += "}";
-		}
-		result += "</style></head><body><h1>" + Tr ("Listing of %1").arg (url.toString ()) + "</h1>";
+					QByteArray rows;
+					for (const auto end = std::min (Pos_ + StreamingBatch, Entries_.size ());
+							Pos_ < end; ++Pos_)
+					{
+						const auto& entry = Entries_.at (Pos_);
+						const auto& mime = mimeCache (entry);
+						Mimes_ << mime;
+						rows += RenderRow (entry, mime);
+					}
+					Listing_.Rows_ += rows;
+
+					Write (MakeChunk (rows), false);
+				}
+				else
+				{
+					Listing_.Mimes_ = Mimes_.toList ();
+					Conn_->GetListingCache ().Put (Path_, Listing_);
+
+					const auto& style = Conn_->GetIconResolver ()->GetStyle (Listing_.Mimes_);
+					Write (MakeChunk (MakeDirTail (style)) + "0\r\n\r\n", true);
+				}
+			}
+		private:
+			void Write (const QByteArray& data, bool last)
+			{
+				Chunk_ = data;
+
+				auto self = shared_from_this ();
+				boost::asio::async_write (Conn_->GetSocket (),
+						boost::asio::buffer (Chunk_.constData (), Chunk_.size ()),
+						Conn_->GetStrand ().wrap ([self, last] (const boost::system::error_code& ec, ulong transferred)
+							{
+								self->Conn_->GetStats ().BytesSent_ += transferred;
+
+								if (ec)
+								{
+									qWarning () << Q_FUNC_INFO
+											<< ec.message ().c_str ();
+									self->Conn_->FinishRequest (false);
+								}
+								else if (last)
+									self->Conn_->FinishRequest (self->KeepAlive_);
+								else
+									self->WriteNext ();
+							}));
+			}
+		};
+	}
+
+	QByteArray RequestHandler::MakeDirHead (const QFileInfo& fi, const QUrl& url, const QByteArray& style)
+	{
+		QByteArray result;
+		result += "<html><head><title>" + fi.fileName ().toUtf8 () + "</title>";
+		if (!style.isEmpty ())
+			result += "<style>" + style + "</style>";
+		result += "</head><body><h1>" + Tr ("Listing of %1").arg (url.toString ()).toUtf8 () + "</h1>";
 		result += "<table style='width: 100%'><tr>";
 		result += QString ("<th style='width: 60%'>%1</th><th style='width: 20%'>%2</th><th style='width: 20%'>%3</th>")
 					.arg (Tr ("Name"))
 					.arg (Tr ("Size"))
-					.arg (Tr ("Created"));
+					.arg (Tr ("Created"))
+					.toUtf8 ();
+		return result;
+	}
 
-		for (int i = 0; i < entries.size (); ++i)
-		{
-			const auto& item = entries.at (i);
+	QByteArray RequestHandler::MakeDirResponse (const QFileInfo& fi, const DirListing& listing)
+	{
+		const auto& style = Conn_->GetIconResolver ()->GetStyle (listing.Mimes_);
+		return MakeDirHead (fi, Url_, style) + listing.Rows_ + MakeDirTail ({});
+	}
 
-			auto link = QUrl::toPercentEncoding (item.fileName (), {}, "'");
+	DirListing RequestHandler::RenderListing (const QFileInfo& fi, const QFileInfoList& entries)
+	{
+		auto& mimeCache = Conn_->GetMimeCache ();
 
-			result += "<tr><td class=" + NormalizeClass (mimes.at (i).MimeType_) + "><a href='";
-			result += link + "'>" + item.fileName () + "</a></td>";
-			result += "<td>" + Util::MakePrettySize (item.size ()) + "</td>";
-			result += "<td>" + item.created ().toString (Qt::SystemLocaleShortDate) + "</td></tr>";
+		DirListing listing { fi.lastModified (), {}, {} };
+		QSet<QByteArray> mimes;
+		for (const auto& entry : entries)
+		{
+			const auto& mime = mimeCache (entry);
+			mimes << mime;
+			listing.Rows_ += RenderRow (entry, mime);
 		}
+		listing.Mimes_ = mimes.toList ();
+		return listing;
+	}
+
+	void RequestHandler::StreamDir (const QString& path, const QFileInfo& fi, const QFileInfoList& entries)
+	{
+		ResponseHeaders_.append ({ "Transfer-Encoding", "chunked" });
+		ResponseBody_ = MakeChunk (MakeDirHead (fi, Url_, {}));
+
+		const auto streamer = std::make_shared<DirStreamer> (Conn_,
+				path, fi.lastModified (), entries, KeepAlive_);
 
-		result += "</table></body></html>";
+		auto c = Conn_;
+		const auto& buffers = ToBuffers (Verb::Get);
+		const auto& holder = GetBuffersData ();
+		boost::asio::async_write (c->GetSocket (),
+				buffers,
+				c->GetStrand ().wrap ([c, streamer, holder] (const boost::system::error_code& ec, ulong transferred)
+					{
+						c->GetStats ().BytesSent_ += transferred;
 
-		return result.toUtf8 ();
+						if (ec)
+						{
+							qWarning () << Q_FUNC_INFO
+									<< ec.message ().c_str ();
+							c->FinishRequest (false);
+						}
+						else
+							streamer->WriteNext ();
+					}));
 	}
 
 	namespace
@@ -312,6 +460,7 @@ namespace HttHare
 		struct Sendfiler
 		{
 			boost::asio::ip::tcp::socket& Sock_;
+			ServerStats& Stats_;
 			std::shared_ptr<QFile> File_;
 			off_t Offset_;
 
@@ -357,6 +506,7 @@ namespace HttHare
 					{
 						CurrentRange_.first = offset;
 						toTransfer -= transferred;
+						Stats_.BytesSent_ += transferred;
 					}
 
 					if (ec == boost::asio::error::interrupted)
@@ -443,39 +593,258 @@ namespace HttHare
 
 	void RequestHandler::WriteDir (const QString& path, const QFileInfo& fi, RequestHandler::Verb verb)
 	{
-		if (Url_.path ().endsWith ('/'))
+		if (!Url_.path ().endsWith ('/'))
 		{
-			ResponseLine_ = "HTTP/1.1 200 OK\r\n";
+			ResponseLine_ = "HTTP/1.1 301 Moved Permanently\r\n";
 
+			auto url = Url_;
+			url.setPath (url.path () + '/');
+			const auto& location = url.toEncoded ();
+			ResponseHeaders_.append ({ "Location", location });
 			ResponseHeaders_.append ({ "Content-Type", "text/html; charset=utf-8" });
-			ResponseBody_ = MakeDirResponse (fi, path, Url_);
+			ResponseBody_ = "<html><body><a href='" + location + "'>" + location + "</a></body></html>";
 
 			DefaultWrite (verb);
+			return;
 		}
-		else
-		{
-			ResponseLine_ = "HTTP/1.1 301 Moved Permanently\r\n";
 
-			auto url = Url_;
-			url.setPath (url.path () + '/');
-			ResponseHeaders_.append ({ "Location", url.toString ().toUtf8 () });
-			ResponseBody_ = MakeDirResponse (fi, path, url);
+		ResponseLine_ = "HTTP/1.1 200 OK\r\n";
+		ResponseHeaders_.append ({ "Content-Type", "text/html; charset=utf-8" });
 
+		auto& cache = Conn_->GetListingCache ();
+		if (const auto& listing = cache.Get (path, fi.lastModified ()))
+		{
+			ResponseBody_ = MakeDirResponse (fi, *listing);
 			DefaultWrite (verb);
+			return;
+		}
+
+		const auto& entries = ListDir (path);
+		if (verb == Verb::Get && IsHttp11_ && entries.size () > StreamingThreshold)
+		{
+			StreamDir (path, fi, entries);
+			return;
+		}
+
+		const auto& listing = RenderListing (fi, entries);
+		cache.Put (path, listing);
+
+		ResponseBody_ = MakeDirResponse (fi, listing);
+		DefaultWrite (verb);
+	}
+
+	namespace
+	{
+		const auto MaxOnTheFlyCompressionSize = 8 * 1024 * 1024;
+
+		QByteArray FormatHttpDate (const QDateTime& dt)
+		{
+			return QLocale::c ().toString (dt.toUTC (), "ddd, dd MMM yyyy hh:mm:ss 'GMT'").toLatin1 ();
+		}
+
+		QDateTime ParseHttpDate (QString str)
+		{
+			str = str.trimmed ();
+			if (str.endsWith (" GMT"))
+				str.chop (4);
+
+			auto dt = QLocale::c ().toDateTime (str, "ddd, dd MMM yyyy hh:mm:ss");
+			dt.setTimeSpec (Qt::UTC);
+			return dt;
+		}
+
+		QByteArray MakeETag (const QFileInfo& fi, const QByteArray& encoding)
+		{
+			auto tag = QByteArray::number (fi.size (), 16) + "-" +
+					QByteArray::number (fi.lastModified ().toMSecsSinceEpoch (), 16);
+			if (!encoding.isEmpty ())
+				tag += "-" + encoding;
+			return '"' + tag + '"';
+		}
+	}
+
+	bool RequestHandler::AcceptsEncoding (const QByteArray& encoding) const
+	{
+		for (auto value : Headers_.value ("Accept-Encoding").toLatin1 ().split (','))
+		{
+			const auto& params = value.split (';');
+			if (params.value (0).trimmed ().toLower () != encoding)
+				continue;
+
+			for (auto param : params.mid (1))
+			{
+				param = param.trimmed ();
+				if (param.startsWith ("q=") && !param.mid (2).toDouble ())
+					return false;
+			}
+
+			return true;
 		}
+
+		return false;
 	}
 
-	void RequestHandler::WriteFile (const QString& path, const QFileInfo& fi, RequestHandler::Verb verb)
+	bool RequestHandler::IsNotModified (const QByteArray& etag, const QDateTime& lastModified) const
+	{
+		const auto& inm = Headers_.value ("If-None-Match").toLatin1 ();
+		if (!inm.isEmpty ())
+		{
+			for (auto tag : inm.split (','))
+			{
+				tag = tag.trimmed ();
+				if (tag.startsWith ("W/"))
+					tag = tag.mid (2);
+				if (tag == "*" || tag == etag)
+					return true;
+			}
+
+			return false;
+		}
+
+		const auto& ims = Headers_.value ("If-Modified-Since");
+		if (ims.isEmpty ())
+			return false;
+
+		const auto& since = ParseHttpDate (ims);
+		return since.isValid () &&
+				lastModified.toTime_t () <= since.toTime_t ();
+	}
+
+	QByteArray RequestHandler::GetCompressedFile (const QString& path, const QByteArray& etag)
+	{
+		auto& cache = Conn_->GetCompressedCache ();
+
+		auto result = cache.Get (path, etag);
+		if (!result.isNull ())
+			return result;
+
+		QFile file { path };
+		if (!file.open (QIODevice::ReadOnly))
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to open"
+					<< path
+					<< file.errorString ();
+			return {};
+		}
+
+		result = Gzip (file.readAll ());
+		if (!result.isNull ())
+			cache.Put (path, etag, result);
+		return result;
+	}
+
+	void RequestHandler::WriteFile (const QString& origPath, const QFileInfo& fi, RequestHandler::Verb verb)
 	{
 		auto ranges = ParseRanges (Headers_.value ("Range"), fi.size ());
 
-		const auto& mime = Util::MimeDetector {} (path);
+		const auto& mime = Conn_->GetMimeCache () (fi);
 		ResponseHeaders_.append ({ "Content-Type", mime });
 
+		const auto compressible = IsCompressibleMime (mime);
+		if (compressible)
+			ResponseHeaders_.append ({ "Vary", "Accept-Encoding" });
+
+		enum class Source
+		{
+			Identity,
+			Precompressed,
+			OnTheFly
+		} source = Source::Identity;
+
+		auto path = origPath;
+		auto size = fi.size ();
+
+		if (compressible && ranges.isEmpty () && AcceptsEncoding ("gzip"))
+		{
+			const QFileInfo gzFi { origPath + ".gz" };
+			if (gzFi.isFile () && gzFi.lastModified () >= fi.lastModified ())
+			{
+				source = Source::Precompressed;
+				path = gzFi.filePath ();
+				size = gzFi.size ();
+			}
+			else if (fi.size () <= MaxOnTheFlyCompressionSize)
+				source = Source::OnTheFly;
+		}
+
+		/* The precompressed file may differ byte-wise from what gets
+		 * compressed on the fly, so they have different tags.
+		 */
+		QByteArray etag;
+		switch (source)
+		{
+		case Source::Identity:
+			etag = MakeETag (fi, {});
+			break;
+		case Source::Precompressed:
+			etag = MakeETag (QFileInfo { path }, "gzip-static");
+			break;
+		case Source::OnTheFly:
+			etag = MakeETag (fi, "gzip");
+			break;
+		}
+		ResponseHeaders_.append ({ "ETag", etag });
+		ResponseHeaders_.append ({ "Last-Modified", FormatHttpDate (fi.lastModified ()) });
+
+		if (IsNotModified (etag, fi.lastModified ()))
+		{
+			ResponseLine_ = "HTTP/1.1 304 Not Modified\r\n";
+			DefaultWrite (verb);
+			return;
+		}
+
+		if (source == Source::OnTheFly)
+		{
+			/* HEAD isn't worth compressing the whole file for, so the
+			 * length is only reported if it's already known.
+			 */
+			if (verb == Verb::Head)
+			{
+				const auto& cached = Conn_->GetCompressedCache ().Get (origPath, etag);
+				if (!cached.isNull ())
+					ResponseHeaders_.append ({ "Content-Length", QByteArray::number (cached.size ()) });
+
+				ResponseLine_ = "HTTP/1.1 200 OK\r\n";
+				ResponseHeaders_.append ({ "Content-Encoding", "gzip" });
+				DefaultWrite (verb);
+				return;
+			}
+
+			ResponseBody_ = GetCompressedFile (origPath, etag);
+			if (ResponseBody_.isNull ())
+			{
+				/* Accept-Ranges, Vary and ETag still describe the
+				 * resource, but the body is now the error page.
+				 */
+				const auto remBegin = std::remove_if (ResponseHeaders_.begin (), ResponseHeaders_.end (),
+						[] (decltype (ResponseHeaders_.at (0)) pair)
+						{
+							const auto& name = pair.first.toLower ();
+							return name == "content-encoding" ||
+									name == "content-length" ||
+									name == "content-type";
+						});
+				ResponseHeaders_.erase (remBegin, ResponseHeaders_.end ());
+				ResponseHeaders_.append ({ "Content-Type", "text/html; charset=utf-8" });
+
+				ErrorResponse (500, "Internal Server Error");
+				return;
+			}
+
+			ResponseLine_ = "HTTP/1.1 200 OK\r\n";
+			ResponseHeaders_.append ({ "Content-Encoding", "gzip" });
+			DefaultWrite (verb);
+			return;
+		}
+
+		if (source == Source::Precompressed)
+			ResponseHeaders_.append ({ "Content-Encoding", "gzip" });
+
 		if (ranges.isEmpty ())
 		{
 			ResponseLine_ = "HTTP/1.1 200 OK\r\n";
-			ResponseHeaders_.append ({ "Content-Length", QByteArray::number (fi.size ()) });
+			ResponseHeaders_.append ({ "Content-Length", QByteArray::number (size) });
 		}
 		else
 		{
@@ -489,24 +858,30 @@ namespace HttHare
 		}
 
 		auto c = Conn_;
+		const auto keepAlive = KeepAlive_;
+		const auto& buffers = ToBuffers (verb);
+		const auto& holder = GetBuffersData ();
 		boost::asio::async_write (c->GetSocket (),
-				ToBuffers (verb),
-				c->GetStrand ().wrap ([c, path, verb, ranges] (boost::system::error_code ec, ulong) mutable -> void
+				buffers,
+				c->GetStrand ().wrap ([c, path, verb, ranges, keepAlive, holder] (boost::system::error_code ec, ulong transferred) mutable -> void
 					{
+						c->GetStats ().BytesSent_ += transferred;
+
 						if (ec)
+						{
 							qWarning () << Q_FUNC_INFO
 									<< ec.message ().c_str ();
+							c->FinishRequest (false);
+							return;
+						}
 
 						auto& s = c->GetSocket ();
 
-						std::shared_ptr<void> shutdownGuard = std::shared_ptr<void> (nullptr,
-								[&s, &ec] (void*)
-								{
-									s.shutdown (boost::asio::socket_base::shutdown_both, ec);
-								});
-
 						if (verb != Verb::Get)
+						{
+							c->FinishRequest (keepAlive);
 							return;
+						}
 
 						std::shared_ptr<QFile> file { new QFile { path } };
 						file->open (QIODevice::ReadOnly);
@@ -521,11 +896,13 @@ namespace HttHare
 						Sendfiler
 						{
 							s,
+							c->GetStats (),
 							file,
 							0,
 							headRange,
 							ranges,
-							[c, shutdownGuard] (boost::system::error_code, ulong) {}
+							[c, keepAlive] (boost::system::error_code ec, ulong)
+								{ c->FinishRequest (keepAlive && !ec); }
 						} (ec, 0);
 					}));
 	}
@@ -533,57 +910,79 @@ namespace HttHare
 	void RequestHandler::DefaultWrite (Verb verb)
 	{
 		auto c = Conn_;
+		const auto keepAlive = KeepAlive_;
+		const auto& buffers = ToBuffers (verb);
+		const auto& holder = GetBuffersData ();
 		boost::asio::async_write (c->GetSocket (),
-				ToBuffers (verb),
-				c->GetStrand ().wrap ([c] (const boost::system::error_code& ec, ulong)
+				buffers,
+				c->GetStrand ().wrap ([c, keepAlive, holder] (const boost::system::error_code& ec, ulong transferred)
 					{
+						c->GetStats ().BytesSent_ += transferred;
+
 						if (ec)
 							qWarning () << Q_FUNC_INFO
 									<< ec.message ().c_str ();
 
-						boost::system::error_code iec;
-						c->GetSocket ().shutdown (boost::asio::socket_base::shutdown_both, iec);
+						c->FinishRequest (keepAlive && !ec);
 					}));
 	}
 
-	namespace
+	QList<QByteArray> RequestHandler::GetBuffersData () const
 	{
-		boost::asio::const_buffer BA2Buffer (const QByteArray& ba)
-		{
-			return { ba.constData (), static_cast<size_t> (ba.size ()) };
-		}
-
-		bool SupportsDeflate (const QStringList& ae)
-		{
-			for (const auto& val : ae)
-				if (!val.trimmed ().compare ("deflate", Qt::CaseInsensitive))
-					return true;
-
-			return false;
-		}
+		return { ResponseLine_, CookedRH_, ResponseBody_ };
 	}
 
 	std::vector<boost::asio::const_buffer> RequestHandler::ToBuffers (Verb verb)
 	{
 		std::vector<boost::asio::const_buffer> result;
 
-		const bool hasContentLength = std::find_if (ResponseHeaders_.begin (), ResponseHeaders_.end (),
-				[] (decltype (ResponseHeaders_.at (0)) pair)
-					{ return pair.first.toLower () == "content-length"; }) != ResponseHeaders_.end ();
-
-		const auto& splitAe = Headers_.value ("Accept-Encoding").split (',');
-		if (verb == Verb::Get &&
+		const auto hasHeader = [this] (const QByteArray& name)
+		{
+			return std::find_if (ResponseHeaders_.begin (), ResponseHeaders_.end (),
+					[&name] (decltype (ResponseHeaders_.at (0)) pair)
+						{ return pair.first.toLower () == name; }) != ResponseHeaders_.end ();
+		};
+		const bool hasContentLength = hasHeader ("content-length");
+		const bool isChunked = hasHeader ("transfer-encoding");
+		const bool isNotModified = ResponseLine_.startsWith ("HTTP/1.1 304");
+
+		/* HEAD goes through the same encoding decision as GET so that the
+		 * reported length matches.
+		 */
+		if (!isChunked &&
 				!ResponseBody_.isEmpty () &&
-				SupportsDeflate (splitAe))
+				!hasHeader ("content-encoding"))
 		{
-			ResponseHeaders_.append ({ "Content-Encoding", "deflate" });
-			ResponseBody_ = qCompress (ResponseBody_, 6);
-			ResponseBody_.remove (0, 4);
+			if (AcceptsEncoding ("gzip"))
+			{
+				ResponseHeaders_.append ({ "Content-Encoding", "gzip" });
+				ResponseBody_ = Gzip (ResponseBody_);
+			}
+			else if (AcceptsEncoding ("deflate"))
+			{
+				ResponseHeaders_.append ({ "Content-Encoding", "deflate" });
+				ResponseBody_ = qCompress (ResponseBody_, 6);
+				ResponseBody_.remove (0, 4);
+			}
 		}
 
-		if (!hasContentLength)
+		const bool hasUnknownLength = verb == Verb::Head &&
+				hasHeader ("content-encoding") &&
+				ResponseBody_.isNull ();
+		if (!hasContentLength && !isChunked && !isNotModified && !hasUnknownLength)
 			ResponseHeaders_.append ({ "Content-Length", QByteArray::number (ResponseBody_.size ()) });
 
+		if (KeepAlive_)
+		{
+			const auto& settings = Conn_->GetSettings ();
+			ResponseHeaders_.append ({ "Connection", "keep-alive" });
+			ResponseHeaders_.append ({ "Keep-Alive",
+					"timeout=" + QByteArray::number (settings.KeepAliveTimeout_.load ()) +
+					", max=" + QByteArray::number (settings.MaxRequests_.load ()) });
+		}
+		else
+			ResponseHeaders_.append ({ "Connection", "close" });
+
 		CookedRH_.clear ();
 		for (const auto& pair : ResponseHeaders_)
 			CookedRH_ += pair.first + ": " + pair.second + "\r\n";
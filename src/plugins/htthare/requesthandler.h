@@ -35,8 +35,8 @@
 #include <QUrl>
 #include <QMap>
 #include <QCoreApplication>
-
-class QFileInfo;
+#include <QFileInfo>
+#include "dirlistingcache.h"
 
 namespace LeechCraft
 {
@@ -59,6 +59,9 @@ namespace HttHare
 		QByteArray CookedRH_;
 		QByteArray ResponseBody_;
 
+		bool IsHttp11_ = false;
+		bool KeepAlive_ = false;
+
 		enum class Verb
 		{
 			Get,
@@ -72,13 +75,27 @@ namespace HttHare
 		QString Tr (const char*);
 
 		void ErrorResponse (int, const QByteArray&, const QByteArray& = QByteArray ());
-		QByteArray MakeDirResponse (const QFileInfo&, const QString&, const QUrl&);
+		QByteArray MakeDirHead (const QFileInfo&, const QUrl&, const QByteArray&);
+		QByteArray MakeDirResponse (const QFileInfo&, const DirListing&);
+		DirListing RenderListing (const QFileInfo&, const QFileInfoList&);
+		void StreamDir (const QString&, const QFileInfo&, const QFileInfoList&);
+
+		bool ShouldKeepAlive (const QByteArray&) const;
+
+		/* Request bodies are never read, so the connection can't be reused
+		 * after one has been sent.
+		 */
+		bool HasBody () const;
+		bool AcceptsEncoding (const QByteArray&) const;
+		bool IsNotModified (const QByteArray&, const QDateTime&) const;
+		QByteArray GetCompressedFile (const QString&, const QByteArray&);
 
 		void HandleRequest (Verb);
 		void WriteDir (const QString&, const QFileInfo&, Verb);
 		void WriteFile (const QString&, const QFileInfo&, Verb);
 		void DefaultWrite (Verb);
 		std::vector<boost::asio::const_buffer> ToBuffers (Verb);
+		QList<QByteArray> GetBuffersData () const;
 	};
 }
 }
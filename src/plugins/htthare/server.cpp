@@ -28,6 +28,7 @@
  **********************************************************************/
 
 #include "server.h"
+#include <algorithm>
 #include <QString>
 #include <QtDebug>
 #include "connection.h"
@@ -40,11 +41,48 @@ namespace HttHare
 {
 	namespace ip = boost::asio::ip;
 
-	Server::Server (const QList<QPair<QString, QString>>& addresses)
-	: IconResolver_ { new IconResolver  }
+	namespace
+	{
+#ifdef SO_REUSEPORT
+		typedef boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT> ReusePort_t;
+#endif
+
+		int GetThreadsCount (const ThreadingSettings& settings)
+		{
+			if (settings.ThreadsCount_ > 0)
+				return settings.ThreadsCount_;
+
+			return std::max<int> (std::thread::hardware_concurrency (), 1);
+		}
+
+		bool UsePerThreadServices (const ThreadingSettings& settings)
+		{
+#ifdef SO_REUSEPORT
+			return settings.PerThreadServices_;
+#else
+			if (settings.PerThreadServices_)
+				qWarning () << Q_FUNC_INFO
+						<< "SO_REUSEPORT is not supported on this platform, falling back to a shared I/O service";
+			return false;
+#endif
+		}
+	}
+
+	Server::Server (const QList<QPair<QString, QString>>& addresses,
+			const ConnectionSettings& connSettings, const ThreadingSettings& threadSettings)
+	: ThreadsCount_ { GetThreadsCount (threadSettings) }
+	, IconResolver_ { new IconResolver  }
 	, TrManager_ { new TrManager }
 	{
-		ip::tcp::resolver resolver { IoService_ };
+		ConnSettings_.Set (connSettings);
+
+		const auto servicesCount = ThreadsCount_ > 1 && UsePerThreadServices (threadSettings) ?
+				ThreadsCount_ :
+				1;
+		for (auto i = 0; i < servicesCount; ++i)
+			IoServices_.emplace_back (new boost::asio::io_service);
+
+		ip::tcp::resolver resolver { *IoServices_.front () };
 
 		for (const auto& pair : addresses)
 		{
@@ -52,13 +90,20 @@ namespace HttHare
 			{
 				const ip::tcp::endpoint endpoint = *resolver.resolve ({ pair.first.toStdString (), pair.second.toStdString () });
 
-				std::unique_ptr<ip::tcp::acceptor> accPtr { new ip::tcp::acceptor { IoService_ } };
-				accPtr->open (endpoint.protocol ());
-				accPtr->set_option (ip::tcp::acceptor::reuse_address (true));
-				accPtr->bind (endpoint);
-				accPtr->listen ();
+				for (const auto& service : IoServices_)
+				{
+					std::unique_ptr<ip::tcp::acceptor> accPtr { new ip::tcp::acceptor { *service } };
+					accPtr->open (endpoint.protocol ());
+					accPtr->set_option (ip::tcp::acceptor::reuse_address (true));
+#ifdef SO_REUSEPORT
+					if (servicesCount > 1)
+						accPtr->set_option (ReusePort_t (true));
+#endif
+					accPtr->bind (endpoint);
+					accPtr->listen ();
 
-				Acceptors_.emplace_back (std::move (accPtr));
+					Acceptors_.emplace_back (std::move (accPtr));
+				}
 			}
 			catch (const std::exception& e)
 			{
@@ -69,13 +114,13 @@ namespace HttHare
 			}
 		}
 
-		StartAccept ();
+		for (const auto& acceptor : Acceptors_)
+			StartAccept (*acceptor);
 	}
 
 	Server::~Server ()
 	{
-		if (!IoService_.stopped ())
-			Stop ();
+		Stop ();
 	}
 
 	void Server::Start ()
@@ -83,35 +128,73 @@ namespace HttHare
 		if (Acceptors_.empty ())
 			return;
 
-		for (auto i = 0; i < 2; ++i)
-			Threads_.emplace_back ([this] { IoService_.run (); });
+		if (IoServices_.size () > 1)
+			for (const auto& service : IoServices_)
+			{
+				const auto svc = service.get ();
+				Threads_.emplace_back ([svc] { svc->run (); });
+			}
+		else
+		{
+			const auto svc = IoServices_.front ().get ();
+			for (auto i = 0; i < ThreadsCount_; ++i)
+				Threads_.emplace_back ([svc] { svc->run (); });
+		}
 	}
 
 	void Server::Stop ()
 	{
-		IoService_.stop ();
+		for (const auto& service : IoServices_)
+			service->stop ();
+
 		for (auto& thread : Threads_)
 			thread.join ();
 		Threads_.clear ();
 	}
 
-	void Server::StartAccept ()
+	void Server::SetConnectionSettings (const ConnectionSettings& settings)
+	{
+		ConnSettings_.Set (settings);
+	}
+
+	const ServerStats& Server::GetStats () const
 	{
-		Connection_ptr connection { new Connection { IoService_, StorageMgr_, IconResolver_, TrManager_ } };
-
-		for (auto& acceptor : Acceptors_)
-			acceptor->async_accept (connection->GetSocket (),
-					[this, connection] (const boost::system::error_code& ec)
-					{
-						if (!ec)
-							connection->Start ();
-						else
-							qWarning () << Q_FUNC_INFO
-									<< "cannot accept:"
-									<< ec.message ().c_str ();
-
-						StartAccept ();
-					});
+		return Stats_;
+	}
+
+	void Server::StartAccept (ip::tcp::acceptor& acceptor)
+	{
+		Connection_ptr connection
+		{
+			new Connection
+			{
+				acceptor.get_io_service (),
+				StorageMgr_,
+				IconResolver_,
+				TrManager_,
+				MimeCache_,
+				ListingCache_,
+				CompressedCache_,
+				ConnSettings_,
+				Stats_
+			}
+		};
+
+		acceptor.async_accept (connection->GetSocket (),
+				[this, &acceptor, connection] (const boost::system::error_code& ec)
+				{
+					if (ec == boost::asio::error::operation_aborted)
+						return;
+
+					if (!ec)
+						connection->Start ();
+					else
+						qWarning () << Q_FUNC_INFO
+								<< "cannot accept:"
+								<< ec.message ().c_str ();
+
+					StartAccept (acceptor);
+				});
 	}
 }
 }
@@ -32,6 +32,11 @@
 #include <thread>
 #include <boost/asio.hpp>
 #include "storagemanager.h"
+#include "connection.h"
+#include "serverstats.h"
+#include "mimecache.h"
+#include "dirlistingcache.h"
+#include "compressedcache.h"
 
 template<typename T>
 class QSet;
@@ -45,19 +50,33 @@ namespace HttHare
 	class IconResolver;
 	class TrManager;
 
+	struct ThreadingSettings
+	{
+		int ThreadsCount_;
+		bool PerThreadServices_;
+	};
+
 	class Server
 	{
-		boost::asio::io_service IoService_;
+		ServerStats Stats_;
+		LiveConnectionSettings ConnSettings_;
+
+		std::vector<std::unique_ptr<boost::asio::io_service>> IoServices_;
 		std::vector<std::unique_ptr<boost::asio::ip::tcp::acceptor>> Acceptors_;
 
 		StorageManager StorageMgr_;
+		MimeCache MimeCache_;
+		DirListingCache ListingCache_;
+		CompressedCache CompressedCache_;
 
+		const int ThreadsCount_;
 		std::vector<std::thread> Threads_;
 
 		IconResolver * const IconResolver_;
 		TrManager * const TrManager_;
 	public:
-		Server (const QList<QPair<QString, QString>>& addresses);
+		Server (const QList<QPair<QString, QString>>& addresses,
+				const ConnectionSettings&, const ThreadingSettings&);
 		~Server ();
 
 		Server (const Server&) = delete;
@@ -65,8 +84,14 @@ namespace HttHare
 
 		void Start ();
 		void Stop ();
+
+		/** Applies to the already established connections as well.
+		 */
+		void SetConnectionSettings (const ConnectionSettings&);
+
+		const ServerStats& GetStats () const;
 	private:
-		void StartAccept ();
+		void StartAccept (boost::asio::ip::tcp::acceptor&);
 	};
 }
 }
@@ -0,0 +1,90 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#include "statswidget.h"
+#include <QFormLayout>
+#include <QLabel>
+#include <QTimer>
+#include <util/util.h>
+#include "serverstats.h"
+
+namespace LeechCraft
+{
+namespace HttHare
+{
+	StatsWidget::StatsWidget (const StatsGetter_f& getter, QWidget *parent)
+	: QWidget { parent }
+	, Getter_ { getter }
+	, ConnsLabel_ { new QLabel }
+	, RateLabel_ { new QLabel }
+	{
+		auto lay = new QFormLayout;
+		lay->setContentsMargins (0, 0, 0, 0);
+		lay->addRow (tr ("Active connections:"), ConnsLabel_);
+		lay->addRow (tr ("Upload rate:"), RateLabel_);
+		setLayout (lay);
+
+		auto timer = new QTimer { this };
+		connect (timer,
+				SIGNAL (timeout ()),
+				this,
+				SLOT (updateStats ()));
+		timer->start (1000);
+
+		updateStats ();
+	}
+
+	void StatsWidget::updateStats ()
+	{
+		const auto stats = Getter_ ();
+		if (!stats)
+		{
+			ConnsLabel_->setText (tr ("server is disabled"));
+			RateLabel_->setText (tr ("server is disabled"));
+			LastBytes_ = 0;
+			LastCheck_ = QDateTime {};
+			return;
+		}
+
+		ConnsLabel_->setText (QString::number (stats->ActiveConnections_));
+
+		const auto now = QDateTime::currentDateTime ();
+		const quint64 bytes = stats->BytesSent_;
+
+		const auto msecs = LastCheck_.isValid () ? LastCheck_.msecsTo (now) : 0;
+		if (msecs > 0 && bytes >= LastBytes_)
+			RateLabel_->setText (Util::MakePrettySize ((bytes - LastBytes_) * 1000 / msecs) + tr ("/s"));
+		else
+			RateLabel_->setText (Util::MakePrettySize (0) + tr ("/s"));
+
+		LastBytes_ = bytes;
+		LastCheck_ = now;
+	}
+}
+}
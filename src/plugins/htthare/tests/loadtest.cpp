@@ -0,0 +1,302 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+/* A simple loopback load generator for HttHare.
+ *
+ * Usage: lc_htthare_loadtest <host> <port> <path> [-c clients] [-n requests]
+ *                            [-p pipeline depth] [--close]
+ *
+ * With --close each request is sent over a new connection, which mimics
+ * the behaviour of HttHare before persistent connections were supported.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/asio.hpp>
+
+namespace
+{
+	namespace ip = boost::asio::ip;
+	typedef std::chrono::steady_clock Clock_t;
+
+	struct Options
+	{
+		std::string Host_;
+		std::string Port_;
+		std::string Path_;
+
+		int Clients_ = 4;
+		int Requests_ = 1000;
+		int Pipeline_ = 1;
+		bool Close_ = false;
+	};
+
+	struct WorkerResult
+	{
+		std::vector<double> Latencies_;
+		int Failures_ = 0;
+	};
+
+	std::string MakeRequest (const Options& opts)
+	{
+		return "GET " + opts.Path_ + " HTTP/1.1\r\n"
+				"Host: " + opts.Host_ + "\r\n"
+				"Connection: " + (opts.Close_ ? "close" : "keep-alive") + "\r\n"
+				"\r\n";
+	}
+
+	size_t GetContentLength (const std::string& headers)
+	{
+		std::string lowered { headers };
+		std::transform (lowered.begin (), lowered.end (), lowered.begin (), ::tolower);
+
+		const auto pos = lowered.find ("content-length:");
+		if (pos == std::string::npos)
+			return 0;
+
+		return std::strtoul (lowered.c_str () + pos + std::strlen ("content-length:"), nullptr, 10);
+	}
+
+	std::string ReadLine (ip::tcp::socket& sock, boost::asio::streambuf& buf)
+	{
+		const auto size = boost::asio::read_until (sock, buf, "\r\n");
+
+		std::string line;
+		line.resize (size);
+		buf.sgetn (&line [0], size);
+		return line;
+	}
+
+	void SkipBytes (ip::tcp::socket& sock, boost::asio::streambuf& buf, size_t size)
+	{
+		if (buf.size () < size)
+			boost::asio::read (sock, buf, boost::asio::transfer_exactly (size - buf.size ()));
+		buf.consume (size);
+	}
+
+	/* HttHare streams large responses, like big directory listings, with
+	 * the chunked transfer coding.
+	 */
+	void SkipChunkedBody (ip::tcp::socket& sock, boost::asio::streambuf& buf)
+	{
+		while (const auto chunkSize = std::strtoul (ReadLine (sock, buf).c_str (), nullptr, 16))
+			SkipBytes (sock, buf, chunkSize + 2);
+
+		while (ReadLine (sock, buf) != "\r\n")
+			;
+	}
+
+	/* Returns whether the server is going to close the connection after
+	 * this response.
+	 */
+	bool ReadResponse (ip::tcp::socket& sock, boost::asio::streambuf& buf)
+	{
+		const auto headerSize = boost::asio::read_until (sock, buf, "\r\n\r\n");
+
+		std::string headers;
+		headers.resize (headerSize);
+		buf.sgetn (&headers [0], headerSize);
+		std::transform (headers.begin (), headers.end (), headers.begin (), ::tolower);
+
+		if (headers.find ("\r\ntransfer-encoding: chunked\r\n") != std::string::npos)
+			SkipChunkedBody (sock, buf);
+		else
+			SkipBytes (sock, buf, GetContentLength (headers));
+
+		return headers.find ("\r\nconnection: close\r\n") != std::string::npos;
+	}
+
+	void Worker (const Options& opts, const ip::tcp::endpoint& endpoint,
+			int requestsCount, WorkerResult& result)
+	{
+		boost::asio::io_service svc;
+		ip::tcp::socket sock { svc };
+		boost::asio::streambuf buf;
+
+		const auto& request = MakeRequest (opts);
+
+		auto batch = opts.Close_ ? 1 : opts.Pipeline_;
+		for (int sent = 0; sent < requestsCount; sent += batch)
+		{
+			batch = std::min (batch, requestsCount - sent);
+
+			int received = 0;
+			try
+			{
+				const auto start = Clock_t::now ();
+
+				/* The server may close the connection in the middle of a
+				 * batch (say, after its per-connection requests limit), in
+				 * which case the outstanding requests are sent again over a
+				 * new one.
+				 */
+				while (received < batch)
+				{
+					if (!sock.is_open ())
+					{
+						buf.consume (buf.size ());
+						sock.connect (endpoint);
+						sock.set_option (ip::tcp::no_delay { true });
+					}
+
+					std::string data;
+					for (int i = received; i < batch; ++i)
+						data += request;
+					boost::asio::write (sock, boost::asio::buffer (data));
+
+					bool closing = false;
+					while (received < batch && !closing)
+					{
+						closing = ReadResponse (sock, buf);
+						++received;
+
+						const std::chrono::duration<double, std::milli> elapsed = Clock_t::now () - start;
+						result.Latencies_.push_back (elapsed.count ());
+					}
+
+					if (closing)
+						sock.close ();
+				}
+
+				if (opts.Close_ && sock.is_open ())
+					sock.close ();
+			}
+			catch (const std::exception&)
+			{
+				result.Failures_ += batch - received;
+
+				boost::system::error_code ec;
+				sock.close (ec);
+			}
+		}
+	}
+
+	bool ParseOptions (int argc, char **argv, Options& opts)
+	{
+		if (argc < 4)
+			return false;
+
+		opts.Host_ = argv [1];
+		opts.Port_ = argv [2];
+		opts.Path_ = argv [3];
+
+		for (int i = 4; i < argc; ++i)
+		{
+			const std::string arg { argv [i] };
+			if (arg == "--close")
+				opts.Close_ = true;
+			else if (i + 1 < argc && arg == "-c")
+				opts.Clients_ = std::atoi (argv [++i]);
+			else if (i + 1 < argc && arg == "-n")
+				opts.Requests_ = std::atoi (argv [++i]);
+			else if (i + 1 < argc && arg == "-p")
+				opts.Pipeline_ = std::atoi (argv [++i]);
+			else
+				return false;
+		}
+
+		return opts.Clients_ > 0 && opts.Requests_ > 0 && opts.Pipeline_ > 0;
+	}
+
+	double Percentile (const std::vector<double>& sorted, double p)
+	{
+		if (sorted.empty ())
+			return 0;
+
+		const auto idx = static_cast<size_t> (p * (sorted.size () - 1));
+		return sorted [idx];
+	}
+}
+
+int main (int argc, char **argv)
+{
+	Options opts;
+	if (!ParseOptions (argc, argv, opts))
+	{
+		std::cerr << "Usage: " << argv [0]
+				<< " <host> <port> <path> [-c clients] [-n requests] [-p pipeline depth] [--close]"
+				<< std::endl;
+		return 1;
+	}
+
+	ip::tcp::endpoint endpoint;
+	try
+	{
+		boost::asio::io_service svc;
+		ip::tcp::resolver resolver { svc };
+		endpoint = *resolver.resolve ({ opts.Host_, opts.Port_ });
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "cannot resolve " << opts.Host_ << ": " << e.what () << std::endl;
+		return 1;
+	}
+
+	std::vector<WorkerResult> results (opts.Clients_);
+	std::vector<std::thread> threads;
+
+	const auto start = Clock_t::now ();
+	for (int i = 0; i < opts.Clients_; ++i)
+	{
+		const auto count = opts.Requests_ / opts.Clients_ +
+				(i < opts.Requests_ % opts.Clients_ ? 1 : 0);
+		threads.emplace_back ([&opts, &endpoint, &results, i, count]
+				{ Worker (opts, endpoint, count, results [i]); });
+	}
+
+	for (auto& thread : threads)
+		thread.join ();
+	const std::chrono::duration<double> elapsed = Clock_t::now () - start;
+
+	std::vector<double> latencies;
+	int failures = 0;
+	for (const auto& result : results)
+	{
+		latencies.insert (latencies.end (), result.Latencies_.begin (), result.Latencies_.end ());
+		failures += result.Failures_;
+	}
+	std::sort (latencies.begin (), latencies.end ());
+
+	std::cout << "mode:         " << (opts.Close_ ? "connection per request" : "persistent") << std::endl;
+	std::cout << "clients:      " << opts.Clients_ << std::endl;
+	std::cout << "pipeline:     " << (opts.Close_ ? 1 : opts.Pipeline_) << std::endl;
+	std::cout << "completed:    " << latencies.size () << std::endl;
+	std::cout << "failed:       " << failures << std::endl;
+	std::cout << "requests/sec: " << latencies.size () / elapsed.count () << std::endl;
+	std::cout << "p50 latency:  " << Percentile (latencies, 0.5) << " ms" << std::endl;
+	std::cout << "p99 latency:  " << Percentile (latencies, 0.99) << " ms" << std::endl;
+
+	return failures ? 2 : 0;
+}
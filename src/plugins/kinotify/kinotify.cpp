@@ -233,6 +233,13 @@ namespace Kinotify
 		}
 	}
 
+	EntityFilter Plugin::GetEntityFilter () const
+	{
+		EntityFilter filter;
+		filter.Mimes_ << "x-leechcraft/notification";
+		return filter;
+	}
+
 	Util::XmlSettingsDialog_ptr Plugin::GetSettingsDialog () const
 	{
 		return SettingsDialog_;
@@ -32,6 +32,7 @@
 #include <QObject>
 #include <interfaces/iinfo.h>
 #include <interfaces/ientityhandler.h>
+#include <interfaces/ientityfilter.h>
 #include <interfaces/ihavesettings.h>
 #include <xmlsettingsdialog/xmlsettingsdialog.h>
 
@@ -50,10 +51,11 @@ namespace Kinotify
 	class Plugin : public QObject
 					, public IInfo
 					, public IEntityHandler
+					, public IEntityFilter
 					, public IHaveSettings
 	{
 		Q_OBJECT
-		Q_INTERFACES (IInfo IEntityHandler IHaveSettings)
+		Q_INTERFACES (IInfo IEntityHandler IEntityFilter IHaveSettings)
 
 		LC_PLUGIN_METADATA ("org.LeechCraft.Kinotify")
 
@@ -76,6 +78,8 @@ namespace Kinotify
 		EntityTestHandleResult CouldHandle (const Entity&) const;
 		void Handle (Entity);
 
+		EntityFilter GetEntityFilter () const;
+
 		Util::XmlSettingsDialog_ptr GetSettingsDialog () const;
 	public slots:
 		void pushNotification ();
@@ -31,6 +31,8 @@
 #include "pogooglue.h"
 #include <QIcon>
 #include <QUrl>
+#include <QTranslator>
+#include <QCoreApplication>
 #include <util/util.h>
 #include <util/xpc/util.h>
 #include <interfaces/entitytesthandleresult.h>
@@ -41,11 +43,18 @@ namespace Pogooglue
 {
 	void Plugin::Init (ICoreProxy_ptr)
 	{
-		Util::InstallTranslator ("pogooglue");
+		/* Init() may be run in the thread pool, so the translator is
+		 * only loaded here and is installed in the main thread later.
+		 */
+		Translator_ = Util::LoadTranslator ("pogooglue", Util::GetLocaleName ());
+		if (Translator_)
+			Translator_->moveToThread (QCoreApplication::instance ()->thread ());
 	}
 
 	void Plugin::SecondInit ()
 	{
+		if (Translator_)
+			QCoreApplication::installTranslator (Translator_);
 	}
 
 	void Plugin::Release ()
@@ -114,6 +123,11 @@ namespace Pogooglue
 		return { { GetUniqueID () + "_Google", "Google", "Google", {} } };
 	}
 
+	bool Plugin::IsInitThreadSafe () const
+	{
+		return true;
+	}
+
 	void Plugin::GoogleIt (QString text)
 	{
 		QString urlStr = QString ("http://www.google.com/search?q=%2"
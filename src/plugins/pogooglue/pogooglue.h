@@ -34,6 +34,9 @@
 #include <interfaces/iinfo.h>
 #include <interfaces/ientityhandler.h>
 #include <interfaces/idatafilter.h>
+#include <interfaces/ithreadsafeinit.h>
+
+class QTranslator;
 
 namespace LeechCraft
 {
@@ -43,11 +46,14 @@ namespace Pogooglue
 				 , public IInfo
 				 , public IEntityHandler
 				 , public IDataFilter
+				 , public IThreadSafeInit
 	{
 		Q_OBJECT
-		Q_INTERFACES (IInfo IEntityHandler IDataFilter)
+		Q_INTERFACES (IInfo IEntityHandler IDataFilter IThreadSafeInit)
 
 		LC_PLUGIN_METADATA ("org.LeechCraft.Pogooglue")
+
+		QTranslator *Translator_ = nullptr;
 	public:
 		void Init (ICoreProxy_ptr);
 		void SecondInit ();
@@ -62,6 +68,8 @@ namespace Pogooglue
 
 		QString GetFilterVerb () const;
 		QList<FilterVariant> GetFilterVariants () const;
+
+		bool IsInitThreadSafe () const;
 	private:
 		void GoogleIt (QString);
 	signals:
@@ -126,6 +126,13 @@ namespace Popishu
 		AnnouncePage (page);
 	}
 
+	EntityFilter Plugin::GetEntityFilter () const
+	{
+		EntityFilter filter;
+		filter.Mimes_ << "x-leechcraft/plain-text-document";
+		return filter;
+	}
+
 	std::shared_ptr<Util::XmlSettingsDialog> Plugin::GetSettingsDialog () const
 	{
 		return XmlSettingsDialog_;
@@ -163,6 +170,11 @@ namespace Popishu
 				});
 	}
 
+	bool Plugin::IsLazy () const
+	{
+		return true;
+	}
+
 	EditorPage* Plugin::MakeEditorPage ()
 	{
 		auto result = new EditorPage (Proxy_, TabClass_, this);
@@ -33,8 +33,10 @@
 #include <interfaces/iinfo.h>
 #include <interfaces/ihavetabs.h>
 #include <interfaces/ientityhandler.h>
+#include <interfaces/ientityfilter.h>
 #include <interfaces/ihavesettings.h>
 #include <interfaces/ihaverecoverabletabs.h>
+#include <interfaces/ilazyplugin.h>
 
 class QTranslator;
 
@@ -48,11 +50,13 @@ namespace Popishu
 				 , public IInfo
 				 , public IHaveTabs
 				 , public IEntityHandler
+				 , public IEntityFilter
 				 , public IHaveSettings
 				 , public IHaveRecoverableTabs
+				 , public ILazyPlugin
 	{
 		Q_OBJECT
-		Q_INTERFACES (IInfo IHaveTabs IEntityHandler IHaveSettings IHaveRecoverableTabs)
+		Q_INTERFACES (IInfo IHaveTabs IEntityHandler IEntityFilter IHaveSettings IHaveRecoverableTabs ILazyPlugin)
 
 		TabClassInfo TabClass_;
 		ICoreProxy_ptr Proxy_;
@@ -72,10 +76,14 @@ namespace Popishu
 		EntityTestHandleResult CouldHandle (const Entity&) const;
 		void Handle (Entity);
 
+		EntityFilter GetEntityFilter () const;
+
 		std::shared_ptr<Util::XmlSettingsDialog> GetSettingsDialog () const;
 
 		void RecoverTabs (const QList<TabRecoverInfo>&);
 		bool HasSimilarTab (const QByteArray&, const QList<QByteArray>&) const;
+
+		bool IsLazy () const;
 	private:
 		EditorPage* MakeEditorPage ();
 		void AnnouncePage (EditorPage*);
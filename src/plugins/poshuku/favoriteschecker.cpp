@@ -33,6 +33,7 @@
 #include <QApplication>
 #include <QFontMetrics>
 #include <QMainWindow>
+#include <QTimer>
 #include <interfaces/core/icoreproxy.h>
 #include <interfaces/core/irootwindowsmanager.h>
 #include "core.h"
@@ -41,6 +42,15 @@ namespace LeechCraft
 {
 namespace Poshuku
 {
+	namespace
+	{
+		const int MaxConcurrentRequests = 8;
+		const int MaxRequestsPerHost = 2;
+		const int MaxRedirects = 5;
+		const int RequestTimeout = 30 * 1000;
+		const int RecheckDays = 7;
+	}
+
 	FavoritesChecker::FavoritesChecker (QObject *parent)
 	: QObject (parent)
 	, Model_ (Core::Instance ().GetFavoritesModel ())
@@ -56,49 +66,110 @@ namespace Poshuku
 
 	void FavoritesChecker::Check ()
 	{
-		if (Pending_.size ())
+		auto rootWM = Core::Instance ().GetProxy ()->GetRootWindowsManager ();
+		if (!Pending_.isEmpty () || !Queue_.isEmpty ())
 		{
-			auto rootWM = Core::Instance ().GetProxy ()->GetRootWindowsManager ();
 			QMessageBox::critical (rootWM->GetPreferredWindow (),
 					"LeechCraft",
 					tr ("Already checking links, please wait..."));
 			return;
 		}
 
-		Pending_.clear ();
 		Results_.clear ();
 
-		Items_ = Model_->GetItems ();
+		const auto& known = Model_->GetCheckResults ();
+		const auto& staleDate = QDateTime::currentDateTime ().addDays (-RecheckDays);
 
-		Q_FOREACH (FavoritesModel::FavoritesItem item, Items_)
+		QStringList urls;
+		QStringList staleUrls;
+		Q_FOREACH (const FavoritesModel::FavoritesItem& item, Model_->GetItems ())
 		{
-			QUrl url = QUrl (item.URL_);
-			QNetworkRequest req (url);
-			QString ua = Core::Instance ().GetUserAgent (url);
-			if (!ua.isEmpty ())
-				req.setRawHeader ("User-Agent", ua.toLatin1 ());
-
-			QNetworkReply *rep = Core::Instance ()
-				.GetNetworkAccessManager ()->head (req);
+			if (urls.contains (item.URL_))
+				continue;
 
-			rep->setProperty ("SourceURL", url);
+			urls << item.URL_;
 
-			connect (rep,
-					SIGNAL (finished ()),
-					this,
-					SLOT (handleFinished ()));
+			const auto pos = known.find (item.URL_);
+			if (pos == known.end () || pos->Checked_ < staleDate)
+				staleUrls << item.URL_;
+		}
 
-			Pending_ << rep;
+		if (staleUrls.size () != urls.size ())
+		{
+			const auto button = QMessageBox::question (rootWM->GetPreferredWindow (),
+					"LeechCraft",
+					tr ("%1 of %2 favorites have been checked during the last %n day(s). "
+						"Do you want to check only the remaining %3 ones?",
+						0,
+						RecheckDays)
+						.arg (urls.size () - staleUrls.size ())
+						.arg (urls.size ())
+						.arg (staleUrls.size ()),
+					QMessageBox::Yes | QMessageBox::No | QMessageBox::Cancel);
+			if (button == QMessageBox::Cancel)
+				return;
+			else if (button == QMessageBox::Yes)
+				urls = staleUrls;
 		}
 
-		if (Pending_.size ())
+		Q_FOREACH (const QString& url, urls)
+			Queue_.append ({ QUrl (url), QUrl (url), 0 });
+
+		if (Queue_.isEmpty ())
+			return;
+
+		ProgressDialog_->setRange (0, Queue_.size ());
+		ProgressDialog_->setValue (0);
+		ProgressDialog_->show ();
+
+		ProcessQueue ();
+	}
+
+	void FavoritesChecker::ProcessQueue ()
+	{
+		auto i = Queue_.begin ();
+		while (i != Queue_.end () &&
+				Pending_.size () < MaxConcurrentRequests)
 		{
-			ProgressDialog_->setRange (0, Pending_.size ());
-			ProgressDialog_->setValue (0);
-			ProgressDialog_->show ();
+			if (HostActive_.value (i->URL_.host ()) >= MaxRequestsPerHost)
+			{
+				++i;
+				continue;
+			}
+
+			const auto request = *i;
+			i = Queue_.erase (i);
+			IssueRequest (request);
 		}
 	}
 
+	void FavoritesChecker::IssueRequest (const QueuedRequest& request)
+	{
+		const auto& url = request.URL_;
+
+		QNetworkRequest req (url);
+		QString ua = Core::Instance ().GetUserAgent (url);
+		if (!ua.isEmpty ())
+			req.setRawHeader ("User-Agent", ua.toLatin1 ());
+
+		QNetworkReply *rep = Core::Instance ()
+			.GetNetworkAccessManager ()->head (req);
+
+		rep->setProperty ("SourceURL", request.Source_);
+		rep->setProperty ("Redirects", request.Redirects_);
+
+		connect (rep,
+				SIGNAL (finished ()),
+				this,
+				SLOT (handleFinished ()));
+		QTimer::singleShot (RequestTimeout,
+				rep,
+				SLOT (abort ()));
+
+		++HostActive_ [url.host ()];
+		Pending_ << rep;
+	}
+
 	namespace
 	{
 		QString BuildMessage (const QStringList& list, const QString& property, int num)
@@ -127,6 +198,106 @@ namespace Poshuku
 		}
 	}
 
+	FavoritesModel::CheckResults_t FavoritesChecker::StoreResults ()
+	{
+		typedef FavoritesModel::CheckResult::State State;
+
+		const auto& now = QDateTime::currentDateTime ();
+
+		FavoritesModel::CheckResults_t results;
+		for (auto i = Results_.begin (), end = Results_.end (); i != end; ++i)
+		{
+			const auto& res = i.value ();
+
+			FavoritesModel::CheckResult check { State::Accessible, QString (), now };
+			if (res.Error_ != QNetworkReply::NoError)
+			{
+				check.State_ = State::Unreachable;
+				check.Message_ = res.ErrorString_;
+			}
+			else if (res.StatusCode_ < 200 ||
+					res.StatusCode_ > 399)
+			{
+				check.State_ = State::ServerError;
+				check.Message_ = QString ("HTTP %1")
+					.arg (res.StatusCode_);
+			}
+			else
+			{
+				check.Message_ = tr ("HTTP %1")
+					.arg (res.StatusCode_);
+				if (res.Length_)
+					check.Message_ += tr ("<br />Length: %1")
+						.arg (res.Length_);
+				if (res.LastModified_.isValid ())
+					check.Message_ += tr ("<br />Last-modified: %1")
+						.arg (res.LastModified_.toString ());
+
+				if (res.RedirectURL_.isValid ())
+				{
+					check.State_ = State::Redirected;
+					check.Message_ += tr ("<br />Redirects to %1")
+						.arg (res.RedirectURL_.toString ());
+				}
+			}
+
+			results [i.key ().toString ()] = check;
+		}
+
+		Model_->SetCheckResults (results);
+		Results_.clear ();
+
+		return results;
+	}
+
+	void FavoritesChecker::Finish ()
+	{
+		typedef FavoritesModel::CheckResult::State State;
+
+		const auto& results = StoreResults ();
+
+		int accessible = 0,
+			serverStuff = 0;
+		QStringList unaccessibleList;
+		QStringList redirectsList;
+
+		for (auto i = results.begin (), end = results.end (); i != end; ++i)
+			switch (i->State_)
+			{
+				case State::Redirected:
+					redirectsList << i.key ();
+					++accessible;
+					break;
+				case State::Accessible:
+					++accessible;
+					break;
+				case State::ServerError:
+					++serverStuff;
+					break;
+				case State::Unreachable:
+					unaccessibleList << i.key ();
+					break;
+			}
+
+		QString message = tr ("%1 favorites total.<br />"
+				"%2 favorites are accessible.<br />"
+				"%3"
+				"%4 are not correctly returned by the remote server.<br />"
+				"%5")
+			.arg (results.size ())
+			.arg (accessible)
+			.arg (BuildMessage (unaccessibleList, "unaccessible", 10))
+			.arg (serverStuff)
+			.arg (BuildMessage (redirectsList, "redirected", 10));
+
+		ProgressDialog_->reset ();
+
+		auto rootWM = Core::Instance ().GetProxy ()->GetRootWindowsManager ();
+		QMessageBox::information (rootWM->GetPreferredWindow (),
+				"LeechCraft",
+				message);
+	}
+
 	void FavoritesChecker::handleFinished ()
 	{
 		QNetworkReply *rep = qobject_cast<QNetworkReply*> (sender ());
@@ -141,101 +312,74 @@ namespace Poshuku
 		Pending_.removeAll (rep);
 		rep->deleteLater ();
 
-		QUrl url = rep->property ("SourceURL").value<QUrl> ();
+		const auto& host = rep->request ().url ().host ();
+		if (--HostActive_ [host] <= 0)
+			HostActive_.remove (host);
+
+		const auto& source = rep->property ("SourceURL").value<QUrl> ();
+		const int redirects = rep->property ("Redirects").toInt ();
+
+		auto target = rep->attribute (QNetworkRequest::RedirectionTargetAttribute).toUrl ();
+		if (target.isValid ())
+			target = rep->url ().resolved (target);
+
+		if (rep->error () == QNetworkReply::NoError &&
+				target.isValid () &&
+				target != rep->url () &&
+				redirects < MaxRedirects)
+		{
+			/* Redirect targets go first so that the checks already
+			 * started finish before new ones are started, but they
+			 * still obey the per-host limit.
+			 */
+			Queue_.prepend ({ source, target, redirects + 1 });
+			ProcessQueue ();
+			return;
+		}
+
+		if (!target.isValid () && redirects)
+			target = rep->url ();
+
 		Result result =
 		{
 			rep->error (),
 			rep->errorString (),
 			rep->attribute (QNetworkRequest::HttpStatusCodeAttribute).toInt (),
-			rep->attribute (QNetworkRequest::RedirectionTargetAttribute).value<QUrl> (),
+			target,
 			rep->header (QNetworkRequest::LastModifiedHeader).toDateTime (),
 			rep->header (QNetworkRequest::ContentLengthHeader).value<qint64> ()
 		};
 
-		Results_ [url] = result;
+		Results_ [source] = result;
 
-		ProgressDialog_->setValue (ProgressDialog_->value () + 1);
+		ProcessQueue ();
 
-		if (!Pending_.size ())
-		{
+		if (Pending_.isEmpty () && Queue_.isEmpty ())
+			Finish ();
+		else
 			ProgressDialog_->setValue (ProgressDialog_->value () + 1);
-
-			int accessible = 0,
-				serverStuff = 0;
-			QStringList unaccessibleList;
-			QStringList redirectsList;
-
-			QMap<QString, QString> result;
-
-			Q_FOREACH (QUrl key, Results_.keys ())
-			{
-				QString mres;
-				Result res = Results_ [key];
-				if (res.Error_ != QNetworkReply::NoError)
-				{
-					unaccessibleList << key.toString ();
-					mres = res.ErrorString_;
-				}
-				else if (res.StatusCode_ < 200 ||
-						res.StatusCode_ > 399)
-				{
-					++serverStuff;
-					mres = QString ("HTTP %1")
-						.arg (res.StatusCode_);
-				}
-				else
-				{
-					++accessible;
-					mres = tr ("HTTP %1")
-						.arg (res.StatusCode_);
-					if (res.Length_)
-						mres += tr ("<br />Length: %1")
-							.arg (res.Length_);
-					if (res.LastModified_.isValid ())
-						mres += tr ("<br />Last-modified: %1")
-							.arg (res.LastModified_.toString ());
-
-					if (res.RedirectURL_.isValid ())
-					{
-						redirectsList << key.toString ();
-						mres += tr ("<br />Redirects to %1")
-							.arg (res.RedirectURL_.toString ());
-					}
-				}
-
-				result [key.toString ()] = mres;
-			}
-
-			Model_->SetCheckResults (result);
-
-			QString message = tr ("%1 favorites total.<br />"
-					"%2 favorites are accessible.<br />"
-					"%3"
-					"%4 are not correctly returned by the remote server.<br />"
-					"%5")
-				.arg (accessible + unaccessibleList.size () + serverStuff)
-				.arg (accessible)
-				.arg (BuildMessage (unaccessibleList, "unaccessible", 10))
-				.arg (serverStuff)
-				.arg (BuildMessage (redirectsList, "redirected", 10));
-
-			auto rootWM = Core::Instance ().GetProxy ()->GetRootWindowsManager ();
-			QMessageBox::information (rootWM->GetPreferredWindow (),
-					"LeechCraft",
-					message);
-
-			ProgressDialog_->reset ();
-		}
 	}
 
 	void FavoritesChecker::handleCanceled ()
 	{
-		Q_FOREACH (QNetworkReply *rep, Pending_)
-			delete rep;
+		Queue_.clear ();
 
+		auto pending = Pending_;
 		Pending_.clear ();
-		Results_.clear ();
-		Items_.clear ();
+		Q_FOREACH (QNetworkReply *rep, pending)
+		{
+			disconnect (rep,
+					0,
+					this,
+					0);
+			rep->abort ();
+			rep->deleteLater ();
+		}
+
+		HostActive_.clear ();
+
+		if (!Results_.isEmpty ())
+			StoreResults ();
 	}
 }
 }
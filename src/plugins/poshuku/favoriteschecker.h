@@ -30,6 +30,7 @@
 #ifndef PLUGINS_POSHUKU_FAVORITESCHECKER_H
 #define PLUGINS_POSHUKU_FAVORITESCHECKER_H
 #include <QMap>
+#include <QHash>
 #include <QUrl>
 #include <QDateTime>
 #include <QNetworkReply>
@@ -48,9 +49,17 @@ namespace Poshuku
 		Q_OBJECT
 
 		FavoritesModel *Model_;
+
+		struct QueuedRequest
+		{
+			QUrl Source_;
+			QUrl URL_;
+			int Redirects_;
+		};
+		QList<QueuedRequest> Queue_;
 		QList<QNetworkReply*> Pending_;
+		QHash<QString, int> HostActive_;
 		QProgressDialog *ProgressDialog_;
-		FavoritesModel::items_t Items_;
 	public:
 		struct Result
 		{
@@ -67,6 +76,11 @@ namespace Poshuku
 		FavoritesChecker (QObject* = 0);
 
 		void Check ();
+	private:
+		void ProcessQueue ();
+		void IssueRequest (const QueuedRequest&);
+		FavoritesModel::CheckResults_t StoreResults ();
+		void Finish ();
 	private slots:
 		void handleFinished ();
 		void handleCanceled ();
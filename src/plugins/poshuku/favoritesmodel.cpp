@@ -35,6 +35,8 @@
 #include <QtDebug>
 #include <QMimeData>
 #include <QFileInfo>
+#include <QFont>
+#include <QBrush>
 #include <interfaces/core/icoreproxy.h>
 #include <interfaces/core/itagsmanager.h>
 #include <util/xpc/defaulthookproxy.h>
@@ -101,7 +103,37 @@ namespace Poshuku
 				else
 					return QVariant ();
 			case Qt::ToolTipRole:
-				return CheckResults_ [Items_ [index.row ()].URL_];
+				return CheckResults_.value (Items_ [index.row ()].URL_).Message_;
+			case Qt::ForegroundRole:
+			{
+				const auto pos = CheckResults_.find (Items_ [index.row ()].URL_);
+				if (pos == CheckResults_.end ())
+					return QVariant ();
+
+				switch (pos->State_)
+				{
+					case CheckResult::State::Unreachable:
+						return QBrush (Qt::red);
+					case CheckResult::State::ServerError:
+						return QBrush (Qt::darkYellow);
+					default:
+						return QVariant ();
+				}
+			}
+			case Qt::FontRole:
+			{
+				if (index.column () != ColumnTitle)
+					return QVariant ();
+
+				const auto pos = CheckResults_.find (Items_ [index.row ()].URL_);
+				if (pos == CheckResults_.end () ||
+						pos->State_ != CheckResult::State::Unreachable)
+					return QVariant ();
+
+				QFont font;
+				font.setStrikeOut (true);
+				return font;
+			}
 			case RoleTags:
 				return Items_ [index.row ()].Tags_;
 			default:
@@ -375,9 +407,21 @@ namespace Poshuku
 		};
 	};
 
-	void FavoritesModel::SetCheckResults (const QMap<QString, QString>& res)
+	const FavoritesModel::CheckResults_t& FavoritesModel::GetCheckResults () const
 	{
-		CheckResults_ = res;
+		return CheckResults_;
+	}
+
+	void FavoritesModel::SetCheckResults (const CheckResults_t& res)
+	{
+		for (auto i = res.begin (), end = res.end (); i != end; ++i)
+			CheckResults_ [i.key ()] = i.value ();
+
+		Core::Instance ().GetStorageBackend ()->SetFavoritesCheckResults (res);
+
+		if (!Items_.isEmpty ())
+			emit dataChanged (index (0, 0),
+					index (Items_.size () - 1, columnCount () - 1));
 	}
 
 	bool FavoritesModel::IsUrlExists (const QString& url) const
@@ -472,6 +516,7 @@ namespace Poshuku
 	{
 		items_t items;
 		Core::Instance ().GetStorageBackend ()->LoadFavorites (items);
+		Core::Instance ().GetStorageBackend ()->LoadFavoritesCheckResults (CheckResults_);
 
 		if (!items.size ())
 			return;
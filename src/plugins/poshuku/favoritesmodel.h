@@ -32,6 +32,8 @@
 #include <QAbstractItemModel>
 #include <QStringList>
 #include <QList>
+#include <QHash>
+#include <QDateTime>
 #include <interfaces/iinfo.h>
 #include <interfaces/core/ihookproxy.h>
 
@@ -55,9 +57,28 @@ namespace Poshuku
 			bool operator== (const FavoritesItem&) const;
 		};
 		typedef QList<FavoritesItem> items_t;
+
+		/** The result of the last check of a favorite's URL.
+		 */
+		struct CheckResult
+		{
+			enum class State
+			{
+				Accessible,
+				Redirected,
+				ServerError,
+				Unreachable
+			};
+
+			State State_;
+			/// Human-readable description, shown as the tooltip.
+			QString Message_;
+			QDateTime Checked_;
+		};
+		typedef QHash<QString, CheckResult> CheckResults_t;
 	private:
 		items_t Items_;
-		QMap<QString, QString> CheckResults_;
+		CheckResults_t CheckResults_;
 	public:
 		enum Columns
 		{
@@ -86,7 +107,12 @@ namespace Poshuku
 		void EditBookmark (const QModelIndex&);
 		void ChangeURL (const QModelIndex&, const QString&);
 		const items_t& GetItems () const;
-		void SetCheckResults (const QMap<QString, QString>&);
+		const CheckResults_t& GetCheckResults () const;
+
+		/** Merges the given results with the already known ones and
+		 * saves them in the storage.
+		 */
+		void SetCheckResults (const CheckResults_t&);
 
 		bool IsUrlExists (const QString&) const;
 	private:
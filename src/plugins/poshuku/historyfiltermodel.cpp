@@ -41,8 +41,8 @@ namespace Poshuku
 	
 	bool HistoryFilterModel::filterAcceptsRow (int row, const QModelIndex& parent) const
 	{
-		if (sourceModel ()->rowCount (sourceModel ()->index (row, 0, parent)))
-			return true;
+		if (!parent.isValid ())
+			return sourceModel ()->hasChildren (sourceModel ()->index (row, 0, parent));
 		
 		const auto& filter = filterRegExp ().pattern ();
 		if (filter.isEmpty ())
@@ -32,6 +32,7 @@
 #include <QTimer>
 #include <QVariant>
 #include <QAction>
+#include <QUrl>
 #include <QtDebug>
 #include <util/xpc/defaulthookproxy.h>
 #include <interfaces/core/icoreproxy.h>
@@ -102,16 +103,39 @@ namespace Poshuku
 					return QObject::tr ("Last %n month(s)", "", number - 3);
 			}
 		}
+
+		/** Returns the first day of the section with the given
+			* number, consistently with SectionNumber().
+			*/
+		QDate SectionStart (int number, const QDate& today)
+		{
+			switch (number)
+			{
+				case 0:
+				case 1:
+				case 2:
+					return today.addDays (-number);
+				case 3:
+					return today.addDays (-7);
+				default:
+					return today.addMonths (-(number - 3));
+			}
+		}
+
+		const int PageSize = 200;
 	};
 
-	HistoryModel::HistoryModel (QObject *parent)
-	: QStandardItemModel { parent }
+	HistoryModel::HistoryModel (QObject *parent, bool collectGarbage)
+	: QAbstractItemModel { parent }
+	, GarbageTimer_ { nullptr }
 	{
-		setHorizontalHeaderLabels ({tr ("Title"), tr ("URL"), tr ("Date") });
 		QTimer::singleShot (0,
 				this,
 				SLOT (loadData ()));
 
+		if (!collectGarbage)
+			return;
+
 		GarbageTimer_ = new QTimer (this);
 		GarbageTimer_->start (15 * 60 * 1000);
 		connect (GarbageTimer_,
@@ -120,6 +144,180 @@ namespace Poshuku
 				SLOT (collectGarbage ()));
 	}
 
+	int HistoryModel::columnCount (const QModelIndex&) const
+	{
+		return 3;
+	}
+
+	QVariant HistoryModel::data (const QModelIndex& index, int role) const
+	{
+		if (!index.isValid ())
+			return {};
+
+		if (IsSection (index))
+		{
+			if (index.column () != ColumnTitle)
+				return {};
+
+			switch (role)
+			{
+			case Qt::DisplayRole:
+				return SectionName (index.row ());
+			case Qt::DecorationRole:
+				return Core::Instance ().GetProxy ()->
+						GetIconThemeManager ()->GetIcon ("document-open-folder");
+			default:
+				return {};
+			}
+		}
+
+		const auto& item = Sections_ [index.internalId () - 1].Items_ [index.row ()];
+		auto normalizeText = [] (QString text)
+		{
+			return text.trimmed ().replace ('\n', ' ');
+		};
+
+		switch (role)
+		{
+		case Qt::DisplayRole:
+			switch (index.column ())
+			{
+			case ColumnTitle:
+				return normalizeText (item.Title_);
+			case ColumnURL:
+				return normalizeText (item.URL_);
+			case ColumnDate:
+				return QLocale {}.toString (item.DateTime_, QLocale::ShortFormat);
+			}
+			break;
+		case Qt::DecorationRole:
+			if (index.column () == ColumnTitle)
+				return Core::Instance ().GetIcon (QUrl { item.URL_ });
+			break;
+		}
+
+		return {};
+	}
+
+	Qt::ItemFlags HistoryModel::flags (const QModelIndex&) const
+	{
+		return Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+	}
+
+	QVariant HistoryModel::headerData (int section, Qt::Orientation orient, int role) const
+	{
+		if (orient != Qt::Horizontal || role != Qt::DisplayRole)
+			return {};
+
+		switch (section)
+		{
+		case ColumnTitle:
+			return tr ("Title");
+		case ColumnURL:
+			return tr ("URL");
+		case ColumnDate:
+			return tr ("Date");
+		default:
+			return {};
+		}
+	}
+
+	QModelIndex HistoryModel::index (int row, int column, const QModelIndex& parent) const
+	{
+		if (!hasIndex (row, column, parent))
+			return {};
+
+		const quintptr id = parent.isValid () ? parent.row () + 1 : 0;
+		return createIndex (row, column, id);
+	}
+
+	QModelIndex HistoryModel::parent (const QModelIndex& index) const
+	{
+		if (!index.isValid () || IsSection (index))
+			return {};
+
+		return createIndex (index.internalId () - 1, 0, static_cast<quintptr> (0));
+	}
+
+	int HistoryModel::rowCount (const QModelIndex& parent) const
+	{
+		if (!parent.isValid ())
+			return Sections_.size ();
+
+		if (IsSection (parent) && parent.column () == ColumnTitle)
+			return Sections_ [parent.row ()].Items_.size ();
+
+		return 0;
+	}
+
+	bool HistoryModel::hasChildren (const QModelIndex& parent) const
+	{
+		if (!parent.isValid ())
+			return !Sections_.isEmpty ();
+
+		if (!IsSection (parent) || parent.column () != ColumnTitle)
+			return false;
+
+		const auto& section = Sections_ [parent.row ()];
+		return section.HasMore_ || !section.Items_.isEmpty ();
+	}
+
+	bool HistoryModel::canFetchMore (const QModelIndex& parent) const
+	{
+		return parent.isValid () &&
+				IsSection (parent) &&
+				Sections_ [parent.row ()].HasMore_;
+	}
+
+	void HistoryModel::fetchMore (const QModelIndex& parent)
+	{
+		if (!canFetchMore (parent))
+			return;
+
+		auto& section = Sections_ [parent.row ()];
+
+		history_items_t fresh;
+		while (fresh.isEmpty () && section.HasMore_)
+		{
+			history_items_t page;
+			Core::Instance ().GetStorageBackend ()->LoadHistoryPage (section.From_,
+					section.Cursor_, Filter_, PageSize, page);
+
+			section.HasMore_ = page.size () == PageSize;
+			if (!page.isEmpty ())
+				section.Cursor_ = { page.last ().DateTime_, page.last ().URL_ };
+
+			for (const auto& item : page)
+				if (!section.URLs_.contains (item.URL_))
+				{
+					section.URLs_ << item.URL_;
+					fresh << item;
+				}
+		}
+
+		if (fresh.isEmpty ())
+		{
+			if (!section.HasMore_ && section.Items_.isEmpty ())
+				emit dataChanged (parent, parent);
+			return;
+		}
+
+		const auto first = section.Items_.size ();
+		beginInsertRows (parent.sibling (parent.row (), ColumnTitle),
+				first, first + fresh.size () - 1);
+		section.Items_ += fresh;
+		endInsertRows ();
+	}
+
+	void HistoryModel::SetFilter (const QString& filter)
+	{
+		if (filter == Filter_)
+			return;
+
+		Filter_ = filter;
+		Reset ();
+	}
+
 	void HistoryModel::addItem (QString title, QString url,
 			QDateTime date, QObject *browserWidget)
 	{
@@ -148,9 +346,17 @@ namespace Poshuku
 
 	QList<QMap<QString, QVariant>> HistoryModel::getItemsMap () const
 	{
+		history_items_t items;
+		Core::Instance ().GetStorageBackend ()->LoadHistory (items);
+
 		QList<QMap<QString, QVariant>> result;
-		for (const auto& item : Items_)
+		QSet<QString> urls;
+		for (const auto& item : items)
 		{
+			if (urls.contains (item.URL_))
+				continue;
+			urls << item.URL_;
+
 			QMap<QString, QVariant> map;
 			map ["Title"] = item.Title_;
 			map ["DateTime"] = item.DateTime_;
@@ -160,72 +366,89 @@ namespace Poshuku
 		return result;
 	}
 
-	void HistoryModel::Add (const HistoryItem& histItem, int section)
+	bool HistoryModel::IsSection (const QModelIndex& index) const
 	{
-		while (section >= rowCount ())
-		{
-			const auto& folderIcon = Core::Instance ().GetProxy ()->
-					GetIconThemeManager ()->GetIcon ("document-open-folder");
-
-			const QList<QStandardItem*> sectItems
-			{
-				new QStandardItem { folderIcon, SectionName (rowCount ()) },
-				new QStandardItem,
-				new QStandardItem
-			};
-			for (const auto item : sectItems)
-				item->setEditable (false);
-
-			appendRow (sectItems);
-		}
-
-		const auto icon = Core::Instance ().GetIcon (QUrl { histItem.URL_ });
-		auto normalizeText = [] (QString text)
-		{
-			return text.trimmed ().replace ('\n', ' ');
-		};
-		const QList<QStandardItem*> items
-		{
-			new QStandardItem { icon, normalizeText (histItem.Title_) },
-			new QStandardItem { normalizeText (histItem.URL_) },
-			new QStandardItem { QLocale {}.toString (histItem.DateTime_, QLocale::ShortFormat) }
-		};
-		for (const auto item : items)
-			item->setEditable (false);
-		item (section)->appendRow (items);
+		return !index.internalId ();
 	}
 
-	void HistoryModel::loadData ()
+	bool HistoryModel::MatchesFilter (const HistoryItem& item) const
 	{
-		collectGarbage ();
+		return Filter_.isEmpty () ||
+				item.Title_.contains (Filter_, Qt::CaseInsensitive) ||
+				item.URL_.contains (Filter_, Qt::CaseInsensitive);
+	}
 
-		if (const auto rc = rowCount ())
-			removeRows (0, rc);
+	void HistoryModel::Reset ()
+	{
+		beginResetModel ();
 
-		Items_.clear ();
-		Core::Instance ().GetStorageBackend ()->LoadHistory (Items_);
+		Sections_.clear ();
 
-		QSet<QString> urls;
-		for (auto i = Items_.begin (); i != Items_.end (); )
+		const auto& oldest = Core::Instance ().GetStorageBackend ()->GetOldestHistoryDate ();
+		if (oldest.isValid ())
 		{
-			if (urls.contains (i->URL_))
-				i = Items_.erase (i);
-			else
+			const auto& now = QDateTime::currentDateTime ();
+			const auto& today = now.date ();
+			const auto count = SectionNumber (oldest, now) + 1;
+
+			// Nothing is visited in the future, but let's not lose
+			// items due to clock skew.
+			QDateTime before { today.addYears (100) };
+			for (int i = 0; i < count; ++i)
 			{
-				urls << i->URL_;
-				++i;
+				Section section;
+				section.From_ = QDateTime { SectionStart (i, today) };
+				section.Cursor_ = { before, {} };
+				Sections_ << section;
+
+				before = section.From_;
 			}
 		}
 
-		const auto& now = QDateTime::currentDateTime ();
-		for (const auto& item : Items_)
-			Add (item, SectionNumber (item.DateTime_, now));
+		endResetModel ();
+	}
+
+	void HistoryModel::loadData ()
+	{
+		if (GarbageTimer_)
+			collectGarbage ();
+		Reset ();
 	}
 
 	void HistoryModel::handleItemAdded (const HistoryItem& item)
 	{
-		Items_.push_back (item);
-		Add (item, SectionNumber (item.DateTime_));
+		if (Sections_.isEmpty ())
+		{
+			Reset ();
+			return;
+		}
+
+		if (!MatchesFilter (item))
+			return;
+
+		auto& section = Sections_ [0];
+		if (item.DateTime_ < section.From_)
+			return;
+
+		// Nothing fetched yet, the item will come with the first page.
+		if (section.HasMore_ && section.Items_.isEmpty ())
+			return;
+
+		const auto& parent = index (0, 0);
+		if (section.URLs_.contains (item.URL_))
+		{
+			const auto pos = std::find_if (section.Items_.begin (), section.Items_.end (),
+					[&item] (const HistoryItem& other) { return other.URL_ == item.URL_; }) -
+					section.Items_.begin ();
+			beginRemoveRows (parent, pos, pos);
+			section.Items_.removeAt (pos);
+			endRemoveRows ();
+		}
+
+		beginInsertRows (parent, 0, 0);
+		section.Items_.prepend (item);
+		section.URLs_ << item.URL_;
+		endInsertRows ();
 	}
 
 	void HistoryModel::collectGarbage ()
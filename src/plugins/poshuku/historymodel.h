@@ -29,13 +29,13 @@
 
 #pragma once
 
-#include <deque>
-#include <vector>
 #include <QStringList>
 #include <QDateTime>
-#include <QStandardItemModel>
+#include <QSet>
+#include <QAbstractItemModel>
 #include <interfaces/core/ihookproxy.h>
 #include <interfaces/poshuku/poshukutypes.h>
+#include "storagebackend.h"
 
 class QTimer;
 class QAction;
@@ -44,12 +44,32 @@ namespace LeechCraft
 {
 namespace Poshuku
 {
-	class HistoryModel : public QStandardItemModel
+	/** Groups the history by date sections ("Today", "Last week", etc).
+	 *
+	 * Only the sections themselves are created on reset, and items of
+	 * each section are paged in from the storage backend on demand via
+	 * canFetchMore()/fetchMore(), so the model keeps in memory only what
+	 * has actually been shown.
+	 */
+	class HistoryModel : public QAbstractItemModel
 	{
 		Q_OBJECT
 
 		QTimer *GarbageTimer_;
-		history_items_t Items_;
+
+		struct Section
+		{
+			QDateTime From_;
+
+			history_items_t Items_;
+			QSet<QString> URLs_;
+
+			HistoryPageCursor Cursor_;
+			bool HasMore_ = true;
+		};
+		QList<Section> Sections_;
+
+		QString Filter_;
 	public:
 		enum Columns
 		{
@@ -58,13 +78,36 @@ namespace Poshuku
 			, ColumnDate
 		};
 
-		HistoryModel (QObject* = 0);
+		/** If collectGarbage is false, this model doesn't clear old
+		 * history, leaving it to the main history model.
+		 */
+		HistoryModel (QObject* = 0, bool collectGarbage = true);
+
+		int columnCount (const QModelIndex& = {}) const;
+		QVariant data (const QModelIndex&, int = Qt::DisplayRole) const;
+		Qt::ItemFlags flags (const QModelIndex&) const;
+		QVariant headerData (int, Qt::Orientation, int = Qt::DisplayRole) const;
+		QModelIndex index (int, int, const QModelIndex& = {}) const;
+		QModelIndex parent (const QModelIndex&) const;
+		int rowCount (const QModelIndex& = {}) const;
+		bool hasChildren (const QModelIndex& = {}) const;
+
+		bool canFetchMore (const QModelIndex&) const;
+		void fetchMore (const QModelIndex&);
+
+		/** Sets the substring the title or URL of each shown item
+		 * should contain, case insensitively. The filtering is done
+		 * by the storage backend. An empty string disables filtering.
+		 */
+		void SetFilter (const QString&);
 	public slots:
 		void addItem (QString title, QString url,
 				QDateTime datetime, QObject *browserwidget = 0);
 		QList<QMap<QString, QVariant>> getItemsMap () const;
 	private:
-		void Add (const HistoryItem&, int section);
+		bool IsSection (const QModelIndex&) const;
+		bool MatchesFilter (const HistoryItem&) const;
+		void Reset ();
 	private slots:
 		void loadData ();
 		void collectGarbage ();
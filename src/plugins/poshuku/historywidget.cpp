@@ -29,6 +29,7 @@
 
 #include "historywidget.h"
 #include <QDateTime>
+#include <QScrollBar>
 #include "core.h"
 #include "historymodel.h"
 
@@ -38,11 +39,17 @@ namespace Poshuku
 {
 	HistoryWidget::HistoryWidget (QWidget *parent)
 	: QWidget (parent)
+	, HistoryModel_ (new HistoryModel (this, false))
 	{
 		Ui_.setupUi (this);
 
+		connect (Core::Instance ().GetStorageBackend (),
+				SIGNAL (added (const HistoryItem&)),
+				HistoryModel_,
+				SLOT (handleItemAdded (const HistoryItem&)));
+
 		HistoryFilterModel_.reset (new HistoryFilterModel (this));
-		HistoryFilterModel_->setSourceModel (Core::Instance ().GetHistoryModel ());
+		HistoryFilterModel_->setSourceModel (HistoryModel_);
 		HistoryFilterModel_->setDynamicSortFilter (true);
 		Ui_.HistoryView_->setModel (HistoryFilterModel_.get ());
 	
@@ -58,6 +65,10 @@ namespace Poshuku
 				SIGNAL (stateChanged (int)),
 				this,
 				SLOT (updateHistoryFilter ()));
+		connect (Ui_.HistoryView_->verticalScrollBar (),
+				SIGNAL (valueChanged (int)),
+				this,
+				SLOT (handleScrolled (int)));
 
 		QHeaderView *itemsHeader = Ui_.HistoryView_->header ();
 		QFontMetrics fm = fontMetrics ();
@@ -83,6 +94,12 @@ namespace Poshuku
 	{
 		int section = Ui_.HistoryFilterType_->currentIndex ();
 		QString text = Ui_.HistoryFilterLine_->text ();
+
+		// Only fixed strings can be pushed down to the storage, other
+		// filter types are applied to the already fetched items.
+		HistoryModel_->SetFilter (section == 1 || section == 2 ?
+					QString () :
+					text);
 	
 		switch (section)
 		{
@@ -102,5 +119,23 @@ namespace Poshuku
 						checkState () == Qt::Checked) ? Qt::CaseSensitive :
 					Qt::CaseInsensitive);
 	}
+
+	void HistoryWidget::handleScrolled (int value)
+	{
+		if (value < Ui_.HistoryView_->verticalScrollBar ()->maximum ())
+			return;
+
+		const auto model = HistoryFilterModel_.get ();
+		for (int i = model->rowCount () - 1; i >= 0; --i)
+		{
+			const auto& section = model->index (i, 0);
+			if (!Ui_.HistoryView_->isExpanded (section))
+				continue;
+
+			if (model->canFetchMore (section))
+				model->fetchMore (section);
+			return;
+		}
+	}
 }
 }
@@ -38,17 +38,21 @@ namespace LeechCraft
 {
 namespace Poshuku
 {
+	class HistoryModel;
+
 	class HistoryWidget : public QWidget
 	{
 		Q_OBJECT
 
 		Ui::HistoryWidget Ui_;
+		HistoryModel *HistoryModel_;
 		std::auto_ptr<HistoryFilterModel> HistoryFilterModel_;
 	public:
 		HistoryWidget (QWidget* = 0);
 	private slots:
 		void on_HistoryView__activated (const QModelIndex&);
 		void updateHistoryFilter ();
+		void handleScrolled (int);
 	};
 }
 }
@@ -29,7 +29,11 @@
 
 #include "sqlstoragebackend.h"
 #include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <QDir>
+#include <QHash>
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QThread>
@@ -42,8 +46,99 @@ namespace LeechCraft
 {
 namespace Poshuku
 {
-	SQLStorageBackend::SQLStorageBackend (StorageBackend::Type type)
+	namespace
+	{
+		/** Frecency of an URL is log (sum (exp (score (visit)))), where
+		 * the score of a visit grows linearly with time, so that a visit
+		 * is worth half as much as a visit made 30 days later. Scores
+		 * are counted from a fixed epoch, thus stored frecencies remain
+		 * comparable without ever being recalculated.
+		 */
+		double GetVisitScore (const QDateTime& dt)
+		{
+			static const QDateTime epoch (QDate (2000, 1, 1), QTime (0, 0), Qt::UTC);
+			return std::log (2.) / 30 * epoch.secsTo (dt) / 86400.;
+		}
+
+		double AddScores (double left, double right)
+		{
+			if (std::isinf (left))
+				return right;
+
+			return std::max (left, right) + std::log1p (std::exp (-std::abs (left - right)));
+		}
+
+		QString GetURLKey (QString url)
+		{
+			url = url.toLower ();
+
+			const auto schemePos = url.indexOf ("://");
+			if (schemePos >= 0 && schemePos < 16)
+				url = url.mid (schemePos + 3);
+			if (url.startsWith ("www."))
+				url = url.mid (4);
+
+			return url;
+		}
+
+		QStringList Tokenize (const QString& str)
+		{
+			const int maxTokens = 32;
+			const int maxTokenLength = 32;
+
+			QStringList result;
+			QString current;
+			auto flush = [&result, &current, maxTokenLength]
+			{
+				current.truncate (maxTokenLength);
+				if (current.size () >= 2 && !result.contains (current))
+					result << current;
+				current.clear ();
+			};
+
+			for (const auto& c : str)
+			{
+				if (c.isLetterOrNumber ())
+					current += c.toLower ();
+				else
+					flush ();
+
+				if (result.size () >= maxTokens)
+					return result;
+			}
+			flush ();
+
+			return result.mid (0, maxTokens);
+		}
+
+		QString GetUpperBound (QString prefix)
+		{
+			if (!prefix.isEmpty ())
+			{
+				const auto pos = prefix.size () - 1;
+				prefix [pos] = QChar (prefix.at (pos).unicode () + 1);
+			}
+			return prefix;
+		}
+
+		QString ToLikePattern (QString str)
+		{
+			str.replace ('\\', "\\\\");
+			str.replace ('%', "\\%");
+			str.replace ('_', "\\_");
+			return '%' + str + '%';
+		}
+
+		struct CompletionRecord
+		{
+			QString Title_;
+			double Frecency_ = -std::numeric_limits<double>::infinity ();
+		};
+	}
+
+	SQLStorageBackend::SQLStorageBackend (StorageBackend::Type type, bool primary)
 	: Type_ (type)
+	, Primary_ (primary)
 	{
 		QString strType;
 		switch (Type_)
@@ -101,13 +196,17 @@ namespace Poshuku
 					.arg (DB_.lastError ().text ()).toUtf8 ().constData ());
 		}
 
+		if (!Primary_)
+			return;
+
 		InitializeTables ();
 		CheckVersions ();
 	}
 
 	SQLStorageBackend::~SQLStorageBackend ()
 	{
-		if (Type_ == SBSQLite &&
+		if (Primary_ &&
+				Type_ == SBSQLite &&
 				XmlSettingsManager::Instance ()->property ("SQLiteVacuum").toBool ())
 		{
 			QSqlQuery vacuum (DB_);
@@ -144,38 +243,106 @@ namespace Poshuku
 				"FROM history "
 				"ORDER BY date DESC");
 
-		HistoryRatedLoader_ = QSqlQuery (DB_);
-		switch (Type_)
-		{
-			case SBSQLite:
-				HistoryRatedLoader_.prepare ("SELECT "
-						"SUM (julianday (date)) - julianday (MIN (date)) * COUNT (date) AS rating, "
-						"title, "
-						"url "
-						"FROM history "
-						"WHERE ( title LIKE :titlebase ) "
-						"OR ( url LIKE :urlbase ) "
-						"GROUP BY url "
-						"ORDER BY rating DESC "
-						"LIMIT 100");
-				break;
-			case SBPostgres:
-				HistoryRatedLoader_.prepare ("SELECT "
-						"SUM (AGE (date)) - AGE (MIN (date)) * COUNT (date) AS rating, "
-						"MAX (title) AS title, "
-						"url "
-						"FROM history "
-						"WHERE ( title LIKE :titlebase ) "
-						"OR ( url LIKE :urlbase ) "
-						"GROUP BY url "
-						"ORDER BY rating ASC "
-						"LIMIT 100");
-				break;
-			case SBMysql:
-				qWarning () << Q_FUNC_INFO
-						<< "it's not MySQL";
-				break;
-		}
+		HistoryPageLoader_ = QSqlQuery (DB_);
+		HistoryPageLoader_.prepare ("SELECT "
+				"title, "
+				"date, "
+				"url "
+				"FROM history "
+				"WHERE date >= :from "
+				"AND ( date < :before OR ( date = :before AND url < :beforeUrl ) ) "
+				"ORDER BY date DESC, url DESC "
+				"LIMIT :limit");
+
+		HistoryFilteredPageLoader_ = QSqlQuery (DB_);
+		HistoryFilteredPageLoader_.prepare (QString ("SELECT "
+					"title, "
+					"date, "
+					"url "
+					"FROM history "
+					"WHERE date >= :from "
+					"AND ( date < :before OR ( date = :before AND url < :beforeUrl ) ) "
+					"AND ( title %1 :titlebase ESCAPE '\\' OR url %1 :urlbase ESCAPE '\\' ) "
+					"ORDER BY date DESC, url DESC "
+					"LIMIT :limit")
+				.arg (Type_ == SBPostgres ? "ILIKE" : "LIKE"));
+
+		HistoryCompletionLoader_ = QSqlQuery (DB_);
+		HistoryCompletionLoader_.prepare (QString ("SELECT "
+					"title, "
+					"url, "
+					"frecency "
+					"FROM history_urls "
+					"WHERE url_key >= :keylow AND url_key < :keyhigh "
+				"UNION "
+				"SELECT "
+					"u.title, "
+					"u.url, "
+					"u.frecency "
+					"FROM history_tokens t "
+					"JOIN history_urls u ON u.id = t.url_id "
+					"WHERE t.token >= :toklow AND t.token < :tokhigh "
+					"AND ( u.title %1 :titlebase OR u.url %1 :urlbase ) "
+				"ORDER BY frecency DESC "
+				"LIMIT 100")
+					.arg (Type_ == SBPostgres ? "ILIKE" : "LIKE"));
+
+		HistoryTopLoader_ = QSqlQuery (DB_);
+		HistoryTopLoader_.prepare ("SELECT "
+				"title, "
+				"url "
+				"FROM history_urls "
+				"ORDER BY frecency DESC "
+				"LIMIT 100");
+
+		HistoryURLSelector_ = QSqlQuery (DB_);
+		HistoryURLSelector_.prepare ("SELECT "
+				"id, "
+				"title, "
+				"frecency "
+				"FROM history_urls "
+				"WHERE url = :url");
+
+		HistoryURLInserter_ = QSqlQuery (DB_);
+		HistoryURLInserter_.prepare ("INSERT INTO history_urls ("
+				"url, "
+				"url_key, "
+				"title, "
+				"frecency"
+				") VALUES ("
+				":url, "
+				":url_key, "
+				":title, "
+				":frecency"
+				")");
+
+		HistoryURLUpdater_ = QSqlQuery (DB_);
+		HistoryURLUpdater_.prepare ("UPDATE history_urls SET "
+				"title = :title, "
+				"frecency = :frecency "
+				"WHERE id = :id");
+
+		HistoryTokensRemover_ = QSqlQuery (DB_);
+		HistoryTokensRemover_.prepare ("DELETE FROM history_tokens "
+				"WHERE url_id = :url_id");
+
+		HistoryTokenInserter_ = QSqlQuery (DB_);
+		HistoryTokenInserter_.prepare ("INSERT INTO history_tokens ("
+				"token, "
+				"url_id"
+				") VALUES ("
+				":token, "
+				":url_id"
+				")");
+
+		HistoryTokensPruner_ = QSqlQuery (DB_);
+		HistoryTokensPruner_.prepare ("DELETE FROM history_tokens "
+				"WHERE url_id IN "
+				"(SELECT id FROM history_urls WHERE url NOT IN (SELECT url FROM history WHERE url IS NOT NULL))");
+
+		HistoryURLsPruner_ = QSqlQuery (DB_);
+		HistoryURLsPruner_.prepare ("DELETE FROM history_urls "
+				"WHERE url NOT IN (SELECT url FROM history WHERE url IS NOT NULL)");
 
 		HistoryAdder_ = QSqlQuery (DB_);
 		HistoryAdder_.prepare ("INSERT INTO history ("
@@ -273,6 +440,31 @@ namespace Poshuku
 		FavoritesRemover_.prepare ("DELETE FROM favorites "
 				"WHERE url = :url");
 
+		FavoritesChecksLoader_ = QSqlQuery (DB_);
+		FavoritesChecksLoader_.prepare ("SELECT "
+				"url, "
+				"state, "
+				"message, "
+				"checked "
+				"FROM favorites_checks");
+
+		FavoritesCheckRemover_ = QSqlQuery (DB_);
+		FavoritesCheckRemover_.prepare ("DELETE FROM favorites_checks "
+				"WHERE url = :url");
+
+		FavoritesCheckAdder_ = QSqlQuery (DB_);
+		FavoritesCheckAdder_.prepare ("INSERT INTO favorites_checks ("
+				"url, "
+				"state, "
+				"message, "
+				"checked"
+				") VALUES ("
+				":url, "
+				":state, "
+				":message, "
+				":checked"
+				")");
+
 		FormsIgnoreSetter_ = QSqlQuery (DB_);
 		FormsIgnoreSetter_.prepare ("INSERT INTO forms_never ("
 				"url"
@@ -288,6 +480,9 @@ namespace Poshuku
 		FormsIgnoreClearer_ = QSqlQuery (DB_);
 		FormsIgnoreClearer_.prepare ("DELETE FROM forms_never ("
 				"WHERE url = :url");
+
+		if (Primary_ && GetSetting ("completionversion") != "1")
+			BuildCompletionIndex ();
 	}
 
 	void SQLStorageBackend::LoadHistory (history_items_t& items) const
@@ -312,35 +507,109 @@ namespace Poshuku
 		HistoryLoader_.finish ();
 	}
 
+	void SQLStorageBackend::LoadHistoryPage (const QDateTime& from, const HistoryPageCursor& before,
+			const QString& filter, int limit, history_items_t& items) const
+	{
+		auto& query = filter.isEmpty () ? HistoryPageLoader_ : HistoryFilteredPageLoader_;
+		query.bindValue (":from", from);
+		query.bindValue (":before", before.Date_);
+		query.bindValue (":beforeUrl", before.URL_);
+		query.bindValue (":limit", limit);
+		if (!filter.isEmpty ())
+		{
+			const auto& pattern = ToLikePattern (filter);
+			query.bindValue (":titlebase", pattern);
+			query.bindValue (":urlbase", pattern);
+		}
+
+		if (!query.exec ())
+		{
+			LeechCraft::Util::DBLock::DumpError (query);
+			return;
+		}
+
+		while (query.next ())
+		{
+			HistoryItem item =
+			{
+				query.value (0).toString (),
+				query.value (1).toDateTime (),
+				query.value (2).toString ()
+			};
+			items.push_back (item);
+		}
+
+		query.finish ();
+	}
+
+	QDateTime SQLStorageBackend::GetOldestHistoryDate () const
+	{
+		QSqlQuery query (DB_);
+		if (!query.exec ("SELECT MIN (date) FROM history"))
+		{
+			LeechCraft::Util::DBLock::DumpError (query);
+			return {};
+		}
+
+		return query.next () ? query.value (0).toDateTime () : QDateTime ();
+	}
+
 	void SQLStorageBackend::LoadResemblingHistory (const QString& base,
 			history_items_t& items) const
 	{
-		QString bound = "%";
-		bound += base;
-		bound += "%";
-		HistoryRatedLoader_.bindValue (":titlebase", bound);
-		HistoryRatedLoader_.bindValue (":urlbase", bound);
-		if (!HistoryRatedLoader_.exec ())
-		{
-			LeechCraft::Util::DBLock::DumpError (HistoryRatedLoader_);
+		const auto& key = GetURLKey (base.trimmed ());
+
+		auto& query = key.isEmpty () ? HistoryTopLoader_ : HistoryCompletionLoader_;
+		if (!key.isEmpty ())
+		{
+			auto token = key;
+			for (const auto& candidate : Tokenize (key))
+				if (token == key || candidate.size () > token.size ())
+					token = candidate;
+
+			const auto& bound = "%" + base.trimmed () + "%";
+			query.bindValue (":keylow", key);
+			query.bindValue (":keyhigh", GetUpperBound (key));
+			query.bindValue (":toklow", token);
+			query.bindValue (":tokhigh", GetUpperBound (token));
+			query.bindValue (":titlebase", bound);
+			query.bindValue (":urlbase", bound);
+		}
+
+		if (!query.exec ())
+		{
+			LeechCraft::Util::DBLock::DumpError (query);
 			throw std::runtime_error ("failed to load ratedly");
 		}
 
-		while (HistoryRatedLoader_.next ())
+		while (query.next ())
 		{
 			HistoryItem item =
 			{
-				HistoryRatedLoader_.value (1).toString (),
+				query.value (0).toString (),
 				QDateTime (),
-				HistoryRatedLoader_.value (2).toString ()
+				query.value (1).toString ()
 			};
 			items.push_back (item);
 		}
-		HistoryRatedLoader_.finish ();
+		query.finish ();
 	}
 
 	void SQLStorageBackend::AddToHistory (const HistoryItem& item)
 	{
+		LeechCraft::Util::DBLock lock (DB_);
+		try
+		{
+			lock.Init ();
+		}
+		catch (const std::exception& e)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to start transaction:"
+					<< e.what ();
+			return;
+		}
+
 		HistoryAdder_.bindValue (":title", item.Title_);
 		HistoryAdder_.bindValue (":date", item.DateTime_);
 		HistoryAdder_.bindValue (":url", item.URL_);
@@ -351,6 +620,11 @@ namespace Poshuku
 			return;
 		}
 
+		if (!UpdateCompletionIndex (item.Title_, item.URL_, GetVisitScore (item.DateTime_)))
+			return;
+
+		lock.Good ();
+
 		emit added (item);
 	}
 
@@ -371,6 +645,16 @@ namespace Poshuku
 			LeechCraft::Util::DBLock::DumpError (HistoryTruncater_);
 			return;
 		}
+		if (!HistoryTokensPruner_.exec ())
+		{
+			LeechCraft::Util::DBLock::DumpError (HistoryTokensPruner_);
+			return;
+		}
+		if (!HistoryURLsPruner_.exec ())
+		{
+			LeechCraft::Util::DBLock::DumpError (HistoryURLsPruner_);
+			return;
+		}
 
 		lock.Good ();
 	}
@@ -400,6 +684,65 @@ namespace Poshuku
 		FavoritesLoader_.finish ();
 	}
 
+	void SQLStorageBackend::LoadFavoritesCheckResults (FavoritesModel::CheckResults_t& results) const
+	{
+		if (!FavoritesChecksLoader_.exec ())
+		{
+			LeechCraft::Util::DBLock::DumpError (FavoritesChecksLoader_);
+			return;
+		}
+
+		while (FavoritesChecksLoader_.next ())
+		{
+			FavoritesModel::CheckResult result =
+			{
+				static_cast<FavoritesModel::CheckResult::State> (FavoritesChecksLoader_.value (1).toInt ()),
+				FavoritesChecksLoader_.value (2).toString (),
+				FavoritesChecksLoader_.value (3).toDateTime ()
+			};
+			results [FavoritesChecksLoader_.value (0).toString ()] = result;
+		}
+
+		FavoritesChecksLoader_.finish ();
+	}
+
+	void SQLStorageBackend::SetFavoritesCheckResults (const FavoritesModel::CheckResults_t& results)
+	{
+		LeechCraft::Util::DBLock lock (DB_);
+		try
+		{
+			lock.Init ();
+		}
+		catch (const std::runtime_error& e)
+		{
+			qWarning () << Q_FUNC_INFO
+				<< e.what ();
+			return;
+		}
+
+		for (auto i = results.begin (), end = results.end (); i != end; ++i)
+		{
+			FavoritesCheckRemover_.bindValue (":url", i.key ());
+			if (!FavoritesCheckRemover_.exec ())
+			{
+				LeechCraft::Util::DBLock::DumpError (FavoritesCheckRemover_);
+				return;
+			}
+
+			FavoritesCheckAdder_.bindValue (":url", i.key ());
+			FavoritesCheckAdder_.bindValue (":state", static_cast<int> (i->State_));
+			FavoritesCheckAdder_.bindValue (":message", i->Message_);
+			FavoritesCheckAdder_.bindValue (":checked", i->Checked_);
+			if (!FavoritesCheckAdder_.exec ())
+			{
+				LeechCraft::Util::DBLock::DumpError (FavoritesCheckAdder_);
+				return;
+			}
+		}
+
+		lock.Good ();
+	}
+
 	void SQLStorageBackend::AddToFavorites (const FavoritesModel::FavoritesItem& item)
 	{
 		FavoritesAdder_.bindValue (":title", item.Title_);
@@ -424,6 +767,10 @@ namespace Poshuku
 			return;
 		}
 
+		FavoritesCheckRemover_.bindValue (":url", item.URL_);
+		if (!FavoritesCheckRemover_.exec ())
+			LeechCraft::Util::DBLock::DumpError (FavoritesCheckRemover_);
+
 		emit removed (item);
 	}
 
@@ -501,6 +848,47 @@ namespace Poshuku
 				LeechCraft::Util::DBLock::DumpError (query);
 		}
 
+		if (!DB_.tables ().contains ("history_urls"))
+		{
+			const bool isPg = Type_ == SBPostgres;
+			if (!query.exec (QString ("CREATE TABLE history_urls ("
+							"id %1, "
+							"url TEXT UNIQUE NOT NULL, "
+							"url_key TEXT %2 NOT NULL, "
+							"title TEXT, "
+							"frecency %3 NOT NULL"
+							");")
+						.arg (isPg ? "SERIAL PRIMARY KEY" : "INTEGER PRIMARY KEY AUTOINCREMENT")
+						.arg (isPg ? "COLLATE \"C\"" : "")
+						.arg (isPg ? "DOUBLE PRECISION" : "REAL")))
+			{
+				LeechCraft::Util::DBLock::DumpError (query);
+				return;
+			}
+
+			if (!query.exec ("CREATE INDEX idx_history_urls_url_key "
+						"ON history_urls (url_key)"))
+				LeechCraft::Util::DBLock::DumpError (query);
+			if (!query.exec ("CREATE INDEX idx_history_urls_frecency "
+						"ON history_urls (frecency)"))
+				LeechCraft::Util::DBLock::DumpError (query);
+
+			if (!query.exec (QString ("CREATE TABLE history_tokens ("
+							"token TEXT %1 NOT NULL, "
+							"url_id INTEGER NOT NULL REFERENCES history_urls (id), "
+							"PRIMARY KEY (token, url_id)"
+							");")
+						.arg (isPg ? "COLLATE \"C\"" : "")))
+			{
+				LeechCraft::Util::DBLock::DumpError (query);
+				return;
+			}
+
+			if (!query.exec ("CREATE INDEX idx_history_tokens_url_id "
+						"ON history_tokens (url_id)"))
+				LeechCraft::Util::DBLock::DumpError (query);
+		}
+
 		if (!DB_.tables ().contains ("favorites"))
 		{
 			if (!query.exec ("CREATE TABLE favorites ("
@@ -514,6 +902,20 @@ namespace Poshuku
 			}
 		}
 
+		if (!DB_.tables ().contains ("favorites_checks"))
+		{
+			if (!query.exec ("CREATE TABLE favorites_checks ("
+						"url TEXT PRIMARY KEY, "
+						"state INTEGER, "
+						"message TEXT, "
+						"checked TIMESTAMP"
+						");"))
+			{
+				LeechCraft::Util::DBLock::DumpError (query);
+				return;
+			}
+		}
+
 		if (!DB_.tables ().contains ("storage_settings"))
 		{
 			if (!query.exec ("CREATE TABLE storage_settings ("
@@ -582,6 +984,133 @@ namespace Poshuku
 	{
 	}
 
+	void SQLStorageBackend::BuildCompletionIndex ()
+	{
+		QSqlQuery query (DB_);
+		if (!query.exec ("SELECT date, title, url FROM history ORDER BY date"))
+		{
+			LeechCraft::Util::DBLock::DumpError (query);
+			return;
+		}
+
+		QHash<QString, CompletionRecord> records;
+		while (query.next ())
+		{
+			auto& record = records [query.value (2).toString ()];
+
+			const auto& title = query.value (1).toString ();
+			if (!title.isEmpty ())
+				record.Title_ = title;
+
+			record.Frecency_ = AddScores (record.Frecency_,
+					GetVisitScore (query.value (0).toDateTime ()));
+		}
+		query.finish ();
+
+		LeechCraft::Util::DBLock lock (DB_);
+		lock.Init ();
+
+		if (!query.exec ("DELETE FROM history_tokens") ||
+				!query.exec ("DELETE FROM history_urls"))
+		{
+			LeechCraft::Util::DBLock::DumpError (query);
+			return;
+		}
+
+		for (auto i = records.begin (), end = records.end (); i != end; ++i)
+			if (!UpdateCompletionIndex (i->Title_, i.key (), i->Frecency_))
+				return;
+
+		SetSetting ("completionversion", "1");
+
+		lock.Good ();
+
+		qDebug () << Q_FUNC_INFO
+				<< "indexed"
+				<< records.size ()
+				<< "URLs";
+	}
+
+	bool SQLStorageBackend::UpdateCompletionIndex (const QString& title,
+			const QString& url, double score)
+	{
+		HistoryURLSelector_.bindValue (":url", url);
+		if (!HistoryURLSelector_.exec ())
+		{
+			LeechCraft::Util::DBLock::DumpError (HistoryURLSelector_);
+			return false;
+		}
+
+		if (HistoryURLSelector_.next ())
+		{
+			const auto id = HistoryURLSelector_.value (0).toInt ();
+			const auto& oldTitle = HistoryURLSelector_.value (1).toString ();
+			const auto frecency = AddScores (HistoryURLSelector_.value (2).toDouble (), score);
+			HistoryURLSelector_.finish ();
+
+			const auto& newTitle = title.isEmpty () ? oldTitle : title;
+
+			HistoryURLUpdater_.bindValue (":id", id);
+			HistoryURLUpdater_.bindValue (":title", newTitle);
+			HistoryURLUpdater_.bindValue (":frecency", frecency);
+			if (!HistoryURLUpdater_.exec ())
+			{
+				LeechCraft::Util::DBLock::DumpError (HistoryURLUpdater_);
+				return false;
+			}
+
+			if (newTitle == oldTitle)
+				return true;
+
+			HistoryTokensRemover_.bindValue (":url_id", id);
+			if (!HistoryTokensRemover_.exec ())
+			{
+				LeechCraft::Util::DBLock::DumpError (HistoryTokensRemover_);
+				return false;
+			}
+
+			return InsertTokens (id, newTitle, url);
+		}
+		HistoryURLSelector_.finish ();
+
+		HistoryURLInserter_.bindValue (":url", url);
+		HistoryURLInserter_.bindValue (":url_key", GetURLKey (url));
+		HistoryURLInserter_.bindValue (":title", title);
+		HistoryURLInserter_.bindValue (":frecency", score);
+		if (!HistoryURLInserter_.exec ())
+		{
+			LeechCraft::Util::DBLock::DumpError (HistoryURLInserter_);
+			return false;
+		}
+
+		if (!HistoryURLSelector_.exec () ||
+				!HistoryURLSelector_.next ())
+		{
+			LeechCraft::Util::DBLock::DumpError (HistoryURLSelector_);
+			return false;
+		}
+		const auto id = HistoryURLSelector_.value (0).toInt ();
+		HistoryURLSelector_.finish ();
+
+		return InsertTokens (id, title, url);
+	}
+
+	bool SQLStorageBackend::InsertTokens (int id, const QString& title, const QString& url)
+	{
+		HistoryTokenInserter_.bindValue (":url_id", id);
+		for (const auto& token : Tokenize (title + ' ' + GetURLKey (url)))
+		{
+			HistoryTokenInserter_.bindValue (":token", token);
+			if (!HistoryTokenInserter_.exec ())
+			{
+				LeechCraft::Util::DBLock::DumpError (HistoryTokenInserter_);
+				return false;
+			}
+		}
+
+		return true;
+	}
+
 	QString SQLStorageBackend::GetSetting (const QString& key) const
 	{
 		QSqlQuery query (DB_);
@@ -42,6 +42,7 @@ namespace Poshuku
 		Q_OBJECT
 
 		Type Type_;
+		const bool Primary_;
 		QSqlDatabase DB_;
 
 				/** Returns:
@@ -51,6 +52,10 @@ namespace Poshuku
 					*/
 		mutable QSqlQuery HistoryLoader_,
 				/** Binds:
+					* - keylow
+					* - keyhigh
+					* - toklow
+					* - tokhigh
 					* - titlebase
 					* - urlbase
 					*
@@ -58,7 +63,69 @@ namespace Poshuku
 					* - title
 					* - url
 					*/
-				HistoryRatedLoader_,
+				HistoryCompletionLoader_,
+				/** Returns:
+					* - title
+					* - url
+					*/
+				HistoryTopLoader_,
+				/** Binds:
+					* - url
+					*
+					* Returns:
+					* - id
+					* - title
+					* - frecency
+					*/
+				HistoryURLSelector_,
+				/** Binds:
+					* - url
+					* - url_key
+					* - title
+					* - frecency
+					*/
+				HistoryURLInserter_,
+				/** Binds:
+					* - id
+					* - title
+					* - frecency
+					*/
+				HistoryURLUpdater_,
+				/** Binds:
+					* - url_id
+					*/
+				HistoryTokensRemover_,
+				/** Binds:
+					* - token
+					* - url_id
+					*/
+				HistoryTokenInserter_,
+				HistoryTokensPruner_,
+				HistoryURLsPruner_,
+				/** Binds:
+					* - from
+					* - before
+					* - limit
+					*
+					* Returns:
+					* - title
+					* - date
+					* - url
+					*/
+				HistoryPageLoader_,
+				/** Binds:
+					* - from
+					* - before
+					* - titlebase
+					* - urlbase
+					* - limit
+					*
+					* Returns:
+					* - title
+					* - date
+					* - url
+					*/
+				HistoryFilteredPageLoader_,
 				/** Binds:
 					* - date
 					* - title
@@ -95,6 +162,24 @@ namespace Poshuku
 					* - url
 					*/
 				FavoritesRemover_,
+				/** Returns:
+					* - url
+					* - state
+					* - message
+					* - checked
+					*/
+				FavoritesChecksLoader_,
+				/** Binds:
+					* - url
+					*/
+				FavoritesCheckRemover_,
+				/** Binds:
+					* - url
+					* - state
+					* - message
+					* - checked
+					*/
+				FavoritesCheckAdder_,
 				/** Binds:
 					* - url
 					*/
@@ -108,7 +193,7 @@ namespace Poshuku
 					*/
 				FormsIgnoreClearer_;
 	public:
-		SQLStorageBackend (Type);
+		SQLStorageBackend (Type, bool primary = true);
 		virtual ~SQLStorageBackend ();
 
 		void Prepare ();
@@ -116,9 +201,14 @@ namespace Poshuku
 		virtual void LoadHistory (history_items_t&) const;
 		virtual void LoadResemblingHistory (const QString&,
 				history_items_t&) const;
+		virtual void LoadHistoryPage (const QDateTime&, const HistoryPageCursor&,
+				const QString&, int, history_items_t&) const;
+		virtual QDateTime GetOldestHistoryDate () const;
 		virtual void AddToHistory (const HistoryItem&);
 		virtual void ClearOldHistory (int, int);
 		virtual void LoadFavorites (FavoritesModel::items_t&) const;
+		virtual void LoadFavoritesCheckResults (FavoritesModel::CheckResults_t&) const;
+		virtual void SetFavoritesCheckResults (const FavoritesModel::CheckResults_t&);
 		virtual void AddToFavorites (const FavoritesModel::FavoritesItem&);
 		virtual void RemoveFromFavorites (const FavoritesModel::FavoritesItem&);
 		virtual void UpdateFavorites (const FavoritesModel::FavoritesItem&);
@@ -127,6 +217,9 @@ namespace Poshuku
 	private:
 		void InitializeTables ();
 		void CheckVersions ();
+		void BuildCompletionIndex ();
+		bool UpdateCompletionIndex (const QString& title, const QString& url, double score);
+		bool InsertTokens (int id, const QString& title, const QString& url);
 		QString GetSetting (const QString&) const;
 		void SetSetting (const QString&, const QString&);
 	};
@@ -42,6 +42,17 @@ namespace LeechCraft
 {
 namespace Poshuku
 {
+	namespace
+	{
+		QString ToLikePattern (QString str)
+		{
+			str.replace ('\\', "\\\\");
+			str.replace ('%', "\\%");
+			str.replace ('_', "\\_");
+			return '%' + str + '%';
+		}
+	}
+
 	SQLStorageBackendMysql::SQLStorageBackendMysql (StorageBackend::Type type)
 	: Type_ (type)
 	{
@@ -98,6 +109,29 @@ namespace Poshuku
 				"ORDER BY rating ASC "
 				"LIMIT 100");
 
+		HistoryPageLoader_ = QSqlQuery (DB_);
+		HistoryPageLoader_.prepare ("SELECT "
+				"title, "
+				"date, "
+				"url "
+				"FROM history "
+				"WHERE date >= ? "
+				"AND ( date < ? OR ( date = ? AND url < ? ) ) "
+				"ORDER BY date DESC, url DESC "
+				"LIMIT ?");
+
+		HistoryFilteredPageLoader_ = QSqlQuery (DB_);
+		HistoryFilteredPageLoader_.prepare ("SELECT "
+				"title, "
+				"date, "
+				"url "
+				"FROM history "
+				"WHERE date >= ? "
+				"AND ( date < ? OR ( date = ? AND url < ? ) ) "
+				"AND ( title LIKE ? OR url LIKE ? ) "
+				"ORDER BY date DESC, url DESC "
+				"LIMIT ?");
+
 		HistoryAdder_ = QSqlQuery (DB_);
 		HistoryAdder_.prepare ("INSERT INTO history ("
 				"date, "
@@ -149,6 +183,31 @@ namespace Poshuku
 		FavoritesRemover_.prepare ("DELETE FROM favorites "
 				"WHERE url = ?");
 
+		FavoritesChecksLoader_ = QSqlQuery (DB_);
+		FavoritesChecksLoader_.prepare ("SELECT "
+				"url, "
+				"state, "
+				"message, "
+				"checked "
+				"FROM favorites_checks");
+
+		FavoritesCheckRemover_ = QSqlQuery (DB_);
+		FavoritesCheckRemover_.prepare ("DELETE FROM favorites_checks "
+				"WHERE url = ?");
+
+		FavoritesCheckAdder_ = QSqlQuery (DB_);
+		FavoritesCheckAdder_.prepare ("INSERT INTO favorites_checks ("
+				"url, "
+				"state, "
+				"message, "
+				"checked"
+				") VALUES ("
+				"?, "
+				"?, "
+				"?, "
+				"?"
+				")");
+
 		FormsIgnoreSetter_ = QSqlQuery (DB_);
 		FormsIgnoreSetter_.prepare ("INSERT INTO forms_never ("
 				"url"
@@ -188,6 +247,55 @@ namespace Poshuku
 		HistoryLoader_.finish ();
 	}
 
+	void SQLStorageBackendMysql::LoadHistoryPage (const QDateTime& from, const HistoryPageCursor& before,
+			const QString& filter, int limit, history_items_t& items) const
+	{
+		auto& query = filter.isEmpty () ? HistoryPageLoader_ : HistoryFilteredPageLoader_;
+		int pos = 0;
+		query.bindValue (pos++, from);
+		query.bindValue (pos++, before.Date_);
+		query.bindValue (pos++, before.Date_);
+		query.bindValue (pos++, before.URL_);
+		if (!filter.isEmpty ())
+		{
+			const auto& pattern = ToLikePattern (filter);
+			query.bindValue (pos++, pattern);
+			query.bindValue (pos++, pattern);
+		}
+		query.bindValue (pos++, limit);
+
+		if (!query.exec ())
+		{
+			LeechCraft::Util::DBLock::DumpError (query);
+			return;
+		}
+
+		while (query.next ())
+		{
+			HistoryItem item =
+			{
+				query.value (0).toString (),
+				query.value (1).toDateTime (),
+				query.value (2).toString ()
+			};
+			items.push_back (item);
+		}
+
+		query.finish ();
+	}
+
+	QDateTime SQLStorageBackendMysql::GetOldestHistoryDate () const
+	{
+		QSqlQuery query (DB_);
+		if (!query.exec ("SELECT MIN(date) FROM history"))
+		{
+			LeechCraft::Util::DBLock::DumpError (query);
+			return {};
+		}
+
+		return query.next () ? query.value (0).toDateTime () : QDateTime ();
+	}
+
 	void SQLStorageBackendMysql::LoadResemblingHistory (const QString& base,
 			history_items_t& items) const
 	{
@@ -276,6 +384,65 @@ namespace Poshuku
 		FavoritesLoader_.finish ();
 	}
 
+	void SQLStorageBackendMysql::LoadFavoritesCheckResults (FavoritesModel::CheckResults_t& results) const
+	{
+		if (!FavoritesChecksLoader_.exec ())
+		{
+			LeechCraft::Util::DBLock::DumpError (FavoritesChecksLoader_);
+			return;
+		}
+
+		while (FavoritesChecksLoader_.next ())
+		{
+			FavoritesModel::CheckResult result =
+			{
+				static_cast<FavoritesModel::CheckResult::State> (FavoritesChecksLoader_.value (1).toInt ()),
+				FavoritesChecksLoader_.value (2).toString (),
+				FavoritesChecksLoader_.value (3).toDateTime ()
+			};
+			results [FavoritesChecksLoader_.value (0).toString ()] = result;
+		}
+
+		FavoritesChecksLoader_.finish ();
+	}
+
+	void SQLStorageBackendMysql::SetFavoritesCheckResults (const FavoritesModel::CheckResults_t& results)
+	{
+		LeechCraft::Util::DBLock lock (DB_);
+		try
+		{
+			lock.Init ();
+		}
+		catch (const std::runtime_error& e)
+		{
+			qWarning () << Q_FUNC_INFO
+				<< e.what ();
+			return;
+		}
+
+		for (auto i = results.begin (), end = results.end (); i != end; ++i)
+		{
+			FavoritesCheckRemover_.bindValue (0, i.key ());
+			if (!FavoritesCheckRemover_.exec ())
+			{
+				LeechCraft::Util::DBLock::DumpError (FavoritesCheckRemover_);
+				return;
+			}
+
+			FavoritesCheckAdder_.bindValue (0, i.key ());
+			FavoritesCheckAdder_.bindValue (1, static_cast<int> (i->State_));
+			FavoritesCheckAdder_.bindValue (2, i->Message_);
+			FavoritesCheckAdder_.bindValue (3, i->Checked_);
+			if (!FavoritesCheckAdder_.exec ())
+			{
+				LeechCraft::Util::DBLock::DumpError (FavoritesCheckAdder_);
+				return;
+			}
+		}
+
+		lock.Good ();
+	}
+
 	void SQLStorageBackendMysql::AddToFavorites (const FavoritesModel::FavoritesItem& item)
 	{
 		FavoritesAdder_.bindValue (0, item.Title_);
@@ -300,6 +467,10 @@ namespace Poshuku
 			return;
 		}
 
+		FavoritesCheckRemover_.bindValue (0, item.URL_);
+		if (!FavoritesCheckRemover_.exec ())
+			LeechCraft::Util::DBLock::DumpError (FavoritesCheckRemover_);
+
 		emit removed (item);
 	}
 
@@ -390,6 +561,20 @@ namespace Poshuku
 			}
 		}
 
+		if (!DB_.tables ().contains ("favorites_checks"))
+		{
+			if (!query.exec ("CREATE TABLE favorites_checks ("
+						"url TEXT, "
+						"state INTEGER, "
+						"message TEXT, "
+						"checked TIMESTAMP"
+						");"))
+			{
+				LeechCraft::Util::DBLock::DumpError (query);
+				return;
+			}
+		}
+
 		if (!DB_.tables ().contains ("storage_settings"))
 		{
 			if (!query.exec ("CREATE TABLE storage_settings ("
@@ -59,6 +59,30 @@ namespace Poshuku
 					* - url
 					*/
 				HistoryRatedLoader_,
+				/** Binds:
+					* - from
+					* - before
+					* - limit
+					*
+					* Returns:
+					* - title
+					* - date
+					* - url
+					*/
+				HistoryPageLoader_,
+				/** Binds:
+					* - from
+					* - before
+					* - titlebase
+					* - urlbase
+					* - limit
+					*
+					* Returns:
+					* - title
+					* - date
+					* - url
+					*/
+				HistoryFilteredPageLoader_,
 				/** Binds:
 					* - date
 					* - title
@@ -95,6 +119,24 @@ namespace Poshuku
 					* - url
 					*/
 				FavoritesRemover_,
+				/** Returns:
+					* - url
+					* - state
+					* - message
+					* - checked
+					*/
+				FavoritesChecksLoader_,
+				/** Binds:
+					* - url
+					*/
+				FavoritesCheckRemover_,
+				/** Binds:
+					* - url
+					* - state
+					* - message
+					* - checked
+					*/
+				FavoritesCheckAdder_,
 				/** Binds:
 					* - url
 					*/
@@ -116,9 +158,14 @@ namespace Poshuku
 		virtual void LoadHistory (history_items_t&) const;
 		virtual void LoadResemblingHistory (const QString&,
 				history_items_t&) const;
+		virtual void LoadHistoryPage (const QDateTime&, const HistoryPageCursor&,
+				const QString&, int, history_items_t&) const;
+		virtual QDateTime GetOldestHistoryDate () const;
 		virtual void AddToHistory (const HistoryItem&);
 		virtual void ClearOldHistory (int, int);
 		virtual void LoadFavorites (FavoritesModel::items_t&) const;
+		virtual void LoadFavoritesCheckResults (FavoritesModel::CheckResults_t&) const;
+		virtual void SetFavoritesCheckResults (const FavoritesModel::CheckResults_t&);
 		virtual void AddToFavorites (const FavoritesModel::FavoritesItem&);
 		virtual void RemoveFromFavorites (const FavoritesModel::FavoritesItem&);
 		virtual void UpdateFavorites (const FavoritesModel::FavoritesItem&);
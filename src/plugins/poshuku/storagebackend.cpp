@@ -46,14 +46,14 @@ namespace Poshuku
 	{
 	}
 
-	std::shared_ptr<StorageBackend> StorageBackend::Create (Type type)
+	std::shared_ptr<StorageBackend> StorageBackend::Create (Type type, bool primary)
 	{
 		std::shared_ptr<StorageBackend> result;
 		switch (type)
 		{
 		case SBSQLite:
 		case SBPostgres:
-			result.reset (new SQLStorageBackend (type));
+			result.reset (new SQLStorageBackend (type, primary));
 			break;
 		case SBMysql:
 			result.reset (new SQLStorageBackendMysql (type));
@@ -61,22 +61,34 @@ namespace Poshuku
 		return result;
 	}
 
+	namespace
+	{
+		StorageBackend::Type GetConfiguredType ()
+		{
+			QString strType = XmlSettingsManager::Instance ()->
+				property ("StorageType").toString ();
+			if (strType == "SQLite")
+				return StorageBackend::SBSQLite;
+			else if (strType == "PostgreSQL")
+				return StorageBackend::SBPostgres;
+			else if (strType == "MySQL")
+				return StorageBackend::SBMysql;
+			else
+				throw std::runtime_error (qPrintable (QString ("Unknown storage type %1")
+							.arg (strType)));
+		}
+	}
+
 	std::shared_ptr<StorageBackend> StorageBackend::Create ()
 	{
-		StorageBackend::Type type;
-		QString strType = XmlSettingsManager::Instance ()->
-			property ("StorageType").toString ();
-		if (strType == "SQLite")
-			type = StorageBackend::SBSQLite;
-		else if (strType == "PostgreSQL")
-			type = StorageBackend::SBPostgres;
-		else if (strType == "MySQL")
-			type = StorageBackend::SBMysql;
-		else
-			throw std::runtime_error (qPrintable (QString ("Unknown storage type %1")
-						.arg (strType)));
+		const auto& sb = Create (GetConfiguredType ());
+		sb->Prepare ();
+		return sb;
+	}
 
-		const auto& sb = Create (type);
+	std::shared_ptr<StorageBackend> StorageBackend::CreateSecondary ()
+	{
+		const auto& sb = Create (GetConfiguredType (), false);
 		sb->Prepare ();
 		return sb;
 	}
@@ -40,6 +40,25 @@ namespace LeechCraft
 {
 namespace Poshuku
 {
+	/** @brief The position in the history to load a page before.
+		*
+		* The history items are ordered by date and then by URL, both
+		* descending, so that items with the same date are neither
+		* skipped nor repeated between pages.
+		*/
+	struct HistoryPageCursor
+	{
+		/** The date of the last item of the previous page, or the
+			* exclusive end of the range for the first page.
+			*/
+		QDateTime Date_;
+
+		/** The URL of the last item of the previous page, or an empty
+			* string for the first page.
+			*/
+		QString URL_;
+	};
+
 	/** @brief Abstract base class for storage backends.
 		*
 		* Specifies interface for all storage backends. Includes functions for
@@ -60,9 +79,19 @@ namespace Poshuku
 
 		StorageBackend (QObject* = 0);
 		virtual ~StorageBackend ();
-		static std::shared_ptr<StorageBackend> Create (Type);
+		static std::shared_ptr<StorageBackend> Create (Type, bool primary = true);
 		static std::shared_ptr<StorageBackend> Create ();
 
+		/** @brief Creates a secondary backend for the current thread.
+			*
+			* The secondary backend opens its own connection to the
+			* storage configured by the user. It relies on the tables
+			* being already initialized by the primary backend and does
+			* no maintenance like vacuuming on destruction, so it is
+			* suitable for serving read queries from a helper thread.
+			*/
+		static std::shared_ptr<StorageBackend> CreateSecondary ();
+
 		/** @brief Do post-initialization.
 			*
 			* This function is called by the Core after all the updates are
@@ -75,8 +104,8 @@ namespace Poshuku
 			* Puts resembling history items (HistoryItem) from the
 			* storage backend into the passed container. An item is considered
 			* resembling if its title or URL contains base string. The
-			* resembling items container should be sorted by date in descending
-			* order.
+			* resembling items container should be sorted by rating (like
+			* frecency) in descending order.
 			*
 			* @param[in] base The base string .
 			* @param[out] items The container with items. They would be
@@ -85,6 +114,35 @@ namespace Poshuku
 		virtual void LoadResemblingHistory (const QString& base,
 				history_items_t& items) const = 0;
 
+		/** @brief Get a page of history items from the storage.
+			*
+			* Puts at most limit history items visited in the
+			* [from; before) time range into the passed container,
+			* sorted by date and URL in descending order. If filter is not
+			* empty, only items whose title or URL contain it (case
+			* insensitively) are returned.
+			*
+			* To get the next page, call this function again passing
+			* the date and the URL of the last returned item as before.
+			*
+			* @param[in] from The earliest date, inclusive.
+			* @param[in] before The position to load the items before,
+			* exclusive.
+			* @param[in] filter The substring to look for.
+			* @param[in] limit The maximum number of items to return.
+			* @param[out] items The container with items. They would be
+			* appended to the container.
+			*/
+		virtual void LoadHistoryPage (const QDateTime& from, const HistoryPageCursor& before,
+				const QString& filter, int limit, history_items_t& items) const = 0;
+
+		/** @brief Returns the date of the oldest history item.
+			*
+			* @return The date of the oldest item, or a null QDateTime
+			* if the history is empty.
+			*/
+		virtual QDateTime GetOldestHistoryDate () const = 0;
+
 		/** @brief Add an item to history.
 			*
 			* Adds the passed item to the storage and emits the added() signal
@@ -114,6 +172,21 @@ namespace Poshuku
 			*/
 		virtual void LoadFavorites (FavoritesModel::items_t& items) const = 0;
 
+		/** @brief Get the saved results of favorites links checks.
+			*
+			* @param[out] results The results, keyed by URL. They would
+			* be added to the container.
+			*/
+		virtual void LoadFavoritesCheckResults (FavoritesModel::CheckResults_t& results) const = 0;
+
+		/** @brief Save the results of favorites links checks.
+			*
+			* Replaces the previously saved results for the same URLs.
+			*
+			* @param[in] results The results, keyed by URL.
+			*/
+		virtual void SetFavoritesCheckResults (const FavoritesModel::CheckResults_t& results) = 0;
+
 		/** @brief Add an item to the favorites list.
 			*
 			* Adds the passed item to the storage and emits the added() signal
@@ -31,11 +31,13 @@
 #include <stdexcept>
 #include <QUrl>
 #include <QTimer>
+#include <QThread>
 #include <QApplication>
 #include <QtDebug>
 #include <util/xpc/defaulthookproxy.h>
 #include <interfaces/core/icoreproxy.h>
 #include "core.h"
+#include "urlcompletionworker.h"
 
 namespace LeechCraft
 {
@@ -44,6 +46,8 @@ namespace Poshuku
 	URLCompletionModel::URLCompletionModel (QObject *parent)
 	: QAbstractItemModel { parent }
 	, ValidateTimer_ { new QTimer { this } }
+	, WorkerThread_ { new QThread { this } }
+	, Generation_ { std::make_shared<std::atomic<int>> (0) }
 	{
 		ValidateTimer_->setSingleShot (true);
 		connect (ValidateTimer_,
@@ -51,6 +55,32 @@ namespace Poshuku
 				this,
 				SLOT (validate ()));
 		ValidateTimer_->setInterval (QApplication::keyboardInputInterval () / 2);
+
+		qRegisterMetaType<history_items_t> ("LeechCraft::Poshuku::history_items_t");
+
+		const auto worker = new URLCompletionWorker { Generation_ };
+		worker->moveToThread (WorkerThread_);
+		connect (WorkerThread_,
+				SIGNAL (finished ()),
+				worker,
+				SLOT (deleteLater ()));
+		connect (this,
+				SIGNAL (completionRequested (QString, int)),
+				worker,
+				SLOT (complete (QString, int)));
+		connect (worker,
+				SIGNAL (gotCompletions (LeechCraft::Poshuku::history_items_t, int)),
+				this,
+				SLOT (handleGotCompletions (LeechCraft::Poshuku::history_items_t, int)));
+		WorkerThread_->start (QThread::LowPriority);
+	}
+
+	URLCompletionModel::~URLCompletionModel ()
+	{
+		++*Generation_;
+
+		WorkerThread_->quit ();
+		WorkerThread_->wait ();
 	}
 
 	int URLCompletionModel::columnCount (const QModelIndex&) const
@@ -127,6 +157,7 @@ namespace Poshuku
 	{
 		Valid_ = false;
 		Base_ = str;
+		++*Generation_;
 
 		ValidateTimer_->stop ();
 		ValidateTimer_->start ();
@@ -135,23 +166,15 @@ namespace Poshuku
 	void URLCompletionModel::validate ()
 	{
 		PopulateNonHook ();
+	}
 
-		Util::DefaultHookProxy_ptr proxy (new Util::DefaultHookProxy);
-		int size = Items_.size ();
-		emit hookURLCompletionNewStringRequested (proxy, this, Base_, size);
-		if (!proxy->IsCancelled ())
+	void URLCompletionModel::handleGotCompletions (const history_items_t& items, int generation)
+	{
+		if (generation != *Generation_)
 			return;
 
-		int newSize = Items_.size ();
-		if (newSize == size)
-			Items_.clear ();
-		else
-		{
-			history_items_t newItems;
-			std::copy (Items_.begin (), Items_.begin () + newSize - size,
-					std::back_inserter (newItems));
-			Items_ = newItems;
-		}
+		SetItems (items);
+		RunHooks ();
 	}
 
 	void URLCompletionModel::handleItemAdded (const HistoryItem&)
@@ -166,39 +189,56 @@ namespace Poshuku
 
 		Valid_ = true;
 
-		int size = Items_.size () - 1;
-		if (size > 0)
-			beginRemoveRows ({}, 0, size);
-		Items_.clear ();
-		if (size > 0)
-			endRemoveRows ();
-
 		if (Base_.startsWith ('!'))
 		{
 			auto cats = Core::Instance ().GetProxy ()->GetSearchCategories ();
 			cats.sort ();
+
+			history_items_t items;
 			for (const auto& cat : cats)
-				Items_.push_back ({ cat, {}, "!" + cat });
+				items.push_back ({ cat, {}, "!" + cat });
+			SetItems (items);
+			RunHooks ();
 		}
 		else
+			emit completionRequested (Base_, *Generation_);
+	}
+
+	void URLCompletionModel::SetItems (const history_items_t& items)
+	{
+		if (!Items_.isEmpty ())
 		{
-			try
-			{
-				Core::Instance ().GetStorageBackend ()->LoadResemblingHistory (Base_, Items_);
-			}
-			catch (const std::runtime_error& e)
-			{
-				qWarning () << Q_FUNC_INFO << e.what ();
-				Valid_ = false;
-			}
+			beginRemoveRows ({}, 0, Items_.size () - 1);
+			Items_.clear ();
+			endRemoveRows ();
 		}
 
-		size = Items_.size () - 1;
-		if (size >= 0)
+		if (!items.isEmpty ())
 		{
-			beginInsertRows ({}, 0, size);
+			beginInsertRows ({}, 0, items.size () - 1);
+			Items_ = items;
 			endInsertRows ();
 		}
 	}
+
+	void URLCompletionModel::RunHooks ()
+	{
+		Util::DefaultHookProxy_ptr proxy (new Util::DefaultHookProxy);
+		int size = Items_.size ();
+		emit hookURLCompletionNewStringRequested (proxy, this, Base_, size);
+		if (!proxy->IsCancelled ())
+			return;
+
+		int newSize = Items_.size ();
+		if (newSize == size)
+			Items_.clear ();
+		else
+		{
+			history_items_t newItems;
+			std::copy (Items_.begin (), Items_.begin () + newSize - size,
+					std::back_inserter (newItems));
+			Items_ = newItems;
+		}
+	}
 }
 }
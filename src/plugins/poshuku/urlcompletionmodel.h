@@ -29,12 +29,15 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <QAbstractItemModel>
 #include <interfaces/core/ihookproxy.h>
 #include <interfaces/poshuku/iurlcompletionmodel.h>
 #include "historymodel.h"
 
 class QTimer;
+class QThread;
 
 namespace LeechCraft
 {
@@ -52,12 +55,16 @@ namespace Poshuku
 		QString Base_;
 
 		QTimer * const ValidateTimer_;
+
+		QThread * const WorkerThread_;
+		const std::shared_ptr<std::atomic<int>> Generation_;
 	public:
 		enum
 		{
 			RoleURL = 45
 		};
 		URLCompletionModel (QObject* = 0);
+		~URLCompletionModel ();
 
 		virtual int columnCount (const QModelIndex& = QModelIndex ()) const;
 		virtual QVariant data (const QModelIndex&, int = Qt::DisplayRole) const;
@@ -72,12 +79,17 @@ namespace Poshuku
 		void AddItem (const QString& title, const QString& url, size_t pos);
 	private:
 		void PopulateNonHook ();
+		void SetItems (const history_items_t&);
+		void RunHooks ();
 	private slots:
 		void validate ();
+		void handleGotCompletions (const LeechCraft::Poshuku::history_items_t&, int);
 	public slots:
 		void setBase (const QString&);
 		void handleItemAdded (const HistoryItem&);
 	signals:
+		void completionRequested (const QString&, int);
+
 		// Plugin API
 		void hookURLCompletionNewStringRequested (LeechCraft::IHookProxy_ptr proxy,
 				QObject *model,
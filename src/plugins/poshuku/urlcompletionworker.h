@@ -0,0 +1,67 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <QObject>
+#include <QMetaType>
+#include "interfaces/poshuku/poshukutypes.h"
+
+namespace LeechCraft
+{
+namespace Poshuku
+{
+	class StorageBackend;
+
+	/** Runs URL completion queries in a helper thread, using its own
+	 * secondary storage backend.
+	 *
+	 * Each request is tagged with a generation number. Requests that
+	 * are superseded by the time the worker gets to them are dropped
+	 * without touching the storage.
+	 */
+	class URLCompletionWorker : public QObject
+	{
+		Q_OBJECT
+
+		std::shared_ptr<StorageBackend> Storage_;
+		const std::shared_ptr<std::atomic<int>> LatestGeneration_;
+	public:
+		URLCompletionWorker (const std::shared_ptr<std::atomic<int>>&);
+	public slots:
+		void complete (const QString& base, int generation);
+	signals:
+		void gotCompletions (const LeechCraft::Poshuku::history_items_t&, int generation);
+	};
+}
+}
+
+Q_DECLARE_METATYPE (LeechCraft::Poshuku::history_items_t)
@@ -46,6 +46,7 @@
 #include "taskqueuemanager.h"
 #include "foldersmodel.h"
 #include "mailmodelsmanager.h"
+#include "accountdatabase.h"
 
 Q_DECLARE_METATYPE (QList<QStringList>)
 Q_DECLARE_METATYPE (QList<QByteArray>)
@@ -332,6 +333,8 @@ namespace Snails
 			dia.SetFoldersToSync (toSync);
 		}
 
+		dia.SetSearchIndexStats (Core::Instance ().GetStorage ()->GetSearchIndexStats (this));
+
 		if (dia.exec () != QDialog::Accepted)
 			return;
 
@@ -518,16 +521,6 @@ namespace Snails
 		UpdateFolderCount (folder);
 	}
 
-	void Account::handleGotOtherMessages (const QList<QByteArray>& ids, const QStringList& folder)
-	{
-		qDebug () << Q_FUNC_INFO << ids.size () << folder;
-		const auto& msgs = Core::Instance ().GetStorage ()->LoadMessages (this, folder, ids);
-
-		MailModelsManager_->Append (msgs);
-
-		UpdateFolderCount (folder);
-	}
-
 	void Account::handleMessagesRemoved (const QList<QByteArray>& ids, const QStringList& folder)
 	{
 		qDebug () << Q_FUNC_INFO << ids.size () << folder;
@@ -554,6 +547,11 @@ namespace Snails
 			});
 	}
 
+	void Account::handleFolderSyncStateChanged (const QStringList& folder, const FolderSyncState& state)
+	{
+		Core::Instance ().GetStorage ()->SetFolderSyncState (this, folder, state);
+	}
+
 	void Account::handleMessageCountFetched (int count, int unread, const QStringList& folder)
 	{
 		const auto storedCount = Core::Instance ().GetStorage ()->GetNumMessages (this, folder);
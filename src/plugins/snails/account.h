@@ -34,6 +34,7 @@
 #include <QHash>
 #include "message.h"
 #include "progresslistener.h"
+#include "folder.h"
 
 class QMutex;
 class QAbstractItemModel;
@@ -166,10 +167,10 @@ namespace Snails
 
 		void handleMsgHeaders (const QList<Message_ptr>&, const QStringList&);
 		void handleGotUpdatedMessages (const QList<Message_ptr>&, const QStringList&);
-		void handleGotOtherMessages (const QList<QByteArray>&, const QStringList&);
 		void handleMessagesRemoved (const QList<QByteArray>&, const QStringList&);
 
 		void handleFolderSyncFinished (const QStringList&, const QByteArray&);
+		void handleFolderSyncStateChanged (const QStringList&, const LeechCraft::Snails::FolderSyncState&);
 		void handleMessageCountFetched (int, int, const QStringList&);
 
 		void handleGotFolders (const QList<LeechCraft::Snails::Folder>&);
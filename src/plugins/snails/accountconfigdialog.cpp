@@ -29,6 +29,8 @@
 
 #include "accountconfigdialog.h"
 #include <QMenu>
+#include <util/util.h>
+#include "accountdatabase.h"
 
 namespace LeechCraft
 {
@@ -273,6 +275,16 @@ namespace Snails
 		Ui_.OutgoingFolder_->setCurrentIndex (-1);
 	}
 
+	void AccountConfigDialog::SetSearchIndexStats (const SearchIndexStats& stats)
+	{
+		auto text = tr ("%n message(s), %1", 0, stats.Messages_)
+				.arg (Util::MakePrettySize (stats.Size_));
+		if (stats.Throughput_ > 0)
+			text += "; " + tr ("indexing %1 messages per second")
+					.arg (static_cast<int> (stats.Throughput_));
+		Ui_.SearchIndexInfo_->setText (text);
+	}
+
 	void AccountConfigDialog::resetInPort ()
 	{
 		const QList<int> values { 465, 993, 143 };
@@ -37,6 +37,8 @@ namespace LeechCraft
 {
 namespace Snails
 {
+	struct SearchIndexStats;
+
 	class AccountConfigDialog : public QDialog
 	{
 		Q_OBJECT
@@ -103,6 +105,8 @@ namespace Snails
 
 		QStringList GetOutFolder () const;
 		void SetOutFolder (const QStringList&);
+
+		void SetSearchIndexStats (const SearchIndexStats&);
 	private slots:
 		void resetInPort ();
 		void rebuildFoldersToSyncLine ();
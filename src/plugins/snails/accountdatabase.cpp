@@ -29,6 +29,9 @@
 
 #include "accountdatabase.h"
 #include <QDir>
+#include <QElapsedTimer>
+#include <QRegExp>
+#include <QSet>
 #include <QSqlDatabase>
 #include <QSqlError>
 #include <QSqlQuery>
@@ -36,6 +39,7 @@
 #include <util/db/dblock.h>
 #include <util/sll/qtutil.h>
 #include "account.h"
+#include "message.h"
 
 bool operator< (const QStringList& left, const QStringList& right)
 {
@@ -88,6 +92,18 @@ namespace Snails
 		return result;
 	}
 
+	QHash<QByteArray, bool> AccountDatabase::GetReadStatuses (const QStringList& folder)
+	{
+		QueryGetReadStatuses_.bindValue (":path", folder.join ("/"));
+		Util::DBLock::Execute (QueryGetReadStatuses_);
+
+		QHash<QByteArray, bool> result;
+		while (QueryGetReadStatuses_.next ())
+			result [QueryGetReadStatuses_.value (0).toByteArray ()] = QueryGetReadStatuses_.value (1).toBool ();
+		QueryGetReadStatuses_.finish ();
+		return result;
+	}
+
 	namespace
 	{
 		int GetCount (QSqlQuery& query, const QStringList& folder)
@@ -164,6 +180,39 @@ namespace Snails
 			return {};
 	}
 
+	boost::optional<FolderSyncState> AccountDatabase::GetFolderSyncState (const QStringList& folder)
+	{
+		QueryGetSyncState_.bindValue (":path", folder.join ("/"));
+		Util::DBLock::Execute (QueryGetSyncState_);
+
+		const std::shared_ptr<void> finishGuard
+		{
+			nullptr,
+			[this] (void*) { QueryGetSyncState_.finish (); }
+		};
+
+		if (!QueryGetSyncState_.next ())
+			return {};
+
+		return FolderSyncState
+		{
+			QueryGetSyncState_.value (0).toUInt (),
+			QueryGetSyncState_.value (1).toUInt (),
+			QueryGetSyncState_.value (2).toULongLong (),
+			QueryGetSyncState_.value (3).toInt ()
+		};
+	}
+
+	void AccountDatabase::SetFolderSyncState (const QStringList& folder, const FolderSyncState& state)
+	{
+		QuerySetSyncState_.bindValue (":folderId", AddFolder (folder));
+		QuerySetSyncState_.bindValue (":uidValidity", state.UIDValidity_);
+		QuerySetSyncState_.bindValue (":uidNext", state.UIDNext_);
+		QuerySetSyncState_.bindValue (":highestModSeq", state.HighestModSeq_);
+		QuerySetSyncState_.bindValue (":messageCount", state.MessageCount_);
+		Util::DBLock::Execute (QuerySetSyncState_);
+	}
+
 	void AccountDatabase::AddMessage (const Message_ptr& msg)
 	{
 		for (const auto& folder : msg->GetFolders ())
@@ -172,11 +221,13 @@ namespace Snails
 		Util::DBLock lock { *DB_ };
 		lock.Init ();
 
+		QSet<int> msgTableIds;
 		for (const auto& folder : msg->GetFolders ())
 		{
 			if (const auto existing = GetMsgTableId (msg->GetFolderID (), folder))
 			{
 				UpdateMessage (*existing, msg);
+				msgTableIds << *existing;
 				continue;
 			}
 
@@ -185,13 +236,78 @@ namespace Snails
 					*existing :
 					AddMessageUnfoldered (msg);
 			AddMessageToFolder (msgTableId, GetFolder (folder), msg->GetFolderID ());
+			msgTableIds << msgTableId;
+		}
+
+		for (const auto msgTableId : msgTableIds)
+		{
+			SetMessageHeader (msgTableId, msg);
+			IndexMessage (msgTableId, msg);
 		}
 
 		lock.Good ();
 	}
 
-	void AccountDatabase::RemoveMessage (const QByteArray& msgId, const QStringList& folder,
-			const std::function<void ()>& continuation)
+	namespace
+	{
+		QByteArray JoinRefs (const QList<QByteArray>& refs)
+		{
+			QByteArray result;
+			for (const auto& ref : refs)
+			{
+				if (!result.isEmpty ())
+					result += '\n';
+				result += ref;
+			}
+			return result;
+		}
+	}
+
+	QList<MessageInfo> AccountDatabase::GetMessageInfos (const QStringList& folder)
+	{
+		if (!KnownFolders_.contains (folder))
+			return {};
+
+		QueryGetMsgInfos_.bindValue (":folderId", KnownFolders_.value (folder));
+		Util::DBLock::Execute (QueryGetMsgInfos_);
+
+		QList<MessageInfo> result;
+		while (QueryGetMsgInfos_.next ())
+		{
+			const auto& dateVar = QueryGetMsgInfos_.value (6);
+			const auto& refs = QueryGetMsgInfos_.value (9).toByteArray ();
+			result.append ({
+					QueryGetMsgInfos_.value (0).toByteArray (),
+					QueryGetMsgInfos_.value (1).toByteArray (),
+					refs.isEmpty () ? QList<QByteArray> {} : refs.split ('\n'),
+					QueryGetMsgInfos_.value (3).toString (),
+					QueryGetMsgInfos_.value (4).toString (),
+					QueryGetMsgInfos_.value (5).toString (),
+					dateVar.isNull () ?
+							QDateTime {} :
+							QDateTime::fromMSecsSinceEpoch (dateVar.toLongLong ()),
+					QueryGetMsgInfos_.value (7).toULongLong (),
+					QueryGetMsgInfos_.value (8).toBool (),
+					QueryGetMsgInfos_.value (2).toBool ()
+				});
+		}
+		QueryGetMsgInfos_.finish ();
+		return result;
+	}
+
+	void AccountDatabase::SetMessageHeaders (const QStringList& folder, const QList<Message_ptr>& msgs)
+	{
+		Util::DBLock lock { *DB_ };
+		lock.Init ();
+
+		for (const auto& msg : msgs)
+			if (const auto msgTableId = GetMsgTableId (msg->GetFolderID (), folder))
+				SetMessageHeader (*msgTableId, msg);
+
+		lock.Good ();
+	}
+
+	void AccountDatabase::RemoveMessage (const QByteArray& msgId, const QStringList& folder)
 	{
 		Util::DBLock lock { *DB_ };
 		lock.Init ();
@@ -200,8 +316,310 @@ namespace Snails
 		QueryRemoveMessage_.bindValue (":path", folder.join ("/"));
 		Util::DBLock::Execute (QueryRemoveMessage_);
 
-		if (continuation)
-			continuation ();
+		QueryRemovePackLocation_.bindValue (":msgId", msgId);
+		QueryRemovePackLocation_.bindValue (":path", folder.join ("/"));
+		Util::DBLock::Execute (QueryRemovePackLocation_);
+
+		lock.Good ();
+	}
+
+	namespace
+	{
+		PackLocation ToPackLocation (const QSqlQuery& query, int firstColumn)
+		{
+			return
+			{
+				query.value (firstColumn).toInt (),
+				query.value (firstColumn + 1).toLongLong (),
+				query.value (firstColumn + 2).toInt ()
+			};
+		}
+	}
+
+	boost::optional<PackLocation> AccountDatabase::GetPackLocation (const QByteArray& msgId, const QStringList& folder)
+	{
+		QueryGetPackLocation_.bindValue (":msgId", msgId);
+		QueryGetPackLocation_.bindValue (":path", folder.join ("/"));
+		Util::DBLock::Execute (QueryGetPackLocation_);
+
+		const std::shared_ptr<void> finishGuard
+		{
+			nullptr,
+			[this] (void*) { QueryGetPackLocation_.finish (); }
+		};
+
+		if (!QueryGetPackLocation_.next ())
+			return {};
+
+		return ToPackLocation (QueryGetPackLocation_, 0);
+	}
+
+	QList<QPair<QByteArray, PackLocation>> AccountDatabase::GetPackLocations (const QStringList& folder)
+	{
+		QueryGetPackLocations_.bindValue (":path", folder.join ("/"));
+		Util::DBLock::Execute (QueryGetPackLocations_);
+
+		QList<QPair<QByteArray, PackLocation>> result;
+		while (QueryGetPackLocations_.next ())
+			result.append ({
+					QueryGetPackLocations_.value (0).toByteArray (),
+					ToPackLocation (QueryGetPackLocations_, 1)
+				});
+		QueryGetPackLocations_.finish ();
+		return result;
+	}
+
+	void AccountDatabase::SetPackLocations (const QStringList& folder,
+			const QList<QPair<QByteArray, PackLocation>>& locations)
+	{
+		const auto folderId = AddFolder (folder);
+
+		Util::DBLock lock { *DB_ };
+		lock.Init ();
+
+		for (const auto& pair : locations)
+		{
+			QuerySetPackLocation_.bindValue (":folderId", folderId);
+			QuerySetPackLocation_.bindValue (":msgId", pair.first);
+			QuerySetPackLocation_.bindValue (":segment", pair.second.Segment_);
+			QuerySetPackLocation_.bindValue (":offset", pair.second.Offset_);
+			QuerySetPackLocation_.bindValue (":length", pair.second.Length_);
+			Util::DBLock::Execute (QuerySetPackLocation_);
+		}
+
+		lock.Good ();
+	}
+
+	QHash<int, qint64> AccountDatabase::GetPackSegmentsUsage ()
+	{
+		QSqlQuery query { *DB_ };
+		query.prepare (QString ("SELECT Segment, SUM(Length + %1) FROM msg_pack_index GROUP BY Segment")
+					.arg (MessagePack::RecordHeaderSize));
+		Util::DBLock::Execute (query);
+
+		QHash<int, qint64> result;
+		while (query.next ())
+			result [query.value (0).toInt ()] = query.value (1).toLongLong ();
+		return result;
+	}
+
+	QList<QPair<qint64, PackLocation>> AccountDatabase::GetPackSegmentEntries (int segment)
+	{
+		QueryGetPackSegmentEntries_.bindValue (":segment", segment);
+		Util::DBLock::Execute (QueryGetPackSegmentEntries_);
+
+		QList<QPair<qint64, PackLocation>> result;
+		while (QueryGetPackSegmentEntries_.next ())
+			result.append ({
+					QueryGetPackSegmentEntries_.value (0).toLongLong (),
+					ToPackLocation (QueryGetPackSegmentEntries_, 1)
+				});
+		QueryGetPackSegmentEntries_.finish ();
+		return result;
+	}
+
+	void AccountDatabase::MovePackEntries (int fromSegment, const QList<QPair<qint64, PackLocation>>& entries)
+	{
+		Util::DBLock lock { *DB_ };
+		lock.Init ();
+
+		for (const auto& pair : entries)
+		{
+			QueryMovePackEntry_.bindValue (":rowId", pair.first);
+			QueryMovePackEntry_.bindValue (":fromSegment", fromSegment);
+			QueryMovePackEntry_.bindValue (":segment", pair.second.Segment_);
+			QueryMovePackEntry_.bindValue (":offset", pair.second.Offset_);
+			QueryMovePackEntry_.bindValue (":length", pair.second.Length_);
+			Util::DBLock::Execute (QueryMovePackEntry_);
+		}
+
+		lock.Good ();
+	}
+
+	bool AccountDatabase::HasSearchIndex () const
+	{
+		return HasSearchIndex_;
+	}
+
+	bool AccountDatabase::IsSearchIndexNew () const
+	{
+		return IsSearchIndexNew_;
+	}
+
+	namespace
+	{
+		/* Shorter prefixes would expand to a good share of all the indexed
+		 * terms, so such terms are matched exactly.
+		 */
+		const int MinPrefixLength = 2;
+
+		QString ToMatchQuery (const QString& text)
+		{
+			QStringList terms;
+			for (auto term : text.split (' ', QString::SkipEmptyParts))
+			{
+				term.remove ('"');
+				if (term.isEmpty ())
+					continue;
+
+				if (term.size () >= MinPrefixLength)
+					terms << '"' + term + "*\"";
+				else
+					terms << '"' + term + '"';
+			}
+			return terms.join (" ");
+		}
+	}
+
+	QList<QByteArray> AccountDatabase::Search (const QStringList& folder, const QString& text)
+	{
+		if (!HasSearchIndex_ || !KnownFolders_.contains (folder))
+			return {};
+
+		const auto& matchQuery = ToMatchQuery (text);
+		if (matchQuery.isEmpty ())
+			return {};
+
+		QuerySearch_.bindValue (":query", matchQuery);
+		QuerySearch_.bindValue (":folderId", KnownFolders_.value (folder));
+		Util::DBLock::Execute (QuerySearch_);
+
+		QList<QByteArray> result;
+		while (QuerySearch_.next ())
+			result << QuerySearch_.value (0).toByteArray ();
+		QuerySearch_.finish ();
+		return result;
+	}
+
+	SearchIndexStats AccountDatabase::GetSearchIndexStats ()
+	{
+		SearchIndexStats stats { 0, 0, 0 };
+		if (!HasSearchIndex_)
+			return stats;
+
+		QSqlQuery query { *DB_ };
+		query.prepare ("SELECT COUNT(1) FROM msg_fts_docsize");
+		Util::DBLock::Execute (query);
+		if (query.next ())
+			stats.Messages_ = query.value (0).toInt ();
+
+		query.prepare ("SELECT SUM(LENGTH(block)) FROM msg_fts_segments");
+		Util::DBLock::Execute (query);
+		if (query.next ())
+			stats.Size_ = query.value (0).toLongLong ();
+
+		if (IndexingTime_)
+			stats.Throughput_ = IndexedCount_ * 1e9 / IndexingTime_;
+
+		return stats;
+	}
+
+	QList<UnindexedMessage> AccountDatabase::GetUnindexedMessages (int afterTableId, int limit)
+	{
+		if (!HasSearchIndex_)
+			return {};
+
+		QueryGetUnindexed_.bindValue (":afterId", afterTableId);
+		QueryGetUnindexed_.bindValue (":limit", limit);
+		Util::DBLock::Execute (QueryGetUnindexed_);
+
+		QList<UnindexedMessage> result;
+		while (QueryGetUnindexed_.next ())
+			result.append ({
+					QueryGetUnindexed_.value (0).toInt (),
+					QueryGetUnindexed_.value (1).toString ().split ('/'),
+					QueryGetUnindexed_.value (2).toByteArray ()
+				});
+		QueryGetUnindexed_.finish ();
+		return result;
+	}
+
+	namespace
+	{
+		QString GetSearchableAddresses (const Message_ptr& msg)
+		{
+			QStringList result;
+			for (auto type : { Message::Address::From, Message::Address::To,
+						Message::Address::Cc, Message::Address::Bcc, Message::Address::ReplyTo })
+				for (const auto& address : msg->GetAddresses (type))
+					result << address.first << address.second;
+			return result.join (" ");
+		}
+
+		QString GetSearchableBody (const Message_ptr& msg)
+		{
+			const auto& body = msg->GetBody ();
+			if (!body.isEmpty ())
+				return body;
+
+			QRegExp invisibleRx { "<(style|script)[^>]*>.*</\\1>", Qt::CaseInsensitive };
+			invisibleRx.setMinimal (true);
+
+			auto html = msg->GetHTMLBody ();
+			html.remove (invisibleRx);
+			html.replace (QRegExp { "<[^>]*>" }, " ");
+			return html;
+		}
+	}
+
+	void AccountDatabase::IndexMessage (int msgTableId, const Message_ptr& msg)
+	{
+		if (!HasSearchIndex_)
+			return;
+
+		QElapsedTimer timer;
+		timer.start ();
+
+		const auto& body = GetSearchableBody (msg);
+
+		QueryGetIndexedBodyLength_.bindValue (":id", msgTableId);
+		Util::DBLock::Execute (QueryGetIndexedBodyLength_);
+		const bool isIndexed = QueryGetIndexedBodyLength_.next ();
+		const auto indexedLength = isIndexed ? QueryGetIndexedBodyLength_.value (0).toInt () : 0;
+		QueryGetIndexedBodyLength_.finish ();
+
+		/* Headers never change, so the message is only worth reindexing
+		 * once its body has been fetched.
+		 */
+		if (isIndexed && (body.isEmpty () || indexedLength))
+			return;
+
+		if (isIndexed)
+		{
+			QueryRemoveFromIndex_.bindValue (":id", msgTableId);
+			Util::DBLock::Execute (QueryRemoveFromIndex_);
+		}
+
+		QueryAddToIndex_.bindValue (":id", msgTableId);
+		QueryAddToIndex_.bindValue (":subject", msg->GetSubject ());
+		QueryAddToIndex_.bindValue (":addresses", GetSearchableAddresses (msg));
+		QueryAddToIndex_.bindValue (":body", body);
+		Util::DBLock::Execute (QueryAddToIndex_);
+
+		++IndexedCount_;
+		IndexingTime_ += timer.nsecsElapsed ();
+	}
+
+	void AccountDatabase::IndexMessages (const QList<QPair<int, Message_ptr>>& msgs)
+	{
+		if (!HasSearchIndex_)
+			return;
+
+		Util::DBLock lock { *DB_ };
+		lock.Init ();
+
+		for (const auto& pair : msgs)
+			try
+			{
+				IndexMessage (pair.first, pair.second);
+			}
+			catch (const std::exception& e)
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "unable to index"
+						<< pair.first
+						<< e.what ();
+			}
 
 		lock.Good ();
 	}
@@ -230,6 +648,23 @@ namespace Snails
 		Util::DBLock::Execute (QuerySetMsgRead_);
 	}
 
+	void AccountDatabase::SetMessageHeader (int tableId, const Message_ptr& msg)
+	{
+		const auto& info = ToMessageInfo (msg);
+
+		QuerySetMsgHeader_.bindValue (":id", tableId);
+		QuerySetMsgHeader_.bindValue (":fromName", info.FromName_);
+		QuerySetMsgHeader_.bindValue (":fromEmail", info.FromEmail_);
+		QuerySetMsgHeader_.bindValue (":subject", info.Subject_);
+		QuerySetMsgHeader_.bindValue (":date", info.Date_.isValid () ?
+					QVariant { info.Date_.toMSecsSinceEpoch () } :
+					QVariant {});
+		QuerySetMsgHeader_.bindValue (":size", info.Size_);
+		QuerySetMsgHeader_.bindValue (":hasAttachments", info.HasAttachments_);
+		QuerySetMsgHeader_.bindValue (":refs", JoinRefs (info.References_));
+		Util::DBLock::Execute (QuerySetMsgHeader_);
+	}
+
 	void AccountDatabase::AddMessageToFolder (int msgTableId, int folderTableId, const QByteArray& msgId)
 	{
 		QueryAddMsgToFolder_.bindValue (":msgId", msgId);
@@ -265,6 +700,44 @@ namespace Snails
 					FolderMessageId TEXT NOT NULL
 					)
 				)d";
+		table2queries ["msg_pack_index"] <<
+				R"d(
+					CREATE TABLE msg_pack_index (
+					FolderId INTEGER NOT NULL REFERENCES folders (Id) ON DELETE CASCADE,
+					FolderMessageId TEXT NOT NULL,
+					Segment INTEGER NOT NULL,
+					Offset INTEGER NOT NULL,
+					Length INTEGER NOT NULL,
+					PRIMARY KEY (FolderId, FolderMessageId)
+					)
+				)d"
+				<< R"d(
+					CREATE INDEX idx_msg_pack_index_segment
+					ON msg_pack_index (Segment, Offset)
+				)d";
+		table2queries ["msg_headers"] <<
+				R"d(
+					CREATE TABLE msg_headers (
+					MsgId INTEGER PRIMARY KEY REFERENCES messages (Id) ON DELETE CASCADE,
+					FromName TEXT,
+					FromEmail TEXT,
+					Subject TEXT,
+					Date INTEGER,
+					Size INTEGER NOT NULL,
+					HasAttachments BOOL NOT NULL,
+					Refs TEXT
+					)
+				)d";
+		table2queries ["folder_sync_state"] <<
+				R"d(
+					CREATE TABLE folder_sync_state (
+					FolderId INTEGER PRIMARY KEY REFERENCES folders (Id) ON DELETE CASCADE,
+					UidValidity INTEGER NOT NULL,
+					UidNext INTEGER NOT NULL,
+					HighestModSeq INTEGER NOT NULL,
+					MessageCount INTEGER NOT NULL
+					)
+				)d";
 
 		QSqlQuery query { *DB_ };
 		for (const auto& pair : Util::Stlize (table2queries))
@@ -276,6 +749,30 @@ namespace Snails
 						throw std::runtime_error ("Query execution failed for storage creation.");
 					}
 
+		for (const auto& queryStr : {
+					"CREATE INDEX IF NOT EXISTS idx_msg2folder_msgid ON msg2folder (MsgId)",
+					"CREATE INDEX IF NOT EXISTS idx_msg2folder_folder ON msg2folder (FolderId, FolderMessageId)"
+				})
+			if (!query.exec (queryStr))
+				Util::DBLock::DumpError (query);
+
+		/* Older SQLite builds lack the unicode61 tokenizer or FTS4
+		 * altogether, in which case search is just unavailable.
+		 */
+		HasSearchIndex_ = DB_->tables ().contains ("msg_fts");
+		if (!HasSearchIndex_)
+		{
+			HasSearchIndex_ = query.exec ("CREATE VIRTUAL TABLE msg_fts USING fts4 (Subject, Addresses, Body, tokenize=unicode61, prefix=\"2,3\")") ||
+					query.exec ("CREATE VIRTUAL TABLE msg_fts USING fts4 (Subject, Addresses, Body, prefix=\"2,3\")");
+			IsSearchIndexNew_ = HasSearchIndex_;
+			if (!HasSearchIndex_)
+			{
+				Util::DBLock::DumpError (query);
+				qWarning () << Q_FUNC_INFO
+						<< "full-text search is unavailable";
+			}
+		}
+
 		query.exec ("PRAGMA foreign_keys = ON;");
 		query.exec ("PRAGMA synchronous = OFF;");
 	}
@@ -289,6 +786,14 @@ namespace Snails
 					AND folders.Id = msg2folder.FolderId
 				)d");
 
+		QueryGetReadStatuses_ = QSqlQuery { *DB_ };
+		QueryGetReadStatuses_.prepare (R"d(
+					SELECT msg2folder.FolderMessageId, messages.IsRead FROM msg2folder, folders, messages
+					WHERE folders.FolderPath = :path
+					AND folders.Id = msg2folder.FolderId
+					AND messages.Id = msg2folder.MsgId
+				)d");
+
 		QueryGetCount_ = QSqlQuery { *DB_ };
 		QueryGetCount_.prepare (R"d(
 					SELECT COUNT(1) FROM msg2folder, folders
@@ -358,6 +863,131 @@ namespace Snails
 					VALUES
 					(:msgTableId, :folderId, :msgId)
 				)d");
+
+		QuerySetMsgHeader_ = QSqlQuery { *DB_ };
+		QuerySetMsgHeader_.prepare (R"d(
+					INSERT OR REPLACE INTO msg_headers
+					(MsgId, FromName, FromEmail, Subject, Date, Size, HasAttachments, Refs)
+					VALUES
+					(:id, :fromName, :fromEmail, :subject, :date, :size, :hasAttachments, :refs)
+				)d");
+
+		QueryGetMsgInfos_ = QSqlQuery { *DB_ };
+		QueryGetMsgInfos_.prepare (R"d(
+					SELECT msg2folder.FolderMessageId, messages.UniqueId, messages.IsRead,
+						msg_headers.FromName, msg_headers.FromEmail, msg_headers.Subject,
+						msg_headers.Date, msg_headers.Size, msg_headers.HasAttachments,
+						msg_headers.Refs
+					FROM msg2folder, messages, msg_headers
+					WHERE msg2folder.FolderId = :folderId
+					AND messages.Id = msg2folder.MsgId
+					AND msg_headers.MsgId = messages.Id
+				)d");
+
+		QueryGetPackLocation_ = QSqlQuery { *DB_ };
+		QueryGetPackLocation_.prepare (R"d(
+					SELECT msg_pack_index.Segment, msg_pack_index.Offset, msg_pack_index.Length
+					FROM msg_pack_index, folders
+					WHERE folders.FolderPath = :path
+					AND folders.Id = msg_pack_index.FolderId
+					AND msg_pack_index.FolderMessageId = :msgId
+				)d");
+
+		QueryGetPackLocations_ = QSqlQuery { *DB_ };
+		QueryGetPackLocations_.prepare (R"d(
+					SELECT msg_pack_index.FolderMessageId,
+						msg_pack_index.Segment, msg_pack_index.Offset, msg_pack_index.Length
+					FROM msg_pack_index, folders
+					WHERE folders.FolderPath = :path
+					AND folders.Id = msg_pack_index.FolderId
+					ORDER BY msg_pack_index.Segment, msg_pack_index.Offset
+				)d");
+
+		QuerySetPackLocation_ = QSqlQuery { *DB_ };
+		QuerySetPackLocation_.prepare (R"d(
+					INSERT OR REPLACE INTO msg_pack_index
+					(FolderId, FolderMessageId, Segment, Offset, Length)
+					VALUES
+					(:folderId, :msgId, :segment, :offset, :length)
+				)d");
+
+		QueryRemovePackLocation_ = QSqlQuery { *DB_ };
+		QueryRemovePackLocation_.prepare (R"d(
+					DELETE FROM msg_pack_index
+					WHERE FolderMessageId = :msgId
+					AND FolderId =
+						(SELECT Id FROM folders WHERE FolderPath = :path)
+				)d");
+
+		QueryGetPackSegmentEntries_ = QSqlQuery { *DB_ };
+		QueryGetPackSegmentEntries_.prepare (R"d(
+					SELECT ROWID, Segment, Offset, Length
+					FROM msg_pack_index
+					WHERE Segment = :segment
+					ORDER BY Offset
+				)d");
+
+		QueryMovePackEntry_ = QSqlQuery { *DB_ };
+		QueryMovePackEntry_.prepare (R"d(
+					UPDATE msg_pack_index
+					SET Segment = :segment, Offset = :offset, Length = :length
+					WHERE ROWID = :rowId AND Segment = :fromSegment
+				)d");
+
+		QueryGetSyncState_ = QSqlQuery { *DB_ };
+		QueryGetSyncState_.prepare (R"d(
+					SELECT folder_sync_state.UidValidity, folder_sync_state.UidNext,
+						folder_sync_state.HighestModSeq, folder_sync_state.MessageCount
+					FROM folder_sync_state, folders
+					WHERE folders.FolderPath = :path
+					AND folders.Id = folder_sync_state.FolderId
+				)d");
+
+		QuerySetSyncState_ = QSqlQuery { *DB_ };
+		QuerySetSyncState_.prepare (R"d(
+					INSERT OR REPLACE INTO folder_sync_state
+					(FolderId, UidValidity, UidNext, HighestModSeq, MessageCount)
+					VALUES
+					(:folderId, :uidValidity, :uidNext, :highestModSeq, :messageCount)
+				)d");
+
+		if (!HasSearchIndex_)
+			return;
+
+		QueryGetIndexedBodyLength_ = QSqlQuery { *DB_ };
+		QueryGetIndexedBodyLength_.prepare ("SELECT LENGTH(Body) FROM msg_fts WHERE docid = :id");
+
+		QueryRemoveFromIndex_ = QSqlQuery { *DB_ };
+		QueryRemoveFromIndex_.prepare ("DELETE FROM msg_fts WHERE docid = :id");
+
+		QueryAddToIndex_ = QSqlQuery { *DB_ };
+		QueryAddToIndex_.prepare (R"d(
+					INSERT INTO msg_fts
+					(docid, Subject, Addresses, Body)
+					VALUES
+					(:id, :subject, :addresses, :body)
+				)d");
+
+		QuerySearch_ = QSqlQuery { *DB_ };
+		QuerySearch_.prepare (R"d(
+					SELECT msg2folder.FolderMessageId FROM msg_fts, msg2folder
+					WHERE msg_fts MATCH :query
+					AND msg2folder.MsgId = msg_fts.docid
+					AND msg2folder.FolderId = :folderId
+				)d");
+
+		QueryGetUnindexed_ = QSqlQuery { *DB_ };
+		QueryGetUnindexed_.prepare (R"d(
+					SELECT messages.Id, folders.FolderPath, msg2folder.FolderMessageId
+					FROM messages, msg2folder, folders
+					WHERE messages.Id > :afterId
+					AND msg2folder.MsgId = messages.Id
+					AND folders.Id = msg2folder.FolderId
+					AND NOT EXISTS (SELECT 1 FROM msg_fts WHERE msg_fts.docid = messages.Id)
+					GROUP BY messages.Id
+					ORDER BY messages.Id
+					LIMIT :limit
+				)d");
 	}
 
 	int AccountDatabase::AddFolder (const QStringList& folder)
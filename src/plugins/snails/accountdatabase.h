@@ -35,6 +35,10 @@
 #include <QSqlQuery>
 #include <QStringList>
 #include <QMap>
+#include <QHash>
+#include "folder.h"
+#include "messagepack.h"
+#include "messageinfo.h"
 
 class QSqlDatabase;
 typedef std::shared_ptr<QSqlDatabase> QSqlDatabase_ptr;
@@ -50,11 +54,36 @@ namespace Snails
 	class Message;
 	typedef std::shared_ptr<Message> Message_ptr;
 
+	struct SearchIndexStats
+	{
+		int Messages_;
+		qint64 Size_;
+
+		/* Messages per second indexed during this session, or zero if
+		 * nothing has been indexed yet.
+		 */
+		double Throughput_;
+	};
+
+	struct UnindexedMessage
+	{
+		int TableId_;
+		QStringList Folder_;
+		QByteArray FolderMessageId_;
+	};
+
 	class AccountDatabase : public QObject
 	{
 		const QSqlDatabase_ptr DB_;
 
+		bool HasSearchIndex_ = false;
+		bool IsSearchIndexNew_ = false;
+
+		int IndexedCount_ = 0;
+		qint64 IndexingTime_ = 0;
+
 		QSqlQuery QueryGetIds_;
+		QSqlQuery QueryGetReadStatuses_;
 		QSqlQuery QueryGetCount_;
 		QSqlQuery QueryGetUnreadCount_;
 		QSqlQuery QueryGetTotalCount_;
@@ -76,24 +105,98 @@ namespace Snails
 		QSqlQuery QueryAddMsgUnfoldered_;
 		QSqlQuery QueryAddMsgToFolder_;
 
+		QSqlQuery QuerySetMsgHeader_;
+		QSqlQuery QueryGetMsgInfos_;
+
+		QSqlQuery QueryGetSyncState_;
+		QSqlQuery QuerySetSyncState_;
+
+		QSqlQuery QueryGetPackLocation_;
+		QSqlQuery QueryGetPackLocations_;
+		QSqlQuery QuerySetPackLocation_;
+		QSqlQuery QueryRemovePackLocation_;
+		QSqlQuery QueryGetPackSegmentEntries_;
+		QSqlQuery QueryMovePackEntry_;
+
+		QSqlQuery QueryGetIndexedBodyLength_;
+		QSqlQuery QueryRemoveFromIndex_;
+		QSqlQuery QueryAddToIndex_;
+		QSqlQuery QuerySearch_;
+		QSqlQuery QueryGetUnindexed_;
+
 		QMap<QStringList, int> KnownFolders_;
 	public:
 		AccountDatabase (const QDir&, Account*, QObject* = nullptr);
 
 		QList<QByteArray> GetIDs (const QStringList& folder);
+		QHash<QByteArray, bool> GetReadStatuses (const QStringList& folder);
 		int GetMessageCount (const QStringList& folder);
 		int GetUnreadMessageCount (const QStringList& folder);
 		int GetMessageCount ();
 
 		void AddMessage (const Message_ptr&);
-		void RemoveMessage (const QByteArray& msgId, const QStringList& folder,
-				const std::function<void ()>& continuation = {});
+
+		/* Only returns the messages whose headers have been stored, which
+		 * is the case for all the messages saved by this version.
+		 */
+		QList<MessageInfo> GetMessageInfos (const QStringList& folder);
+		void SetMessageHeaders (const QStringList& folder, const QList<Message_ptr>&);
+		void RemoveMessage (const QByteArray& msgId, const QStringList& folder);
 
 		boost::optional<int> GetMsgTableId (const QByteArray& uniqueId);
 		boost::optional<int> GetMsgTableId (const QByteArray& msgId, const QStringList& folder);
+
+		boost::optional<FolderSyncState> GetFolderSyncState (const QStringList& folder);
+		void SetFolderSyncState (const QStringList& folder, const FolderSyncState&);
+
+		boost::optional<PackLocation> GetPackLocation (const QByteArray& msgId, const QStringList& folder);
+
+		/* Returns the locations of all the messages in the folder, ordered
+		 * by their position in the pack.
+		 */
+		QList<QPair<QByteArray, PackLocation>> GetPackLocations (const QStringList& folder);
+		void SetPackLocations (const QStringList& folder, const QList<QPair<QByteArray, PackLocation>>&);
+
+		/* Returns the number of bytes referenced by the index in each of
+		 * the pack segments.
+		 */
+		QHash<int, qint64> GetPackSegmentsUsage ();
+
+		/* The first element of each pair is an opaque entry handle which
+		 * should be passed back to MovePackEntries (). Only the entries
+		 * still pointing to the given segment are moved, so the messages
+		 * removed or saved anew since GetPackSegmentEntries () are kept
+		 * intact.
+		 */
+		QList<QPair<qint64, PackLocation>> GetPackSegmentEntries (int segment);
+		void MovePackEntries (int fromSegment, const QList<QPair<qint64, PackLocation>>&);
+
+		bool HasSearchIndex () const;
+
+		/* Returns true if the search index has been created for an already
+		 * existing database, so the messages stored before should be fed
+		 * to IndexMessage ().
+		 */
+		bool IsSearchIndexNew () const;
+
+		/* Returns the folder-local IDs of the messages in the folder
+		 * matching all the words in the text, each word but the single
+		 * character ones treated as a prefix.
+		 */
+		QList<QByteArray> Search (const QStringList& folder, const QString& text);
+		SearchIndexStats GetSearchIndexStats ();
+
+		QList<UnindexedMessage> GetUnindexedMessages (int afterTableId, int limit);
+		void IndexMessage (int msgTableId, const Message_ptr&);
+
+		/* Indexes the given messages, keyed by their table IDs, in a single
+		 * transaction.
+		 */
+		void IndexMessages (const QList<QPair<int, Message_ptr>>&);
 	private:
 		int AddMessageUnfoldered (const Message_ptr&);
 		void UpdateMessage (int, const Message_ptr&);
+		void SetMessageHeader (int, const Message_ptr&);
 		void AddMessageToFolder (int msgTableId, int folderTableId, const QByteArray& msgId);
 
 		void InitTables ();
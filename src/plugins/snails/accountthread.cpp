@@ -94,10 +94,6 @@ namespace Snails
 				SIGNAL (gotUpdatedMessages (QList<Message_ptr>, QStringList)),
 				A_,
 				SLOT (handleGotUpdatedMessages (QList<Message_ptr>, QStringList)));
-		connect (W_,
-				SIGNAL (gotOtherMessages (QList<QByteArray>, QStringList)),
-				A_,
-				SLOT (handleGotOtherMessages (QList<QByteArray>, QStringList)));
 		connect (W_,
 				SIGNAL (gotMessagesRemoved (QList<QByteArray>, QStringList)),
 				A_,
@@ -111,6 +107,10 @@ namespace Snails
 				SIGNAL (folderSyncFinished (QStringList, QByteArray)),
 				A_,
 				SLOT (handleFolderSyncFinished (QStringList, QByteArray)));
+		connect (W_,
+				SIGNAL (folderSyncStateChanged (QStringList, LeechCraft::Snails::FolderSyncState)),
+				A_,
+				SLOT (handleFolderSyncStateChanged (QStringList, LeechCraft::Snails::FolderSyncState)));
 
 		connect (W_,
 				SIGNAL (gotEntity (LeechCraft::Entity)),
@@ -41,6 +41,7 @@
 #include <vmime/net/transport.hpp>
 #include <vmime/net/store.hpp>
 #include <vmime/net/message.hpp>
+#include <vmime/net/imap/IMAPFolderStatus.hpp>
 #include <vmime/utility/datetimeUtils.hpp>
 #include <vmime/dateTime.hpp>
 #include <vmime/messageParser.hpp>
@@ -522,63 +523,72 @@ namespace Snails
 			const QByteArray& last)
 	{
 		for (const auto& folder : origFolders)
-			if (const auto& netFolder = GetFolder (folder, FolderMode::ReadWrite))
-				FetchMessagesInFolder (folder, netFolder, last);
+			FetchMessagesInFolder (folder, last);
 	}
 
 	namespace
 	{
-		MessageVector_t GetMessagesInFolder (const VmimeFolder_ptr& folder, const QByteArray& lastId)
+		QByteArray GetUID (const vmime::shared_ptr<vmime::net::message>& message)
 		{
-			if (lastId.isEmpty ())
-			{
-				const auto count = folder->getMessageCount ();
+			return static_cast<vmime::string> (message->getUID ()).c_str ();
+		}
 
-				MessageVector_t messages;
-				messages.reserve (count);
+		boost::optional<FolderSyncState> GetRemoteSyncState (const VmimeFolder_ptr& folder)
+		{
+			try
+			{
+				const auto& status = vmime::dynamicCast<vmime::net::imap::IMAPFolderStatus> (folder->getStatus ());
+				if (!status || !status->getUIDValidity ())
+					return {};
 
-				const auto chunkSize = 100;
-				for (int i = 0; i < count; i += chunkSize)
+				return FolderSyncState
 				{
-					const auto endVal = i + chunkSize;
-					const auto& set = vmime::net::messageSet::byNumber (i + 1, std::min (count, endVal));
-					try
-					{
-						const auto& theseMessages = folder->getMessages (set);
-						std::move (theseMessages.begin (), theseMessages.end (), std::back_inserter (messages));
-					}
-					catch (const std::exception& e)
-					{
-						qWarning () << Q_FUNC_INFO
-								<< "cannot get messages from"
-								<< i + 1
-								<< "to"
-								<< endVal
-								<< "because:"
-								<< e.what ();
-						return {};
-					}
-				}
-
-				return messages;
+					status->getUIDValidity (),
+					status->getUIDNext (),
+					status->getHighestModSeq (),
+					static_cast<int> (status->getMessageCount ())
+				};
 			}
-			else
+			catch (const std::exception& e)
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "cannot get folder status:"
+						<< e.what ();
+				return {};
+			}
+		}
+
+		MessageVector_t GetMessagesInFolder (const VmimeFolder_ptr& folder)
+		{
+			const auto count = folder->getMessageCount ();
+
+			MessageVector_t messages;
+			messages.reserve (count);
+
+			const auto chunkSize = 100;
+			for (int i = 0; i < count; i += chunkSize)
 			{
-				const auto& set = vmime::net::messageSet::byUID (lastId.constData (), "*");
+				const auto endVal = i + chunkSize;
+				const auto& set = vmime::net::messageSet::byNumber (i + 1, std::min (count, endVal));
 				try
 				{
-					return folder->getMessages (set);
+					const auto& theseMessages = folder->getMessages (set);
+					std::move (theseMessages.begin (), theseMessages.end (), std::back_inserter (messages));
 				}
 				catch (const std::exception& e)
 				{
 					qWarning () << Q_FUNC_INFO
 							<< "cannot get messages from"
-							<< lastId
+							<< i + 1
+							<< "to"
+							<< endVal
 							<< "because:"
 							<< e.what ();
-					return {};
+					throw;
 				}
 			}
+
+			return messages;
 		}
 	}
 
@@ -628,9 +638,25 @@ namespace Snails
 		return newMessages;
 	}
 
-	void AccountThreadWorker::FetchMessagesInFolder (const QStringList& folderName,
-			const VmimeFolder_ptr& folder, const QByteArray& lastId)
+	void AccountThreadWorker::FetchFlags (MessageVector_t& messages, const VmimeFolder_ptr& folder)
+	{
+		if (messages.empty ())
+			return;
+
+		const auto& context = tr ("Synchronizing flags for %1")
+				.arg (A_->GetName ());
+
+		folder->fetchMessages (messages,
+				vmime::net::fetchAttributes::FLAGS | vmime::net::fetchAttributes::UID,
+				MkPgListener (context));
+	}
+
+	void AccountThreadWorker::FetchMessagesInFolder (const QStringList& folderName, const QByteArray& lastId)
 	{
+		const auto& folder = GetFolder (folderName, FolderMode::NoChange);
+		if (!folder)
+			return;
+
 		const auto& changeGuard = ChangeListener_->Disable ();
 		Q_UNUSED (changeGuard)
 
@@ -642,55 +668,161 @@ namespace Snails
 
 		qDebug () << Q_FUNC_INFO << folderName << folder.get () << lastId;
 
-		auto messages = GetMessagesInFolder (folder, lastId);
-		auto newMessages = FetchVmimeMessages (messages, folder, folderName);
-		auto existing = Core::Instance ().GetStorage ()->LoadIDs (A_, folderName);
+		const auto storage = Core::Instance ().GetStorage ();
 
-		QList<QByteArray> ids;
+		const auto& remoteState = GetRemoteSyncState (folder);
+		auto localState = storage->GetFolderSyncState (A_, folderName);
+		auto existingIds = storage->LoadIDs (A_, folderName);
 
-		QList<Message_ptr> updatedMessages;
-		Q_FOREACH (const auto& msg, newMessages)
+		if (remoteState && localState)
 		{
-			if (!existing.contains (msg->GetFolderID ()))
-				continue;
+			if (remoteState->UIDValidity_ != localState->UIDValidity_)
+			{
+				qDebug () << Q_FUNC_INFO
+						<< "UIDVALIDITY changed for"
+						<< folderName
+						<< ", dropping"
+						<< existingIds.size ()
+						<< "local messages";
+				emit gotMessagesRemoved (existingIds, folderName);
+				existingIds.clear ();
+				localState.reset ();
+			}
+			else if (remoteState->HighestModSeq_ && *remoteState == *localState)
+			{
+				qDebug () << Q_FUNC_INFO
+						<< folderName
+						<< "is unchanged";
+				return;
+			}
+		}
+
+		const auto& existing = existingIds.toSet ();
 
-			existing.removeAll (msg->GetFolderID ());
-			newMessages.removeAll (msg);
+		quint32 knownUidNext = 0;
+		if (localState)
+			knownUidNext = localState->UIDNext_;
+		else if (!lastId.isEmpty () && !existing.isEmpty ())
+			knownUidNext = lastId.toUInt () + 1;
 
-			bool isUpdated = false;
+		MessageVector_t known;
+		MessageVector_t fresh;
+		QSet<QByteArray> remoteIds;
+		bool isFullyListed = false;
 
-			auto updated = Core::Instance ().GetStorage ()->LoadMessage (A_, folderName, msg->GetFolderID ());
+		try
+		{
+			GetFolder (folderName, FolderMode::ReadWrite);
 
-			if (updated->IsRead () != msg->IsRead ())
+			if (knownUidNext)
 			{
-				updated->SetRead (msg->IsRead ());
-				isUpdated = true;
+				const bool hasNew = !remoteState || !localState ||
+						remoteState->UIDNext_ > knownUidNext;
+				if (hasNew)
+				{
+					const auto& set = vmime::net::messageSet::byUID (QByteArray::number (knownUidNext).constData (), "*");
+					for (const auto& msg : folder->getMessages (set))
+					{
+						const auto& id = GetUID (msg);
+						remoteIds << id;
+						if (!existing.contains (id))
+							fresh.push_back (msg);
+					}
+				}
+
+				const bool flagsChanged = !remoteState || !localState ||
+						!remoteState->HighestModSeq_ ||
+						remoteState->HighestModSeq_ != localState->HighestModSeq_ ||
+						remoteState->MessageCount_ != existing.size () + static_cast<int> (fresh.size ());
+				if (knownUidNext > 1 && !existing.isEmpty () && flagsChanged)
+				{
+					const auto& set = vmime::net::messageSet::byUID ("1",
+							QByteArray::number (knownUidNext - 1).constData ());
+					known = folder->getAndFetchMessages (set,
+							vmime::net::fetchAttributes::FLAGS | vmime::net::fetchAttributes::UID);
+					isFullyListed = true;
+				}
 			}
+			else
+			{
+				auto all = GetMessagesInFolder (folder);
+				if (existing.isEmpty ())
+					fresh = std::move (all);
+				else
+				{
+					FetchFlags (all, folder);
+					known = std::move (all);
+					isFullyListed = true;
+				}
+			}
+		}
+		catch (const std::exception& e)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to synchronize"
+					<< folderName
+					<< e.what ();
+			return;
+		}
+
+		const auto& readStatuses = known.empty () ?
+				QHash<QByteArray, bool> {} :
+				storage->LoadReadStatuses (A_, folderName);
+
+		QList<Message_ptr> updatedMessages;
+		for (const auto& msg : known)
+		{
+			const auto& id = GetUID (msg);
+			remoteIds << id;
 
-			auto sumFolders = updated->GetFolders ();
-			if (!folderName.isEmpty () &&
-					!sumFolders.contains (folderName))
+			if (!existing.contains (id))
 			{
-				updated->AddFolder (folderName);
-				isUpdated = true;
+				fresh.push_back (msg);
+				continue;
 			}
 
-			updated->SetVmimeHeader (msg->GetVmimeHeader ());
+			const bool isRead = msg->getFlags () & vmime::net::message::FLAG_SEEN;
+			if (readStatuses.value (id) == isRead)
+				continue;
 
-			if (isUpdated)
+			try
+			{
+				const auto& updated = storage->LoadMessage (A_, folderName, id);
+				updated->SetRead (isRead);
 				updatedMessages << updated;
-			else
-				ids << msg->GetFolderID ();
+			}
+			catch (const std::exception& e)
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "unable to load message"
+						<< id
+						<< e.what ();
+			}
 		}
 
-		if (ids.size ())
-			emit gotOtherMessages (ids, folderName);
+		const auto& newMessages = FetchVmimeMessages (fresh, folder, folderName);
+
+		QList<QByteArray> removedIds;
+		if (isFullyListed)
+			removedIds = (existing - remoteIds).toList ();
+
+		qDebug () << Q_FUNC_INFO
+				<< folderName
+				<< "new:"
+				<< newMessages.size ()
+				<< "updated:"
+				<< updatedMessages.size ()
+				<< "removed:"
+				<< removedIds.size ();
+
+		if (!removedIds.isEmpty ())
+			emit gotMessagesRemoved (removedIds, folderName);
 
 		emit gotMsgHeaders (newMessages, folderName);
 		emit gotUpdatedMessages (updatedMessages, folderName);
 
-		if (lastId.isEmpty ())
-			emit gotMessagesRemoved (existing, folderName);
+		if (remoteState && newMessages.size () == static_cast<int> (fresh.size ()))
+			emit folderSyncStateChanged (folderName, *remoteState);
 	}
 
 	namespace
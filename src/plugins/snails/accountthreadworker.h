@@ -40,6 +40,7 @@
 #include "progresslistener.h"
 #include "message.h"
 #include "account.h"
+#include "folder.h"
 
 namespace LeechCraft
 {
@@ -48,8 +49,6 @@ namespace Snails
 	class Account;
 	class MessageChangeListener;
 
-	struct Folder;
-
 	typedef std::vector<vmime::shared_ptr<vmime::net::message>> MessageVector_t;
 	typedef vmime::shared_ptr<vmime::net::folder> VmimeFolder_ptr;
 
@@ -89,7 +88,8 @@ namespace Snails
 
 		void FetchMessagesIMAP (const QList<QStringList>&, const QByteArray&);
 		QList<Message_ptr> FetchVmimeMessages (MessageVector_t, const VmimeFolder_ptr&, const QStringList&);
-		void FetchMessagesInFolder (const QStringList&, const VmimeFolder_ptr&, const QByteArray&);
+		void FetchFlags (MessageVector_t&, const VmimeFolder_ptr&);
+		void FetchMessagesInFolder (const QStringList&, const QByteArray&);
 
 		void SyncIMAPFolders (vmime::shared_ptr<vmime::net::store>);
 		QList<Message_ptr> FetchFullMessages (const std::vector<vmime::shared_ptr<vmime::net::message>>&);
@@ -120,7 +120,6 @@ namespace Snails
 
 		void gotMsgHeaders (QList<Message_ptr>, QStringList);
 		void gotUpdatedMessages (QList<Message_ptr>, QStringList);
-		void gotOtherMessages (QList<QByteArray>, QStringList);
 		void gotMessagesRemoved (QList<QByteArray>, QStringList);
 
 		void messageBodyFetched (Message_ptr);
@@ -128,6 +127,7 @@ namespace Snails
 		void gotFolders (const QList<LeechCraft::Snails::Folder>&);
 
 		void folderSyncFinished (const QStringList& folder, const QByteArray& lastRequestedId);
+		void folderSyncStateChanged (const QStringList& folder, const LeechCraft::Snails::FolderSyncState& state);
 	};
 }
 }
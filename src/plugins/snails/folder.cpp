@@ -37,6 +37,19 @@ namespace Snails
 	{
 		return f1.Type_ == f2.Type_ && f1.Path_ == f2.Path_;
 	}
+
+	bool operator== (const FolderSyncState& s1, const FolderSyncState& s2)
+	{
+		return s1.UIDValidity_ == s2.UIDValidity_ &&
+				s1.UIDNext_ == s2.UIDNext_ &&
+				s1.HighestModSeq_ == s2.HighestModSeq_ &&
+				s1.MessageCount_ == s2.MessageCount_;
+	}
+
+	bool operator!= (const FolderSyncState& s1, const FolderSyncState& s2)
+	{
+		return !(s1 == s2);
+	}
 }
 }
 
@@ -56,11 +56,25 @@ namespace Snails
 	};
 
 	bool operator== (const Folder&, const Folder&);
+
+	struct FolderSyncState
+	{
+		quint32 UIDValidity_;
+		quint32 UIDNext_;
+		/* Zero if the server doesn't support CONDSTORE.
+		 */
+		quint64 HighestModSeq_;
+		int MessageCount_;
+	};
+
+	bool operator== (const FolderSyncState&, const FolderSyncState&);
+	bool operator!= (const FolderSyncState&, const FolderSyncState&);
 }
 }
 
 Q_DECLARE_METATYPE (LeechCraft::Snails::Folder)
 Q_DECLARE_METATYPE (QList<LeechCraft::Snails::Folder>)
+Q_DECLARE_METATYPE (LeechCraft::Snails::FolderSyncState)
 
 QDataStream& operator<< (QDataStream&, const LeechCraft::Snails::Folder&);
 QDataStream& operator>> (QDataStream&, LeechCraft::Snails::Folder&);
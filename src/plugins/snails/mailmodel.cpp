@@ -32,6 +32,7 @@
 #include <util/util.h>
 #include <interfaces/core/iiconthememanager.h>
 #include "core.h"
+#include "storage.h"
 #include "messagelistactionsmanager.h"
 
 namespace LeechCraft
@@ -40,7 +41,7 @@ namespace Snails
 {
 	struct MailModel::TreeNode : std::enable_shared_from_this<TreeNode>
 	{
-		Message_ptr Msg_;
+		MessageInfo Info_;
 
 		TreeNode_wptr Parent_;
 		QList<TreeNode_ptr> Children_;
@@ -59,7 +60,7 @@ namespace Snails
 			{
 				qWarning () << Q_FUNC_INFO
 						<< "unknown row for item"
-						<< Msg_->GetFolderID ();
+						<< Info_.FolderId_;
 				return -1;
 			}
 
@@ -68,19 +69,21 @@ namespace Snails
 
 		TreeNode () = default;
 
-		TreeNode (const Message_ptr& msg, const TreeNode_ptr& parent)
-		: Msg_ { msg }
+		TreeNode (const MessageInfo& info, const TreeNode_ptr& parent)
+		: Info_ (info)
 		, Parent_ { parent }
 		{
 		}
 	};
 
-	MailModel::MailModel (const MessageListActionsManager *actsMgr, QObject *parent)
+	MailModel::MailModel (const MessageListActionsManager *actsMgr, Account *acc, QObject *parent)
 	: QAbstractItemModel { parent }
 	, ActionsMgr_ { actsMgr }
+	, Acc_ { acc }
 	, Headers_ { tr ("From"), {}, {}, {}, tr ("Subject"), tr ("Date"), tr ("Size")  }
 	, Folder_ { "INBOX" }
 	, Root_ { std::make_shared<TreeNode> () }
+	, MsgId2Actions_ { 1000 }
 	{
 	}
 
@@ -103,7 +106,7 @@ namespace Snails
 		if (structItem == Root_.get ())
 			return {};
 
-		const auto& msg = structItem->Msg_;
+		const auto& info = structItem->Info_;
 
 		const auto column = static_cast<Column> (index.column ());
 
@@ -131,7 +134,7 @@ namespace Snails
 			switch (column)
 			{
 			case Column::StatusIcon:
-				if (!msg->IsRead ())
+				if (!info.IsRead_)
 					iconName = "mail-unread-new";
 				else if (structItem->UnreadChildren_.size ())
 					iconName = "mail-unread";
@@ -139,7 +142,7 @@ namespace Snails
 					iconName = "mail-read";
 				break;
 			case Column::AttachIcon:
-				if (!msg->GetAttachments ().isEmpty ())
+				if (info.HasAttachments_)
 					iconName = "mail-attachment";
 			default:
 				break;
@@ -151,9 +154,9 @@ namespace Snails
 			return Core::Instance ().GetProxy ()->GetIconThemeManager ()->GetIcon (iconName);
 		}
 		case ID:
-			return msg->GetFolderID ();
+			return info.FolderId_;
 		case IsRead:
-			return msg->IsRead ();
+			return info.IsRead_;
 		case UnreadChildrenCount:
 			return structItem->UnreadChildren_.size ();
 		default:
@@ -163,25 +166,22 @@ namespace Snails
 		switch (column)
 		{
 		case Column::From:
-		{
-			const auto& addr = msg->GetAddress (Message::Address::From);
-			return addr.first.isEmpty () ? addr.second : addr.first;
-		}
+			return info.FromName_.isEmpty () ? info.FromEmail_ : info.FromName_;
 		case Column::Subject:
 			if (role != MessageActions)
-				return msg->GetSubject ();
+				return info.Subject_;
 			else
-				return QVariant::fromValue (MsgId2Actions_.value (msg->GetFolderID ()));
+				return QVariant::fromValue (GetMessageActions (info.FolderId_));
 		case Column::Date:
 			if (role == Sort)
-				return msg->GetDate ();
+				return info.Date_;
 			else
-				return msg->GetDate ().toLocalTime ().toString ();
+				return info.Date_.toLocalTime ().toString ();
 		case Column::Size:
 			if (role == Sort)
-				return msg->GetSize ();
+				return info.Size_;
 			else
-				return Util::MakePrettySize (msg->GetSize ());
+				return Util::MakePrettySize (info.Size_);
 		case Column::UnreadChildren:
 		{
 			const auto unread = structItem->UnreadChildren_.size ();
@@ -251,128 +251,148 @@ namespace Snails
 
 	Message_ptr MailModel::GetMessage (const QByteArray& id) const
 	{
-		return GetMessageByFolderId (id);
+		if (!FolderId2Nodes_.contains (id))
+			return {};
+
+		try
+		{
+			return Core::Instance ().GetStorage ()->LoadMessage (Acc_, Folder_, id);
+		}
+		catch (const std::exception& e)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to load message"
+					<< id.toHex ()
+					<< e.what ();
+			return {};
+		}
 	}
 
 	void MailModel::Clear ()
 	{
-		if (Messages_.isEmpty ())
+		if (Root_->Children_.isEmpty ())
 			return;
 
-		beginRemoveRows ({}, 0, Messages_.size () - 1);
-		Messages_.clear ();
+		beginResetModel ();
 		Root_->Children_.clear ();
 		FolderId2Nodes_.clear ();
 		MsgId2FolderId_.clear ();
-		endRemoveRows ();
+		endResetModel ();
 
 		MsgId2Actions_.clear ();
 	}
 
-	void MailModel::Append (QList<Message_ptr> messages)
+	void MailModel::Append (const QList<Message_ptr>& messages)
 	{
-		if (messages.isEmpty ())
-			return;
-
-		for (auto i = messages.begin (); i != messages.end (); )
-		{
-			const auto& msg = *i;
-
-			if (!msg->GetFolders ().contains (Folder_))
-			{
-				i = messages.erase (i);
-				continue;
-			}
+		QList<MessageInfo> infos;
+		for (const auto& msg : messages)
+			if (msg->GetFolders ().contains (Folder_))
+				infos << ToMessageInfo (msg);
 
-			if (Update (msg))
-			{
-				i = messages.erase (i);
-				continue;
-			}
+		Append (infos);
+	}
 
-			++i;
+	void MailModel::Append (QList<MessageInfo> infos)
+	{
+		for (auto i = infos.begin (); i != infos.end (); )
+		{
+			if (Update (*i))
+				i = infos.erase (i);
+			else
+				++i;
 		}
 
-		if (messages.isEmpty ())
+		if (infos.isEmpty ())
 			return;
 
-		std::sort (messages.begin (), messages.end (),
-				[] (const Message_ptr& left, const Message_ptr& right)
-					{ return left->GetDate () < right->GetDate (); });
+		std::sort (infos.begin (), infos.end (),
+				[] (const MessageInfo& left, const MessageInfo& right)
+					{ return left.Date_ < right.Date_; });
 
-		Messages_ += messages;
+		for (const auto& info : infos)
+			if (!info.MessageId_.isEmpty ())
+				MsgId2FolderId_ [info.MessageId_] = info.FolderId_;
 
-		for (const auto& msg : messages)
-		{
-			const auto& msgId = msg->GetMessageID ();
-			if (!msgId.isEmpty ())
-				MsgId2FolderId_ [msgId] = msg->GetFolderID ();
+		/* Filling an empty model row by row is way too slow for large
+		 * folders, so it's reset once instead.
+		 */
+		const bool reset = Root_->Children_.isEmpty ();
+		if (reset)
+			beginResetModel ();
 
-			const auto& acts = ActionsMgr_->GetMessageActions (msg);
-			if (!acts.isEmpty ())
-				MsgId2Actions_ [msg->GetFolderID ()] = acts;
-		}
+		for (const auto& info : infos)
+			if (!AppendStructured (info, !reset))
+				AppendToRoot (info, !reset);
 
-		for (const auto& msg : messages)
-			if (!AppendStructured (msg))
-			{
-				const auto& node = std::make_shared<TreeNode> (msg, Root_);
-				beginInsertRows ({}, Root_->Children_.size (), Root_->Children_.size ());
-				Root_->Children_.append (node);
-				FolderId2Nodes_ [msg->GetFolderID ()] << node;
-				endInsertRows ();
-			}
+		if (reset)
+			endResetModel ();
 
 		emit messageListUpdated ();
 	}
 
 	bool MailModel::Update (const Message_ptr& msg)
 	{
-		const auto pos = std::find_if (Messages_.begin (), Messages_.end (),
-				[&msg] (const Message_ptr& other)
-					{ return other->GetFolderID () == msg->GetFolderID (); });
-		if (pos == Messages_.end ())
+		if (!FolderId2Nodes_.contains (msg->GetFolderID ()))
 			return false;
 
-		if (*pos != msg)
-		{
-			const auto readChanged = (*pos)->IsRead () != msg->IsRead ();
+		MsgId2Actions_.remove (msg->GetFolderID ());
+		return Update (ToMessageInfo (msg));
+	}
 
-			*pos = msg;
-			for (const auto& indexPair : GetIndexes (msg->GetFolderID (), { 0, columnCount () - 1 }))
-			{
-				for (const auto& index : indexPair)
-					static_cast<TreeNode*> (index.internalPointer ())->Msg_ = msg;
-				emit dataChanged (indexPair.value (0), indexPair.value (1));
-			}
+	bool MailModel::Update (const MessageInfo& info)
+	{
+		const auto& nodes = FolderId2Nodes_.value (info.FolderId_);
+		if (nodes.isEmpty ())
+			return false;
+
+		const auto readChanged = nodes.first ()->Info_.IsRead_ != info.IsRead_;
 
-			if (readChanged)
-				UpdateParentReadCount (msg->GetFolderID (), !msg->IsRead ());
+		for (const auto& indexPair : GetIndexes (info.FolderId_, { 0, columnCount () - 1 }))
+		{
+			static_cast<TreeNode*> (indexPair.value (0).internalPointer ())->Info_ = info;
+			emit dataChanged (indexPair.value (0), indexPair.value (1));
 		}
 
+		if (readChanged)
+			UpdateParentReadCount (info.FolderId_, !info.IsRead_);
+
 		return true;
 	}
 
 	bool MailModel::Remove (const QByteArray& id)
 	{
-		const auto msgPos = std::find_if (Messages_.begin (), Messages_.end (),
-				[&id] (const Message_ptr& other) { return other->GetFolderID () == id; });
-		if (msgPos == Messages_.end ())
+		const auto& nodes = FolderId2Nodes_.value (id);
+		if (nodes.isEmpty ())
 			return false;
 
+		const auto msgId = nodes.first ()->Info_.MessageId_;
+
 		UpdateParentReadCount (id, false);
 
-		for (const auto& node : FolderId2Nodes_.value (id))
+		for (const auto& node : nodes)
 			RemoveNode (node);
 
 		FolderId2Nodes_.remove (id);
-		MsgId2FolderId_.remove ((*msgPos)->GetMessageID ());
-		Messages_.erase (msgPos);
+		MsgId2FolderId_.remove (msgId);
+		MsgId2Actions_.remove (id);
 
 		return true;
 	}
 
-	void MailModel::UpdateParentReadCount (const QByteArray& folderId, bool addUnread)
+	QList<MessageListActionInfo> MailModel::GetMessageActions (const QByteArray& id) const
+	{
+		if (const auto actions = MsgId2Actions_.object (id))
+			return *actions;
+
+		QList<MessageListActionInfo> actions;
+		if (const auto& msg = GetMessage (id))
+			actions = ActionsMgr_->GetMessageActions (msg);
+
+		MsgId2Actions_.insert (id, new QList<MessageListActionInfo> { actions });
+		return actions;
+	}
+
+	void MailModel::UpdateParentReadCount (const QByteArray& folderId, bool addUnread, bool notify)
 	{
 		QList<TreeNode_ptr> nodes;
 		for (const auto& node : FolderId2Nodes_.value (folderId))
@@ -395,7 +415,7 @@ namespace Snails
 			else if (!addUnread && item->UnreadChildren_.remove (folderId))
 				emitUpdate = true;
 
-			if (emitUpdate)
+			if (emitUpdate && notify)
 			{
 				const auto& leftIdx = createIndex (item->Row (), 0, item.get ());
 				const auto& rightIdx = createIndex (item->Row (), columnCount () - 1, item.get ());
@@ -442,13 +462,22 @@ namespace Snails
 		endRemoveRows ();
 	}
 
-	bool MailModel::AppendStructured (const Message_ptr& msg)
+	void MailModel::AppendToRoot (const MessageInfo& info, bool notify)
 	{
-		auto refs = msg->GetReferences ();
-		for (const auto& replyTo : msg->GetInReplyTo ())
-			if (!refs.contains (replyTo))
-				refs << replyTo;
+		const auto& node = std::make_shared<TreeNode> (info, Root_);
+		const auto row = Root_->Children_.size ();
+
+		if (notify)
+			beginInsertRows ({}, row, row);
+		Root_->Children_.append (node);
+		FolderId2Nodes_ [info.FolderId_] << node;
+		if (notify)
+			endInsertRows ();
+	}
 
+	bool MailModel::AppendStructured (const MessageInfo& info, bool notify)
+	{
+		const auto& refs = info.References_;
 		if (refs.isEmpty ())
 			return false;
 
@@ -462,23 +491,24 @@ namespace Snails
 		if (folderId.isEmpty ())
 			return false;
 
-		const auto& indexes = GetIndexes (folderId, 0);
-		for (const auto& parentIndex : indexes)
+		const auto& parentNodes = FolderId2Nodes_.value (folderId);
+		for (const auto& parentNode : parentNodes)
 		{
-			const auto parentNode = static_cast<TreeNode*> (parentIndex.internalPointer ());
 			const auto row = parentNode->Children_.size ();
 
-			const auto& node = std::make_shared<TreeNode> (msg, parentNode->shared_from_this ());
-			beginInsertRows (parentIndex, row, row);
+			const auto& node = std::make_shared<TreeNode> (info, parentNode);
+			if (notify)
+				beginInsertRows (createIndex (parentNode->Row (), 0, parentNode.get ()), row, row);
 			parentNode->Children_ << node;
-			FolderId2Nodes_ [msg->GetFolderID ()] << node;
-			endInsertRows ();
+			FolderId2Nodes_ [info.FolderId_] << node;
+			if (notify)
+				endInsertRows ();
 		}
 
-		if (!msg->IsRead ())
-			UpdateParentReadCount (msg->GetFolderID (), true);
+		if (!info.IsRead_)
+			UpdateParentReadCount (info.FolderId_, true, notify);
 
-		return !indexes.isEmpty ();
+		return !parentNodes.isEmpty ();
 	}
 
 	QList<QModelIndex> MailModel::GetIndexes (const QByteArray& folderId, int column) const
@@ -501,15 +531,5 @@ namespace Snails
 		}
 		return result;
 	}
-
-	Message_ptr MailModel::GetMessageByFolderId (const QByteArray& id) const
-	{
-		const auto pos = std::find_if (Messages_.begin (), Messages_.end (),
-				[&id] (const Message_ptr& msg) { return msg->GetFolderID () == id; });
-		if (pos == Messages_.end ())
-			return {};
-
-		return *pos;
-	}
 }
 }
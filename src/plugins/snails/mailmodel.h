@@ -32,19 +32,24 @@
 #include <QStringList>
 #include <QAbstractItemModel>
 #include <QList>
+#include <QCache>
 #include "message.h"
+#include "messageinfo.h"
 #include "messagelistactioninfo.h"
 
 namespace LeechCraft
 {
 namespace Snails
 {
+	class Account;
 	class MessageListActionsManager;
+
 	class MailModel : public QAbstractItemModel
 	{
 		Q_OBJECT
 
 		const MessageListActionsManager * const ActionsMgr_;
+		Account * const Acc_;
 
 		const QStringList Headers_;
 
@@ -55,11 +60,13 @@ namespace Snails
 		typedef std::weak_ptr<TreeNode> TreeNode_wptr;
 		const TreeNode_ptr Root_;
 
-		QList<Message_ptr> Messages_;
 		QHash<QByteArray, QList<TreeNode_ptr>> FolderId2Nodes_;
 		QHash<QByteArray, QByteArray> MsgId2FolderId_;
 
-		QHash<QByteArray, QList<MessageListActionInfo>> MsgId2Actions_;
+		/* Computing the actions requires the full message, so they are
+		 * only computed for the rows that are actually shown.
+		 */
+		mutable QCache<QByteArray, QList<MessageListActionInfo>> MsgId2Actions_;
 	public:
 		enum class Column
 		{
@@ -81,7 +88,7 @@ namespace Snails
 			MessageActions
 		};
 
-		MailModel (const MessageListActionsManager*, QObject* = 0);
+		MailModel (const MessageListActionsManager*, Account*, QObject* = 0);
 
 		QVariant headerData (int, Qt::Orientation, int) const;
 		int columnCount (const QModelIndex& = {}) const;
@@ -98,19 +105,23 @@ namespace Snails
 
 		void Clear ();
 
-		void Append (QList<Message_ptr>);
+		void Append (const QList<Message_ptr>&);
+		void Append (QList<MessageInfo>);
 
 		bool Update (const Message_ptr&);
+		bool Update (const MessageInfo&);
 		bool Remove (const QByteArray&);
 	private:
-		void UpdateParentReadCount (const QByteArray&, bool);
+		QList<MessageListActionInfo> GetMessageActions (const QByteArray&) const;
+
+		void UpdateParentReadCount (const QByteArray&, bool addUnread, bool notify = true);
 
 		void RemoveNode (const TreeNode_ptr&);
-		bool AppendStructured (const Message_ptr&);
+		void AppendToRoot (const MessageInfo&, bool notify);
+		bool AppendStructured (const MessageInfo&, bool notify);
 
 		QList<QModelIndex> GetIndexes (const QByteArray& folderId, int column) const;
 		QList<QList<QModelIndex>> GetIndexes (const QByteArray& folderId, const QList<int>& columns) const;
-		Message_ptr GetMessageByFolderId (const QByteArray&) const;
 	signals:
 		void messageListUpdated ();
 	};
@@ -43,11 +43,15 @@ namespace Snails
 	, Acc_ { acc }
 	, MsgListActionsMgr_ { new MessageListActionsManager { Acc_, this } }
 	{
+		connect (Core::Instance ().GetStorage (),
+				SIGNAL (messageHeadersFilled (Account*, QStringList, QList<MessageInfo>)),
+				this,
+				SLOT (handleMessageHeadersFilled (Account*, QStringList, QList<MessageInfo>)));
 	}
 
 	MailModel* MailModelsManager::CreateModel ()
 	{
-		auto model = new MailModel { MsgListActionsMgr_, Acc_ };
+		auto model = new MailModel { MsgListActionsMgr_, Acc_, Acc_ };
 		Models_ << model;
 
 		connect (model,
@@ -78,10 +82,9 @@ namespace Snails
 		mailModel->SetFolder (path);
 
 		const auto storage = Core::Instance ().GetStorage ();
-		const auto& ids = storage->LoadIDs (Acc_, path);
-		const auto& messages = storage->LoadMessages (Acc_, path, ids);
+		mailModel->Append (storage->LoadMessageInfos (Acc_, path));
 
-		mailModel->Append (messages);
+		const auto& ids = storage->LoadIDs (Acc_, path);
 
 		Acc_->Synchronize (path, ids.isEmpty () ? QByteArray {} : ids.last ());
 	}
@@ -110,5 +113,16 @@ namespace Snails
 	{
 		Models_.removeAll (static_cast<MailModel*> (modelObj));
 	}
+
+	void MailModelsManager::handleMessageHeadersFilled (Account *acc,
+			const QStringList& folder, const QList<MessageInfo>& infos)
+	{
+		if (acc != Acc_)
+			return;
+
+		for (const auto model : Models_)
+			if (model->GetCurrentFolder () == folder)
+				model->Append (infos);
+	}
 }
 }
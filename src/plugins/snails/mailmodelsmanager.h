@@ -31,6 +31,7 @@
 
 #include <memory>
 #include <QObject>
+#include "messageinfo.h"
 
 namespace LeechCraft
 {
@@ -63,6 +64,7 @@ namespace Snails
 		void Remove (const QList<QByteArray>&);
 	private slots:
 		void handleModelDestroyed (QObject*);
+		void handleMessageHeadersFilled (Account*, const QStringList&, const QList<MessageInfo>&);
 	};
 }
 }
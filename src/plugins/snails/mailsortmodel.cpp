@@ -46,6 +46,40 @@ namespace Snails
 		handleRespectUnreadRootsChanged ();
 	}
 
+	void MailSortModel::SetSearchResults (const QSet<QByteArray>& ids)
+	{
+		HasSearchResults_ = true;
+		SearchResults_ = ids;
+		invalidateFilter ();
+	}
+
+	void MailSortModel::ClearSearchResults ()
+	{
+		if (!HasSearchResults_)
+			return;
+
+		HasSearchResults_ = false;
+		SearchResults_.clear ();
+		invalidateFilter ();
+	}
+
+	bool MailSortModel::filterAcceptsRow (int row, const QModelIndex& parent) const
+	{
+		if (!HasSearchResults_)
+			return true;
+
+		const auto& idx = sourceModel ()->index (row, 0, parent);
+		if (SearchResults_.contains (idx.data (MailModel::MailRole::ID).toByteArray ()))
+			return true;
+
+		/* Threads containing a matching message are kept visible. */
+		for (int i = 0, rc = sourceModel ()->rowCount (idx); i < rc; ++i)
+			if (filterAcceptsRow (i, idx))
+				return true;
+
+		return false;
+	}
+
 	bool MailSortModel::lessThan (const QModelIndex& left, const QModelIndex& right) const
 	{
 		if (left.parent ().isValid () ||
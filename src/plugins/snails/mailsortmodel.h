@@ -30,6 +30,7 @@
 #pragma once
 
 #include <QSortFilterProxyModel>
+#include <QSet>
 
 namespace LeechCraft
 {
@@ -41,9 +42,16 @@ namespace Snails
 
 		bool RespectUnreadRoots_ = false;
 		bool RespectUnreadChildren_ = false;
+
+		bool HasSearchResults_ = false;
+		QSet<QByteArray> SearchResults_;
 	public:
 		MailSortModel (QObject* = nullptr);
+
+		void SetSearchResults (const QSet<QByteArray>&);
+		void ClearSearchResults ();
 	protected:
+		bool filterAcceptsRow (int, const QModelIndex&) const;
 		bool lessThan (const QModelIndex&, const QModelIndex&) const;
 	private slots:
 		void handleRespectUnreadRootsChanged ();
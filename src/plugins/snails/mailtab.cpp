@@ -35,6 +35,8 @@
 #include <QMenu>
 #include <QFileDialog>
 #include <QToolButton>
+#include <QTimer>
+#include <QElapsedTimer>
 #include <util/util.h>
 #include <util/tags/categoryselector.h>
 #include <util/sys/extensionsdata.h>
@@ -67,6 +69,7 @@ namespace Snails
 	, TabClass_ (tc)
 	, PMT_ (pmt)
 	, MailSortFilterModel_ (new MailSortModel { this })
+	, SearchTimer_ (new QTimer { this })
 	{
 		Ui_.setupUi (this);
 		//Ui_.MailTreeLay_->insertWidget (0, MsgToolbar_);
@@ -130,6 +133,17 @@ namespace Snails
 				this,
 				SLOT (handleMailSelected ()));
 
+		SearchTimer_->setSingleShot (true);
+		SearchTimer_->setInterval (300);
+		connect (SearchTimer_,
+				SIGNAL (timeout ()),
+				this,
+				SLOT (handleSearch ()));
+		connect (Ui_.SearchLine_,
+				SIGNAL (textChanged (QString)),
+				SearchTimer_,
+				SLOT (start ()));
+
 		FillTabToolbarActions ();
 	}
 
@@ -548,6 +562,7 @@ namespace Snails
 					0);
 
 			MailSortFilterModel_->setSourceModel (nullptr);
+			MailSortFilterModel_->ClearSearchResults ();
 			MailModel_.reset ();
 			CurrAcc_.reset ();
 			ReadMarker_.reset ();
@@ -602,10 +617,38 @@ namespace Snails
 		CurrAcc_->GetMailModelsManager ()->ShowFolder (folder, MailModel_.get ());
 		Ui_.MailTree_->setCurrentIndex ({});
 
+		handleSearch ();
 		handleMailSelected ();
 		rebuildOpsToFolders ();
 	}
 
+	void MailTab::handleSearch ()
+	{
+		SearchTimer_->stop ();
+
+		const auto& text = Ui_.SearchLine_->text ().trimmed ();
+		if (text.isEmpty () || !CurrAcc_ || !MailModel_)
+		{
+			MailSortFilterModel_->ClearSearchResults ();
+			return;
+		}
+
+		QElapsedTimer timer;
+		timer.start ();
+
+		const auto& ids = Core::Instance ().GetStorage ()->Search (CurrAcc_.get (),
+				MailModel_->GetCurrentFolder (), text);
+		qDebug () << Q_FUNC_INFO
+				<< ids.size ()
+				<< "results for"
+				<< text
+				<< "in"
+				<< timer.elapsed ()
+				<< "ms";
+
+		MailSortFilterModel_->SetSearchResults (ids.toSet ());
+	}
+
 	void MailTab::handleMailSelected ()
 	{
 		if (!CurrAcc_)
@@ -40,6 +40,7 @@ class QStandardItemModel;
 class QStandardItem;
 class QSortFilterProxyModel;
 class QToolButton;
+class QTimer;
 
 namespace LeechCraft
 {
@@ -47,6 +48,7 @@ namespace Snails
 {
 	class MessageListEditorManager;
 	class MailTabReadMarker;
+	class MailSortModel;
 
 	class MailTab : public QWidget
 				  , public ITabWidget
@@ -74,7 +76,8 @@ namespace Snails
 		MessageListEditorManager *MsgListEditorMgr_;
 
 		std::shared_ptr<MailModel> MailModel_;
-		QSortFilterProxyModel *MailSortFilterModel_;
+		MailSortModel * const MailSortFilterModel_;
+		QTimer * const SearchTimer_;
 		Account_ptr CurrAcc_;
 		Message_ptr CurrMsg_;
 
@@ -104,6 +107,8 @@ namespace Snails
 		void handleCurrentTagChanged (const QModelIndex&);
 		void handleMailSelected ();
 
+		void handleSearch ();
+
 		void rebuildOpsToFolders ();
 
 		void handleReply ();
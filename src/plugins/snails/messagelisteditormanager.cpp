@@ -29,6 +29,9 @@
 
 #include "messagelisteditormanager.h"
 #include <QTreeView>
+#include <QScrollBar>
+#include <QTimer>
+#include <QEvent>
 #include "mailtreedelegate.h"
 #include "mailmodel.h"
 
@@ -42,14 +45,86 @@ namespace Snails
 	, View_ { view }
 	, Delegate_ { delegate }
 	{
+		View_->viewport ()->installEventFilter (this);
+
+		connect (View_->verticalScrollBar (),
+				SIGNAL (valueChanged (int)),
+				this,
+				SLOT (scheduleUpdate ()));
+		connect (View_,
+				SIGNAL (expanded (QModelIndex)),
+				this,
+				SLOT (scheduleUpdate ()));
+		connect (View_,
+				SIGNAL (collapsed (QModelIndex)),
+				this,
+				SLOT (scheduleUpdate ()));
+
+		const auto model = View_->model ();
+		connect (model,
+				SIGNAL (layoutChanged ()),
+				this,
+				SLOT (scheduleUpdate ()));
+		connect (model,
+				SIGNAL (modelReset ()),
+				this,
+				SLOT (scheduleUpdate ()));
+		connect (model,
+				SIGNAL (rowsInserted (QModelIndex, int, int)),
+				this,
+				SLOT (scheduleUpdate ()));
+		connect (model,
+				SIGNAL (rowsRemoved (QModelIndex, int, int)),
+				this,
+				SLOT (scheduleUpdate ()));
+	}
+
+	bool MessageListEditorManager::eventFilter (QObject*, QEvent *event)
+	{
+		if (event->type () == QEvent::Resize)
+			scheduleUpdate ();
+		return false;
 	}
 
 	void MessageListEditorManager::handleMessageListUpdated ()
 	{
-		const auto model = View_->model ();
-		for (int i = 0, rc = model->rowCount (); i < rc; ++i)
-			View_->openPersistentEditor (model->index (i,
-						static_cast<int> (MailModel::Column::Subject)));
+		scheduleUpdate ();
+	}
+
+	void MessageListEditorManager::scheduleUpdate ()
+	{
+		if (UpdateScheduled_)
+			return;
+
+		UpdateScheduled_ = true;
+		QTimer::singleShot (0, this, SLOT (updateVisibleEditors ()));
+	}
+
+	void MessageListEditorManager::updateVisibleEditors ()
+	{
+		UpdateScheduled_ = false;
+
+		/* Creating an editor requires the full message, so editors are
+		 * only kept for the rows that are currently visible.
+		 */
+		const auto column = static_cast<int> (MailModel::Column::Subject);
+		const auto& viewportRect = View_->viewport ()->rect ();
+
+		QList<QPersistentModelIndex> visible;
+		for (auto idx = View_->indexAt (viewportRect.topLeft ());
+				idx.isValid () && View_->visualRect (idx).top () <= viewportRect.bottom ();
+				idx = View_->indexBelow (idx))
+			visible << idx.sibling (idx.row (), column);
+
+		for (const auto& idx : OpenedEditors_)
+			if (idx.isValid () && !visible.contains (idx))
+				View_->closePersistentEditor (idx);
+
+		for (const auto& idx : visible)
+			if (!OpenedEditors_.contains (idx))
+				View_->openPersistentEditor (idx);
+
+		OpenedEditors_ = visible;
 	}
 }
 }
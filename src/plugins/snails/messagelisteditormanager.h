@@ -31,6 +31,7 @@
 
 #include <QObject>
 #include <QModelIndex>
+#include <QPersistentModelIndex>
 
 class QTreeView;
 
@@ -46,10 +47,18 @@ namespace Snails
 
 		QTreeView * const View_;
 		MailTreeDelegate * const Delegate_;
+
+		QList<QPersistentModelIndex> OpenedEditors_;
+		bool UpdateScheduled_ = false;
 	public:
 		MessageListEditorManager (QTreeView*, MailTreeDelegate*, QObject* = nullptr);
+
+		bool eventFilter (QObject*, QEvent*);
 	public slots:
 		void handleMessageListUpdated ();
+	private slots:
+		void scheduleUpdate ();
+		void updateVisibleEditors ();
 	};
 }
 }
@@ -0,0 +1,258 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+
+#include "messagepack.h"
+#include <algorithm>
+#include <stdexcept>
+#include <QFile>
+#include <QFileInfo>
+#include <QtEndian>
+#include <QtDebug>
+
+namespace LeechCraft
+{
+namespace Snails
+{
+	MessagePack::MessagePack (const QDir& dir)
+	: Dir_ { dir }
+	{
+		const auto& segments = GetSegments ();
+		OpenWriter (segments.isEmpty () ? 0 : segments.last ());
+	}
+
+	MessagePack::~MessagePack ()
+	{
+		for (const auto segment : Mapped_.keys ())
+			Unmap (segment);
+	}
+
+	PackLocation MessagePack::Append (const QByteArray& data)
+	{
+		QMutexLocker locker { &Mutex_ };
+
+		if (WriterSize_ >= MaxSegmentSize)
+			OpenWriter (CurrentSegment_ + 1);
+
+		const PackLocation location { CurrentSegment_, WriterSize_, data.size () };
+
+		uchar header [RecordHeaderSize];
+		qToBigEndian<quint32> (data.size (), header);
+		if (Writer_->write (reinterpret_cast<const char*> (header), RecordHeaderSize) != RecordHeaderSize ||
+				Writer_->write (data) != data.size ())
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to write to"
+					<< Writer_->fileName ()
+					<< Writer_->errorString ();
+			throw std::runtime_error ("Unable to append to the message pack.");
+		}
+
+		WriterSize_ += RecordHeaderSize + data.size ();
+
+		return location;
+	}
+
+	bool MessagePack::Flush ()
+	{
+		QMutexLocker locker { &Mutex_ };
+
+		if (Writer_->flush ())
+			return true;
+
+		qWarning () << Q_FUNC_INFO
+				<< "unable to flush"
+				<< Writer_->fileName ()
+				<< Writer_->errorString ();
+		return false;
+	}
+
+	QByteArray MessagePack::Read (const PackLocation& location)
+	{
+		QMutexLocker locker { &Mutex_ };
+
+		const auto data = Map (location.Segment_,
+				location.Offset_ + RecordHeaderSize + location.Length_);
+		if (!data)
+			return {};
+
+		const auto record = data + location.Offset_;
+		const auto length = qFromBigEndian<quint32> (record);
+		if (length != static_cast<quint32> (location.Length_))
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "record length mismatch in segment"
+					<< location.Segment_
+					<< "at"
+					<< location.Offset_
+					<< length
+					<< location.Length_;
+			return {};
+		}
+
+		return QByteArray { reinterpret_cast<const char*> (record + RecordHeaderSize), location.Length_ };
+	}
+
+	QList<int> MessagePack::GetSegments () const
+	{
+		QList<int> result;
+		for (const auto& name : Dir_.entryList ({ "*.pack" }, QDir::Files))
+		{
+			bool ok = false;
+			const auto segment = name.section ('.', 0, 0).toInt (&ok);
+			if (ok)
+				result << segment;
+		}
+		std::sort (result.begin (), result.end ());
+		return result;
+	}
+
+	int MessagePack::GetCurrentSegment () const
+	{
+		QMutexLocker locker { &Mutex_ };
+		return CurrentSegment_;
+	}
+
+	qint64 MessagePack::GetSegmentSize (int segment) const
+	{
+		QMutexLocker locker { &Mutex_ };
+		if (segment == CurrentSegment_)
+			return WriterSize_;
+
+		return QFileInfo { GetSegmentPath (segment) }.size ();
+	}
+
+	void MessagePack::RemoveSegment (int segment)
+	{
+		QMutexLocker locker { &Mutex_ };
+		if (segment == CurrentSegment_)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "refusing to remove the current segment"
+					<< segment;
+			return;
+		}
+
+		Unmap (segment);
+		Mapped_.remove (segment);
+
+		if (!QFile::remove (GetSegmentPath (segment)))
+			qWarning () << Q_FUNC_INFO
+					<< "unable to remove segment"
+					<< segment;
+	}
+
+	QString MessagePack::GetSegmentPath (int segment) const
+	{
+		return Dir_.filePath (QString ("%1.pack").arg (segment, 6, 10, QChar ('0')));
+	}
+
+	void MessagePack::OpenWriter (int segment)
+	{
+		const auto& writer = std::make_shared<QFile> (GetSegmentPath (segment));
+		if (!writer->open (QIODevice::WriteOnly | QIODevice::Append))
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to open"
+					<< writer->fileName ()
+					<< writer->errorString ();
+			throw std::runtime_error ("Unable to open the message pack segment.");
+		}
+
+		if (Writer_)
+			Writer_->flush ();
+
+		Writer_ = writer;
+		WriterSize_ = Writer_->size ();
+		CurrentSegment_ = segment;
+	}
+
+	const uchar* MessagePack::Map (int segment, qint64 minSize)
+	{
+		auto& mapped = Mapped_ [segment];
+		if (mapped.Data_ && mapped.Size_ >= minSize)
+			return mapped.Data_;
+
+		if (segment == CurrentSegment_)
+			Writer_->flush ();
+
+		if (!mapped.File_)
+		{
+			const auto& file = std::make_shared<QFile> (GetSegmentPath (segment));
+			if (!file->open (QIODevice::ReadOnly))
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "unable to open"
+						<< file->fileName ()
+						<< file->errorString ();
+				Mapped_.remove (segment);
+				return nullptr;
+			}
+			mapped.File_ = file;
+		}
+
+		Unmap (segment);
+
+		const auto size = mapped.File_->size ();
+		if (size < minSize)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "segment"
+					<< segment
+					<< "is too short:"
+					<< size
+					<< minSize;
+			return nullptr;
+		}
+
+		mapped.Data_ = mapped.File_->map (0, size);
+		if (!mapped.Data_)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to map"
+					<< mapped.File_->fileName ()
+					<< mapped.File_->errorString ();
+			return nullptr;
+		}
+
+		mapped.Size_ = size;
+		return mapped.Data_;
+	}
+
+	void MessagePack::Unmap (int segment)
+	{
+		auto& mapped = Mapped_ [segment];
+		if (mapped.Data_)
+			mapped.File_->unmap (mapped.Data_);
+
+		mapped.Data_ = nullptr;
+		mapped.Size_ = 0;
+	}
+}
+}
@@ -0,0 +1,103 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+
+#pragma once
+
+#include <memory>
+#include <QDir>
+#include <QHash>
+#include <QMutex>
+
+class QFile;
+
+namespace LeechCraft
+{
+namespace Snails
+{
+	struct PackLocation
+	{
+		int Segment_;
+		qint64 Offset_;
+		int Length_;
+	};
+
+	/* Append-only storage for serialized messages.
+	 *
+	 * Records are appended to the current segment file, each prefixed by
+	 * its length, and a new segment is started once the current one grows
+	 * past MaxSegmentSize. Segments are read via mmap. The index mapping
+	 * messages to their locations is kept by the AccountDatabase.
+	 */
+	class MessagePack
+	{
+		const QDir Dir_;
+
+		mutable QMutex Mutex_;
+
+		int CurrentSegment_ = 0;
+		std::shared_ptr<QFile> Writer_;
+		qint64 WriterSize_ = 0;
+
+		struct MappedSegment
+		{
+			std::shared_ptr<QFile> File_;
+			uchar *Data_ = nullptr;
+			qint64 Size_ = 0;
+		};
+		QHash<int, MappedSegment> Mapped_;
+	public:
+		static const qint64 MaxSegmentSize = 64 * 1024 * 1024;
+		static const int RecordHeaderSize = sizeof (quint32);
+
+		MessagePack (const QDir& dir);
+		~MessagePack ();
+
+		MessagePack (const MessagePack&) = delete;
+		MessagePack& operator= (const MessagePack&) = delete;
+
+		PackLocation Append (const QByteArray&);
+		bool Flush ();
+
+		QByteArray Read (const PackLocation&);
+
+		QList<int> GetSegments () const;
+		int GetCurrentSegment () const;
+		qint64 GetSegmentSize (int) const;
+		void RemoveSegment (int);
+	private:
+		QString GetSegmentPath (int) const;
+		void OpenWriter (int);
+		const uchar* Map (int segment, qint64 minSize);
+		void Unmap (int segment);
+	};
+
+	typedef std::shared_ptr<MessagePack> MessagePack_ptr;
+}
+}
@@ -29,6 +29,7 @@
 
 #include "storage.h"
 #include <stdexcept>
+#include <algorithm>
 #include <QFile>
 #include <QApplication>
 #include <QtConcurrentMap>
@@ -37,11 +38,13 @@
 #include <QSqlError>
 #include <QtConcurrentRun>
 #include <QFutureWatcher>
+#include <QTimer>
 #include <util/db/dblock.h>
 #include <util/sys/paths.h>
 #include "xmlsettingsmanager.h"
 #include "account.h"
 #include "accountdatabase.h"
+#include "messagepack.h"
 
 namespace LeechCraft
 {
@@ -57,76 +60,96 @@ namespace Snails
 			stream << t;
 			return result;
 		}
-	}
 
-	Storage::Storage (QObject *parent)
-	: QObject (parent)
-	, Settings_ (QCoreApplication::organizationName (),
-				QCoreApplication::applicationName () + "_Snails_Storage")
-	{
-		SDir_ = Util::CreateIfNotExists ("snails/storage");
-	}
+		const QString PackDirName = "pack";
+		const QString MigratedMarkerName = "migrated";
 
-	namespace
-	{
-		QList<Message_ptr> MessageSaverProc (QList<Message_ptr> msgs, const QDir dir)
+		QString BackfillKey (Account *acc)
 		{
-			for (const auto& msg : msgs)
-			{
-				if (msg->GetFolderID ().isEmpty ())
-					continue;
-
-				const QString dirName = msg->GetFolderID ().toHex ().right (3);
-
-				QDir msgDir = dir;
-				if (!dir.exists (dirName))
-					msgDir.mkdir (dirName);
-				if (!msgDir.cd (dirName))
-				{
-					qWarning () << Q_FUNC_INFO
-							<< "unable to cd into"
-							<< msgDir.filePath (dirName);
-					continue;
-				}
+			return "SearchIndexBackfill/" + acc->GetID ().toHex ();
+		}
 
-				QFile file (msgDir.filePath (msg->GetFolderID ().toHex ()));
-				file.open (QIODevice::WriteOnly);
-				file.write (qCompress (msg->Serialize (), 9));
-			}
+		struct PackedMessage
+		{
+			Message_ptr Msg_;
+			QByteArray Data_;
+		};
 
-			return msgs;
+		QList<PackedMessage> MessagePackerProc (const QList<Message_ptr>& msgs)
+		{
+			QList<PackedMessage> result;
+			for (const auto& msg : msgs)
+				if (!msg->GetFolderID ().isEmpty ())
+					result.append ({ msg, qCompress (msg->Serialize (), 1) });
+			return result;
 		}
-	}
 
-	void Storage::SaveMessages (Account *acc, const QStringList& folder, const QList<Message_ptr>& msgs)
-	{
-		auto dir = DirForAccount (acc);
-		for (const auto& elem : folder)
+		Message_ptr Unpack (const QByteArray& data)
 		{
-			const auto& subdir = elem.toUtf8 ().toHex ();
-			if (!dir.exists (subdir))
-				dir.mkdir (subdir);
+			if (data.isEmpty ())
+				return {};
 
-			if (!dir.cd (subdir))
+			const auto& msg = std::make_shared<Message> ();
+			try
+			{
+				msg->Deserialize (qUncompress (data));
+			}
+			catch (const std::exception& e)
 			{
 				qWarning () << Q_FUNC_INFO
-						<< "unable to cd to"
-						<< dir.filePath (subdir);
-				throw std::runtime_error ("Unable to cd to the directory");
+						<< "error deserializing the message:"
+						<< e.what ();
+				return {};
 			}
+			return msg;
+		}
+
+		QList<Message_ptr> HeadersUnpackerProc (const QList<QByteArray>& packed)
+		{
+			QList<Message_ptr> result;
+			for (const auto& data : packed)
+				if (const auto& msg = Unpack (data))
+					result << msg;
+			return result;
 		}
 
+		typedef QList<QPair<int, Message_ptr>> UnpackedBackfill_t;
+
+		UnpackedBackfill_t BackfillUnpackerProc (const QList<QPair<int, QByteArray>>& packed)
+		{
+			UnpackedBackfill_t result;
+			for (const auto& pair : packed)
+				if (const auto& msg = Unpack (pair.second))
+					result.append ({ pair.first, msg });
+			return result;
+		}
+	}
+
+	Storage::Storage (QObject *parent)
+	: QObject (parent)
+	, Settings_ (QCoreApplication::organizationName (),
+				QCoreApplication::applicationName () + "_Snails_Storage")
+	{
+		SDir_ = Util::CreateIfNotExists ("snails/storage");
+	}
+
+	void Storage::SaveMessages (Account *acc, const QStringList& folder, const QList<Message_ptr>& msgs)
+	{
+		const auto saveId = ++LastSaveId_;
+
+		auto& pending = PendingSaveMessages_ [acc];
 		for (const auto& msg : msgs)
-			PendingSaveMessages_ [acc] [msg->GetFolderID ()] = msg;
+			if (!msg->GetFolderID ().isEmpty ())
+				pending [msg->GetFolderID ()] = { msg, saveId };
 
-		auto watcher = new QFutureWatcher<QList<Message_ptr>> ();
-		FutureWatcher2Account_ [watcher] = acc;
+		auto watcher = new QFutureWatcher<QList<PackedMessage>> ();
+		PendingSaves_ [watcher] = { acc, folder, saveId };
 
 		connect (watcher,
 				SIGNAL (finished ()),
 				this,
 				SLOT (handleMessagesSaved ()));
-		auto future = QtConcurrent::run (MessageSaverProc, msgs, dir);
+		auto future = QtConcurrent::run (MessagePackerProc, msgs);
 		watcher->setFuture (future);
 
 		for (const auto& msg : msgs)
@@ -139,149 +162,51 @@ namespace Snails
 		}
 	}
 
-	MessageSet Storage::LoadMessages (Account *acc)
-	{
-		MessageSet result;
-
-		const QDir& dir = DirForAccount (acc);
-		for (const auto& str : dir.entryList (QDir::NoDotAndDotDot | QDir::Dirs))
-		{
-			QDir subdir = dir;
-			if (!subdir.cd (str))
-			{
-				qWarning () << Q_FUNC_INFO
-						<< "unable to cd to"
-						<< str;
-				continue;
-			}
-
-			for (const auto& str : subdir.entryList (QDir::NoDotAndDotDot | QDir::Files))
-			{
-				QFile file (subdir.filePath (str));
-				if (!file.open (QIODevice::ReadOnly))
-				{
-					qWarning () << Q_FUNC_INFO
-							<< "unable to open"
-							<< str
-							<< file.errorString ();
-					continue;
-				}
-
-				const auto& msg = std::make_shared<Message> ();
-				try
-				{
-					msg->Deserialize (qUncompress (file.readAll ()));
-				}
-				catch (const std::exception& e)
-				{
-					qWarning () << Q_FUNC_INFO
-							<< "error deserializing the message from"
-							<< file.fileName ()
-							<< e.what ();
-					continue;
-				}
-				result << msg;
-				UpdateCaches (msg);
-			}
-		}
-
-		for (const auto& msg : PendingSaveMessages_ [acc])
-		{
-			result << msg;
-			UpdateCaches (msg);
-		}
-
-		return result;
-	}
-
 	Message_ptr Storage::LoadMessage (Account *acc, const QStringList& folder, const QByteArray& id)
 	{
-		if (PendingSaveMessages_ [acc].contains (id))
-			return PendingSaveMessages_ [acc] [id];
+		const auto& pending = PendingSaveMessages_ [acc];
+		if (pending.contains (id))
+			return pending [id].Msg_;
 
-		auto dir = DirForAccount (acc);
-		for (const auto& elem : folder)
-		{
-			const auto& subdir = elem.toUtf8 ().toHex ();
-			if (!dir.cd (subdir))
-			{
-				qWarning () << Q_FUNC_INFO
-						<< "unable to cd to"
-						<< dir.filePath (subdir);
-				throw std::runtime_error ("Unable to cd to the directory");
-			}
-		}
-
-		const auto& msg = LoadMessage (acc, dir, id);
-		UpdateCaches (msg);
-		return msg;
-	}
-
-	Message_ptr Storage::LoadMessage (Account *acc, QDir dir, const QByteArray& id) const
-	{
-		if (PendingSaveMessages_ [acc].contains (id))
-			return PendingSaveMessages_ [acc] [id];
-
-		if (!dir.cd (id.toHex ().right (3)))
-		{
-			qWarning () << Q_FUNC_INFO
-					<< "unable to cd to"
-					<< dir.filePath (id.toHex ().right (3));
-			throw std::runtime_error ("Unable to cd to the directory");
-		}
-
-		QFile file (dir.filePath (id.toHex ()));
-		if (!file.open (QIODevice::ReadOnly))
+		const auto& location = BaseForAccount (acc)->GetPackLocation (id, folder);
+		if (!location)
 		{
 			qWarning () << Q_FUNC_INFO
-					<< "unable to open"
-					<< file.fileName ()
-					<< file.errorString ();
-			throw std::runtime_error ("Unable to open the message file");
+					<< "no message"
+					<< id
+					<< "in"
+					<< folder;
+			throw std::runtime_error ("Unable to find the message in the storage");
 		}
 
-		const auto& msg = std::make_shared<Message> ();
-		try
-		{
-			msg->Deserialize (qUncompress (file.readAll ()));
-		}
-		catch (const std::exception& e)
-		{
-			qWarning () << Q_FUNC_INFO
-					<< "error deserializing the message from"
-					<< file.fileName ()
-					<< e.what ();
-			throw;
-		}
+		const auto& msg = Unpack (PackForAccount (acc)->Read (*location));
+		if (!msg)
+			throw std::runtime_error ("Unable to unpack the message");
 
+		UpdateCaches (msg);
 		return msg;
 	}
 
 	QList<Message_ptr> Storage::LoadMessages (Account *acc, const QStringList& folder, const QList<QByteArray>& ids)
 	{
-		auto rootDir = DirForAccount (acc);
-		for (const auto& elem : folder)
-		{
-			const auto& subdir = elem.toUtf8 ().toHex ();
-			if (!rootDir.cd (subdir))
-			{
-				qWarning () << Q_FUNC_INFO
-						<< "unable to cd to"
-						<< rootDir.filePath (subdir);
-				throw std::runtime_error ("Unable to cd to the directory");
-			}
-		}
+		const auto& pending = PendingSaveMessages_ [acc];
+		const auto& wanted = ids.toSet ();
+
+		const auto& pack = PackForAccount (acc);
+
+		QList<QByteArray> packed;
+		for (const auto& pair : BaseForAccount (acc)->GetPackLocations (folder))
+			if (wanted.contains (pair.first) && !pending.contains (pair.first))
+				packed << pack->Read (pair.second);
 
 		QList<Message_ptr> result;
-		auto future = QtConcurrent::mapped (ids,
-				std::function<Message_ptr (QByteArray)>
-				{
-					[this, acc, rootDir] (const QByteArray& id)
-						{ return LoadMessage (acc, rootDir, id); }
-				});
+		for (const auto& msg : QtConcurrent::blockingMapped<QList<Message_ptr>> (packed, Unpack))
+			if (msg)
+				result << msg;
 
-		for (const auto& item : future.results ())
-			result << item;
+		for (const auto& id : ids)
+			if (pending.contains (id))
+				result << pending [id].Msg_;
 
 		for (const auto& msg : result)
 			UpdateCaches (msg);
@@ -289,39 +214,63 @@ namespace Snails
 		return result;
 	}
 
+	QList<MessageInfo> Storage::LoadMessageInfos (Account *acc, const QStringList& folder)
+	{
+		const auto& base = BaseForAccount (acc);
+		auto infos = base->GetMessageInfos (folder);
+
+		/* Messages saved before the headers were kept in the database are
+		 * loaded once in the background to fill them in.
+		 */
+		auto missing = base->GetIDs (folder).toSet ();
+		for (const auto& info : infos)
+			missing.remove (info.FolderId_);
+		if (missing.isEmpty ())
+			return infos;
+
+		qDebug () << Q_FUNC_INFO
+				<< "filling in headers for"
+				<< missing.size ()
+				<< "messages in"
+				<< folder;
+
+		const auto pos = std::find_if (HeadersBackfills_.begin (), HeadersBackfills_.end (),
+				[acc, &folder] (const HeadersBackfill& backfill)
+					{ return backfill.Acc_ == acc && backfill.Folder_ == folder; });
+		if (pos != HeadersBackfills_.end ())
+			pos->Missing_ = missing.toList ();
+		else
+			HeadersBackfills_.append ({ acc, folder, missing.toList () });
+
+		if (!IsFillingHeaders_)
+		{
+			IsFillingHeaders_ = true;
+			QTimer::singleShot (0, this, SLOT (fillMessageHeaders ()));
+		}
+
+		return infos;
+	}
+
 	QList<QByteArray> Storage::LoadIDs (Account *acc, const QStringList& folder)
 	{
 		return BaseForAccount (acc)->GetIDs (folder);
 	}
 
+	QHash<QByteArray, bool> Storage::LoadReadStatuses (Account *acc, const QStringList& folder)
+	{
+		return BaseForAccount (acc)->GetReadStatuses (folder);
+	}
+
 	void Storage::RemoveMessage (Account *acc, const QStringList& folder, const QByteArray& id)
 	{
 		PendingSaveMessages_ [acc].remove (id);
 
-		BaseForAccount (acc)->RemoveMessage (id, folder,
-				[this, acc, folder, id] { RemoveMessageFile (acc, folder, id); });
+		BaseForAccount (acc)->RemoveMessage (id, folder);
 	}
 
-	int Storage::GetNumMessages (Account *acc) const
+	int Storage::GetNumMessages (Account *acc)
 	{
-		int result = 0;
-
-		const QDir& dir = DirForAccount (acc);
-		for (const auto& str : dir.entryList (QDir::NoDotAndDotDot | QDir::Dirs))
-		{
-			QDir subdir = dir;
-			if (!subdir.cd (str))
-			{
-				qWarning () << Q_FUNC_INFO
-						<< "unable to cd to"
-						<< str;
-				continue;
-			}
-
-			result += subdir.entryList (QDir::NoDotAndDotDot | QDir::Files).size ();
-		}
-
-		return result;
+		return BaseForAccount (acc)->GetMessageCount ();
 	}
 
 	int Storage::GetNumMessages (Account *acc, const QStringList& folder)
@@ -334,7 +283,7 @@ namespace Snails
 		return BaseForAccount (acc)->GetUnreadMessageCount (folder);
 	}
 
-	bool Storage::HasMessagesIn (Account *acc) const
+	bool Storage::HasMessagesIn (Account *acc)
 	{
 		return GetNumMessages (acc);
 	}
@@ -347,41 +296,24 @@ namespace Snails
 		return LoadMessage (acc, folder, id)->IsRead ();
 	}
 
-	void Storage::RemoveMessageFile (Account *acc, const QStringList& folder, const QByteArray& id)
+	boost::optional<FolderSyncState> Storage::GetFolderSyncState (Account *acc, const QStringList& folder)
 	{
-		auto dir = DirForAccount (acc);
-		for (const auto& elem : folder)
-		{
-			const auto& subdir = elem.toUtf8 ().toHex ();
-			if (!dir.cd (subdir))
-			{
-				qWarning () << Q_FUNC_INFO
-						<< "unable to cd to"
-						<< dir.filePath (subdir);
-				throw std::runtime_error ("Unable to cd to the directory");
-			}
-		}
+		return BaseForAccount (acc)->GetFolderSyncState (folder);
+	}
 
-		if (!dir.cd (id.toHex ().right (3)))
-		{
-			qWarning () << Q_FUNC_INFO
-					<< "unable to cd to"
-					<< dir.filePath (id.toHex ().right (3));
-			throw std::runtime_error ("Unable to cd to the directory");
-		}
+	void Storage::SetFolderSyncState (Account *acc, const QStringList& folder, const FolderSyncState& state)
+	{
+		BaseForAccount (acc)->SetFolderSyncState (folder, state);
+	}
 
-		QFile file (dir.filePath (id.toHex ()));
-		if (!file.exists ())
-			return;
+	QList<QByteArray> Storage::Search (Account *acc, const QStringList& folder, const QString& text)
+	{
+		return BaseForAccount (acc)->Search (folder, text);
+	}
 
-		qDebug () << "removing" << file.fileName () << file.size ();
-		if (!file.remove ())
-		{
-			qWarning () << Q_FUNC_INFO
-					<< "unable to remove the file:"
-					<< file.errorString ();
-			throw std::runtime_error ("Unable to remove the file");
-		}
+	SearchIndexStats Storage::GetSearchIndexStats (Account *acc)
+	{
+		return BaseForAccount (acc)->GetSearchIndexStats ();
 	}
 
 	QDir Storage::DirForAccount (Account *acc) const
@@ -410,9 +342,202 @@ namespace Snails
 		const auto& dir = DirForAccount (acc);
 		const auto& base = std::make_shared<AccountDatabase> (dir, acc);
 		AccountBases_ [acc] = base;
+
+		/* Messages stored before the search index existed are indexed in
+		 * small batches, resuming where the previous session stopped.
+		 */
+		if (base->IsSearchIndexNew ())
+			Settings_.setValue (BackfillKey (acc), 0);
+		if (base->HasSearchIndex () && Settings_.contains (BackfillKey (acc)))
+		{
+			if (SearchBackfillPos_.isEmpty ())
+				QTimer::singleShot (0, this, SLOT (backfillSearchIndex ()));
+			SearchBackfillPos_ [acc] = Settings_.value (BackfillKey (acc)).toInt ();
+		}
+
 		return base;
 	}
 
+	MessagePack_ptr Storage::PackForAccount (Account *acc)
+	{
+		if (AccountPacks_.contains (acc))
+			return AccountPacks_ [acc];
+
+		auto dir = DirForAccount (acc);
+		if (!dir.exists (PackDirName))
+			dir.mkdir (PackDirName);
+		if (!dir.cd (PackDirName))
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to cd into"
+					<< dir.filePath (PackDirName);
+			throw std::runtime_error ("Unable to cd to the pack dir");
+		}
+
+		const auto& pack = std::make_shared<MessagePack> (dir);
+		AccountPacks_ [acc] = pack;
+
+		/* The marker is written only after all the legacy messages are
+		 * in the pack and indexed, so an interrupted or failed migration
+		 * is resumed on the next start.
+		 */
+		if (dir.exists (MigratedMarkerName))
+			CompactPack (acc, pack);
+		else if (MigrateLegacyFiles (acc, pack))
+		{
+			QFile marker { dir.filePath (MigratedMarkerName) };
+			if (!marker.open (QIODevice::WriteOnly))
+				qWarning () << Q_FUNC_INFO
+						<< "unable to create"
+						<< marker.fileName ()
+						<< marker.errorString ();
+		}
+
+		return pack;
+	}
+
+	bool Storage::MigrateLegacyFiles (Account *acc, const MessagePack_ptr& pack)
+	{
+		const auto& dir = DirForAccount (acc);
+
+		const auto& result = MigrateLegacyDir (dir, {}, acc, pack);
+		if (result.Migrated_)
+			qDebug () << Q_FUNC_INFO
+					<< "migrated"
+					<< result.Migrated_
+					<< "messages of"
+					<< acc->GetName ()
+					<< "to the message pack";
+
+		if (!result.Failed_)
+			return true;
+
+		qWarning () << Q_FUNC_INFO
+				<< "unable to migrate"
+				<< result.Failed_
+				<< "messages of"
+				<< acc->GetName ()
+				<< "; keeping them in"
+				<< dir.path ();
+		return false;
+	}
+
+	Storage::MigrationResult Storage::MigrateLegacyDir (QDir dir, const QStringList& folder,
+			Account *acc, const MessagePack_ptr& pack)
+	{
+		MigrationResult result;
+		QList<QPair<QByteArray, PackLocation>> locations;
+		QStringList migratedFiles;
+		QStringList buckets;
+
+		for (const auto& name : dir.entryList (QDir::NoDotAndDotDot | QDir::Dirs))
+		{
+			if (folder.isEmpty () && name == PackDirName)
+				continue;
+
+			QDir subdir = dir;
+			if (!subdir.cd (name))
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "unable to cd to"
+						<< dir.filePath (name);
+				continue;
+			}
+
+			/* Folder components are hex-encoded and thus have even length,
+			 * while per-message buckets are always three characters long.
+			 */
+			if (name.size () != 3)
+			{
+				const auto& component = QString::fromUtf8 (QByteArray::fromHex (name.toLatin1 ()));
+				const auto& sub = MigrateLegacyDir (subdir, folder + QStringList { component }, acc, pack);
+				result.Migrated_ += sub.Migrated_;
+				result.Failed_ += sub.Failed_;
+
+				dir.rmdir (name);
+				continue;
+			}
+
+			buckets << name;
+
+			for (const auto& fileName : subdir.entryList (QDir::Files))
+			{
+				QFile file { subdir.filePath (fileName) };
+				if (!file.open (QIODevice::ReadOnly))
+				{
+					qWarning () << Q_FUNC_INFO
+							<< "unable to open"
+							<< file.fileName ()
+							<< file.errorString ();
+					++result.Failed_;
+					continue;
+				}
+
+				locations.append ({ QByteArray::fromHex (fileName.toLatin1 ()), pack->Append (file.readAll ()) });
+				migratedFiles << file.fileName ();
+			}
+		}
+
+		if (!locations.isEmpty ())
+		{
+			if (!pack->Flush ())
+			{
+				result.Failed_ += locations.size ();
+				return result;
+			}
+
+			BaseForAccount (acc)->SetPackLocations (folder, locations);
+			result.Migrated_ += locations.size ();
+		}
+
+		/* Only the files that are already in the pack and in the index are
+		 * removed, and the directories are removed only if they are empty.
+		 */
+		for (const auto& path : migratedFiles)
+			QFile::remove (path);
+		for (const auto& bucket : buckets)
+			dir.rmdir (bucket);
+
+		return result;
+	}
+
+	void Storage::CompactPack (Account *acc, const MessagePack_ptr& pack)
+	{
+		const auto& base = BaseForAccount (acc);
+		const auto& usage = base->GetPackSegmentsUsage ();
+
+		/* Segments are up to MessagePack::MaxSegmentSize, so the live
+		 * records are copied out of them in the background, a few
+		 * megabytes at a time.
+		 */
+		for (const auto segment : pack->GetSegments ())
+		{
+			if (segment == pack->GetCurrentSegment ())
+				continue;
+
+			const auto size = pack->GetSegmentSize (segment);
+			const auto live = usage.value (segment);
+			if (live * 2 >= size)
+				continue;
+
+			qDebug () << Q_FUNC_INFO
+					<< "scheduling compaction of segment"
+					<< segment
+					<< "of"
+					<< acc->GetName ()
+					<< live
+					<< size;
+
+			PackCompactions_.append ({ acc, segment, base->GetPackSegmentEntries (segment), {} });
+		}
+
+		if (!PackCompactions_.isEmpty () && !IsCompactingPacks_)
+		{
+			IsCompactingPacks_ = true;
+			QTimer::singleShot (1000, this, SLOT (compactPacks ()));
+		}
+	}
+
 	void Storage::AddMessage (Message_ptr msg, Account *acc)
 	{
 		const auto& base = BaseForAccount (acc);
@@ -426,11 +551,10 @@ namespace Snails
 
 	void Storage::handleMessagesSaved ()
 	{
-		auto watcher = dynamic_cast<QFutureWatcher<QList<Message_ptr>>*> (sender ());
+		auto watcher = dynamic_cast<QFutureWatcher<QList<PackedMessage>>*> (sender ());
 		watcher->deleteLater ();
 
-		auto acc = FutureWatcher2Account_.take (watcher);
-		if (!acc)
+		if (!PendingSaves_.contains (watcher))
 		{
 			qWarning () << Q_FUNC_INFO
 					<< "no account for future watcher"
@@ -438,11 +562,207 @@ namespace Snails
 			return;
 		}
 
-		auto& hash = PendingSaveMessages_ [acc];
+		const auto save = PendingSaves_.take (watcher);
+		auto& pending = PendingSaveMessages_ [save.Acc_];
+		const auto& pack = PackForAccount (save.Acc_);
+
+		QList<QPair<QByteArray, PackLocation>> locations;
+		for (const auto& packed : watcher->result ())
+		{
+			const auto& id = packed.Msg_->GetFolderID ();
+
+			/* The message has either been removed or saved once again
+			 * since, and the latter save will take care of it.
+			 */
+			const auto pos = pending.find (id);
+			if (pos == pending.end () || pos->SaveId_ != save.SaveId_)
+				continue;
+
+			locations.append ({ id, pack->Append (packed.Data_) });
+		}
+
+		/* The messages stay pending and thus available from memory until
+		 * they are saved successfully.
+		 */
+		if (!pack->Flush ())
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to flush the pack of"
+					<< save.Acc_->GetName ()
+					<< "; not storing"
+					<< locations.size ()
+					<< "messages";
+			return;
+		}
+
+		BaseForAccount (save.Acc_)->SetPackLocations (save.Folder_, locations);
+
+		for (const auto& pair : locations)
+			pending.remove (pair.first);
+	}
+	void Storage::backfillSearchIndex ()
+	{
+		const int batchSize = 50;
+
+		while (!SearchBackfillPos_.isEmpty ())
+		{
+			const auto i = SearchBackfillPos_.begin ();
+			const auto acc = i.key ();
+			const auto& base = BaseForAccount (acc);
+
+			const auto& unindexed = base->GetUnindexedMessages (*i, batchSize);
+			if (unindexed.isEmpty ())
+			{
+				qDebug () << Q_FUNC_INFO
+						<< "search index is complete for"
+						<< acc->GetName ();
+				Settings_.remove (BackfillKey (acc));
+				SearchBackfillPos_.erase (i);
+				continue;
+			}
+
+			/* Only the raw records are read here, while unpacking them
+			 * is done in a separate thread.
+			 */
+			const auto& pack = PackForAccount (acc);
+			QList<QPair<int, QByteArray>> packed;
+			for (const auto& item : unindexed)
+				if (const auto& location = base->GetPackLocation (item.FolderMessageId_, item.Folder_))
+					packed.append ({ item.TableId_, pack->Read (*location) });
+
+			auto watcher = new QFutureWatcher<UnpackedBackfill_t> ();
+			PendingBackfills_ [watcher] = { acc, unindexed.last ().TableId_ };
+
+			connect (watcher,
+					SIGNAL (finished ()),
+					this,
+					SLOT (handleBackfillUnpacked ()));
+			watcher->setFuture (QtConcurrent::run (BackfillUnpackerProc, packed));
+			return;
+		}
+	}
+
+	void Storage::handleBackfillUnpacked ()
+	{
+		auto watcher = dynamic_cast<QFutureWatcher<UnpackedBackfill_t>*> (sender ());
+		watcher->deleteLater ();
+
+		const auto backfill = PendingBackfills_.take (watcher);
+		if (!SearchBackfillPos_.contains (backfill.Acc_))
+			return;
+
+		BaseForAccount (backfill.Acc_)->IndexMessages (watcher->result ());
+
+		SearchBackfillPos_ [backfill.Acc_] = backfill.LastTableId_;
+		Settings_.setValue (BackfillKey (backfill.Acc_), backfill.LastTableId_);
+
+		QTimer::singleShot (50, this, SLOT (backfillSearchIndex ()));
+	}
+
+	void Storage::fillMessageHeaders ()
+	{
+		const int batchSize = 100;
+
+		while (!HeadersBackfills_.isEmpty ())
+		{
+			auto& backfill = HeadersBackfills_.first ();
+			if (backfill.Missing_.isEmpty ())
+			{
+				HeadersBackfills_.removeFirst ();
+				continue;
+			}
+
+			const auto acc = backfill.Acc_;
+			const auto& base = BaseForAccount (acc);
+			const auto& pack = PackForAccount (acc);
+
+			QList<QByteArray> packed;
+			const auto& batch = backfill.Missing_.mid (0, batchSize);
+			backfill.Missing_ = backfill.Missing_.mid (batchSize);
+			for (const auto& id : batch)
+				if (const auto& location = base->GetPackLocation (id, backfill.Folder_))
+					packed << pack->Read (*location);
+
+			auto watcher = new QFutureWatcher<QList<Message_ptr>> ();
+			PendingHeadersFills_ [watcher] = { acc, backfill.Folder_ };
+
+			connect (watcher,
+					SIGNAL (finished ()),
+					this,
+					SLOT (handleHeadersUnpacked ()));
+			watcher->setFuture (QtConcurrent::run (HeadersUnpackerProc, packed));
+			return;
+		}
+
+		IsFillingHeaders_ = false;
+	}
+
+	void Storage::handleHeadersUnpacked ()
+	{
+		auto watcher = dynamic_cast<QFutureWatcher<QList<Message_ptr>>*> (sender ());
+		watcher->deleteLater ();
+
+		const auto fill = PendingHeadersFills_.take (watcher);
+		const auto& msgs = watcher->result ();
+		BaseForAccount (fill.Acc_)->SetMessageHeaders (fill.Folder_, msgs);
+
+		QList<MessageInfo> infos;
+		for (const auto& msg : msgs)
+		{
+			UpdateCaches (msg);
+			infos << ToMessageInfo (msg);
+		}
+		emit messageHeadersFilled (fill.Acc_, fill.Folder_, infos);
+
+		QTimer::singleShot (0, this, SLOT (fillMessageHeaders ()));
+	}
+
+	void Storage::compactPacks ()
+	{
+		const qint64 batchBytes = 4 * 1024 * 1024;
+
+		if (PackCompactions_.isEmpty ())
+		{
+			IsCompactingPacks_ = false;
+			return;
+		}
+
+		auto& compaction = PackCompactions_.first ();
+		const auto& pack = PackForAccount (compaction.Acc_);
+
+		qint64 copied = 0;
+		while (!compaction.Entries_.isEmpty () && copied < batchBytes)
+		{
+			const auto entry = compaction.Entries_.takeFirst ();
+			const auto& data = pack->Read (entry.second);
+			if (data.isEmpty ())
+				continue;
+
+			compaction.Moved_.append ({ entry.first, pack->Append (data) });
+			copied += data.size ();
+		}
+
+		if (compaction.Entries_.isEmpty ())
+		{
+			const auto done = PackCompactions_.takeFirst ();
+
+			/* The old segment is kept and the index isn't touched unless
+			 * the copies are safely on disk.
+			 */
+			if (pack->Flush ())
+			{
+				BaseForAccount (done.Acc_)->MovePackEntries (done.Segment_, done.Moved_);
+				pack->RemoveSegment (done.Segment_);
+			}
+			else
+				qWarning () << Q_FUNC_INFO
+						<< "unable to flush the pack of"
+						<< done.Acc_->GetName ()
+						<< "; keeping segment"
+						<< done.Segment_;
+		}
 
-		auto messages = watcher->result ();
-		for (const auto& msg : messages)
-			hash.remove (msg->GetFolderID ());
+		QTimer::singleShot (50, this, SLOT (compactPacks ()));
 	}
 }
 }
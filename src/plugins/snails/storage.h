@@ -34,7 +34,11 @@
 #include <QSettings>
 #include <QHash>
 #include <QSet>
+#include <boost/optional.hpp>
 #include "message.h"
+#include "folder.h"
+#include "messageinfo.h"
+#include "messagepack.h"
 
 namespace LeechCraft
 {
@@ -45,6 +49,8 @@ namespace Snails
 	class AccountDatabase;
 	typedef std::shared_ptr<AccountDatabase> AccountDatabase_ptr;
 
+	struct SearchIndexStats;
+
 	class Storage : public QObject
 	{
 		Q_OBJECT
@@ -54,38 +60,116 @@ namespace Snails
 		QHash<QByteArray, bool> IsMessageRead_;
 
 		QHash<Account*, AccountDatabase_ptr> AccountBases_;
-		QHash<Account*, QHash<QByteArray, Message_ptr>> PendingSaveMessages_;
+		QHash<Account*, MessagePack_ptr> AccountPacks_;
+
+		struct PendingMessage
+		{
+			Message_ptr Msg_;
+			quint64 SaveId_;
+		};
+		QHash<Account*, QHash<QByteArray, PendingMessage>> PendingSaveMessages_;
+
+		struct PendingSave
+		{
+			Account *Acc_;
+			QStringList Folder_;
+			quint64 SaveId_;
+		};
+		QHash<QObject*, PendingSave> PendingSaves_;
+		quint64 LastSaveId_ = 0;
+
+		QHash<Account*, int> SearchBackfillPos_;
+
+		struct PendingBackfill
+		{
+			Account *Acc_;
+			int LastTableId_;
+		};
+		QHash<QObject*, PendingBackfill> PendingBackfills_;
+
+		struct HeadersBackfill
+		{
+			Account *Acc_;
+			QStringList Folder_;
+			QList<QByteArray> Missing_;
+		};
+		QList<HeadersBackfill> HeadersBackfills_;
+		bool IsFillingHeaders_ = false;
+
+		struct PackCompaction
+		{
+			Account *Acc_;
+			int Segment_;
+			QList<QPair<qint64, PackLocation>> Entries_;
+			QList<QPair<qint64, PackLocation>> Moved_;
+		};
+		QList<PackCompaction> PackCompactions_;
+		bool IsCompactingPacks_ = false;
+
+		struct PendingHeadersFill
+		{
+			Account *Acc_;
+			QStringList Folder_;
+		};
+		QHash<QObject*, PendingHeadersFill> PendingHeadersFills_;
 
-		QHash<QObject*, Account*> FutureWatcher2Account_;
+		struct MigrationResult
+		{
+			int Migrated_ = 0;
+			int Failed_ = 0;
+		};
 	public:
 		Storage (QObject* = 0);
 
 		void SaveMessages (Account*, const QStringList& folders, const QList<Message_ptr>&);
 
-		MessageSet LoadMessages (Account*);
 		Message_ptr LoadMessage (Account*, const QStringList& folder, const QByteArray& id);
 		QList<Message_ptr> LoadMessages (Account*, const QStringList& folder, const QList<QByteArray>& ids);
 
+		/* Returns the infos of the messages in the folder whose headers
+		 * are already in the database. The headers of the rest are filled
+		 * in the background and announced by messageHeadersFilled().
+		 */
+		QList<MessageInfo> LoadMessageInfos (Account*, const QStringList& folder);
+
 		QList<QByteArray> LoadIDs (Account*, const QStringList& folder);
+		QHash<QByteArray, bool> LoadReadStatuses (Account*, const QStringList& folder);
 		void RemoveMessage (Account*, const QStringList&, const QByteArray&);
 
-		int GetNumMessages (Account*) const;
+		int GetNumMessages (Account*);
 		int GetNumMessages (Account*, const QStringList& folder);
 		int GetNumUnread (Account*, const QStringList& folder);
-		bool HasMessagesIn (Account*) const;
+		bool HasMessagesIn (Account*);
 
 		bool IsMessageRead (Account*, const QStringList& folder, const QByteArray&);
-	private:
-		Message_ptr LoadMessage (Account*, QDir, const QByteArray&) const;
-		void RemoveMessageFile (Account*, const QStringList&, const QByteArray&);
+
+		boost::optional<FolderSyncState> GetFolderSyncState (Account*, const QStringList& folder);
+		void SetFolderSyncState (Account*, const QStringList& folder, const FolderSyncState&);
+
+		QList<QByteArray> Search (Account*, const QStringList& folder, const QString& text);
+		SearchIndexStats GetSearchIndexStats (Account*);
 	private:
 		QDir DirForAccount (Account*) const;
 		AccountDatabase_ptr BaseForAccount (Account*);
+		MessagePack_ptr PackForAccount (Account*);
+
+		bool MigrateLegacyFiles (Account*, const MessagePack_ptr&);
+		MigrationResult MigrateLegacyDir (QDir, const QStringList&, Account*, const MessagePack_ptr&);
+		void CompactPack (Account*, const MessagePack_ptr&);
 
 		void AddMessage (Message_ptr, Account*);
 		void UpdateCaches (Message_ptr);
 	private slots:
 		void handleMessagesSaved ();
+		void backfillSearchIndex ();
+		void handleBackfillUnpacked ();
+
+		void fillMessageHeaders ();
+		void handleHeadersUnpacked ();
+
+		void compactPacks ();
+	signals:
+		void messageHeadersFilled (Account*, const QStringList& folder, const QList<MessageInfo>&);
 	};
 }
 }